@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/anomaly_detector.h"
+
+using namespace equipment_tracker;
+
+// Per-fix cost of checking and learning anomaly baselines across a large
+// fleet, and the memory each machine's baseline takes
+namespace
+{
+    constexpr int MACHINES = 10000;
+    constexpr int ROUNDS = 200; // Fixes per machine
+    const Timestamp START = std::chrono::system_clock::from_time_t(1699833600 + 9 * 3600); // Monday 09:00 UTC
+} // namespace
+
+int main()
+{
+    // Machines drive at 2-6 m/s around their own site, one fix every 5 s,
+    // with an occasional GPS glitch
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> heading(0.0, 2.0 * 3.14159265358979323846);
+    std::uniform_real_distribution<double> speed(2.0, 6.0);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<std::string> ids;
+    std::vector<Position> last;
+    for (int m = 0; m < MACHINES; ++m)
+    {
+        ids.push_back("M-" + std::to_string(m));
+        last.emplace_back(37.0 + (m / 100) * 0.05, -122.0 + (m % 100) * 0.05, 0.0, 2.0, START);
+    }
+    std::vector<Position> fixes;
+    fixes.reserve(static_cast<size_t>(MACHINES) * ROUNDS);
+    for (int round = 1; round <= ROUNDS; ++round)
+    {
+        for (int m = 0; m < MACHINES; ++m)
+        {
+            double meters = speed(rng) * 5.0;
+            double angle = heading(rng);
+            double latitude = last[m].getLatitude() + meters * std::sin(angle) / 111195.0;
+            double longitude = last[m].getLongitude() + meters * std::cos(angle) / 88800.0;
+            last[m] = Position(latitude, longitude, 0.0, 2.0, START + std::chrono::seconds(5 * round));
+            fixes.push_back(chance(rng) < 0.0005 ? Position(latitude + 1.0, longitude, 0.0, 2.0, last[m].getTimestamp())
+                                                 : last[m]);
+        }
+    }
+
+    AnomalyDetector detector;
+    size_t events = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fixes.size(); ++i)
+    {
+        events += detector.observe(ids[i % MACHINES], fixes[i]).size();
+    }
+    double per_fix_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() /
+                        static_cast<double>(fixes.size());
+
+    // Baseline state plus its map node and key
+    size_t per_machine_bytes = detector.baselineBytes() + sizeof(void *) * 2 + ids[0].capacity();
+
+    std::cout << MACHINES << " machines, " << fixes.size() << " fixes, " << events << " anomalies" << std::endl;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(28) << std::left << "observe" << std::right
+              << std::setw(10) << per_fix_ns << " ns/fix" << std::endl;
+    std::cout << std::setw(28) << std::left << "baseline per machine" << std::right << std::setw(10)
+              << per_machine_bytes << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/arrow_export.h"
+
+using namespace equipment_tracker;
+
+// Arrow IPC export of a fleet's history to a file with different thread
+// counts, next to a plain write of the same number of bytes for reference
+namespace
+{
+    constexpr int MACHINES = 20;
+    constexpr int FIXES_PER_MACHINE = 50000;
+    const std::string BENCH_PATH = "arrow_export_bench_db";
+
+    void report(const std::string &label, uint64_t bytes, double seconds)
+    {
+        std::cout << std::left << std::setw(16) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << bytes / 1e6 << " MB" << std::setw(9) << bytes / 1e6 / seconds << " MB/s"
+                  << std::endl;
+    }
+
+    uint64_t measure(DataStorage &storage, const std::vector<EquipmentId> &ids, size_t threads)
+    {
+        ArrowExporter exporter(storage, threads);
+        std::ofstream out(BENCH_PATH + "/export.arrow", std::ios::binary | std::ios::trunc);
+        auto begin = std::chrono::steady_clock::now();
+        exporter.exportHistory(ids, ArrowIpcFormat::File, out);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        report(std::to_string(threads) + " thread(s)", exporter.getStats().bytes, seconds);
+        return exporter.getStats().bytes;
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(BENCH_PATH);
+    {
+        DataStorage storage(BENCH_PATH);
+        storage.initialize();
+        std::vector<EquipmentId> ids;
+        for (int m = 0; m < MACHINES; ++m)
+        {
+            ids.push_back("BENCH-" + std::to_string(m));
+            storage.saveEquipment(Equipment(ids.back(), EquipmentType::Truck, "Truck"));
+            for (int i = 0; i < FIXES_PER_MACHINE; ++i)
+            {
+                storage.savePosition(ids.back(), Position(37.0 + i * 1e-6, -122.0 + m * 1e-3, 12.5, 2.0,
+                                                          Timestamp(std::chrono::seconds(1700000000 + i))));
+            }
+        }
+        storage.flush();
+
+        std::cout << MACHINES * FIXES_PER_MACHINE << " fixes" << std::endl;
+        uint64_t bytes = 0;
+        for (size_t threads : {1, 2, 4, 8})
+        {
+            bytes = measure(storage, ids, threads);
+        }
+
+        std::vector<char> block(1 << 20, 'x');
+        std::ofstream out(BENCH_PATH + "/plain.out", std::ios::binary | std::ios::trunc);
+        auto begin = std::chrono::steady_clock::now();
+        for (uint64_t written = 0; written < bytes; written += block.size())
+        {
+            out.write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+        out.flush();
+        report("plain write", bytes, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+    std::filesystem::remove_all(BENCH_PATH);
+    return 0;
+}
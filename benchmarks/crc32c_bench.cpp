@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/position_log.h"
+#include "equipment_tracker/utils/crc32c.h"
+
+using namespace equipment_tracker;
+
+// Checksum throughput: raw CRC-32C over an in-memory buffer for each
+// implementation, then PositionLog::verify() over a 256 MiB history, which
+// includes reading the segments back from disk.
+namespace
+{
+    constexpr size_t BUFFER_SIZE = 64 * 1024 * 1024;
+    constexpr int PASSES = 8;
+    constexpr uint64_t HISTORY_BYTES = 256ull * 1024 * 1024;
+
+    void report(const std::string &name, double bytes, double seconds)
+    {
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+                  << bytes / seconds / 1e9 << " GB/s" << std::endl;
+    }
+
+    template <typename Checksum>
+    void runChecksum(const std::string &name, const std::vector<char> &buffer, Checksum checksum)
+    {
+        uint32_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            sink ^= checksum(buffer.data(), buffer.size());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        report(name, static_cast<double>(buffer.size()) * PASSES, seconds);
+        if (sink == 0x12345678)
+        {
+            std::cout << std::endl; // Keeps the loop from being optimized away
+        }
+    }
+
+    void runVerify(const std::filesystem::path &directory)
+    {
+        auto io = createStorageIoBackend(IoBackendType::ThreadPool);
+        {
+            PositionLog log(directory, *io);
+            log.open(true);
+            auto base = std::chrono::system_clock::from_time_t(1700000000);
+            for (uint64_t i = 0; i < HISTORY_BYTES / POSITION_RECORD_SIZE; ++i)
+            {
+                log.append(Position(37.7749 + i * 1e-9, -122.4194, 10.0, 2.5, base + std::chrono::milliseconds(i)));
+            }
+            io->wait();
+            log.writeTail();
+            io->wait();
+        }
+
+        PositionLog log(directory, *io);
+        log.open(false);
+
+        auto start = std::chrono::steady_clock::now();
+        PositionLogCheck check = log.verify();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        report("PositionLog::verify", static_cast<double>(check.bytes), seconds);
+        std::cout << "  " << check.segments << " segments, " << check.records << " fixes, "
+                  << check.corrupt_records << " corrupt" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::vector<char> buffer(BUFFER_SIZE);
+    std::mt19937_64 rng(7);
+    for (auto &byte : buffer)
+    {
+        byte = static_cast<char>(rng());
+    }
+
+    std::cout << "CRC-32C implementation: " << crc32cImplementation() << std::endl;
+    runChecksum(std::string("crc32c/") + crc32cImplementation(), buffer,
+                [](const char *data, size_t size)
+                {
+                    return crc32c(data, size);
+                });
+    runChecksum("crc32c/table", buffer,
+                [](const char *data, size_t size)
+                {
+                    return crc32cExtendSoftware(0, data, size);
+                });
+
+    std::filesystem::path directory = "crc32c_bench_log";
+    std::filesystem::remove_all(directory);
+    runVerify(directory);
+    std::filesystem::remove_all(directory);
+    return 0;
+}
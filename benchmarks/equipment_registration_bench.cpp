@@ -0,0 +1,65 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/equipment_tracker_service.h"
+
+using namespace equipment_tracker;
+
+// Site onboarding: registers 100k machines one call at a time and then as
+// a single batch, each into a fresh database.
+namespace
+{
+    constexpr size_t EQUIPMENT_COUNT = 100000;
+
+    std::vector<Equipment> makeFleet(const std::string &prefix)
+    {
+        std::vector<Equipment> fleet;
+        fleet.reserve(EQUIPMENT_COUNT);
+        for (size_t i = 0; i < EQUIPMENT_COUNT; ++i)
+        {
+            fleet.emplace_back(prefix + std::to_string(i), static_cast<EquipmentType>(i % 6),
+                               "Machine " + std::to_string(i));
+        }
+        return fleet;
+    }
+
+    void report(const std::string &name, double seconds)
+    {
+        std::cout << std::left << std::setw(20) << name
+                  << std::right << std::setw(8) << std::fixed << std::setprecision(2) << seconds << " s"
+                  << std::setw(12) << std::setprecision(0) << EQUIPMENT_COUNT / seconds << " machines/s"
+                  << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(DEFAULT_DB_PATH);
+    {
+        EquipmentTrackerService service;
+        auto fleet = makeFleet("ONE-");
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &equipment : fleet)
+        {
+            service.addEquipment(equipment);
+        }
+        report("addEquipment x100k", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::filesystem::remove_all(DEFAULT_DB_PATH);
+    {
+        EquipmentTrackerService service;
+        auto fleet = makeFleet("BATCH-");
+
+        auto start = std::chrono::steady_clock::now();
+        service.addEquipmentBatch(fleet);
+        report("addEquipmentBatch", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::filesystem::remove_all(DEFAULT_DB_PATH);
+    return 0;
+}
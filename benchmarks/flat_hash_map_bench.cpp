@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "equipment_tracker/position.h"
+#include "equipment_tracker/utils/flat_hash_map.h"
+
+using namespace equipment_tracker;
+
+namespace
+{
+    // Stand-in for a fleet table row: last fix plus status
+    struct FleetRecord
+    {
+        Position position;
+        EquipmentStatus status{EquipmentStatus::Active};
+    };
+
+    template <typename Fn>
+    double timeMs(Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char *map_name, const char *op, double ms, size_t count)
+    {
+        std::cout << map_name << " " << op << ": " << ms << " ms ("
+                  << (ms * 1e6 / static_cast<double>(count)) << " ns/op)" << std::endl;
+    }
+} // namespace
+
+// Compares the fleet table's FlatHashMap with std::unordered_map at 1M entries
+int main()
+{
+    constexpr size_t ENTRY_COUNT = 1000000;
+
+    std::vector<std::string> ids;
+    ids.reserve(ENTRY_COUNT);
+    for (size_t i = 0; i < ENTRY_COUNT; ++i)
+    {
+        ids.push_back("EQUIPMENT-" + std::to_string(i));
+    }
+
+    std::vector<std::string> lookups = ids;
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(1));
+
+    volatile double sink = 0.0;
+
+    {
+        std::unordered_map<EquipmentId, FleetRecord> map;
+        report("unordered_map", "insert", timeMs([&]
+                                                  {
+            for (const auto &id : ids) { map.emplace(id, FleetRecord{}); } }),
+               ENTRY_COUNT);
+        report("unordered_map", "lookup", timeMs([&]
+                                                  {
+            for (const auto &id : lookups) { sink = sink + map.find(id)->second.position.getLatitude(); } }),
+               ENTRY_COUNT);
+        report("unordered_map", "iterate", timeMs([&]
+                                                   {
+            for (const auto &[_, record] : map) { sink = sink + record.position.getLatitude(); } }),
+               ENTRY_COUNT);
+    }
+
+    {
+        FlatHashMap<FleetRecord> map;
+        report("FlatHashMap", "insert", timeMs([&]
+                                                {
+            for (const auto &id : ids) { map.try_emplace(id, FleetRecord{}); } }),
+               ENTRY_COUNT);
+        report("FlatHashMap", "lookup", timeMs([&]
+                                                {
+            for (const auto &id : lookups) { sink = sink + map.find(id)->second.position.getLatitude(); } }),
+               ENTRY_COUNT);
+        report("FlatHashMap", "lookup(string_view)", timeMs([&]
+                                                             {
+            for (const auto &id : lookups) { sink = sink + map.find(std::string_view(id))->second.position.getLatitude(); } }),
+               ENTRY_COUNT);
+        report("FlatHashMap", "iterate", timeMs([&]
+                                                 {
+            for (const auto &[_, record] : map) { sink = sink + record.position.getLatitude(); } }),
+               ENTRY_COUNT);
+    }
+
+    return 0;
+}
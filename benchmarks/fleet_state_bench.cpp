@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "equipment_tracker/fleet_state_table.h"
+
+using namespace equipment_tracker;
+
+// A reader process's view of the published fleet: lookups of single
+// machines and full-table scans, with and without a writer publishing
+// fixes at the same time.
+namespace
+{
+    constexpr size_t MACHINES = 4096;
+    constexpr size_t LOOKUPS = 2000000;
+    constexpr size_t SCANS = 2000;
+    const std::string BENCH_REGION = "/equipment_tracker_fleet_bench";
+
+    Equipment machine(size_t i, int step)
+    {
+        Equipment equipment("M-" + std::to_string(i), EquipmentType::Truck, "Truck");
+        equipment.setLastPosition(Position(37.0 + step * 1e-6, -122.0 + i * 1e-4, 0.0, 2.0));
+        return equipment;
+    }
+
+    void measure(const std::string &label, FleetStateReader &reader, const std::vector<std::string> &ids)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (size_t i = 0; i < LOOKUPS; ++i)
+        {
+            found += reader.find(ids[(i * 7919) % ids.size()]).has_value();
+        }
+        double lookup = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / LOOKUPS;
+
+        begin = std::chrono::steady_clock::now();
+        size_t records = 0;
+        for (size_t i = 0; i < SCANS; ++i)
+        {
+            records += reader.readAll().size();
+        }
+        double scan = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / SCANS;
+
+        std::cout << std::left << std::setw(18) << label << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(8) << lookup << " ns/find"
+                  << std::setw(10) << scan << " us/scan of " << records / SCANS << " machines"
+                  << (found == LOOKUPS ? "" : " (missed lookups)") << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    FleetStateTable table(BENCH_REGION, MACHINES);
+    if (!table.create())
+    {
+        return 1;
+    }
+
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < MACHINES; ++i)
+    {
+        table.publish(machine(i, 0));
+        ids.push_back("M-" + std::to_string(i));
+    }
+
+    FleetStateReader reader;
+    if (!reader.open(BENCH_REGION))
+    {
+        return 1;
+    }
+    measure("idle writer", reader, ids);
+
+    // One fix per machine per pass, as fast as the writer can go
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> published{0};
+    std::thread writer(
+        [&]
+        {
+            for (int step = 1; !stop; ++step)
+            {
+                for (size_t i = 0; i < MACHINES && !stop; ++i)
+                {
+                    table.publish(machine(i, step));
+                    ++published;
+                }
+            }
+        });
+    auto begin = std::chrono::steady_clock::now();
+    measure("busy writer", reader, ids);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    stop = true;
+    writer.join();
+
+    std::cout << "Writer published " << std::setprecision(0) << published / seconds << " fixes/s meanwhile"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/fleet_tiles.h"
+
+using namespace equipment_tracker;
+
+// Cost of keeping map tiles current as fixes arrive, and of serving a map
+// pan from the tile cache compared with tiles that must be rebuilt
+namespace
+{
+    constexpr int MACHINES = 10000;
+    constexpr int UPDATES = 500000;
+    constexpr int LOOKUPS = 200000;
+
+    double elapsedNs(std::chrono::steady_clock::time_point begin, int operations)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() /
+               operations;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(37.60, 37.90);
+    std::uniform_real_distribution<double> lon(-122.60, -122.20);
+    std::uniform_real_distribution<double> step(-0.0002, 0.0002);
+
+    std::vector<Equipment> fleet;
+    FleetTileIndex index;
+    for (int i = 0; i < MACHINES; ++i)
+    {
+        fleet.emplace_back("M-" + std::to_string(i), EquipmentType::Truck, "Truck");
+        fleet.back().setLastPosition(Position(lat(rng), lon(rng), 0.0, 2.0));
+        index.update(fleet.back());
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < UPDATES; ++i)
+    {
+        Equipment &equipment = fleet[i % MACHINES];
+        Position last = *equipment.getLastPosition();
+        equipment.setLastPosition(Position(last.getLatitude() + step(rng), last.getLongitude() + step(rng), 0.0, 2.0));
+        index.update(equipment);
+    }
+    double update_ns = elapsedNs(begin, UPDATES);
+
+    // A 4x4 viewport at zoom 12 and zoom 15 over the fleet
+    auto pan = [&](int zoom, bool move_between)
+    {
+        auto [x, y] = FleetTileIndex::tileFor(37.75, -122.40, zoom);
+        auto start = std::chrono::steady_clock::now();
+        size_t items = 0;
+        for (int i = 0; i < LOOKUPS; ++i)
+        {
+            if (move_between && i % 16 == 0)
+            {
+                Equipment &equipment = fleet[(i / 16) % MACHINES];
+                equipment.setLastPosition(*equipment.getLastPosition());
+                index.update(equipment);
+            }
+            auto tile = index.getTile(zoom, x + (i % 4), y + (i / 4) % 4);
+            items += tile->clusters.size() + tile->points.size();
+        }
+        return std::make_pair(elapsedNs(start, LOOKUPS), items / LOOKUPS);
+    };
+
+    std::cout << MACHINES << " machines" << std::endl;
+    std::cout << std::fixed << std::setprecision(0) << std::setw(28) << std::left << "update" << std::right
+              << std::setw(8) << update_ns << " ns/fix" << std::endl;
+    for (int zoom : {12, 15})
+    {
+        auto cached = pan(zoom, false);
+        auto live = pan(zoom, true);
+        std::cout << std::setw(28) << std::left << ("zoom " + std::to_string(zoom) + " tile, cached") << std::right
+                  << std::setw(8) << cached.first << " ns/tile" << std::setw(6) << cached.second << " items"
+                  << std::endl;
+        std::cout << std::setw(28) << std::left << ("zoom " + std::to_string(zoom) + " tile, fix every 16") << std::right
+                  << std::setw(8) << live.first << " ns/tile" << std::endl;
+    }
+    return 0;
+}
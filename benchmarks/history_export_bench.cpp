@@ -0,0 +1,63 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/history_export.h"
+
+using namespace equipment_tracker;
+
+// Export throughput for each format, writing a fleet's history to a file
+namespace
+{
+    constexpr int MACHINES = 20;
+    constexpr int FIXES_PER_MACHINE = 50000;
+    const std::string BENCH_PATH = "history_export_bench_db";
+
+    void measure(HistoryExporter &exporter, const std::vector<EquipmentId> &ids, HistoryExportFormat format,
+                 const std::string &label)
+    {
+        std::ofstream out(BENCH_PATH + "/export.out", std::ios::binary | std::ios::trunc);
+        auto begin = std::chrono::steady_clock::now();
+        exporter.exportHistory(ids, format, out);
+        out.flush();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        const auto &stats = exporter.getStats();
+        std::cout << std::left << std::setw(12) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << stats.bytes / 1e6 << " MB" << std::setw(9) << stats.bytes / 1e6 / seconds
+                  << " MB/s" << std::setw(9) << stats.fixes / 1e6 / seconds << " M fixes/s" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(BENCH_PATH);
+    {
+        DataStorage storage(BENCH_PATH);
+        storage.initialize();
+        std::vector<EquipmentId> ids;
+        for (int m = 0; m < MACHINES; ++m)
+        {
+            ids.push_back("BENCH-" + std::to_string(m));
+            storage.saveEquipment(Equipment(ids.back(), EquipmentType::Truck, "Truck"));
+            for (int i = 0; i < FIXES_PER_MACHINE; ++i)
+            {
+                storage.savePosition(ids.back(), Position(37.0 + i * 1e-6, -122.0 + m * 1e-3, 12.5, 2.0,
+                                                          Timestamp(std::chrono::seconds(1700000000 + i))));
+            }
+        }
+        storage.flush();
+
+        std::cout << MACHINES * FIXES_PER_MACHINE << " fixes" << std::endl;
+        HistoryExporter exporter(storage);
+        measure(exporter, ids, HistoryExportFormat::Csv, "csv");
+        measure(exporter, ids, HistoryExportFormat::Ndjson, "ndjson");
+        measure(exporter, ids, HistoryExportFormat::GeoJsonPoints, "points");
+        measure(exporter, ids, HistoryExportFormat::GeoJsonLineStrings, "linestrings");
+    }
+    std::filesystem::remove_all(BENCH_PATH);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/data_storage.h"
+
+using namespace equipment_tracker;
+
+// A week-long chart of hourly buckets, answered from the write-time rollups
+// and, for comparison, by reading every fix and bucketing them
+namespace
+{
+    constexpr int FIX_INTERVAL_SECONDS = 5;
+    constexpr int WEEK_SECONDS = 7 * 24 * 3600;
+    constexpr int QUERIES = 20;
+    const std::string BENCH_PATH = "history_rollup_bench_db";
+    const Timestamp WEEK_START = std::chrono::system_clock::from_time_t(1699833600);
+
+    double elapsedUs(std::chrono::steady_clock::time_point begin, int operations)
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() /
+               operations;
+    }
+
+    void report(const std::string &label, double value, const std::string &unit)
+    {
+        std::cout << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << value << " " << unit << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(BENCH_PATH);
+    {
+        DataStorage storage(BENCH_PATH);
+        storage.initialize();
+        storage.saveEquipment(Equipment("BENCH-1", EquipmentType::Truck, "Truck"));
+
+        constexpr int FIXES = WEEK_SECONDS / FIX_INTERVAL_SECONDS;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < FIXES; ++i)
+        {
+            storage.savePosition("BENCH-1", Position(37.0 + (i % 720) * 1e-5, -122.0, 12.5, 2.0,
+                                                     WEEK_START + std::chrono::seconds(i * FIX_INTERVAL_SECONDS)));
+        }
+        storage.flush();
+        double save_us = elapsedUs(begin, FIXES);
+
+        Timestamp week_end = WEEK_START + std::chrono::seconds(WEEK_SECONDS - 1);
+        size_t buckets = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q)
+        {
+            buckets = storage.getAggregatedHistory("BENCH-1", WEEK_START, week_end, std::chrono::hours(1)).size();
+        }
+        double rollup_us = elapsedUs(begin, QUERIES);
+
+        // The same chart from the raw fixes: samples and distance per hour
+        begin = std::chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q)
+        {
+            auto fixes = storage.getPositionHistory("BENCH-1", WEEK_START, week_end);
+            std::vector<double> distance(7 * 24, 0.0);
+            for (size_t i = 1; i < fixes.size(); ++i)
+            {
+                auto hour = std::chrono::duration_cast<std::chrono::hours>(fixes[i].getTimestamp() - WEEK_START);
+                distance[hour.count()] += fixes[i - 1].distanceTo(fixes[i]);
+            }
+        }
+        double raw_us = elapsedUs(begin, QUERIES);
+
+        std::cout << FIXES << " fixes, " << buckets << " hourly buckets" << std::endl;
+        report("savePosition", save_us, "us/fix");
+        report("week chart from rollups", rollup_us, "us");
+        report("week chart from fixes", raw_us, "us");
+    }
+    std::filesystem::remove_all(BENCH_PATH);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/data_storage.h"
+
+using namespace equipment_tracker;
+
+// Forty days of fixes every 15 s for a few machines, then one-hour history
+// queries against each tier: the last hour (RAM), ten days ago (mapped
+// segments) and five weeks ago (compressed archives).
+namespace
+{
+    constexpr int MACHINES = 4;
+    constexpr int DAYS = 40;
+    constexpr int INTERVAL_SECONDS = 15;
+    constexpr int QUERIES = 200;
+    const std::string BENCH_DB_PATH = "history_tiers_bench_db";
+
+    double queryMicros(DataStorage &storage, const Timestamp &start, const Timestamp &end, size_t &fixes)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            fixes = storage.getPositionHistory("M-" + std::to_string(i % MACHINES), start, end).size();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / QUERIES;
+    }
+
+    void report(const std::string &name, double micros, size_t fixes, uint64_t bytes)
+    {
+        std::cout << std::left << std::setw(22) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(1) << micros << " us/query"
+                  << std::setw(8) << fixes << " fixes"
+                  << std::setw(10) << std::setprecision(0) << bytes / 1024.0 << " KiB"
+                  << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(BENCH_DB_PATH);
+    {
+        DataStorage storage(BENCH_DB_PATH);
+        storage.initialize();
+
+        Timestamp now = getCurrentTimestamp();
+        Timestamp first = now - std::chrono::hours(24 * DAYS);
+        int steps = DAYS * 24 * 3600 / INTERVAL_SECONDS;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; ++step)
+        {
+            Timestamp time = first + std::chrono::seconds(step * INTERVAL_SECONDS);
+            for (int machine = 0; machine < MACHINES; ++machine)
+            {
+                storage.savePosition("M-" + std::to_string(machine),
+                                     Position(37.0 + step * 1e-6, -122.0 + machine * 0.01, 12.0, 2.5, time));
+            }
+        }
+        storage.flush();
+        storage.maintainHistoryTiers(now);
+        double load = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Loaded " << static_cast<uint64_t>(steps) * MACHINES << " fixes in "
+                  << std::setprecision(2) << std::fixed << load << " s" << std::endl;
+
+        size_t hot_fixes = 0;
+        size_t warm_fixes = 0;
+        size_t cold_fixes = 0;
+        Timestamp query_now = getCurrentTimestamp(); // Loading took a while
+        double hot = queryMicros(storage, query_now - std::chrono::minutes(59), query_now, hot_fixes);
+        double warm = queryMicros(storage, now - std::chrono::hours(24 * 10 + 1), now - std::chrono::hours(24 * 10),
+                                  warm_fixes);
+        double cold = queryMicros(storage, now - std::chrono::hours(24 * 35 + 1), now - std::chrono::hours(24 * 35),
+                                  cold_fixes);
+
+        HistoryTierStats stats = storage.getHistoryTierStats();
+        report("hot (last hour)", hot, hot_fixes, stats.hot_bytes);
+        report("warm (10 days ago)", warm, warm_fixes, stats.logs.warm_bytes);
+        report("cold (35 days ago)", cold, cold_fixes, stats.logs.cold_bytes);
+        std::cout << "Mapped " << std::setprecision(2) << stats.logs.mapped_bytes / (1024.0 * 1024.0)
+                  << " MiB; cold tier " << std::setprecision(1)
+                  << stats.logs.cold_bytes / static_cast<double>(stats.logs.cold_fixes) << " bytes/fix vs "
+                  << POSITION_RECORD_SIZE << " uncompressed" << std::endl;
+    }
+    std::filesystem::remove_all(BENCH_DB_PATH);
+    return 0;
+}
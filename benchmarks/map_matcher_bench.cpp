@@ -0,0 +1,142 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/map_matcher.h"
+
+using namespace equipment_tracker;
+
+// Per-fix cost of map matching a fleet on a site road grid, and how far the
+// matched road distance and the raw fix-to-fix distance are from the truth
+namespace
+{
+    constexpr int GRID = 60;            // GRID x GRID junctions, 100 m apart
+    constexpr float BLOCK_METERS = 100.0f;
+    constexpr int MACHINES = 2000;
+    constexpr int ROUNDS = 250;         // Fixes per machine, 1 s apart
+    constexpr float SPEED_MPS = 10.0f;
+    constexpr float NOISE_METERS = 5.0f;
+    const LocalProjection SITE(37.0, -122.0);
+    const Timestamp START = std::chrono::system_clock::from_time_t(1700000000);
+
+    uint32_t nodeAt(int column, int row)
+    {
+        return static_cast<uint32_t>(row * GRID + column);
+    }
+
+    // A truck driving the grid, turning at random at each junction
+    struct Truck
+    {
+        int column;
+        int row;
+        int step_column{1};
+        int step_row{0};
+        float progress{0.0f}; // Metres towards the next junction
+    };
+} // namespace
+
+int main()
+{
+    RoadGraph graph;
+    for (int row = 0; row < GRID; ++row)
+    {
+        for (int column = 0; column < GRID; ++column)
+        {
+            double latitude = 0.0;
+            double longitude = 0.0;
+            SITE.unproject(LocalPoint{column * BLOCK_METERS, row * BLOCK_METERS}, latitude, longitude);
+            graph.addNode(latitude, longitude);
+            if (column > 0)
+            {
+                graph.addEdge(nodeAt(column - 1, row), nodeAt(column, row));
+            }
+            if (row > 0)
+            {
+                graph.addEdge(nodeAt(column, row - 1), nodeAt(column, row));
+            }
+        }
+    }
+
+    auto build_begin = std::chrono::steady_clock::now();
+    MapMatcher matcher(graph);
+    double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_begin).count();
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> start(1, GRID - 2);
+    std::uniform_int_distribution<int> turn(0, 3);
+    std::normal_distribution<float> noise(0.0f, NOISE_METERS);
+    std::vector<Truck> trucks;
+    for (int m = 0; m < MACHINES; ++m)
+    {
+        trucks.push_back(Truck{start(rng), start(rng)});
+    }
+    std::vector<Position> fixes;
+    fixes.reserve(static_cast<size_t>(MACHINES) * ROUNDS);
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        for (auto &truck : trucks)
+        {
+            truck.progress += SPEED_MPS;
+            while (truck.progress >= BLOCK_METERS)
+            {
+                truck.progress -= BLOCK_METERS;
+                truck.column += truck.step_column;
+                truck.row += truck.step_row;
+                const int steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                do
+                {
+                    int choice = turn(rng);
+                    truck.step_column = steps[choice][0];
+                    truck.step_row = steps[choice][1];
+                } while (truck.column + truck.step_column < 0 || truck.column + truck.step_column >= GRID ||
+                         truck.row + truck.step_row < 0 || truck.row + truck.step_row >= GRID);
+            }
+            float east = truck.column * BLOCK_METERS + truck.step_column * truck.progress + noise(rng);
+            float north = truck.row * BLOCK_METERS + truck.step_row * truck.progress + noise(rng);
+            double latitude = 0.0;
+            double longitude = 0.0;
+            SITE.unproject(LocalPoint{east, north}, latitude, longitude);
+            fixes.emplace_back(latitude, longitude, 0.0, 2.0, START + std::chrono::seconds(round));
+        }
+    }
+    std::vector<std::string> ids;
+    for (int m = 0; m < MACHINES; ++m)
+    {
+        ids.push_back("T-" + std::to_string(m));
+    }
+
+    size_t matched = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < fixes.size(); ++i)
+    {
+        matched += matcher.match(ids[i % MACHINES], fixes[i]).has_value();
+    }
+    double per_fix_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() /
+                        static_cast<double>(fixes.size());
+
+    double raw_meters = 0.0;
+    double road_meters = 0.0;
+    for (size_t i = MACHINES; i < fixes.size(); ++i)
+    {
+        raw_meters += fixes[i - MACHINES].distanceTo(fixes[i]);
+    }
+    for (const auto &id : ids)
+    {
+        road_meters += matcher.getMatch(id)->total_route_meters;
+    }
+    double true_meters = static_cast<double>(MACHINES) * (ROUNDS - 1) * SPEED_MPS;
+
+    std::cout << graph.getEdges().size() << " road edges, " << MACHINES << " machines, " << fixes.size()
+              << " fixes, " << matched << " matched" << std::endl;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(28) << std::left << "build graph index" << std::right
+              << std::setw(10) << build_ms << " ms" << std::endl;
+    std::cout << std::setw(28) << std::left << "match" << std::right << std::setw(10) << per_fix_ns << " ns/fix"
+              << std::endl;
+    std::cout << std::setw(28) << std::left << "distance, raw fixes" << std::right << std::setw(10)
+              << 100.0 * raw_meters / true_meters << " % of true" << std::endl;
+    std::cout << std::setw(28) << std::left << "distance, matched" << std::right << std::setw(10)
+              << 100.0 * road_meters / true_meters << " % of true" << std::endl;
+    return 0;
+}
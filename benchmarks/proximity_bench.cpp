@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/proximity_engine.h"
+
+using namespace equipment_tracker;
+
+// Simulates a dense site: 50k machines random-walking inside a 4 km square,
+// each reporting once per tick (1 Hz), and reports the cost of one tick.
+int main()
+{
+    constexpr size_t ASSET_COUNT = 50000;
+    constexpr int TICKS = 10;
+    constexpr double SITE_METERS = 4000.0;
+    constexpr double METERS_PER_DEGREE = 111195.0;
+    constexpr double ORIGIN_LAT = 37.7749;
+    constexpr double ORIGIN_LON = -122.4194;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> place(0.0, SITE_METERS);
+    std::normal_distribution<double> step(0.0, 1.5);
+
+    std::vector<EquipmentId> ids;
+    std::vector<EquipmentType> types;
+    std::vector<double> north(ASSET_COUNT);
+    std::vector<double> east(ASSET_COUNT);
+    for (size_t i = 0; i < ASSET_COUNT; ++i)
+    {
+        ids.push_back("EQ-" + std::to_string(i));
+        types.push_back(static_cast<EquipmentType>(i % 6));
+        north[i] = place(rng);
+        east[i] = place(rng);
+    }
+
+    ProximityEngine engine(5.0);
+    engine.setThreshold(EquipmentType::Truck, 15.0);
+
+    double lon_scale = METERS_PER_DEGREE * std::cos(ORIGIN_LAT * 3.14159265358979323846 / 180.0);
+    size_t total_events = 0;
+
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        // Prepare fixes outside the timed region
+        std::vector<Position> fixes;
+        fixes.reserve(ASSET_COUNT);
+        for (size_t i = 0; i < ASSET_COUNT; ++i)
+        {
+            north[i] += step(rng);
+            east[i] += step(rng);
+            fixes.emplace_back(ORIGIN_LAT + north[i] / METERS_PER_DEGREE,
+                               ORIGIN_LON + east[i] / lon_scale);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t tick_events = 0;
+        for (size_t i = 0; i < ASSET_COUNT; ++i)
+        {
+            tick_events += engine.update(ids[i], types[i], fixes[i]).size();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total_events += tick_events;
+
+        double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+        std::cout << "tick " << tick << ": " << ms << " ms, "
+                  << (ms * 1e6 / ASSET_COUNT) << " ns/update, "
+                  << tick_events << " events, "
+                  << engine.getActivePairs().size() << " active pairs" << std::endl;
+    }
+
+    std::cout << "total events: " << total_events << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "equipment_tracker/replication.h"
+
+using namespace equipment_tracker;
+
+// Cost of replicating position writes to a standby on loopback: how long
+// the primary's writes take and when the standby has all of them, with
+// asynchronous and synchronous commit.
+namespace
+{
+    constexpr int FIXES = 5000;
+    const std::string BENCH_PATH = "replication_bench_db";
+
+    void measure(ReplicationCommitMode mode, const std::string &label)
+    {
+        std::filesystem::remove_all(BENCH_PATH);
+        ReplicationStandby standby(BENCH_PATH + "/standby");
+        if (!standby.start())
+        {
+            return;
+        }
+
+        DataStorage primary(BENCH_PATH + "/primary");
+        ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, standby.getPort(), mode);
+        replication.start();
+        Equipment equipment("BENCH-1", EquipmentType::Truck, "Truck");
+        primary.saveEquipment(equipment);
+        replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(5));
+        uint64_t batches_before = replication.getStatus().batches_shipped;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < FIXES; ++i)
+        {
+            primary.savePosition("BENCH-1", Position(37.0 + i * 1e-6, -122.0, 0.0, 2.0,
+                                                     Timestamp(std::chrono::seconds(1700000000 + i))));
+        }
+        auto written = std::chrono::steady_clock::now();
+        uint64_t max_lag = replication.getStatus().lag_records;
+        replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(60));
+        auto replicated = std::chrono::steady_clock::now();
+        auto status = replication.getStatus();
+
+        std::cout << std::left << std::setw(7) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << std::chrono::duration<double, std::micro>(written - begin).count() / FIXES
+                  << " us/write" << std::setw(9)
+                  << std::chrono::duration<double, std::milli>(replicated - begin).count()
+                  << " ms until replicated" << std::setw(7) << status.batches_shipped - batches_before
+                  << " batches, lag " << max_lag << " records after the last write" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::cout << FIXES << " position writes" << std::endl;
+    measure(ReplicationCommitMode::Async, "async");
+    measure(ReplicationCommitMode::Sync, "sync");
+    std::filesystem::remove_all(BENCH_PATH);
+    return 0;
+}
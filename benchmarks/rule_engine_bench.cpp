@@ -0,0 +1,153 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "equipment_tracker/rule_engine.h"
+
+using namespace equipment_tracker;
+
+// Per-fix cost of evaluating a few thousand zone, type and time-window rules
+// through the compiled plan, against checking every rule in turn
+namespace
+{
+    constexpr int GRID = 40; // GRID x GRID zones of about 1.5 km
+    constexpr int MACHINES = 5000;
+    constexpr int FIXES = 500000;
+    const Timestamp START = std::chrono::system_clock::from_time_t(1700006400 + 22 * 3600 - 90); // 21:58:30 UTC
+
+    RuleZone squareZone(const std::string &name, double latitude, double longitude, double half_size)
+    {
+        return RuleZone{name,
+                        {{latitude - half_size, longitude - half_size},
+                         {latitude - half_size, longitude + half_size},
+                         {latitude + half_size, longitude + half_size},
+                         {latitude + half_size, longitude - half_size}}};
+    }
+
+    bool inZone(const RuleZone &zone, double latitude, double longitude)
+    {
+        bool inside = false;
+        const auto &v = zone.vertices;
+        for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++)
+        {
+            if ((v[i].first > latitude) != (v[j].first > latitude) &&
+                longitude < (v[j].second - v[i].second) * (latitude - v[i].first) / (v[j].first - v[i].first) + v[i].second)
+            {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    // Every rule checked on every fix
+    size_t matchLinearly(const std::vector<RuleDefinition> &rules, const std::unordered_map<std::string, RuleZone> &zones,
+                         EquipmentType type, const Position &position, double speed_mps)
+    {
+        int minute = static_cast<int>(std::chrono::duration_cast<std::chrono::minutes>(
+                                          position.getTimestamp().time_since_epoch())
+                                          .count() %
+                                      1440);
+        size_t matched = 0;
+        for (const auto &rule : rules)
+        {
+            if ((rule.type && *rule.type != type) || !(speed_mps > rule.min_speed_mps))
+            {
+                continue;
+            }
+            if (rule.window)
+            {
+                int start = rule.window->start_minute;
+                int end = rule.window->end_minute;
+                if (start < end ? (minute < start || minute >= end) : (minute < start && minute >= end))
+                {
+                    continue;
+                }
+            }
+            if (rule.zone && !inZone(zones.at(*rule.zone), position.getLatitude(), position.getLongitude()))
+            {
+                continue;
+            }
+            ++matched;
+        }
+        return matched;
+    }
+} // namespace
+
+int main()
+{
+    std::vector<RuleZone> zones;
+    std::vector<RuleDefinition> rules;
+    std::unordered_map<std::string, RuleZone> zones_by_name;
+    for (int row = 0; row < GRID; ++row)
+    {
+        for (int column = 0; column < GRID; ++column)
+        {
+            std::string name = "Z" + std::to_string(row) + "-" + std::to_string(column);
+            zones.push_back(squareZone(name, 37.0 + row * 0.02, -122.0 + column * 0.02, 0.007));
+            zones_by_name.emplace(name, zones.back());
+            rules.push_back(*parseRule("truck-" + name + ": type is Truck and in zone " + name + " and speed > 15 km/h"));
+            rules.push_back(*parseRule("night-" + name + ": in zone " + name + " and moving and between 22:00 and 05:00"));
+        }
+    }
+    rules.push_back(*parseRule("after-hours: moving and between 22:00 and 05:00"));
+
+    auto compile_begin = std::chrono::steady_clock::now();
+    auto plan = RulePlan::compile(zones, rules);
+    double compile_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compile_begin).count();
+
+    // Machines wander across the zone grid at up to 25 km/h, one fix every
+    // 2 s, while the night rules switch on
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> lat(37.0, 37.0 + GRID * 0.02);
+    std::uniform_real_distribution<double> lon(-122.0, -122.0 + GRID * 0.02);
+    std::uniform_real_distribution<double> step(-0.0001, 0.0001);
+    std::vector<Position> fixes;
+    std::vector<Position> last(MACHINES);
+    for (int m = 0; m < MACHINES; ++m)
+    {
+        last[m] = Position(lat(rng), lon(rng), 0.0, 2.0, START);
+    }
+    for (int i = 0; i < FIXES; ++i)
+    {
+        Position &previous = last[i % MACHINES];
+        previous = Position(previous.getLatitude() + step(rng), previous.getLongitude() + step(rng), 0.0, 2.0,
+                            START + std::chrono::seconds(2 * (i / MACHINES + 1)));
+        fixes.push_back(previous);
+    }
+    auto typeOf = [](int i)
+    {
+        return static_cast<EquipmentType>(i % 6);
+    };
+
+    RuleEngine engine;
+    engine.setPlan(plan);
+    size_t alerts = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < FIXES; ++i)
+    {
+        alerts += engine.evaluate("M-" + std::to_string(i % MACHINES), typeOf(i % MACHINES), fixes[i]).size();
+    }
+    double engine_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / FIXES;
+
+    size_t matched = 0;
+    constexpr int LINEAR_FIXES = 2000;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < LINEAR_FIXES; ++i)
+    {
+        matched += matchLinearly(rules, zones_by_name, typeOf(i % MACHINES), fixes[i], 5.0);
+    }
+    double linear_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / LINEAR_FIXES;
+
+    std::cout << rules.size() << " rules over " << zones.size() << " zones, " << MACHINES << " machines, "
+              << alerts << " alerts" << std::endl;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(28) << std::left << "compile" << std::right
+              << std::setw(10) << compile_ms << " ms" << std::endl;
+    std::cout << std::setw(28) << std::left << "evaluate, compiled plan" << std::right << std::setw(10) << engine_ns
+              << " ns/fix" << std::endl;
+    std::cout << std::setw(28) << std::left << "evaluate, every rule" << std::right << std::setw(10) << linear_ns
+              << " ns/fix" << std::setw(8) << static_cast<double>(matched) / LINEAR_FIXES << " matches/fix" << std::endl;
+    return 0;
+}
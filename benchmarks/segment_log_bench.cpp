@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/data_storage.h"
+
+using namespace equipment_tracker;
+
+// Long-running ingest: 50 machines reporting once per second, replayed as
+// six "days" with a flush after every simulated minute. Prints throughput per
+// day so growth-related slowdowns show up, and how much of the written
+// history stays in the page cache afterwards (the change feed's buffered
+// writes are part of that figure in every run).
+namespace
+{
+    constexpr int EQUIPMENT_COUNT = 50;
+    constexpr int DAYS = 6;
+    constexpr int FIXES_PER_DAY = 2000; // Per machine; a compressed day
+    constexpr int FIXES_PER_FLUSH = 60;
+
+    Position fixAt(int i)
+    {
+        auto base = std::chrono::system_clock::from_time_t(1700000000);
+        return Position(37.7749 + i * 1e-6, -122.4194, 10.0, 2.5, base + std::chrono::seconds(i));
+    }
+
+    // Page cache size in KiB, or -1 where /proc/meminfo does not exist
+    long long cachedKiB()
+    {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        long long value;
+        std::string unit;
+        while (meminfo >> key >> value >> unit)
+        {
+            if (key == "Cached:")
+            {
+                return value;
+            }
+        }
+        return -1;
+    }
+
+    void run(const std::string &name, const std::string &root, const PositionLogOptions &options)
+    {
+        std::filesystem::remove_all(root);
+        DataStorage storage(root, IoBackendType::ThreadPool, options);
+        storage.initialize();
+
+        long long cached_before = cachedKiB();
+        std::cout << std::left << std::setw(18) << name;
+
+        int fix = 0;
+        for (int day = 0; day < DAYS; ++day)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < FIXES_PER_DAY; ++i, ++fix)
+            {
+                for (int e = 0; e < EQUIPMENT_COUNT; ++e)
+                {
+                    storage.savePosition("EQ-" + std::to_string(e), fixAt(fix));
+                }
+                if (i % FIXES_PER_FLUSH == FIXES_PER_FLUSH - 1)
+                {
+                    storage.flush();
+                }
+            }
+            storage.flush();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << std::right << std::setw(9) << std::fixed << std::setprecision(0)
+                      << FIXES_PER_DAY * EQUIPMENT_COUNT / seconds;
+        }
+
+        long long cached_after = cachedKiB();
+        if (cached_before >= 0)
+        {
+            std::cout << std::setw(10) << (cached_after - cached_before) / 1024 << " MiB";
+        }
+        std::cout << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::string root = "segment_log_bench_db";
+
+    std::cout << std::left << std::setw(18) << "fixes/s by day";
+    for (int day = 1; day <= DAYS; ++day)
+    {
+        std::cout << std::right << std::setw(9) << ("day " + std::to_string(day));
+    }
+    std::cout << std::setw(14) << "cache growth" << std::endl;
+
+    PositionLogOptions unsegmented;
+    unsegmented.segment_size = UINT64_MAX / 2;
+    unsegmented.preallocate = false;
+    run("single file", root, unsegmented);
+
+    PositionLogOptions segmented;
+    segmented.segment_size = 64 * 1024;
+    run("segments", root, segmented);
+
+    PositionLogOptions direct = segmented;
+    direct.direct_io = true;
+    run("segments+direct", root, direct);
+
+    std::filesystem::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/data_storage.h"
+#include "equipment_tracker/storage_io.h"
+
+using namespace equipment_tracker;
+
+// Write-heavy ingest: 200 machines each reporting 250 fixes. Compares the
+// old one-file-per-fix layout against the append log on each I/O backend.
+namespace
+{
+    constexpr int EQUIPMENT_COUNT = 200;
+    constexpr int FIXES_PER_EQUIPMENT = 250;
+    constexpr int TOTAL_FIXES = EQUIPMENT_COUNT * FIXES_PER_EQUIPMENT;
+
+    Position fixAt(int i)
+    {
+        auto base = std::chrono::system_clock::from_time_t(1700000000);
+        return Position(37.7749 + i * 1e-6, -122.4194, 10.0, 2.5, base + std::chrono::seconds(i));
+    }
+
+    void report(const std::string &name, double seconds, double syscalls_per_fix)
+    {
+        std::cout << std::left << std::setw(22) << name
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(0)
+                  << TOTAL_FIXES / seconds << " fixes/s"
+                  << std::setw(10) << std::setprecision(2) << syscalls_per_fix << " syscalls/fix"
+                  << std::endl;
+    }
+
+    // The previous savePosition(): stat, mkdir check, open, write, close per fix
+    void runLegacy(const std::string &root)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < FIXES_PER_EQUIPMENT; ++i)
+        {
+            for (int e = 0; e < EQUIPMENT_COUNT; ++e)
+            {
+                std::string positions_dir = root + "/positions";
+                if (!std::filesystem::exists(positions_dir))
+                {
+                    std::filesystem::create_directory(positions_dir);
+                }
+                std::string equipment_dir = positions_dir + "/EQ-" + std::to_string(e);
+                if (!std::filesystem::exists(equipment_dir))
+                {
+                    std::filesystem::create_directory(equipment_dir);
+                }
+
+                Position position = fixAt(i);
+                auto timestamp = std::chrono::system_clock::to_time_t(position.getTimestamp());
+                std::ofstream file(equipment_dir + "/" + std::to_string(timestamp) + ".txt");
+                file << std::fixed << std::setprecision(10);
+                file << "latitude=" << position.getLatitude() << std::endl;
+                file << "longitude=" << position.getLongitude() << std::endl;
+                file << "altitude=" << position.getAltitude() << std::endl;
+                file << "accuracy=" << position.getAccuracy() << std::endl;
+                file << "timestamp=" << timestamp << std::endl;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Two stats, open, one write per endl-flushed line (5), close
+        report("per-fix files", seconds, 9.0);
+    }
+
+    void runAppendLog(const std::string &root, IoBackendType type)
+    {
+        DataStorage storage(root, type);
+        storage.initialize();
+        IoStats before = storage.getIoStats();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < FIXES_PER_EQUIPMENT; ++i)
+        {
+            for (int e = 0; e < EQUIPMENT_COUNT; ++e)
+            {
+                storage.savePosition("EQ-" + std::to_string(e), fixAt(i));
+            }
+        }
+        storage.flush();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        IoStats after = storage.getIoStats();
+        // One change-feed append per fix plus the position I/O kernel entries
+        double syscalls = 1.0 + static_cast<double>(after.syscalls - before.syscalls) / TOTAL_FIXES;
+        report(std::string("append log/") + storage.getIoBackendName(), seconds, syscalls);
+    }
+} // namespace
+
+int main()
+{
+    std::string root = "storage_write_bench_db";
+
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    runLegacy(root);
+
+    for (IoBackendType type : {IoBackendType::ThreadPool, IoBackendType::IoUring})
+    {
+        if (type == IoBackendType::IoUring && !createStorageIoBackend(type))
+        {
+            std::cout << "io_uring unavailable on this kernel" << std::endl;
+            continue;
+        }
+        std::filesystem::remove_all(root);
+        runAppendLog(root, type);
+    }
+
+    std::filesystem::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/data_storage.h"
+
+using namespace equipment_tracker;
+
+// Fleet-wide utilization read from the maintained counters, against
+// recomputing the same counters from every machine's stored history
+namespace
+{
+    constexpr int MACHINES = 1000;
+    constexpr int FIXES_PER_MACHINE = 400;
+    const std::string BENCH_PATH = "utilization_bench_db";
+
+    double elapsedMs(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(BENCH_PATH);
+    {
+        DataStorage storage(BENCH_PATH);
+        storage.initialize();
+        std::vector<Equipment> fleet;
+        Timestamp start = getCurrentTimestamp() - std::chrono::hours(2);
+        for (int m = 0; m < MACHINES; ++m)
+        {
+            fleet.emplace_back("M-" + std::to_string(m), EquipmentType::Truck, "Truck");
+        }
+
+        // Ingest as the service does: counters advance with each saved fix
+        for (int i = 0; i < FIXES_PER_MACHINE; ++i)
+        {
+            for (int m = 0; m < MACHINES; ++m)
+            {
+                // Alternating stretches of driving and waiting
+                double latitude = 37.0 + m * 1e-3 + (i / 20 % 2 ? 0.0 : (i % 20) * 1e-4);
+                Position fix(latitude, -122.0, 0.0, 2.0, start + std::chrono::seconds(5 * i));
+                fleet[m].updateUtilization(fix);
+                fleet[m].setLastPosition(fix);
+                storage.savePosition(fleet[m].getId(), fix);
+            }
+        }
+        storage.flush();
+
+        auto begin = std::chrono::steady_clock::now();
+        double counted_hours = 0.0;
+        for (const auto &equipment : fleet)
+        {
+            counted_hours += equipment.getUtilization().operatingSeconds() / 3600.0;
+        }
+        double counters_ms = elapsedMs(begin);
+
+        begin = std::chrono::steady_clock::now();
+        double recomputed_hours = 0.0;
+        for (const auto &equipment : fleet)
+        {
+            UtilizationCounters counters;
+            auto history = storage.getPositionHistory(equipment.getId());
+            for (size_t i = 1; i < history.size(); ++i)
+            {
+                counters.add(history[i - 1], history[i]);
+            }
+            recomputed_hours += counters.operatingSeconds() / 3600.0;
+        }
+        double history_ms = elapsedMs(begin);
+
+        std::cout << MACHINES << " machines, " << MACHINES * FIXES_PER_MACHINE << " fixes" << std::endl;
+        std::cout << std::fixed << std::setprecision(3) << std::setw(26) << std::left << "from counters" << std::right
+                  << std::setw(10) << counters_ms << " ms" << std::setw(12) << counted_hours << " h" << std::endl;
+        std::cout << std::setw(26) << std::left << "recomputed from history" << std::right << std::setw(10)
+                  << history_ms << " ms" << std::setw(12) << recomputed_hours << " h" << std::endl;
+    }
+    std::filesystem::remove_all(BENCH_PATH);
+    return 0;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    enum class AnomalyType
+    {
+        Teleport,          // Jump no ground machine can make (GPS fault or tampering)
+        UnusualSpeed,      // Far above the machine's learned speed
+        OffHoursMovement,  // Moving in an hour of the week it is rarely moved
+        LeftOperatingArea  // Outside every area it is usually seen in
+    };
+
+    /**
+     * @brief Emitted when a fix departs from its machine's learned behaviour
+     */
+    struct AnomalyEvent
+    {
+        EquipmentId equipment_id;
+        AnomalyType type;
+        Position position;
+        double speed_mps;       // Implied speed since the previous fix
+        double distance_meters; // Distance from the previous fix
+    };
+
+    using AnomalyCallback = std::function<void(const AnomalyEvent &event)>;
+
+    /**
+     * @brief What the detector has learned about one machine
+     */
+    struct AnomalyBaseline
+    {
+        uint64_t samples{0};        // Fixes observed
+        uint64_t moving_samples{0}; // Intervals that counted as moving
+        double mean_speed_mps{0.0}; // Exponentially weighted, over moving intervals
+        double speed_deviation_mps{0.0};
+        size_t known_cells{0};      // Area cells visited often enough to count as operating area
+        Timestamp first_seen;
+    };
+
+    /**
+     * @brief Streaming per-machine anomaly detection over incoming fixes
+     *
+     * Each machine has a fixed-size baseline, learned from its own fixes:
+     * - the mean and deviation of its speed while moving, as exponentially
+     *   weighted moving averages;
+     * - how much of its moving time falls in each of the 168 hours of the
+     *   week;
+     * - its ANOMALY_AREA_CELLS most visited grid cells, kept with the
+     *   Space-Saving algorithm so a long-lived machine's table never grows.
+     *
+     * A fix is checked against the baseline before it is learned. Speed and
+     * area checks start after ANOMALY_WARMUP_SAMPLES fixes, the hour check
+     * once a full week has been seen. A machine is reported at most once per
+     * anomaly type every ANOMALY_REPEAT_SECONDS. Fixes older than the
+     * machine's latest are ignored.
+     *
+     * Thread-safe; the service feeds it from a queued event-bus subscriber
+     * so detection never holds up ingest.
+     */
+    class AnomalyDetector
+    {
+    public:
+        // Check a fix against its machine's baseline, then learn from it
+        std::vector<AnomalyEvent> observe(const EquipmentId &id, const Position &position);
+
+        // Forget a machine's baseline
+        void remove(const EquipmentId &id);
+
+        std::optional<AnomalyBaseline> getBaseline(const EquipmentId &id) const;
+        size_t size() const;
+
+        // Fixed size of one machine's baseline, excluding its map entry
+        static constexpr size_t baselineBytes() { return sizeof(Asset); }
+
+    private:
+        static constexpr size_t HOURS_PER_WEEK = 7 * 24;
+        static constexpr size_t ANOMALY_TYPES = static_cast<size_t>(AnomalyType::LeftOperatingArea) + 1;
+
+        struct AreaCell
+        {
+            uint64_t key;
+            uint32_t count;
+            uint32_t error; // Count inherited on replacement; count - error is guaranteed
+        };
+
+        struct Asset
+        {
+            Position last;
+            Timestamp first_seen;
+            uint64_t samples{0};
+            uint64_t moving_samples{0};
+            double mean_speed{0.0};
+            double speed_variance{0.0};
+            std::array<uint16_t, HOURS_PER_WEEK> hours{};
+            uint32_t hours_total{0};
+            std::array<AreaCell, ANOMALY_AREA_CELLS> cells{};
+            uint32_t cell_count{0};
+            std::array<Timestamp, ANOMALY_TYPES> last_reported{};
+        };
+
+        mutable std::mutex mutex_;
+        std::unordered_map<EquipmentId, Asset> assets_;
+
+        // Private methods
+        static uint64_t cellKey(int64_t row, int64_t column);
+        static bool knownArea(const Asset &asset, double latitude, double longitude);
+        static void learnArea(Asset &asset, uint64_t key);
+        static void learnHour(Asset &asset, size_t hour);
+        static void learnSpeed(Asset &asset, double speed_mps);
+    };
+
+} // namespace equipment_tracker
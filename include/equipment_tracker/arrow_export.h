@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "utils/time_utils.h"
+#include "data_storage.h"
+
+namespace equipment_tracker
+{
+
+    enum class ArrowIpcFormat
+    {
+        File,  // Random-access file (.arrow / Feather v2) with a footer
+        Stream // Streaming format, readable before the export finishes
+    };
+
+    /**
+     * @brief Totals of the last ArrowExporter::exportHistory() call
+     */
+    struct ArrowExportStats
+    {
+        uint64_t equipment{0}; // Machines with at least one exported fix
+        uint64_t rows{0};
+        uint64_t batches{0};
+        uint64_t bytes{0};
+    };
+
+    /**
+     * @brief Writes stored position history in the Arrow IPC format
+     *
+     * Every record batch holds fixes of a single machine in the columns
+     * equipment_id (utf8), timestamp_ns (timestamp[ns, UTC]) and latitude,
+     * longitude, altitude, accuracy (float64), so dataframe tools load the
+     * output without conversion and without losing sub-second precision.
+     *
+     * Worker threads each take the next machine, stream its history through
+     * DataStorage::scanPositionHistory() and encode batches of up to
+     * batch_rows rows. The calling thread writes them in the order of the
+     * requested IDs, so the output does not depend on the thread count.
+     * Encoded batches waiting for the writer are capped at
+     * ARROW_EXPORT_QUEUE_BYTES.
+     *
+     * The Flatbuffers metadata is built by hand; no Arrow library is needed.
+     * Buffers are written in host byte order, which must be little-endian.
+     */
+    class ArrowExporter
+    {
+    public:
+        // Constructor; threads = 0 uses one per hardware thread
+        explicit ArrowExporter(DataStorage &storage, size_t threads = 0, size_t batch_rows = ARROW_BATCH_ROWS);
+
+        // Export the fixes of each machine with start <= timestamp <= end;
+        // false when the output stream fails
+        bool exportHistory(const std::vector<EquipmentId> &ids, ArrowIpcFormat format, std::ostream &out,
+                           const Timestamp &start = Timestamp(), const Timestamp &end = getCurrentTimestamp());
+
+        const ArrowExportStats &getStats() const { return stats_; }
+
+    private:
+        DataStorage &storage_;
+        size_t threads_;
+        size_t batch_rows_;
+        ArrowExportStats stats_;
+    };
+
+} // namespace equipment_tracker
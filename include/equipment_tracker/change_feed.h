@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "equipment.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    enum class ChangeType
+    {
+        EquipmentSaved,   // Equipment record created or updated
+        EquipmentDeleted, // Equipment and its history removed
+        PositionSaved     // Fix appended to an equipment's history
+    };
+
+    /**
+     * @brief One committed mutation of the store
+     */
+    struct ChangeRecord
+    {
+        uint64_t lsn{0}; // Log sequence number, strictly increasing from 1
+        ChangeType type{ChangeType::EquipmentSaved};
+        EquipmentId equipment_id;
+        Timestamp committed_at;
+
+        // EquipmentSaved only
+        std::string name;
+        EquipmentType equipment_type{EquipmentType::Other};
+        EquipmentStatus status{EquipmentStatus::Unknown};
+        UtilizationCounters utilization;
+
+        // PositionSaved, or the last known position on EquipmentSaved
+        std::optional<Position> position;
+    };
+
+    /**
+     * @brief Ordered, durable change-data-capture log
+     *
+     * Each mutation is appended as one tab-separated line to changes.log and
+     * flushed immediately, so external consumers can follow the file with
+     * `tail -F`. In-process consumers read batches by LSN and record their
+     * progress as named offsets, persisted under offsets/ next to the log.
+     *
+     * Once changes.log passes the segment size it is sealed as
+     * changes-<first lsn>.log, with a sparse LSN index beside it in
+     * changes-<first lsn>.idx, and a new changes.log is started. At each
+     * rotation, sealed segments every named consumer has committed past are
+     * deleted (all but the newest when there are no consumers), so reads
+     * before the oldest retained record start from that record. open() loads
+     * the sealed indexes and scans only changes.log.
+     *
+     * Line format:
+     *   lsn  type  id  committed_ns  name  equipment_type  status
+     *   has_position  lat  lon  alt  accuracy  position_ns
+     *   moving_s  idle_s  distance_m
+     * where type is E (saved), D (deleted) or P (position). Lines written
+     * before the utilization fields were added decode with zero counters.
+     */
+    class ChangeFeed
+    {
+    public:
+        // Constructor
+        explicit ChangeFeed(std::string directory, uint64_t segment_bytes = CHANGE_SEGMENT_BYTES);
+
+        // Lifecycle; open() recovers the LSN sequence from an existing log
+        bool open();
+        void close();
+        bool isOpen() const;
+
+        // Producer side
+        uint64_t appendEquipmentSaved(const Equipment &equipment);
+        uint64_t appendEquipmentDeleted(const EquipmentId &id);
+        uint64_t appendPositionSaved(const EquipmentId &id, const Position &position);
+
+        // Batches get consecutive LSNs and reach the log in one write; returns
+        // the last LSN, or 0 when nothing was appended
+        uint64_t appendEquipmentSavedBatch(const std::vector<Equipment> &equipment);
+        uint64_t appendEquipmentDeletedBatch(const std::vector<EquipmentId> &ids);
+
+        // Consumer side: records with lsn > after_lsn, oldest first
+        std::vector<ChangeRecord> read(uint64_t after_lsn,
+                                       size_t max_records = DEFAULT_CHANGE_BATCH_SIZE) const;
+
+        // Named consumer offsets (the last LSN the consumer has processed)
+        bool commitOffset(const std::string &consumer, uint64_t lsn);
+        uint64_t getOffset(const std::string &consumer) const;
+        std::vector<ChangeRecord> readNext(const std::string &consumer,
+                                           size_t max_records = DEFAULT_CHANGE_BATCH_SIZE) const;
+
+        // Block until a record past after_lsn exists; false on timeout
+        bool waitForChanges(uint64_t after_lsn, std::chrono::milliseconds timeout) const;
+
+        // Called with the last LSN after every append, on the appending
+        // thread and outside the feed's lock. Replication uses it to hold
+        // writers until the standby has the change (synchronous commit)
+        void setCommitHook(std::function<void(uint64_t)> hook);
+
+        // Getters
+        uint64_t getLatestLsn() const;
+        uint64_t getOldestLsn() const;
+        size_t getSegmentCount() const;
+        std::string getLogPath() const { return directory_ + "/changes.log"; }
+        const std::string &getDirectory() const { return directory_; }
+
+        // Line codec (exposed for tools tailing the file)
+        static std::string encode(const ChangeRecord &record);
+        static std::optional<ChangeRecord> decode(const std::string &line);
+
+    private:
+        struct Segment
+        {
+            uint64_t first_lsn{1};
+            uint64_t last_lsn{0}; // first_lsn - 1 while empty
+            uint64_t size{0};     // Bytes of complete records
+            std::vector<std::pair<uint64_t, uint64_t>> index; // (lsn, byte offset) every CHANGE_INDEX_INTERVAL records
+        };
+
+        std::string directory_;
+        uint64_t segment_bytes_;
+        mutable std::mutex mutex_;
+        mutable std::condition_variable appended_;
+        std::function<void(uint64_t)> commit_hook_;
+        std::ofstream log_;
+        bool is_open_{false};
+
+        // Retained segments, oldest first; the last one is changes.log
+        std::vector<Segment> segments_;
+
+        // Private methods
+        uint64_t append(ChangeRecord record);
+        uint64_t appendAll(std::vector<ChangeRecord> records);
+        std::string offsetPath(const std::string &consumer) const;
+        std::string segmentPath(uint64_t first_lsn, const char *extension) const;
+        std::string pathOf(const Segment &segment) const;
+        static void scanSegment(const std::string &path, uint64_t first_lsn, Segment &segment);
+        bool loadSegmentIndex(Segment &segment) const;
+        bool writeSegmentIndex(const Segment &segment) const;
+        bool rotate();
+        void dropConsumedSegments();
+        uint64_t minimumConsumerOffset() const;
+    };
+
+} // namespace equipment_tracker
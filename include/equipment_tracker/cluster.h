@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "equipment.h"
+#include "position.h"
+#include "hash_ring.h"
+
+namespace equipment_tracker
+{
+
+    class EquipmentTrackerService;
+
+    /**
+     * Cluster wire protocol. Every message is framed as its length in
+     * decimal, a newline and the body. A request body is a command line
+     * ("PING", "ADD", "REMOVE <id>", "POSITION <id>", "GET <id>",
+     * "STATUS <n>", "AREA <lat1> <lon1> <lat2> <lon2>", "ALL", "IDS",
+     * "EXPORT <id>", "IMPORT", "APPEND <id>", "HANDOFF <id> <address> <port>"),
+     * optionally followed by one record per line. A response starts with
+     * "OK", "NONE" or "ERR <reason>", followed by records the same way.
+     *
+     * Equipment records are tab-separated: id, type, status, name, either
+     * "-" or the last position, and the utilization counters ("moving-s
+     * idle-s distance-m"; absent in records from older nodes). Positions are
+     * "lat lon alt accuracy timestamp-ns" with doubles printed round-trip
+     * exact. IDs and names are percent-escaped.
+     *
+     * HANDOFF makes the receiving node copy a machine to the node at the
+     * given address: IMPORT of its record, then its whole stored history as
+     * APPEND frames of up to CLUSTER_HANDOFF_CHUNK_FIXES fixes.
+     */
+    std::string encodeClusterEquipment(const Equipment &equipment);
+    std::optional<Equipment> decodeClusterEquipment(const std::string &line);
+    std::string encodeClusterPosition(const Position &position);
+    std::optional<Position> decodeClusterPosition(const std::string &line);
+
+    /**
+     * @brief Serves one EquipmentTrackerService to cluster routers over TCP
+     *
+     * Each connection gets its own thread and is answered in request order.
+     * The node owns no routing state: it serves whatever equipment its
+     * service holds, and routers decide what that is.
+     */
+    class ClusterNode
+    {
+    public:
+        // Constructor; port 0 picks a free port (see getPort())
+        ClusterNode(EquipmentTrackerService &service,
+                    std::string address = CLUSTER_DEFAULT_ADDRESS, uint16_t port = 0);
+
+        // Destructor stops serving
+        ~ClusterNode();
+
+        ClusterNode(const ClusterNode &) = delete;
+        ClusterNode &operator=(const ClusterNode &) = delete;
+
+        // Listen and serve in the background
+        bool start();
+        void stop();
+        bool isRunning() const { return listen_fd_ >= 0; }
+
+        // Getters
+        uint16_t getPort() const { return port_; }
+        const std::string &getAddress() const { return address_; }
+
+        // Answer one request body (exposed for tests)
+        std::string handleRequest(const std::string &request);
+
+    private:
+        EquipmentTrackerService &service_;
+        std::string address_;
+        uint16_t port_;
+        int listen_fd_{-1};
+        std::atomic<bool> stopping_{false};
+        std::thread accept_thread_;
+
+        std::mutex connections_mutex_;
+        std::set<int> connections_;
+        std::vector<std::thread> connection_threads_;
+
+        // Private methods
+        void acceptLoop();
+        void serveConnection(int fd);
+        std::string handOff(const EquipmentId &id, const std::string &address, uint16_t port);
+    };
+
+    /**
+     * @brief Routes ingest and queries to the cluster node owning each machine
+     *
+     * Equipment is partitioned across nodes with a ConsistentHashRing.
+     * Single-machine calls go to the owner; fleet-wide queries are sent to
+     * every node in parallel and merged. When a node joins or leaves, only
+     * the machines whose owner changes are moved: the old node copies each
+     * one, with its counters and whole stored history, straight to the new
+     * owner, and only then is it removed from the old node. Routed calls wait
+     * while a move is under way.
+     *
+     * Thread-safe. All routers of a cluster must be given the same
+     * membership to agree on ownership.
+     */
+    class ClusterRouter
+    {
+    public:
+        // Constructor
+        explicit ClusterRouter(size_t virtual_nodes = CLUSTER_VIRTUAL_NODES);
+
+        // Destructor closes the node connections
+        ~ClusterRouter();
+
+        ClusterRouter(const ClusterRouter &) = delete;
+        ClusterRouter &operator=(const ClusterRouter &) = delete;
+
+        // Membership. Both rebalance before returning and report the
+        // machines moved, or std::nullopt when the change was refused (node
+        // unreachable, duplicate/unknown name, last node). A machine that
+        // fails to move is reported on std::cerr and left where it was
+        std::optional<size_t> addNode(const std::string &node, const std::string &address, uint16_t port);
+        std::optional<size_t> removeNode(const std::string &node);
+        std::vector<std::string> getNodes() const;
+        std::optional<std::string> ownerOf(const EquipmentId &id) const;
+
+        // Routed to the owning node
+        bool addEquipment(const Equipment &equipment);
+        bool removeEquipment(const EquipmentId &id);
+        bool updateEquipmentPosition(const EquipmentId &id, const Position &position);
+        std::optional<Equipment> getEquipment(const EquipmentId &id) const;
+
+        // Scatter-gather across all nodes; ordered by ID
+        std::vector<Equipment> getAllEquipment() const;
+        std::vector<Equipment> findEquipmentByStatus(EquipmentStatus status) const;
+        std::vector<Equipment> findEquipmentInArea(double lat1, double lon1,
+                                                   double lat2, double lon2) const;
+
+    private:
+        // One persistent connection per node; requests on it are serialized
+        struct Peer
+        {
+            std::string address;
+            uint16_t port{0};
+            int fd{-1};
+            std::string buffer; // Bytes received past the last response
+            std::mutex mutex;
+        };
+
+        mutable std::shared_mutex mutex_; // Shared for routed calls, exclusive for membership
+        ConsistentHashRing ring_;
+        std::map<std::string, std::shared_ptr<Peer>> peers_;
+
+        // Private methods
+        static std::optional<std::string> call(Peer &peer, const std::string &request);
+        std::shared_ptr<Peer> ownerPeer(const EquipmentId &id) const;
+        std::vector<Equipment> gather(const std::string &request) const;
+        bool moveEquipment(const EquipmentId &id, Peer &from, Peer &to);
+        std::optional<std::vector<EquipmentId>> listIds(Peer &peer);
+    };
+
+} // namespace equipment_tracker
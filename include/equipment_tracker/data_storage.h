@@ -4,30 +4,106 @@
 #include <vector>
 #include <optional>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <filesystem>
+#include <functional>
+#include <ctime>
 #include "utils/types.h"
 #include "utils/constants.h"
 #include "equipment.h"
 #include "position.h"
+#include "change_feed.h"
+#include "storage_io.h"
+#include "position_log.h"
+#include "history_rollup.h"
 
 namespace equipment_tracker {
 
+/**
+ * @brief Footprint of DataStorage's position history by tier
+ */
+struct HistoryTierStats {
+    size_t hot_equipment{0};     // Equipment with recent fixes held in memory
+    uint64_t hot_fixes{0};
+    uint64_t hot_bytes{0};
+    PositionLogTiers logs;       // Warm and cold tiers, summed over open logs
+};
+
 /**
  * @brief Manages persistent storage of equipment and position data
+ *
+ * Fixes are appended to a per-equipment segmented binary log through an
+ * asynchronous I/O backend (io_uring where available), so savePosition() only
+ * queues the write. Reads wait for queued writes first; flush() also makes
+ * them durable and releases sealed segments from the page cache.
+ *
+ * Deletion is logical: deleteEquipment() moves the record and its history
+ * under a tombstone directory in constant time and a background thread
+ * reclaims the files. The ID can be reused at once.
+ *
+ * Position history is tiered. The last HOT_HISTORY_WINDOW_SECONDS of fixes
+ * of recently queried equipment are held in memory; older fixes are read
+ * from memory-mapped log segments, and segments older than
+ * WARM_HISTORY_WINDOW_SECONDS are compressed into archives. Fixes move
+ * between tiers as they age, and getPositionHistory() answers from
+ * whichever tiers the range touches.
+ *
+ * Every saved fix also updates per-machine rollups at several bucket widths
+ * (see HistoryRollup), so getAggregatedHistory() summarizes long ranges
+ * without reading the fixes.
+ *
+ * Batch saves write every record into one checksummed pack file under
+ * equipment/packs instead of one file per machine; an <id>.txt written by a
+ * later single save takes precedence over the packed record. Packs are
+ * never rewritten in place: once superseded records and deletion markers
+ * pass PACK_COMPACTION_MIN_BYTES and PACK_COMPACTION_RATIO of all pack
+ * bytes, the live records are copied into one new pack and the older packs
+ * are removed.
  */
 class DataStorage {
 public:
     // Constructor
-    explicit DataStorage(const std::string& db_path = DEFAULT_DB_PATH);
+    explicit DataStorage(const std::string& db_path = DEFAULT_DB_PATH,
+                         IoBackendType io_backend = IoBackendType::Auto,
+                         const PositionLogOptions& log_options = PositionLogOptions());
+    
+    // Destructor stops reclamation, flushes queued writes and closes the
+    // position logs. Unreclaimed tombstones are picked up by the next initialize()
+    ~DataStorage();
     
     // Database initialization
     bool initialize();
     
+    // Write pending equipment updates, then wait for queued position writes
+    // and sync them to disk
+    bool flush();
+    
     // Equipment CRUD operations
     bool saveEquipment(const Equipment& equipment);
     std::optional<Equipment> loadEquipment(const EquipmentId& id);
+    
+    // The stored record alone (status, last position, utilization), without
+    // reading the position history; for callers that keep history elsewhere
+    std::optional<Equipment> loadEquipmentRecord(const EquipmentId& id);
+    
+    // For the per-fix refresh of a stored record: the record is held in memory
+    // (and served by loads) and written with other pending updates as one pack
+    // once EQUIPMENT_UPDATE_BATCH_SIZE are pending, the oldest is
+    // EQUIPMENT_UPDATE_MAX_DELAY_MS old, or on flush()
     bool updateEquipment(const Equipment& equipment);
     bool deleteEquipment(const EquipmentId& id);
     
+    // Batch forms: one lock acquisition, one synced pack-file write through
+    // the I/O backend and one change-feed write for the whole batch
+    bool saveEquipmentBatch(const std::vector<Equipment>& equipment);
+    bool deleteEquipmentBatch(const std::vector<EquipmentId>& ids);
+    
     // Position history operations
     bool savePosition(const EquipmentId& id, const Position& position);
     std::vector<Position> getPositionHistory(
@@ -36,8 +112,55 @@ public:
         const Timestamp& end = getCurrentTimestamp()
     );
     
+    // The most recent stored fixes (at most count), oldest first; reads only
+    // the newest log segments
+    std::vector<Position> getRecentPositions(const EquipmentId& id, size_t count);
+    
+    // Stream the stored fixes with start <= timestamp <= end to visit in
+    // chunks of at most one log segment, in log order (time order when fixes
+    // arrive in order). The lock is held only while a chunk is read, and the
+    // chunk vector is reused, so memory stays constant however long the
+    // history. visit returns false to stop. False when there is no history
+    bool scanPositionHistory(
+        const EquipmentId& id,
+        const Timestamp& start,
+        const Timestamp& end,
+        const std::function<bool(const std::vector<Position>&)>& visit
+    );
+    
+    // Per-bucket summaries (first, last, min, max and average position,
+    // distance travelled, sample count) of the buckets of bucket_width that
+    // overlap [start, end] and hold fixes, oldest first. Buckets are aligned
+    // to multiples of their width since the epoch and returned whole. The
+    // width must be a whole number of minutes; coarser widths read fewer rollup
+    // records, so the cost follows the number of buckets, not of fixes
+    std::vector<PositionAggregate> getAggregatedHistory(
+        const EquipmentId& id,
+        const Timestamp& start,
+        const Timestamp& end,
+        std::chrono::seconds bucket_width
+    );
+    
+    // Trim the in-memory tier and archive segments that aged out of the warm
+    // window, for every equipment; returns the number of segments archived.
+    // Rotating logs are also archived by a background worker, so this is only
+    // needed for idle equipment. Compression runs without holding the lock
+    size_t maintainHistoryTiers(const Timestamp& now = getCurrentTimestamp());
+    
+    // Block until the background worker has archived every rotated log
+    void waitForArchiving();
+    HistoryTierStats getHistoryTierStats() const;
+    
+    // Returns the stored fixes bracketing the instant: one fix on an exact
+    // match, otherwise the nearest fix before and/or after it (oldest first)
+    std::vector<Position> getBracketingPositions(
+        const EquipmentId& id,
+        const Timestamp& at
+    );
+    
     // Query operations
     std::vector<Equipment> getAllEquipment();
+    std::vector<Equipment> getAllEquipmentRecords(); // Records only, as loadEquipmentRecord()
     std::vector<Equipment> findEquipmentByStatus(EquipmentStatus status);
     std::vector<Equipment> findEquipmentByType(EquipmentType type);
     std::vector<Equipment> findEquipmentInArea(
@@ -45,10 +168,70 @@ public:
         double lat2, double lon2
     );
     
+    // Tombstones still waiting for their files to be deleted
+    size_t getPendingReclamationCount() const;
+    
+    // Block until every scheduled tombstone has been reclaimed
+    void waitForReclamation();
+    
+    // Change-data-capture: every committed mutation, in order. The feed is
+    // opened by initialize() and lives in <db_path>/cdc/changes.log
+    ChangeFeed& getChangeFeed() { return change_feed_; }
+    
+    // I/O diagnostics
+    const char* getIoBackendName() const { return io_->name(); }
+    IoStats getIoStats() const { return io_->getStats(); }
+    
 private:
     std::string db_path_;
     mutable std::mutex mutex_;
     bool is_initialized_{false};
+    ChangeFeed change_feed_;
+    std::unique_ptr<StorageIoBackend> io_;
+    
+    PositionLogOptions log_options_;
+    std::unordered_map<EquipmentId, std::unique_ptr<PositionLog>> position_logs_;
+    
+    // Hot tier: every logged fix at or after covered_from, in time order
+    struct HotHistory {
+        std::deque<Position> fixes;
+        Timestamp covered_from;
+    };
+    std::unordered_map<EquipmentId, HotHistory> hot_history_;
+    
+    // Rollups of each machine written to since startup, open buckets included
+    std::unordered_map<EquipmentId, std::unique_ptr<HistoryRollup>> rollups_;
+    
+    // Background reclamation of tombstoned equipment
+    std::thread reclaim_thread_;
+    mutable std::mutex reclaim_mutex_;
+    std::condition_variable reclaim_condition_;
+    std::deque<std::filesystem::path> reclaim_queue_;
+    bool reclaim_busy_{false};
+    std::atomic<bool> reclaim_stop_{false};
+    uint64_t tombstone_sequence_{0};
+    
+    // Background archiving of aged segments, queued by savePosition() on rotation
+    std::thread archive_thread_;
+    std::mutex archive_mutex_;
+    std::condition_variable archive_condition_;
+    std::deque<std::pair<EquipmentId, Timestamp>> archive_queue_;
+    bool archive_busy_{false};
+    std::atomic<bool> archive_stop_{false};
+    
+    // Where each batch-saved record lives; built from the packs by initialize()
+    struct PackedRecord {
+        uint64_t pack;
+        uint64_t offset;
+        size_t length;
+    };
+    std::unordered_map<EquipmentId, PackedRecord> packed_equipment_;
+    uint64_t next_pack_{1};
+    uint64_t pack_bytes_{0}; // Size of every pack file, superseded entries included
+    
+    // Records changed by updateEquipment() and not yet written
+    std::unordered_map<EquipmentId, Equipment> pending_updates_;
+    std::chrono::steady_clock::time_point oldest_pending_update_;
     
     // Private helper methods
     void initDatabase();
@@ -56,12 +239,40 @@ private:
     bool initializeInternal(); // Internal initialization without mutex lock
     
     // Internal method that doesn't acquire mutex (for use when mutex is already locked)
-    std::optional<Equipment> loadEquipmentInternal(const EquipmentId& id);
+    std::optional<Equipment> loadEquipmentInternal(const EquipmentId& id, bool with_history);
+    std::vector<Equipment> getAllEquipmentInternal(bool with_history);
     std::vector<Position> getPositionHistoryInternal(
         const EquipmentId& id, 
         const Timestamp& start = Timestamp(),
         const Timestamp& end = getCurrentTimestamp()
     );
+    std::optional<Position> readPositionFile(
+        const std::filesystem::path& path,
+        time_t timestamp
+    );
+    PositionLog* openPositionLog(const EquipmentId& id, bool create);
+    void closePositionLog(const EquipmentId& id);
+    HistoryRollup* openRollup(const EquipmentId& id, bool create);
+    std::vector<Position> readBracketingWindow(const EquipmentId& id, const Timestamp& at);
+    HotHistory* primeHotHistory(const EquipmentId& id, const Timestamp& now);
+    void trimHotHistory(HotHistory& hot, const Timestamp& cutoff);
+    std::vector<std::filesystem::path> listLegacyPositionFiles(const EquipmentId& id);
+    std::filesystem::path newTombstonePath(const std::string& name);
+    void moveToTombstone(const EquipmentId& id, const std::filesystem::path& destination);
+    void loadEquipmentPacks();
+    uint64_t writeEquipmentPack(const std::string& content);
+    bool saveEquipmentBatchInternal(const std::vector<Equipment>& equipment);
+    bool writePendingUpdates();
+    std::filesystem::path packPath(uint64_t pack) const;
+    bool readPackedRecord(const PackedRecord& record, std::string& content);
+    bool removePackedRecords(const std::vector<EquipmentId>& ids);
+    void maybeCompactEquipmentPacks();
+    bool compactEquipmentPacks();
+    void scheduleReclamation(const std::filesystem::path& tombstone);
+    void reclaimLoop();
+    size_t archiveHistory(const EquipmentId& id, const Timestamp& cutoff);
+    void scheduleArchiving(const EquipmentId& id, const Timestamp& cutoff);
+    void archiveLoop();
     
     // SQL statement preparation
     void prepareStatements();
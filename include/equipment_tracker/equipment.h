@@ -10,6 +10,28 @@
 namespace equipment_tracker
 {
 
+    /**
+     * @brief Cumulative operating counters of one machine
+     *
+     * Each interval between consecutive fixes counts as moving when its
+     * average speed exceeds MOVEMENT_SPEED_THRESHOLD and as idle otherwise.
+     * Distance accrues only while moving, so GPS jitter at rest does not add
+     * up. Intervals longer than UTILIZATION_MAX_GAP_SECONDS (the machine was
+     * off or out of coverage) and out-of-order fixes are not counted.
+     */
+    struct UtilizationCounters
+    {
+        double moving_seconds{0.0};
+        double idle_seconds{0.0};
+        double distance_meters{0.0};
+
+        // Engine hours: time reported while powered, moving or not
+        double operatingSeconds() const { return moving_seconds + idle_seconds; }
+
+        // Fold in the interval between two consecutive fixes
+        void add(const Position &from, const Position &to);
+    };
+
     /**
      * @brief Represents a piece of heavy equipment with tracking capabilities
      */
@@ -31,6 +53,7 @@ namespace equipment_tracker
         EquipmentType getType() const { return type_; }
         const std::string &getName() const { return name_; }
         EquipmentStatus getStatus() const { return status_; }
+        UtilizationCounters getUtilization() const;
 
         // Thread-safe position access
         std::optional<Position> getLastPosition() const;
@@ -39,10 +62,16 @@ namespace equipment_tracker
         void setStatus(EquipmentStatus status);
         void setName(const std::string &name);
         void setLastPosition(const Position &position);
+        void setUtilization(const UtilizationCounters &utilization);
+
+        // Fold the interval since the newest fix seen into the utilization
+        // counters; older fixes are ignored
+        void updateUtilization(const Position &position);
 
         // Position history management
         void recordPosition(const Position &position);
         std::vector<Position> getPositionHistory() const;
+        void setPositionHistory(std::vector<Position> history); // Oldest first; keeps the newest entries
         void clearPositionHistory();
 
         // Utility methods
@@ -55,6 +84,8 @@ namespace equipment_tracker
         std::string name_;
         EquipmentStatus status_;
         std::optional<Position> last_position_;
+        UtilizationCounters utilization_;
+        std::optional<Position> newest_fix_; // Start of the next utilization interval; the last position when unset
         std::vector<Position> position_history_;
         size_t max_history_size_{DEFAULT_MAX_HISTORY_SIZE};
         mutable std::mutex mutex_; // For thread safety
@@ -7,10 +7,22 @@
 #include <optional>
 #include <vector>
 #include "utils/types.h"
+#include "utils/flat_hash_map.h"
 #include "equipment.h"
 #include "gps_tracker.h"
 #include "data_storage.h"
 #include "network_manager.h"
+#include "position_interpolation.h"
+#include "proximity_engine.h"
+#include "local_projection.h"
+#include "fleet_snapshot.h"
+#include "position_events.h"
+#include "history_cache.h"
+#include "fleet_state_table.h"
+#include "fleet_tiles.h"
+#include "rule_engine.h"
+#include "anomaly_detector.h"
+#include "map_matcher.h"
 
 namespace equipment_tracker {
 
@@ -19,8 +31,8 @@ namespace equipment_tracker {
  */
 class EquipmentTrackerService {
 public:
-    // Constructor
-    EquipmentTrackerService();
+    // Constructor; db_path selects the storage directory
+    explicit EquipmentTrackerService(const std::string& db_path = DEFAULT_DB_PATH);
     
     // Destructor
     ~EquipmentTrackerService();
@@ -36,6 +48,88 @@ public:
     std::optional<Equipment> getEquipment(const EquipmentId& id) const;
     std::vector<Equipment> getAllEquipment() const;
     
+    /**
+     * @brief Bulk equipment management for onboarding and fleet edits
+     *
+     * A batch is validated item by item under one lock acquisition, persisted
+     * with one batched storage write and only then applied in memory and
+     * published as one fleet snapshot; a failed write applies nothing, so the
+     * batch can simply be retried. Adds reject empty, existing and repeated IDs;
+     * updates apply name and status to existing equipment and reject type
+     * changes; removes reject unknown IDs.
+     *
+     * @return One flag per item, in request order; false when the item was
+     *         rejected or the batch could not be persisted
+     */
+    std::vector<bool> addEquipmentBatch(const std::vector<Equipment>& equipment);
+    std::vector<bool> updateEquipmentBatch(const std::vector<Equipment>& equipment);
+    std::vector<bool> removeEquipmentBatch(const std::vector<EquipmentId>& ids);
+    
+    /**
+     * @brief Current immutable view of the fleet
+     *
+     * Never blocks on ingest; the returned snapshot stays valid and unchanged
+     * for as long as the caller holds it. The read APIs above and below find
+     * their records in the snapshot as well. Position history is the
+     * exception; see getPositionHistory().
+     */
+    std::shared_ptr<const FleetSnapshot> getFleetSnapshot() const;
+    
+    /**
+     * @brief Recent position history under a fleet-wide memory budget
+     *
+     * Fleet records do not carry history. Recent fixes live in a CLOCK-evicted
+     * HistoryCache instead; cold machines are evicted once the budget is
+     * exceeded and their history is refetched from storage on the next read.
+     * getEquipment(), getPositionHistory() and getPositionsAt() read through
+     * the cache, while the fleet-wide queries return records without history.
+     *
+     * A cache hit does not block ingest. A miss refetches through
+     * DataStorage::getRecentPositions(), which takes the storage mutex that
+     * every accepted fix also takes to save it. The read can therefore wait
+     * behind ingest, and ingest behind the read, for as long as the refetch
+     * takes. Size the budget so the working set stays resident and misses
+     * stay rare (see getHistoryCacheStats()).
+     */
+    std::vector<Position> getPositionHistory(const EquipmentId& id) const;
+    void setHistoryMemoryBudget(size_t bytes);
+    HistoryCacheStats getHistoryCacheStats() const;
+    
+    /**
+     * @brief Publish the latest fleet state to shared memory
+     *
+     * Creates a FleetStateTable under the given POSIX shared-memory name and
+     * keeps it current on every add, update, removal and accepted fix, so
+     * co-located processes can read each machine's latest fix through a
+     * FleetStateReader without calling into the service.
+     */
+    bool startFleetStatePublishing(const std::string& name = DEFAULT_FLEET_STATE_NAME,
+                                   size_t capacity = DEFAULT_FLEET_STATE_CAPACITY);
+    void stopFleetStatePublishing();
+    
+    /**
+     * @brief Map tile of the latest fleet positions
+     *
+     * Web Mercator XYZ addressing. Low zooms return clustered counts and
+     * high zooms individual machines (see FleetTileIndex). Tiles are kept
+     * current as fixes arrive, and an unchanged tile is answered from a
+     * cache without blocking ingest.
+     *
+     * @return nullptr for a zoom or coordinates outside the tile grid
+     */
+    std::shared_ptr<const FleetTile> getFleetTile(int zoom, uint32_t x, uint32_t y) const;
+    
+    /**
+     * @brief Cumulative moving time, idle time and distance per machine
+     *
+     * The counters advance on every accepted fix (see UtilizationCounters)
+     * and are saved with the equipment record, so they survive restarts and
+     * are read from the fleet snapshot in constant time per machine, without
+     * touching position history.
+     */
+    std::optional<UtilizationCounters> getUtilization(const EquipmentId& id) const;
+    std::vector<std::pair<EquipmentId, UtilizationCounters>> getFleetUtilization() const;
+    
     // Equipment queries
     std::vector<Equipment> findEquipmentByStatus(EquipmentStatus status) const;
     std::vector<Equipment> findActiveEquipment() const;
@@ -44,22 +138,121 @@ public:
         double lat2, double lon2
     ) const;
     
+    // Position ingestion: records the fix, persists it and runs safety checks
+    bool updateEquipmentPosition(const EquipmentId& id, const Position& position);
+    
+    // Append stored fixes to a known machine's history without treating them
+    // as live fixes (used when a machine moves between cluster nodes); the
+    // cached history is refetched from storage on the next read
+    bool importPositionHistory(const EquipmentId& id, const std::vector<Position>& positions);
+    
+    // Historical queries
+    /**
+     * @brief Estimate where each piece of equipment was at the given instant
+     *
+     * Uses the in-memory history when it covers the instant and otherwise the
+     * bracketing fixes from storage. Work is split across threads by equipment.
+     *
+     * @return One entry per requested ID, in request order; std::nullopt when
+     *         the equipment is unknown or has no fixes around the instant
+     */
+    std::vector<std::optional<Position>> getPositionsAt(
+        const std::vector<EquipmentId>& ids,
+        const Timestamp& at,
+        InterpolationMethod method = InterpolationMethod::GreatCircle) const;
+    
     // Advanced features 
     bool setGeofence(const EquipmentId& id, 
                     double lat1, double lon1, 
                     double lat2, double lon2);
     
+    // Site-local geometry: fixes are projected once at ingest
+    uint32_t addSite(const std::string& name, double latitude, double longitude,
+                     double radius_meters = DEFAULT_SITE_RADIUS_METERS);
+    std::optional<LocalFix> getLocalPosition(const EquipmentId& id) const;
+    
+    // Proximity alerts between equipment
+    void registerProximityCallback(ProximityCallback callback);
+    bool setProximityThreshold(EquipmentType type, double meters);
+    std::vector<std::pair<EquipmentId, EquipmentId>> getProximityPairs() const;
+    
+    /**
+     * @brief Declarative alert rules evaluated on every accepted fix
+     *
+     * The rules are compiled into a RulePlan before the service lock is
+     * taken, so replacing thousands of rules does not stall ingest. Alerts
+     * are edge-triggered (see RuleEngine) and delivered to the rule callback
+     * without the service lock held.
+     *
+     * @return false, keeping the current rules, when the rules do not compile
+     */
+    bool setRules(const std::vector<RuleZone>& zones,
+                  const std::vector<RuleDefinition>& rules,
+                  std::chrono::minutes utc_offset = std::chrono::minutes(0));
+    void registerRuleCallback(RuleAlertCallback callback);
+    std::vector<std::pair<EquipmentId, std::string>> getActiveRuleAlerts() const;
+    
+    /**
+     * @brief Theft and anomaly detection on accepted fixes
+     *
+     * Every accepted fix is checked against its machine's learned speed,
+     * hours and operating area (see AnomalyDetector). Detection runs on its
+     * own event-bus worker, so it never holds up ingest, and anomalies are
+     * delivered to the callback from that worker.
+     */
+    void registerAnomalyCallback(AnomalyCallback callback);
+    std::optional<AnomalyBaseline> getAnomalyBaseline(const EquipmentId& id) const;
+    
+    /**
+     * @brief Snap accepted fixes onto a site road graph
+     *
+     * The matcher is built before the service lock is taken and replaces any
+     * previous graph, restarting every machine's track. Matching runs on its
+     * own event-bus worker (see MapMatcher), so the latest match trails
+     * ingest slightly.
+     *
+     * @return false, keeping the current graph, when the graph has no edges
+     */
+    bool setRoadGraph(const RoadGraph& graph);
+    std::optional<MatchedPosition> getMatchedPosition(const EquipmentId& id) const;
+    
     // Component access (for advanced usage)
     GPSTracker& getGPSTracker() { return *gps_tracker_; }
     DataStorage& getDataStorage() { return *data_storage_; }
     NetworkManager& getNetworkManager() { return *network_manager_; }
     
+    // Accepted fixes fan out here; subscribe analytics, uplinks, etc. with
+    // DeliveryMode::Queued so they never hold up ingest.
+    //
+    // The built-in "uplink" subscriber forwards fixes to the NetworkManager
+    // and is delivery-at-most-once: it queues up to
+    // UPLINK_EVENT_QUEUE_CAPACITY fixes, then drops the oldest (counted in
+    // its SubscriberStats::dropped); fixes still queued when the service is
+    // destroyed, or offered while the server cannot be reached, are lost.
+    // Fixes are always in storage first, so a server that sees gaps can
+    // backfill them from the position history
+    PositionEventBus& getPositionEventBus() { return position_bus_; }
+    
 private:
     std::unique_ptr<GPSTracker> gps_tracker_;
     std::unique_ptr<DataStorage> data_storage_;
     std::unique_ptr<NetworkManager> network_manager_;
+    AnomalyDetector anomaly_detector_;       // Fed by a position_bus_ subscriber; locks itself
+    AnomalyCallback anomaly_callback_;
+    std::shared_ptr<MapMatcher> map_matcher_; // Swapped under mutex_, fed by a position_bus_ subscriber
+    PositionEventBus position_bus_;  // Declared after its subscribers' targets so it stops first
+    SiteProjectionRegistry site_projections_;
+    std::unique_ptr<ProximityEngine> proximity_engine_; // Shares site_projections_
+    std::unordered_map<EquipmentId, LocalFix> local_positions_;
+    ProximityCallback proximity_callback_;
+    RuleEngine rule_engine_;
+    RuleAlertCallback rule_callback_;
     
-    std::unordered_map<EquipmentId, Equipment> equipment_map_;
+    FlatHashMap<Equipment> equipment_map_;  // Writer-side state, guarded by mutex_
+    FleetSnapshotPublisher fleet_;          // Reader-side state, published on every change
+    mutable HistoryCache history_cache_;    // Recent fixes, refetched from data_storage_ after eviction
+    std::unique_ptr<FleetStateTable> fleet_state_; // Shared-memory copy for local readers, when published
+    FleetTileIndex fleet_tiles_;            // Map tiles, updated with every change; locks itself
     bool is_running_{false};
     mutable std::mutex mutex_;
     
@@ -68,6 +261,9 @@ private:
     void handlePositionUpdate(double latitude, double longitude, 
                             double altitude, Timestamp timestamp);
     void handleRemoteCommand(const std::string& command);
+    void dispatchProximityEvents(const std::vector<ProximityEvent>& events);
+    void dispatchRuleAlerts(const std::vector<RuleAlert>& alerts);
+    void cacheHistory(const Equipment& equipment);
     std::optional<EquipmentId> determineEquipmentId();
 };
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "utils/types.h"
+#include "utils/persistent_hash_map.h"
+#include "equipment.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Immutable, versioned view of the whole fleet
+     *
+     * A snapshot never changes once published. Writers derive the next version
+     * with withEquipment()/withoutEquipment(), which share every untouched
+     * record and trie node with the previous version, so a single-asset change
+     * costs O(log n) rather than a copy of the fleet.
+     */
+    class FleetSnapshot
+    {
+    public:
+        FleetSnapshot() = default;
+
+        // Getters
+        uint64_t getVersion() const { return version_; }
+        size_t size() const { return equipment_.size(); }
+        bool empty() const { return equipment_.empty(); }
+
+        // Lookup; returns nullptr when the equipment is not in this version
+        std::shared_ptr<const Equipment> find(std::string_view id) const;
+
+        // Visit every piece of equipment; fn(const Equipment&)
+        template <typename Fn>
+        void forEach(Fn &&fn) const
+        {
+            equipment_.forEach([&fn](const EquipmentId &, const std::shared_ptr<const Equipment> &equipment)
+                               { fn(*equipment); });
+        }
+
+        // Derive the next version
+        std::shared_ptr<const FleetSnapshot> withEquipment(const Equipment &equipment) const;
+        std::shared_ptr<const FleetSnapshot> withoutEquipment(const EquipmentId &id) const;
+
+        // Derive the next version from many changes at once (one version bump)
+        std::shared_ptr<const FleetSnapshot> withChanges(const std::vector<Equipment> &upserts,
+                                                         const std::vector<EquipmentId> &removals) const;
+
+    private:
+        PersistentHashMap<std::shared_ptr<const Equipment>> equipment_;
+        uint64_t version_{0};
+    };
+
+    /**
+     * @brief Publication point for fleet snapshots (read-copy-update)
+     *
+     * Readers take the current snapshot with a single atomic load and keep it
+     * for as long as they need; they never wait for writers. Writers are
+     * expected to be serialized externally and publish each new version with
+     * an atomic store. A retired version is reclaimed once the last reader
+     * holding it lets go, which plays the role of the grace period.
+     */
+    class FleetSnapshotPublisher
+    {
+    public:
+        // Constructor
+        FleetSnapshotPublisher();
+
+        // Reader side
+        std::shared_ptr<const FleetSnapshot> acquire() const;
+        uint64_t getVersion() const { return version_.load(std::memory_order_acquire); }
+
+        // Writer side
+        void publish(std::shared_ptr<const FleetSnapshot> snapshot);
+
+    private:
+        std::shared_ptr<const FleetSnapshot> current_;
+        std::atomic<uint64_t> version_{0};
+    };
+
+} // namespace equipment_tracker
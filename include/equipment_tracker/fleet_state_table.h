@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "equipment.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * Shared-memory layout, version FLEET_STATE_LAYOUT_VERSION:
+     *
+     *   header    64 bytes: magic "ETFLEET\0", layout version, header size,
+     *             slot size, capacity, slots in use, change generation
+     *   slots     capacity x 128 bytes: a 32-bit sequence number, then one
+     *             FleetStateRecord
+     *
+     * All fields are native-endian; readers and the writer share a machine.
+     * Any change to the layout bumps the version, and readers refuse a
+     * region whose version, header size or slot size they do not know.
+     */
+    constexpr uint32_t FLEET_STATE_LAYOUT_VERSION = 1;
+
+    /**
+     * @brief Latest state of one machine as stored in a table slot
+     *
+     * Plain data so readers can copy it out of the mapping in one go.
+     */
+    struct FleetStateRecord
+    {
+        char id[FLEET_STATE_ID_SIZE]; // NUL-terminated
+        uint8_t type;                 // EquipmentType
+        uint8_t status;               // EquipmentStatus
+        uint8_t has_position;
+        uint8_t reserved[5];
+        double latitude;
+        double longitude;
+        double altitude;
+        double accuracy;
+        int64_t timestamp_ns; // Since the Unix epoch
+        uint64_t updates;     // Times this slot was written for this equipment
+
+        std::optional<Position> getPosition() const;
+    };
+
+    /**
+     * @brief Writer side: publishes the fleet's latest state to shared memory
+     *
+     * Each slot is guarded by a sequence lock. The writer makes the sequence
+     * odd, copies the record and makes it even again; a reader copies the
+     * record between two reads of an equal, even sequence, and retries
+     * otherwise. Readers never block the writer and never write to the
+     * region, so any number of processes can map it read-only.
+     *
+     * A machine keeps its slot until it is removed; freed slots are reused.
+     * The region is unlinked when the table is destroyed; readers that still
+     * map it keep their view.
+     *
+     * Thread-safe. POSIX only: create() fails on Windows.
+     */
+    class FleetStateTable
+    {
+    public:
+        // Constructor; name is a POSIX shared-memory name such as "/fleet"
+        explicit FleetStateTable(std::string name, size_t capacity = DEFAULT_FLEET_STATE_CAPACITY);
+
+        // Destructor unmaps and unlinks the region
+        ~FleetStateTable();
+
+        FleetStateTable(const FleetStateTable &) = delete;
+        FleetStateTable &operator=(const FleetStateTable &) = delete;
+
+        // Create (or replace) the region; all slots start free
+        bool create();
+
+        // Publish the equipment's identity, status and last position. Fails
+        // when the table is full or the ID does not fit a slot
+        bool publish(const Equipment &equipment);
+
+        // Free the equipment's slot
+        bool remove(const EquipmentId &id);
+
+        // Free every slot
+        void clear();
+
+        // Getters
+        const std::string &getName() const { return name_; }
+        size_t getCapacity() const { return capacity_; }
+        size_t size() const;
+
+    private:
+        std::string name_;
+        size_t capacity_;
+        size_t region_size_{0};
+        char *region_{nullptr};
+
+        mutable std::mutex mutex_;
+        std::unordered_map<EquipmentId, uint32_t> slots_; // Writer-side index
+        std::vector<uint32_t> free_slots_;
+
+        // Private methods
+        void writeSlot(uint32_t slot, const FleetStateRecord *record);
+    };
+
+    /**
+     * @brief Reader side: a read-only mapping of a FleetStateTable
+     *
+     * Lookups by ID go through a private index of slot positions, checked
+     * against the slot's ID on every read and rebuilt when stale, so a hit
+     * costs one hash lookup and one seqlocked copy of the slot.
+     *
+     * Not thread-safe; use one reader per thread.
+     */
+    class FleetStateReader
+    {
+    public:
+        FleetStateReader() = default;
+        ~FleetStateReader();
+
+        FleetStateReader(const FleetStateReader &) = delete;
+        FleetStateReader &operator=(const FleetStateReader &) = delete;
+
+        // Map the named region; fails on a missing region or unknown layout
+        bool open(const std::string &name);
+        void close();
+        bool isOpen() const { return region_ != nullptr; }
+
+        // Bumped by every change to any slot
+        uint64_t getGeneration() const;
+
+        // Latest state of one machine
+        std::optional<FleetStateRecord> find(const EquipmentId &id) const;
+
+        // Copy one slot; false when the slot is free
+        bool readSlot(size_t slot, FleetStateRecord &record) const;
+
+        // Every occupied slot
+        std::vector<FleetStateRecord> readAll() const;
+
+        // Slots that have ever been used; slots past this are all free
+        size_t getSlotCount() const;
+
+    private:
+        const char *region_{nullptr};
+        size_t region_size_{0};
+        size_t capacity_{0};
+        mutable std::unordered_map<EquipmentId, size_t> index_;
+        mutable uint64_t indexed_generation_{0};
+
+        // Private methods
+        void rebuildIndex() const;
+    };
+
+} // namespace equipment_tracker
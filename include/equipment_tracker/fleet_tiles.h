@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "equipment.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Machines aggregated into one cell of a cluster tile
+     */
+    struct TileCluster
+    {
+        double latitude;  // Centroid of the members
+        double longitude;
+        uint32_t count;
+    };
+
+    /**
+     * @brief One machine on a point tile
+     */
+    struct TilePoint
+    {
+        EquipmentId id;
+        EquipmentType type;
+        EquipmentStatus status;
+        double latitude;
+        double longitude;
+    };
+
+    /**
+     * @brief Contents of one Web Mercator (XYZ / slippy map) tile
+     *
+     * Below FLEET_TILE_POINT_ZOOM a tile is split into a grid of
+     * 2^FLEET_TILE_CLUSTER_BITS cells per side and lists one cluster per
+     * occupied cell. From FLEET_TILE_POINT_ZOOM on it lists every machine.
+     */
+    struct FleetTile
+    {
+        int zoom{0};
+        uint32_t x{0};
+        uint32_t y{0};
+        uint32_t count{0}; // Machines on the tile
+        std::vector<TileCluster> clusters;
+        std::vector<TilePoint> points;
+    };
+
+    /**
+     * @brief Level-of-detail summaries of the latest fleet positions
+     *
+     * Every zoom level up to the cluster cells below FLEET_TILE_POINT_ZOOM
+     * keeps a count and coordinate sums per occupied tile, and machines are
+     * bucketed by their tile at FLEET_TILE_POINT_ZOOM. A fix adjusts one
+     * entry per zoom level, so the cost of ingest does not depend on the
+     * fleet size.
+     *
+     * Built tiles are cached together with the version of the entry they
+     * were built from; getTile() returns the cached tile while the version
+     * still matches and rebuilds it otherwise.
+     *
+     * Thread-safe.
+     */
+    class FleetTileIndex
+    {
+    public:
+        // Track a machine's latest fix, type and status; machines without a
+        // position are removed
+        void update(const Equipment &equipment);
+        void remove(const EquipmentId &id);
+        void clear();
+
+        // nullptr for coordinates outside the tile grid or zoom above
+        // FLEET_TILE_MAX_ZOOM; empty tiles have no clusters or points
+        std::shared_ptr<const FleetTile> getTile(int zoom, uint32_t x, uint32_t y) const;
+
+        size_t size() const;
+
+        // Tile containing a coordinate; latitude is clamped to the Mercator limit
+        static std::pair<uint32_t, uint32_t> tileFor(double latitude, double longitude, int zoom);
+
+    private:
+        struct Cell
+        {
+            uint32_t count{0};
+            double latitude_sum{0.0};
+            double longitude_sum{0.0};
+            uint64_t version{0};
+        };
+
+        struct Bucket
+        {
+            std::unordered_map<EquipmentId, TilePoint> points;
+            uint64_t version{0};
+        };
+
+        struct CachedTile
+        {
+            uint64_t version;
+            std::shared_ptr<const FleetTile> tile;
+        };
+
+        mutable std::mutex mutex_;
+        std::unordered_map<EquipmentId, TilePoint> machines_;
+        std::unordered_map<uint64_t, Cell> cells_;     // Keyed by tileKey(), zooms 0 to FLEET_TILE_CELL_ZOOM
+        std::unordered_map<uint64_t, Bucket> buckets_; // Keyed by tileKey() at FLEET_TILE_POINT_ZOOM
+        mutable std::unordered_map<uint64_t, CachedTile> cache_;
+        uint64_t next_version_{0};
+
+        // Private methods
+        static uint64_t tileKey(int zoom, uint32_t x, uint32_t y);
+        void add(const TilePoint &point);
+        void subtract(const TilePoint &point);
+        std::shared_ptr<const FleetTile> buildClusterTile(int zoom, uint32_t x, uint32_t y, uint32_t count) const;
+        std::shared_ptr<const FleetTile> buildPointTile(int zoom, uint32_t x, uint32_t y, const Bucket &bucket) const;
+    };
+
+} // namespace equipment_tracker
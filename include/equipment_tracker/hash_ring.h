@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "utils/constants.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Consistent-hash ring assigning keys (equipment IDs) to nodes
+     *
+     * Each node is placed on a 64-bit ring at virtual_nodes pseudo-random
+     * points; a key belongs to the node owning the first point at or after
+     * the key's hash. Adding a node takes over only the arcs in front of its
+     * points and removing one hands only its own arcs to their successors,
+     * so about 1/N of the keys move on a membership change.
+     *
+     * Hashes are stable across processes and builds, so every router agrees
+     * on ownership. Not thread-safe.
+     */
+    class ConsistentHashRing
+    {
+    public:
+        // Constructor
+        explicit ConsistentHashRing(size_t virtual_nodes = CLUSTER_VIRTUAL_NODES);
+
+        // Membership; false when the node is already present / absent
+        bool addNode(const std::string &node);
+        bool removeNode(const std::string &node);
+        bool hasNode(const std::string &node) const { return nodes_.count(node) != 0; }
+
+        // Owning node of a key; std::nullopt on an empty ring
+        std::optional<std::string> ownerOf(std::string_view key) const;
+
+        // Getters
+        std::vector<std::string> getNodes() const { return {nodes_.begin(), nodes_.end()}; }
+        size_t size() const { return nodes_.size(); }
+        bool empty() const { return nodes_.empty(); }
+
+        // The ring's hash function (FNV-1a with a 64-bit finalizer)
+        static uint64_t hash(std::string_view key);
+
+    private:
+        size_t virtual_nodes_;
+        std::vector<std::pair<uint64_t, std::string>> points_; // Sorted by position
+        std::set<std::string> nodes_;
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Hit/miss and residency counters of a HistoryCache
+     */
+    struct HistoryCacheStats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};    // Each miss is one refetch through the loader
+        uint64_t evictions{0};
+        size_t resident_entries{0};
+        size_t resident_bytes{0};
+        size_t budget_bytes{0};
+    };
+
+    /**
+     * @brief Recent position history of the fleet under a global memory budget
+     *
+     * Holds up to max_positions recent fixes per equipment. When the resident
+     * total exceeds the budget, cold equipment is evicted with the CLOCK
+     * algorithm: the hand sweeps the entries, clearing the reference bit of
+     * those read or written since its last pass and evicting the first one it
+     * finds unreferenced. A read of evicted history refetches it through the
+     * loader (normally DataStorage), so eviction is invisible to callers.
+     *
+     * Fixes recorded for non-resident equipment are not kept; the loader is
+     * expected to return them from storage on the next read.
+     *
+     * Thread-safe. The loader runs without the cache lock held.
+     */
+    class HistoryCache
+    {
+    public:
+        // Returns up to max_positions most recent fixes, oldest first
+        using Loader = std::function<std::vector<Position>(const EquipmentId &id, size_t max_positions)>;
+
+        // Constructor
+        HistoryCache(Loader loader,
+                     size_t budget_bytes = DEFAULT_HISTORY_MEMORY_BUDGET,
+                     size_t max_positions = DEFAULT_MAX_HISTORY_SIZE);
+
+        // Recent history, oldest first; refetched when not resident
+        std::vector<Position> get(const EquipmentId &id);
+
+        // Append a fix to resident history
+        void record(const EquipmentId &id, const Position &position);
+
+        // Make the given history resident, replacing what was cached. It is
+        // lost on eviction unless the fixes are also in storage
+        void put(const EquipmentId &id, std::vector<Position> history);
+
+        // Drop the equipment's history (e.g. when it is removed)
+        void erase(const EquipmentId &id);
+
+        // Change the budget; evicts at once when shrinking
+        void setBudget(size_t budget_bytes);
+
+        // Metrics
+        HistoryCacheStats getStats() const;
+        bool isResident(const EquipmentId &id) const;
+
+    private:
+        struct Entry
+        {
+            EquipmentId id;
+            std::vector<Position> history;
+            size_t bytes{0};
+            bool referenced{false};
+            bool occupied{false};
+        };
+
+        Loader loader_;
+        size_t max_positions_;
+
+        mutable std::mutex mutex_;
+        size_t budget_bytes_;
+        std::vector<Entry> entries_; // CLOCK ring; free slots are reused
+        std::vector<size_t> free_entries_;
+        std::unordered_map<EquipmentId, size_t> index_;
+        size_t hand_{0};
+        size_t resident_bytes_{0};
+        uint64_t hits_{0};
+        uint64_t misses_{0};
+        uint64_t evictions_{0};
+
+        // Refetches in flight, with the fixes recorded meanwhile
+        struct Refetch
+        {
+            std::vector<Position> recorded;
+            bool cancelled{false}; // Erased while loading; the result is not cached
+        };
+        std::unordered_map<EquipmentId, Refetch> loading_;
+
+        // Private methods
+        void insert(const EquipmentId &id, std::vector<Position> history);
+        void account(Entry &entry);
+        void release(size_t slot);
+        void evict();
+    };
+
+} // namespace equipment_tracker
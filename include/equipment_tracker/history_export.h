@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "utils/time_utils.h"
+#include "data_storage.h"
+
+namespace equipment_tracker
+{
+
+    enum class HistoryExportFormat
+    {
+        Csv,               // Header row, then one row per fix
+        Ndjson,            // One JSON object per fix and line
+        GeoJsonPoints,     // FeatureCollection with one Point feature per fix
+        GeoJsonLineStrings // FeatureCollection with one LineString feature per equipment
+    };
+
+    /**
+     * @brief Output buffer with allocation-free number formatting
+     *
+     * Text collects in a fixed buffer that reaches the stream in one write
+     * whenever it fills. Doubles are printed with std::to_chars in their
+     * shortest round-trip form and integers without locale handling.
+     */
+    class BufferedSink
+    {
+    public:
+        // Constructor
+        explicit BufferedSink(std::ostream &out, size_t capacity = EXPORT_BUFFER_SIZE);
+
+        // Destructor flushes
+        ~BufferedSink();
+
+        BufferedSink(const BufferedSink &) = delete;
+        BufferedSink &operator=(const BufferedSink &) = delete;
+
+        void append(std::string_view text);
+        void append(char c);
+        void appendInteger(int64_t value);
+        void appendDouble(double value); // Non-finite values are written as null
+        void appendJsonString(std::string_view text);
+
+        // Write the buffer out; false once the stream has failed
+        bool flush();
+        bool good() const { return out_.good(); }
+
+        // Bytes appended so far, flushed or not
+        uint64_t getBytesWritten() const { return bytes_flushed_ + used_; }
+
+    private:
+        std::ostream &out_;
+        std::vector<char> buffer_;
+        size_t used_{0};
+        uint64_t bytes_flushed_{0};
+
+        // Private methods
+        char *reserve(size_t bytes);
+    };
+
+    /**
+     * @brief Totals of the last HistoryExporter::exportHistory() call
+     */
+    struct HistoryExportStats
+    {
+        uint64_t equipment{0}; // Machines with at least one exported fix
+        uint64_t fixes{0};
+        uint64_t bytes{0};
+    };
+
+    /**
+     * @brief Streams stored position history as CSV, NDJSON or GeoJSON
+     *
+     * History is pulled from DataStorage::scanPositionHistory() one log
+     * segment at a time and formatted straight into a BufferedSink, so an
+     * export uses the same memory for a day of history as for a year.
+     * Timestamps are nanoseconds since the Unix epoch. GeoJSON coordinates are
+     * [longitude, latitude, altitude]; a machine with a single fix in range
+     * becomes a Point feature in the LineString format.
+     */
+    class HistoryExporter
+    {
+    public:
+        // Constructor
+        explicit HistoryExporter(DataStorage &storage);
+
+        // Export the fixes of each machine with start <= timestamp <= end;
+        // false when the output stream fails
+        bool exportHistory(const std::vector<EquipmentId> &ids, HistoryExportFormat format, std::ostream &out,
+                           const Timestamp &start = Timestamp(), const Timestamp &end = getCurrentTimestamp());
+
+        const HistoryExportStats &getStats() const { return stats_; }
+
+    private:
+        DataStorage &storage_;
+        HistoryExportStats stats_;
+    };
+
+} // namespace equipment_tracker
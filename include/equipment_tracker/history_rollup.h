@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Summary of the fixes in one time bucket
+     */
+    struct PositionAggregate
+    {
+        Timestamp bucket_start;
+        Timestamp bucket_end; // Exclusive
+        uint64_t samples{0};
+        Position first; // Earliest and latest fix in the bucket
+        Position last;
+        double min_latitude{0.0};
+        double max_latitude{0.0};
+        double min_longitude{0.0};
+        double max_longitude{0.0};
+        double min_altitude{0.0};
+        double max_altitude{0.0};
+        double avg_latitude{0.0};
+        double avg_longitude{0.0};
+        double avg_altitude{0.0};
+        double distance_meters{0.0}; // Legs between consecutive fixes, counted in the bucket of the later fix
+        double max_speed_mps{0.0};   // Fastest of those legs
+    };
+
+    constexpr size_t ROLLUP_RECORD_SIZE = 208;
+
+    /**
+     * @brief Mergeable aggregate of one bucket, as stored in rollup files
+     */
+    struct RollupBucket
+    {
+        int64_t start_ns{0};
+        uint64_t samples{0};
+        Position first;
+        Position last;
+        double min_latitude{0.0};
+        double max_latitude{0.0};
+        double min_longitude{0.0};
+        double max_longitude{0.0};
+        double min_altitude{0.0};
+        double max_altitude{0.0};
+        double latitude_sum{0.0};
+        double longitude_sum{0.0};
+        double altitude_sum{0.0};
+        double distance_meters{0.0};
+        double max_speed_mps{0.0};
+
+        // Fold in a fix and the leg that led to it (zero for the first fix
+        // and for fixes that arrive out of order)
+        void add(const Position &fix, double leg_meters, double leg_seconds);
+
+        // Fold in a bucket of the same or a finer level
+        void merge(const RollupBucket &other);
+
+        PositionAggregate toAggregate(int64_t width_ns) const;
+
+        // Fixed-size little-endian record with a CRC-32C; decode() rejects a
+        // torn or corrupt record
+        void encode(char *out) const;
+        static bool decode(const char *data, RollupBucket &bucket);
+    };
+
+    /**
+     * @brief Multi-resolution rollups of one machine's position history
+     *
+     * Every fix is folded into the open bucket of each level in
+     * ROLLUP_LEVEL_SECONDS. When a later fix starts a new bucket, the
+     * finished one is appended to rollup-<seconds>.bin in the machine's
+     * history directory. Buckets are aligned to multiples of their width
+     * since the epoch, and only buckets with fixes are stored.
+     *
+     * query() answers from the coarsest level whose width divides the
+     * requested width, so a week of hourly buckets reads 168 records however
+     * many fixes the week holds.
+     *
+     * Open buckets live only in memory. open() reports the instant from which
+     * the stored fixes have to be replayed to rebuild them: the end of the
+     * earliest last-closed bucket across levels, or the start of history for a
+     * machine whose rollups were never written. A fix that arrives after
+     * its bucket was closed is merged into the stored record. It counts as a
+     * sample but adds no distance.
+     *
+     * Not thread-safe; DataStorage serializes access.
+     */
+    class HistoryRollup
+    {
+    public:
+        // Constructor
+        explicit HistoryRollup(const std::filesystem::path &directory);
+
+        // Read the stored levels; returns the timestamp in nanoseconds from
+        // which stored fixes must be passed to add(fix, true), or
+        // std::nullopt when every stored fix must be replayed
+        std::optional<int64_t> open();
+
+        // Fold in a fix. Replayed fixes that fall into an already stored
+        // bucket are skipped, since the stored bucket includes them
+        bool add(const Position &fix, bool replay = false);
+
+        // Buckets of width_seconds that hold fixes and overlap
+        // [start, end], oldest first; each bucket is returned whole.
+        // The width must be a multiple of ROLLUP_LEVEL_SECONDS[0]
+        std::vector<PositionAggregate> query(const Timestamp &start, const Timestamp &end,
+                                             std::chrono::seconds width) const;
+
+        static bool supportsWidth(std::chrono::seconds width);
+
+    private:
+        struct Level
+        {
+            int64_t width_ns;
+            std::filesystem::path path;
+            uint64_t records{0};
+            std::optional<int64_t> last_stored_start;
+            std::optional<RollupBucket> open;
+        };
+
+        std::filesystem::path directory_;
+        std::array<Level, ROLLUP_LEVEL_COUNT> levels_;
+        std::optional<Position> previous_; // Latest fix in time order
+
+        // Private methods
+        bool append(Level &level, const RollupBucket &bucket);
+        bool mergeStored(Level &level, const RollupBucket &bucket);
+        std::vector<RollupBucket> readStored(const Level &level, int64_t from_ns, int64_t to_ns) const;
+    };
+
+} // namespace equipment_tracker
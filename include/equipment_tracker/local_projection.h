@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/constants.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief A point in a site's local east-north plane, in metres from the site origin
+     */
+    struct LocalPoint
+    {
+        float east{0.0f};
+        float north{0.0f};
+
+        float distanceTo(const LocalPoint &other) const
+        {
+            float de = east - other.east;
+            float dn = north - other.north;
+            return std::sqrt(de * de + dn * dn);
+        }
+
+        float distanceSquaredTo(const LocalPoint &other) const
+        {
+            float de = east - other.east;
+            float dn = north - other.north;
+            return de * de + dn * dn;
+        }
+    };
+
+    /**
+     * @brief A fix converted to the local plane of the site that contains it
+     */
+    struct LocalFix
+    {
+        uint32_t site{0};
+        LocalPoint point;
+    };
+
+    /**
+     * @brief Local tangent-plane (ENU) projection around a fixed origin
+     *
+     * The WGS84 radii of curvature are evaluated once at the origin, so each
+     * conversion is a handful of multiply-adds with no trigonometry. A
+     * first-order correction for meridian convergence keeps the error well
+     * under a metre within DEFAULT_SITE_RADIUS_METERS of the origin.
+     */
+    class LocalProjection
+    {
+    public:
+        // Constructor
+        LocalProjection(double origin_latitude, double origin_longitude);
+
+        // Getters
+        double getOriginLatitude() const { return origin_lat_; }
+        double getOriginLongitude() const { return origin_lon_; }
+
+        // Conversion
+        LocalPoint project(double latitude, double longitude) const;
+        LocalPoint project(const Position &position) const;
+        void unproject(const LocalPoint &point, double &latitude, double &longitude) const;
+
+        /**
+         * @brief Convert many fixes at once from structure-of-arrays input
+         *
+         * Away from the antimeridian the loop body is branch-free over
+         * contiguous arrays, so the compiler can vectorize it (SSE/AVX/NEON
+         * depending on the target). Used where many points share one
+         * projection, such as the road graph nodes in MapMatcher; live fixes
+         * arrive one at a time and go through project().
+         */
+        void projectBatch(const double *latitudes, const double *longitudes, size_t count,
+                          float *east, float *north) const;
+
+    private:
+        double origin_lat_;
+        double origin_lon_;
+        double meters_per_deg_lat_; // Meridional radius of curvature, per degree
+        double meters_per_deg_lon_; // Parallel radius at the origin, per degree
+        double convergence_;        // d(meters_per_deg_lon)/d(latitude degree)
+    };
+
+    /**
+     * @brief Caches one projection per operating site
+     *
+     * Sites are registered explicitly as circles, or created on demand as
+     * tiles of a fixed latitude/longitude grid whose corners lie
+     * default_radius_meters from their centre. A fix belongs to the covering
+     * registered site with the nearest origin, otherwise to its grid tile, so
+     * assignment depends only on where the fix is, never on which fixes came
+     * before it. Not thread-safe.
+     */
+    class SiteProjectionRegistry
+    {
+    public:
+        struct Site
+        {
+            std::string name;
+            LocalProjection projection;
+            double radius_meters;
+            bool tile{false};   // Auto-created grid tile rather than a registered circle
+            double south{0.0};  // Tile bounds in degrees
+            double north{0.0};
+            double west{0.0};
+            double east{0.0};
+            float inner_east{0.0f};   // Tile half-extents in its own plane, at the narrowest point
+            float inner_north{0.0f};
+            bool overlapped{false};   // Shares ground with a registered site
+        };
+
+        // Constructor
+        explicit SiteProjectionRegistry(double default_radius_meters = DEFAULT_SITE_RADIUS_METERS);
+
+        // Register a site; returns its index
+        uint32_t addSite(const std::string &name, double latitude, double longitude,
+                         double radius_meters);
+
+        // Convert a fix, creating its grid tile if no site covers it
+        LocalFix project(const Position &position);
+
+        // Queries
+        size_t size() const { return sites_.size(); }
+        const Site &getSite(uint32_t index) const { return sites_.at(index); }
+        std::optional<uint32_t> findSite(double latitude, double longitude) const;
+
+        /**
+         * @brief Existing sites whose area comes within the given distance of a point
+         *
+         * Includes the site containing the point. Used to compare machines on
+         * either side of a site boundary; the distance must be well below the
+         * tile size.
+         */
+        std::vector<uint32_t> sitesNear(double latitude, double longitude, double meters) const;
+
+        // Cheap test on the local point: could any other site lie within the distance?
+        bool nearEdge(const LocalFix &fix, double meters) const;
+
+    private:
+        double default_radius_meters_;
+        double tile_degrees_; // Tile height in degrees of latitude
+        std::vector<Site> sites_;
+        std::vector<uint32_t> registered_; // Indices of explicitly added sites
+        std::unordered_map<uint64_t, uint32_t> tiles_;
+
+        // Private methods
+        int64_t tileRow(double latitude) const;
+        int64_t tileColumns(int64_t row) const;
+        int64_t tileColumn(int64_t row, double longitude) const;
+        static uint64_t tileKey(int64_t row, int64_t column);
+        Site makeTile(int64_t row, int64_t column) const;
+        static bool overlaps(const Site &tile, const Site &registered);
+        static double edgeDistance(const Site &site, double latitude, double longitude);
+    };
+
+} // namespace equipment_tracker
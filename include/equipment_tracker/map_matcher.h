@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+#include "local_projection.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief A site road network of nodes joined by straight two-way edges
+     *
+     * Curved roads are drawn as chains of short edges. The text form has one
+     * record per line; blank lines and lines starting with '#' are ignored:
+     *
+     *     node <name> <latitude> <longitude>
+     *     edge <from-name> <to-name>
+     */
+    class RoadGraph
+    {
+    public:
+        struct Node
+        {
+            double latitude;
+            double longitude;
+        };
+
+        struct Edge
+        {
+            uint32_t from;
+            uint32_t to;
+        };
+
+        // Construction; addEdge returns false for unknown or identical nodes
+        uint32_t addNode(double latitude, double longitude);
+        bool addEdge(uint32_t from, uint32_t to);
+
+        // Getters
+        const std::vector<Node> &getNodes() const { return nodes_; }
+        const std::vector<Edge> &getEdges() const { return edges_; }
+
+        // Read the text form; std::nullopt on the first malformed line
+        static std::optional<RoadGraph> parse(std::istream &in);
+        static std::optional<RoadGraph> load(const std::string &path);
+
+    private:
+        std::vector<Node> nodes_;
+        std::vector<Edge> edges_;
+    };
+
+    /**
+     * @brief A fix snapped onto the road graph
+     */
+    struct MatchedPosition
+    {
+        uint32_t edge{0};              // Index into RoadGraph::getEdges()
+        double offset_meters{0.0};     // Along the edge from its first node
+        double latitude{0.0};          // Snapped point
+        double longitude{0.0};
+        double error_meters{0.0};      // Distance from the raw fix to the snapped point
+        double route_meters{0.0};      // Road distance from the previous fix along the best path
+        double total_route_meters{0.0}; // Road distance along the best path since the machine was first matched
+        Timestamp timestamp;
+    };
+
+    /**
+     * @brief Incremental hidden-Markov map matching of fixes onto a RoadGraph
+     *
+     * Each fix's candidates are the nearest edges within
+     * MAP_MATCH_SEARCH_METERS, found through a uniform grid over the graph.
+     * A candidate is weighed by its distance from the fix (Gaussian, sigma
+     * from the fix's accuracy) and by how well the road distance from each
+     * previous candidate agrees with the straight-line distance between the
+     * fixes (exponential, MAP_MATCH_BETA_METERS). Road distances come from a
+     * shortest-path search bounded by the distance travelled.
+     *
+     * Viterbi runs online: every fix advances each machine's candidate
+     * scores by one step and the best candidate is reported at once, so the
+     * cost per fix is independent of the track length. Each candidate carries
+     * the road distance of its own best path, so when a later fix shows an
+     * earlier choice was wrong the total follows the corrected path. Fixes
+     * closer than two
+     * sigma to the last used fix are answered with the current match, so a
+     * parked machine's jitter adds no distance. A machine with no nearby
+     * road, no road path between fixes or a gap over
+     * MAP_MATCH_MAX_GAP_SECONDS restarts from its next fix.
+     *
+     * Thread-safe.
+     */
+    class MapMatcher
+    {
+    public:
+        // Constructor; projects the graph and builds its edge index
+        explicit MapMatcher(const RoadGraph &graph);
+
+        /**
+         * @brief Match a machine's next fix
+         *
+         * @return The snapped position, or std::nullopt when no road is close
+         *         enough; fixes older than the machine's latest are ignored
+         */
+        std::optional<MatchedPosition> match(const EquipmentId &id, const Position &position);
+
+        // Latest match of a machine
+        std::optional<MatchedPosition> getMatch(const EquipmentId &id) const;
+
+        // Forget a machine's track
+        void remove(const EquipmentId &id);
+        size_t size() const;
+
+        // Edges within the radius of a point, by index
+        std::vector<uint32_t> edgesNear(double latitude, double longitude, double radius_meters) const;
+
+    private:
+        struct Candidate
+        {
+            uint32_t edge;
+            float offset;       // Along the edge from its first node
+            LocalPoint point;   // Snapped point
+            float error;        // Distance from the fix
+            double score;       // Log probability of the best path ending here
+            double route;       // Road distance from that path's previous candidate
+            double distance;    // Road distance along that path since the track restarted
+        };
+
+        struct Track
+        {
+            std::vector<Candidate> candidates;
+            LocalPoint anchor;  // Last fix that advanced the match
+            Timestamp last_time;
+            std::optional<MatchedPosition> current;
+            double restart_route{0.0}; // Road distance matched before the track last restarted
+        };
+
+        LocalProjection projection_;
+        std::vector<RoadGraph::Edge> edges_;
+        std::vector<LocalPoint> points_;       // Per node
+        std::vector<float> lengths_;           // Per edge
+        std::vector<uint32_t> adjacency_offsets_;
+        std::vector<std::pair<uint32_t, uint32_t>> adjacency_; // (neighbour node, edge)
+
+        // Edge index: CSR buckets over a grid of square cells
+        LocalPoint grid_origin_;
+        float cell_meters_{static_cast<float>(MAP_MATCH_CELL_METERS)};
+        uint32_t grid_columns_{0};
+        uint32_t grid_rows_{0};
+        std::vector<uint32_t> cell_offsets_;
+        std::vector<uint32_t> cell_edges_;
+
+        mutable std::mutex mutex_;
+        std::unordered_map<EquipmentId, Track> tracks_;
+
+        // Scratch reused under mutex_
+        mutable std::vector<uint32_t> edge_stamps_;
+        mutable uint32_t stamp_{0};
+        std::vector<float> node_distances_;
+        std::vector<uint32_t> touched_nodes_;
+        std::vector<std::pair<float, uint32_t>> heap_;
+
+        // Private methods
+        void buildIndex();
+        std::vector<Candidate> findCandidates(const LocalPoint &fix, float radius, float sigma, size_t limit) const;
+        void searchRoutes(const Candidate &from, float limit);
+        double routeTo(const Candidate &from, const Candidate &to) const;
+        MatchedPosition report(Track &track, const Candidate &best, const Timestamp &at) const;
+    };
+
+} // namespace equipment_tracker
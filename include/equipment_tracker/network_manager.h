@@ -43,6 +43,11 @@ public:
     std::string getServerUrl() const { return server_url_; }
     int getServerPort() const { return server_port_; }
     
+    // Wire format for one position update: a JSON object whose last field,
+    // "crc32c", is the CRC-32C (8 hex digits) of the object without that field
+    static std::string formatPositionPayload(const EquipmentId& id, const Position& position);
+    static bool verifyPayloadChecksum(const std::string& payload);
+    
 private:
     std::string server_url_;
     int server_port_;
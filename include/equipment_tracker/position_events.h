@@ -0,0 +1,22 @@
+#pragma once
+
+#include "utils/types.h"
+#include "utils/event_bus.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief A fix accepted for a known piece of equipment
+     */
+    struct PositionEvent
+    {
+        EquipmentId equipment_id;
+        EquipmentType type;
+        Position position;
+    };
+
+    using PositionEventBus = EventBus<PositionEvent>;
+
+} // namespace equipment_tracker
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include "utils/types.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Strategy used to estimate a position between two recorded fixes
+     */
+    enum class InterpolationMethod
+    {
+        Linear,     // Straight-line interpolation of latitude/longitude degrees
+        GreatCircle // Spherical interpolation along the great circle between fixes
+    };
+
+    /**
+     * @brief Interpolate between two fixes at the given instant
+     * @param before Fix at or before the instant
+     * @param after Fix at or after the instant
+     * @param at Instant to estimate; clamped to [before, after]
+     * @param method Interpolation strategy
+     * @return Estimated position stamped with the requested instant
+     */
+    Position interpolatePosition(const Position &before, const Position &after,
+                                 const Timestamp &at, InterpolationMethod method);
+
+    /**
+     * @brief Estimate the position at an instant from a chronological history
+     *
+     * Bracketing fixes are located with a binary search, so the history must be
+     * sorted by timestamp (as produced by Equipment and DataStorage).
+     *
+     * @return Estimated position, or std::nullopt if the instant lies outside
+     *         the time range covered by the history
+     */
+    std::optional<Position> interpolateHistory(const std::vector<Position> &history,
+                                               const Timestamp &at,
+                                               InterpolationMethod method);
+
+} // namespace equipment_tracker
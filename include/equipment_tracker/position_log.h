@@ -0,0 +1,291 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+#include "storage_io.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * Binary append-only position history, one directory per equipment at
+     * positions/<id>/ holding numbered segment files. A segment is a run of
+     * fixed-size records in host byte order:
+     *
+     *   bytes  0-39  payload; for fixes int64 timestamp (ns since epoch),
+     *                then double latitude, longitude, altitude, accuracy
+     *   bytes 40-43  uint32 record kind
+     *   bytes 44-47  uint32 CRC-32C of bytes 0-43
+     *
+     * Each segment starts with a header record. Sealing it appends a footer
+     * with the fix count and the CRC-32C of every byte before the footer, so
+     * an intact sealed segment verifies with one pass over its bytes. An
+     * all-zero record marks the end of the data (preallocated or block-padded
+     * space reads back as zeros). Segments without a header use the earlier
+     * unchecked 40-byte layout and are read but never appended to. Footers
+     * also carry the timestamps of the segment's first and last fix (zero in
+     * segments sealed before they did), so range queries skip whole segments.
+     *
+     * Sealed segments whose fixes have all aged past the archive window are
+     * rewritten as archive-<index>.arc: a 48-byte header (magic, version,
+     * CRC-32C of the body, fix count, first and last timestamp, body size)
+     * followed by the fixes compressed with encodePositionArchive().
+     */
+    constexpr size_t POSITION_RECORD_SIZE = 48;
+    constexpr size_t LEGACY_POSITION_RECORD_SIZE = 40;
+    constexpr const char *POSITION_LOG_FILENAME = "positions.log"; // Single-file layout, read as segment 0
+
+    enum class PositionRecordKind : uint32_t
+    {
+        End = 0,
+        Fix = 1,
+        SegmentHeader = 2,
+        SegmentFooter = 3
+    };
+
+    // Serialize one fix into a POSITION_RECORD_SIZE checksummed record at out
+    void encodePositionRecord(const Position &position, char *out);
+
+    // Decode the fixes in a run of checksummed records, up to the first
+    // all-zero or partial record. Records failing their checksum are skipped
+    // and counted in corrupt_records when given.
+    std::vector<Position> decodePositionRecords(const char *data, size_t size,
+                                                size_t *corrupt_records = nullptr);
+
+    // Decode unchecked 40-byte records up to the first all-zero or partial one
+    std::vector<Position> decodeLegacyPositionRecords(const char *data, size_t size);
+
+    // Lossless archive codec for fixes in time order: timestamps as zig-zag
+    // varint delta-of-deltas, each coordinate as the XOR with its previous
+    // value stored without its leading and trailing zero bytes. Slowly moving
+    // equipment compresses to roughly 20 bytes a fix
+    std::string encodePositionArchive(const std::vector<Position> &positions);
+    bool decodePositionArchive(const char *data, size_t size, std::vector<Position> &out);
+
+    struct PositionLogOptions
+    {
+        uint64_t segment_size{POSITION_SEGMENT_SIZE}; // Bytes per segment before rotating
+        bool preallocate{true};                       // fallocate each new segment up front (Linux)
+        bool direct_io{false};                        // O_DIRECT with block-aligned buffers (Linux)
+        int64_t archive_after_seconds{WARM_HISTORY_WINDOW_SECONDS}; // Compress sealed segments this much older
+                                                                     // than the newest fix; 0 never archives
+    };
+
+    /**
+     * @brief Outcome of PositionLog::verify()
+     */
+    struct PositionLogCheck
+    {
+        uint64_t segments{0};
+        uint64_t bytes{0};
+        uint64_t records{0};          // Fixes that verified (legacy fixes count as verified)
+        uint64_t corrupt_records{0};  // Fixes skipped for a bad checksum
+        uint64_t corrupt_segments{0}; // Sealed segments whose footer checksum did not match
+    };
+
+    /**
+     * @brief Storage footprint of a PositionLog by tier
+     */
+    struct PositionLogTiers
+    {
+        uint64_t warm_segments{0}; // Uncompressed segments, including the active one
+        uint64_t warm_bytes{0};
+        uint64_t mapped_bytes{0};  // Sealed segments currently memory-mapped for queries
+        uint64_t cold_segments{0}; // Compressed archives
+        uint64_t cold_bytes{0};
+        uint64_t cold_fixes{0};
+    };
+
+    /**
+     * @brief Segmented append log for one piece of equipment
+     *
+     * Appends are queued on the shared I/O backend. New segments are
+     * preallocated so steady-state appends never extend the file's block map,
+     * and a segment is rotated once it reaches the configured size. Sealed
+     * segments are dropped from the page cache after they have been synced,
+     * and history scans read them with sequential-access advice, so a long
+     * history does not push hot data out of memory on small devices.
+     *
+     * With direct I/O, appends collect in an aligned tail block and only whole
+     * blocks are written; the partial tail is written by flush. Each block is
+     * therefore never in flight twice.
+     *
+     * Range queries skip segments outside the range using the bounds in their
+     * footers, read sealed segments through read-only memory maps (at most
+     * POSITION_MAPPED_SEGMENTS at a time) and decompress archives on demand. A
+     * rotation only records the archive cutoff (see
+     * PositionLogOptions::archive_after_seconds); the owner collects it with
+     * takeArchiveCutoff() and archives off the append path.
+     *
+     * Not thread-safe; DataStorage serializes access under its mutex.
+     */
+    class PositionLog
+    {
+    public:
+        // Constructor
+        PositionLog(std::filesystem::path directory, StorageIoBackend &io,
+                    PositionLogOptions options = PositionLogOptions());
+
+        // Destructor closes descriptors; queued operations must have completed
+        ~PositionLog();
+
+        PositionLog(const PositionLog &) = delete;
+        PositionLog &operator=(const PositionLog &) = delete;
+
+        // Scan existing segments; without create, false when there are none
+        bool open(bool create);
+
+        // Queue one fix
+        bool append(const Position &position);
+
+        // Every stored fix, oldest first; waits for queued I/O. Corrupt
+        // records are skipped and reported on stderr
+        std::vector<Position> readAll();
+
+        // The last count fixes appended, oldest first; reads segments newest
+        // first and stops once it has enough
+        std::vector<Position> readRecent(size_t count);
+
+        // Fixes with start <= timestamp <= end, in log order. Segments whose
+        // time range lies outside are not read
+        std::vector<Position> readRange(const Timestamp &start, const Timestamp &end);
+
+        // readRange one segment at a time: appends the in-range fixes of the
+        // next overlapping segment from next_segment on and moves next_segment
+        // past it; false once no segment is left. Segment indices stay valid
+        // across appends and archiving, so a scan can resume between calls
+        bool readRangeChunk(const Timestamp &start, const Timestamp &end,
+                            size_t &next_segment, std::vector<Position> &out);
+
+        // Earliest and latest fix of each non-empty segment, from footers,
+        // archive headers and the active segment's running bounds; false when
+        // some segment's range cannot be established
+        bool getSegmentRanges(std::vector<std::pair<Timestamp, Timestamp>> &ranges);
+
+        // Compress every durable sealed segment whose last fix is older than
+        // cutoff; returns the number archived
+        size_t archiveBefore(const Timestamp &cutoff);
+
+        /**
+         * @brief One sealed segment being rewritten as an archive
+         *
+         * archiveBefore() in three steps, so the compression and the durable
+         * write can run without the owner's lock: planArchive() picks the aged
+         * segments, writeArchive() builds each archive beside its segment (any
+         * thread; it touches only the job's files) and commitArchive() swaps
+         * the finished archives in.
+         */
+        struct ArchiveJob
+        {
+            uint64_t generation{0}; // getGeneration() of the planning log
+            uint64_t segment{0};    // Segment file index
+            std::filesystem::path source;
+            std::filesystem::path target;
+            int64_t first_ns{0};
+            int64_t last_ns{0};
+            uint64_t size{0};   // Set by writeArchive()
+            uint64_t fixes{0};
+            bool written{false};
+        };
+
+        std::vector<ArchiveJob> planArchive(const Timestamp &cutoff);
+        static bool writeArchive(ArchiveJob &job);
+        size_t commitArchive(std::vector<ArchiveJob> &jobs);
+
+        // Remove the temporary files of jobs that will not be committed
+        static void discardArchive(const std::vector<ArchiveJob> &jobs);
+
+        // The cutoff recorded by the latest rotation, once
+        std::optional<Timestamp> takeArchiveCutoff();
+
+        PositionLogTiers getTiers() const;
+
+        // Check every segment, one at a time. Sealed segments whose footer
+        // checksum matches are not decoded record by record
+        PositionLogCheck verify();
+
+        // Flush protocol, with io.wait() between the steps:
+        //   writeTail() -> submitSync() -> releaseSealed()
+        void writeTail();
+        void submitSync(const std::shared_ptr<std::atomic<bool>> &ok);
+        void releaseSealed();
+
+        // Getters
+        size_t getSegmentCount() const { return segments_.size(); }
+        // Unique per instance in this process, so an owner can tell a log it
+        // planned against from a later one reopened for the same directory
+        uint64_t getGeneration() const { return generation_; }
+
+        bool isDirectIo() const { return direct_io_; }
+        const std::filesystem::path &getDirectory() const { return directory_; }
+
+    private:
+        struct Segment
+        {
+            uint64_t index{0};
+            std::filesystem::path path;
+            uint64_t size{0}; // Bytes of record data
+            int fd{-1};       // Open while active or awaiting its final sync
+            bool dirty{false};
+            bool sealed{false};
+            uint32_t crc{0};     // Active only: CRC-32C of bytes written so far
+            uint64_t fixes{0};   // Active only: fix records written so far
+            bool archived{false}; // path is an archive
+            bool archiving{false}; // Planned by planArchive(), not yet committed
+
+            // Timestamps (ns) of the first and last fix, once known
+            bool range_known{false};
+            int64_t first_ns{0};
+            int64_t last_ns{0};
+
+            // Read-only mapping of a sealed, uncompressed segment
+            const char *map{nullptr};
+            size_t map_size{0};
+        };
+
+        // Bytes read back from one segment
+        struct SegmentImage
+        {
+            IoBuffer buffer;
+            size_t size{0};
+            bool archived{false};
+        };
+
+        std::filesystem::path directory_;
+        StorageIoBackend &io_;
+        PositionLogOptions options_;
+        bool direct_io_{false};
+        uint64_t generation_{0};
+        std::vector<Segment> segments_;
+
+        std::deque<uint64_t> mapped_; // Indices of mapped segments, oldest mapping first
+        std::optional<Timestamp> archive_cutoff_;
+
+        // Direct I/O only: the block containing the end of the active segment
+        IoBuffer tail_block_;
+        uint64_t tail_block_offset_{0};
+
+        // Private methods
+        bool openSegment(Segment &segment, bool create);
+        bool startSegment();
+        void sealActiveSegment();
+        void appendRecord(Segment &segment, const char *record);
+        void writeBlock(Segment &segment, const char *data, uint64_t offset);
+        std::vector<SegmentImage> readImages(size_t first, size_t last);
+        bool mapSegment(Segment &segment);
+        void unmapSegment(Segment &segment);
+        void learnRange(Segment &segment);
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+#include "local_projection.h"
+
+namespace equipment_tracker
+{
+
+    enum class ProximityEventType
+    {
+        Entered, // Pair came within its threshold
+        Exited   // Pair separated beyond its threshold (plus hysteresis)
+    };
+
+    /**
+     * @brief Emitted when two pieces of equipment enter or leave proximity
+     */
+    struct ProximityEvent
+    {
+        EquipmentId first;
+        EquipmentId second;
+        ProximityEventType type;
+        double distance_meters;
+        Timestamp timestamp;
+    };
+
+    using ProximityCallback = std::function<void(const ProximityEvent &event)>;
+
+    /**
+     * @brief Incremental pairwise proximity detection over the latest fixes
+     *
+     * Latest positions are kept in a uniform spatial hash whose cell size is the
+     * largest pair threshold, so each update only inspects the 3x3 block of
+     * cells around the moved equipment. Events are emitted only when a pair's
+     * state changes. Distances are computed on the site-local plane of each fix
+     * (see SiteProjectionRegistry). Cells belong to one site; a machine near a
+     * site boundary is also projected into each neighbouring site and compared
+     * with the machines there in that site's plane.
+     *
+     * Not thread-safe; callers serialize access (the service does so under its
+     * own mutex).
+     */
+    class ProximityEngine
+    {
+    public:
+        // Constructors; the second shares a registry whose LocalFix values are passed to update().
+        // A non-positive or non-finite default falls back to DEFAULT_PROXIMITY_THRESHOLD_METERS
+        explicit ProximityEngine(double default_threshold_meters = DEFAULT_PROXIMITY_THRESHOLD_METERS);
+        explicit ProximityEngine(SiteProjectionRegistry &sites,
+                                 double default_threshold_meters = DEFAULT_PROXIMITY_THRESHOLD_METERS);
+        ProximityEngine(const ProximityEngine &) = delete;
+        ProximityEngine &operator=(const ProximityEngine &) = delete;
+
+        // Threshold configuration; a pair uses the larger of its two thresholds.
+        // Returns false, keeping the current threshold, unless meters is positive and finite
+        bool setThreshold(EquipmentType type, double meters);
+        double getThreshold(EquipmentType type) const;
+        double getPairThreshold(EquipmentType a, EquipmentType b) const;
+
+        // Update the latest position of one piece of equipment; fix.site indexes the engine's registry
+        std::vector<ProximityEvent> update(const EquipmentId &id, EquipmentType type,
+                                           const LocalFix &fix, const Timestamp &timestamp);
+
+        // Convenience overload projecting through the engine's own site registry
+        std::vector<ProximityEvent> update(const EquipmentId &id, EquipmentType type,
+                                           const Position &position);
+
+        // Stop tracking equipment; emits Exited events for its active pairs
+        std::vector<ProximityEvent> remove(const EquipmentId &id);
+
+        // Queries
+        size_t size() const { return index_.size(); }
+        std::vector<std::pair<EquipmentId, EquipmentId>> getActivePairs() const;
+
+    private:
+        struct Asset
+        {
+            EquipmentId id;
+            EquipmentType type;
+            uint32_t site{0};
+            LocalPoint point;
+            int64_t cell_x{0};
+            int64_t cell_y{0};
+            bool active{false};
+            std::vector<uint32_t> neighbours; // Assets currently in proximity
+        };
+
+        double thresholds_[static_cast<size_t>(EquipmentType::Other) + 1];
+        double cell_size_;
+
+        SiteProjectionRegistry own_sites_;
+        SiteProjectionRegistry *sites_;
+
+        std::vector<Asset> assets_;
+        std::vector<uint32_t> free_slots_;
+        std::unordered_map<EquipmentId, uint32_t> index_;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> grid_;
+
+        // Private methods
+        static uint64_t cellKey(uint32_t site, int64_t cell_x, int64_t cell_y);
+        LocalPoint pointIn(const Asset &asset, uint32_t site) const;
+        float distanceBetween(const Asset &a, const Asset &b) const;
+        void findEntered(uint32_t slot, uint32_t site, const LocalPoint &point,
+                         const Timestamp &timestamp, std::vector<ProximityEvent> &events);
+        void insertIntoGrid(uint32_t slot);
+        void removeFromGrid(uint32_t slot);
+        void rebuildGrid();
+        static void unlink(std::vector<uint32_t> &list, uint32_t slot);
+    };
+
+} // namespace equipment_tracker
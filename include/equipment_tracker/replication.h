@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "utils/constants.h"
+#include "data_storage.h"
+
+namespace equipment_tracker
+{
+
+    enum class ReplicationCommitMode
+    {
+        Async, // Writes return once durable locally; the standby catches up
+        Sync   // Writes also wait until the standby has applied them
+    };
+
+    /**
+     * @brief Replication progress as seen by the primary
+     */
+    struct ReplicationStatus
+    {
+        bool connected{false};
+        bool fenced{false};      // The standby was promoted; shipping has stopped
+        uint64_t latest_lsn{0};  // Newest change in the primary's feed
+        uint64_t shipped_lsn{0}; // Newest change sent to the standby
+        uint64_t acked_lsn{0};   // Newest change the standby has applied
+        uint64_t lag_records{0}; // latest_lsn - acked_lsn
+        std::chrono::nanoseconds lag{0}; // Age of the oldest unacknowledged change
+        uint64_t batches_shipped{0};
+    };
+
+    /**
+     * @brief Ships a DataStorage's change feed to a standby
+     *
+     * A background thread reads the feed after the standby's acknowledged
+     * LSN and sends everything available (up to REPLICATION_BATCH_SIZE
+     * records) as one batch, so records committed while a batch is in
+     * flight go out together in the next one. The standby acknowledges each
+     * batch once applied; the LSN is kept as the feed's REPLICATION_CONSUMER
+     * offset. On (re)connect the standby reports what it has applied and
+     * shipping resumes from there.
+     *
+     * In Sync mode every write to the storage waits, up to
+     * REPLICATION_SYNC_TIMEOUT_MS, for its acknowledgement. DataStorage
+     * serializes writes, so synchronous commit costs one round trip per write.
+     *
+     * Protocol (framed as in utils/socket_io.h): "HELLO" is answered with
+     * "OK <applied lsn>"; "BATCH" followed by one ChangeFeed line per record
+     * is answered with "ACK <applied lsn>". A promoted standby answers
+     * "ERR promoted" and the primary stops shipping.
+     */
+    class ReplicationPrimary
+    {
+    public:
+        // Constructor
+        ReplicationPrimary(DataStorage &storage, std::string standby_address, uint16_t standby_port,
+                           ReplicationCommitMode mode = ReplicationCommitMode::Async);
+
+        // Destructor stops shipping
+        ~ReplicationPrimary();
+
+        ReplicationPrimary(const ReplicationPrimary &) = delete;
+        ReplicationPrimary &operator=(const ReplicationPrimary &) = delete;
+
+        // Initialize the storage if needed and ship in the background
+        bool start();
+        void stop();
+
+        // Commit mode can change while running
+        void setCommitMode(ReplicationCommitMode mode) { mode_ = mode; }
+        ReplicationCommitMode getCommitMode() const { return mode_; }
+
+        // Block until the standby has applied lsn; false on timeout, fencing or stop
+        bool waitForAck(uint64_t lsn, std::chrono::milliseconds timeout);
+
+        ReplicationStatus getStatus() const;
+
+    private:
+        DataStorage &storage_;
+        std::string address_;
+        uint16_t port_;
+        std::atomic<ReplicationCommitMode> mode_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable acked_changed_;
+        bool running_{false};
+        bool connected_{false};
+        bool fenced_{false};
+        int fd_{-1}; // Standby connection, shut down by stop() to wake the shipper
+        uint64_t shipped_lsn_{0};
+        uint64_t acked_lsn_{0};
+        uint64_t batches_shipped_{0};
+        std::thread shipper_;
+
+        // Private methods
+        void shipLoop();
+        bool handshake(int fd, std::string &buffer);
+        void onCommit(uint64_t lsn);
+        void setAcked(uint64_t lsn);
+    };
+
+    /**
+     * @brief Receives a primary's change feed into a local DataStorage
+     *
+     * Serves one primary connection at a time. Each batch is applied through
+     * DataStorage (so the standby keeps its own files, position logs and
+     * change feed) and the applied primary LSN is persisted in
+     * <db_path>/replication/state before the batch is acknowledged. A batch
+     * replayed after a crash between those two steps may store its fixes
+     * twice; equipment records are simply rewritten.
+     *
+     * promote() ends replication for good: the standby refuses further
+     * batches, which fences the old primary, and releases the storage so an
+     * EquipmentTrackerService can be started on the same db_path.
+     */
+    class ReplicationStandby
+    {
+    public:
+        // Constructor; port 0 picks a free port (see getPort())
+        explicit ReplicationStandby(std::string db_path,
+                                    std::string address = CLUSTER_DEFAULT_ADDRESS, uint16_t port = 0);
+
+        // Destructor stops serving
+        ~ReplicationStandby();
+
+        ReplicationStandby(const ReplicationStandby &) = delete;
+        ReplicationStandby &operator=(const ReplicationStandby &) = delete;
+
+        // Listen for the primary; fails once promoted
+        bool start();
+        void stop();
+
+        // Take over as the writable copy. A running standby keeps refusing
+        // the old primary until stop()
+        bool promote();
+        bool isPromoted() const;
+
+        // Getters
+        uint64_t getAppliedLsn() const;
+        Timestamp getLastAppliedAt() const;
+        uint16_t getPort() const { return port_; }
+        const std::string &getDbPath() const { return db_path_; }
+
+        // Answer one request body (exposed for tests)
+        std::string handleRequest(const std::string &request);
+
+    private:
+        std::string db_path_;
+        std::string address_;
+        uint16_t port_;
+        std::unique_ptr<DataStorage> storage_;
+
+        mutable std::mutex mutex_;
+        uint64_t applied_lsn_{0};
+        Timestamp last_applied_at_{};
+        bool promoted_{false};
+
+        std::atomic<int> listen_fd_{-1};
+        std::atomic<int> connection_fd_{-1};
+        std::thread accept_thread_;
+
+        // Private methods
+        void acceptLoop(int listen_fd);
+        bool apply(const ChangeRecord &record);
+        bool loadState();
+        bool saveState();
+        std::string statePath() const { return db_path_ + "/replication/state"; }
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+#include "utils/constants.h"
+#include "position.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Named polygon that rules can be restricted to
+     */
+    struct RuleZone
+    {
+        std::string name;
+        std::vector<std::pair<double, double>> vertices; // (latitude, longitude), at least three
+    };
+
+    /**
+     * @brief Daily window in local minutes after midnight, [start, end)
+     *
+     * A window whose end is before its start wraps midnight (22:00-05:00).
+     */
+    struct RuleTimeWindow
+    {
+        int start_minute{0};
+        int end_minute{0};
+    };
+
+    /**
+     * @brief One declarative rule; every condition that is set must hold
+     *
+     * Rules are usually written as text and read with parseRule():
+     *
+     *   zone-b-speeding: type is Truck and in zone B and speed > 15 km/h
+     *   after-hours: moving and between 22:00 and 05:00
+     *
+     * Clauses are joined by "and": "type is <type>", "in zone <name>",
+     * "speed > <n> [km/h|m/s]" (km/h by default), "moving" (speed above
+     * MOVEMENT_SPEED_THRESHOLD) and "between HH:MM and HH:MM".
+     */
+    struct RuleDefinition
+    {
+        std::string name;
+        std::optional<EquipmentType> type;   // Any type when unset
+        std::optional<std::string> zone;     // Anywhere when unset
+        std::optional<RuleTimeWindow> window; // At any time when unset
+        double min_speed_mps{-1.0};          // Speed must exceed this; negative for any speed
+    };
+
+    // Parse one rule; std::nullopt (with the reason on stderr) when malformed
+    std::optional<RuleDefinition> parseRule(const std::string &text);
+
+    enum class RuleAlertType
+    {
+        Raised, // The machine started matching the rule
+        Cleared // It stopped matching, or was removed
+    };
+
+    /**
+     * @brief Emitted when a machine starts or stops matching a rule
+     */
+    struct RuleAlert
+    {
+        std::string rule;
+        EquipmentId equipment_id;
+        RuleAlertType type;
+        double speed_mps;
+        Position position;
+    };
+
+    using RuleAlertCallback = std::function<void(const RuleAlert &alert)>;
+
+    /**
+     * @brief Rules compiled into a per-fix evaluation plan
+     *
+     * Zones are bucketed into a grid of RULE_ZONE_CELL_DEGREES cells, so a
+     * fix only runs point-in-polygon tests for the zones overlapping its
+     * cell. Rules are grouped by (zone, equipment type) with "anywhere" and
+     * "any type" as groups of their own, so a fix visits two groups for
+     * "anywhere" and two for each zone it is in. Within a group, rules
+     * without a time window and the rules active in each local hour are kept
+     * in separate lists sorted by speed threshold; a scan stops at the first
+     * threshold the fix does not exceed. Rules that cannot fire are never
+     * looked at.
+     *
+     * Immutable once compiled, so one plan can be shared across threads.
+     */
+    class RulePlan
+    {
+    public:
+        // Empty plan; matches nothing
+        RulePlan() = default;
+
+        // Compile a rule set; nullptr (with the reason on stderr) when a zone is
+        // degenerate or duplicated, or a rule names an unknown zone or has an
+        // invalid window. Windows are in local time, utc_offset ahead of UTC
+        static std::shared_ptr<const RulePlan> compile(
+            const std::vector<RuleZone> &zones,
+            const std::vector<RuleDefinition> &rules,
+            std::chrono::minutes utc_offset = std::chrono::minutes(0));
+
+        // Append the indices of the rules the fix satisfies, in ascending order
+        void match(EquipmentType type, const Position &position, double speed_mps,
+                   std::vector<uint32_t> &matched) const;
+
+        size_t size() const { return names_.size(); }
+        const std::string &ruleName(uint32_t rule) const { return names_[rule]; }
+
+    private:
+        static constexpr size_t TYPE_GROUPS = static_cast<size_t>(EquipmentType::Other) + 2; // Last is "any type"
+
+        struct Zone
+        {
+            std::vector<std::pair<double, double>> vertices;
+            double min_latitude, max_latitude, min_longitude, max_longitude;
+        };
+
+        struct CompiledRule
+        {
+            double min_speed_mps;
+            int start_minute;
+            int end_minute;
+            uint32_t rule;
+        };
+
+        struct Group
+        {
+            std::vector<CompiledRule> always;                // Sorted by min_speed_mps
+            std::array<std::vector<CompiledRule>, 24> hourly; // Windowed rules, by local hour
+        };
+
+        std::vector<std::string> names_;
+        std::vector<Zone> zones_;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> zone_cells_;
+        std::vector<uint32_t> large_zones_; // Too large to grid; tested on every fix
+        std::vector<int32_t> group_index_;  // (zone + 1) * TYPE_GROUPS + type -> groups_, or -1
+        std::vector<Group> groups_;
+        int64_t utc_offset_seconds_{0};
+
+        // Private methods
+        static uint64_t cellKey(int64_t row, int64_t column);
+        static bool contains(const Zone &zone, double latitude, double longitude);
+        void matchZone(size_t zone_slot, size_t type, double speed_mps, int hour, int minute,
+                       std::vector<uint32_t> &matched) const;
+    };
+
+    /**
+     * @brief Evaluates a RulePlan against every machine's fixes
+     *
+     * Speed is derived from consecutive fixes of the same machine. Alerts are
+     * edge-triggered: Raised when a machine starts matching a rule and
+     * Cleared when it stops, never once per fix. Fixes older than the
+     * machine's latest are ignored.
+     *
+     * Not thread-safe; callers serialize access (the service does so under its
+     * own mutex).
+     */
+    class RuleEngine
+    {
+    public:
+        // Constructor
+        RuleEngine();
+
+        // Install a compiled plan. Active alerts of the previous plan are
+        // dropped without Cleared alerts; the next fixes raise them again
+        void setPlan(std::shared_ptr<const RulePlan> plan);
+        const std::shared_ptr<const RulePlan> &getPlan() const { return plan_; }
+
+        // Evaluate one fix of a machine
+        std::vector<RuleAlert> evaluate(const EquipmentId &id, EquipmentType type, const Position &position);
+
+        // Stop tracking a machine; clears its active alerts
+        std::vector<RuleAlert> remove(const EquipmentId &id);
+
+        // (machine, rule) pairs currently raised
+        std::vector<std::pair<EquipmentId, std::string>> getActiveAlerts() const;
+
+    private:
+        struct MachineState
+        {
+            Position last;
+            double speed_mps{0.0};
+            std::vector<uint32_t> active; // Raised rules, ascending
+        };
+
+        std::shared_ptr<const RulePlan> plan_;
+        std::unordered_map<EquipmentId, MachineState> machines_;
+        std::vector<uint32_t> matched_; // Reused across evaluations
+    };
+
+} // namespace equipment_tracker
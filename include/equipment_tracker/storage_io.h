@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "utils/constants.h"
+
+namespace equipment_tracker
+{
+
+    enum class IoBackendType
+    {
+        Auto,      // io_uring when the kernel allows it, otherwise a thread pool
+        IoUring,   // Linux io_uring; creation fails when unavailable
+        ThreadPool // Blocking pread/pwrite on worker threads
+    };
+
+    /**
+     * @brief Owning byte buffer with a guaranteed start alignment
+     */
+    class IoBuffer
+    {
+    public:
+        IoBuffer() = default;
+        explicit IoBuffer(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        static IoBuffer copyOf(const void *data, size_t size,
+                               size_t alignment = alignof(std::max_align_t));
+
+        char *data() { return data_; }
+        const char *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+    private:
+        std::unique_ptr<char[]> storage_;
+        char *data_{nullptr};
+        size_t size_{0};
+    };
+
+    /**
+     * @brief Outcome of one operation: bytes transferred (or 0) on success, -errno on failure
+     */
+    struct IoResult
+    {
+        int64_t result{0};
+        IoBuffer buffer; // The operation's buffer; holds the data for reads
+    };
+
+    using IoCompletion = std::function<void(IoResult &result)>;
+
+    /**
+     * @brief Counters for judging how well operations are batched
+     */
+    struct IoStats
+    {
+        uint64_t operations{0}; // Reads, writes and syncs completed
+        uint64_t syscalls{0};   // Kernel entries made to perform them
+        uint64_t batches{0};    // submit() calls that found work queued
+    };
+
+    /**
+     * @brief Asynchronous positional file I/O with batched submission
+     *
+     * Operations are queued and handed to the kernel (or to workers) together,
+     * either when IO_SUBMIT_BATCH_SIZE operations are waiting, when the oldest
+     * has waited IO_SUBMIT_MAX_DELAY, or on submit()/wait(). Completions run on
+     * a backend thread and must not call back into the backend.
+     *
+     * Operations on the same file are not ordered relative to each other;
+     * callers that need a sync to cover earlier writes wait() first.
+     */
+    class StorageIoBackend
+    {
+    public:
+        virtual ~StorageIoBackend() = default;
+
+        // Queue operations; reads fill the whole buffer starting at offset
+        virtual void submitWrite(int fd, IoBuffer buffer, uint64_t offset, IoCompletion done = {}) = 0;
+        virtual void submitRead(int fd, IoBuffer buffer, uint64_t offset, IoCompletion done) = 0;
+        virtual void submitSync(int fd, IoCompletion done = {}) = 0;
+
+        // Hand queued operations over now
+        virtual void submit() = 0;
+
+        // Submit and block until every operation issued so far has completed
+        virtual void wait() = 0;
+
+        virtual IoStats getStats() const = 0;
+        virtual const char *name() const = 0;
+    };
+
+    // Returns nullptr only when IoUring is requested and unavailable
+    std::unique_ptr<StorageIoBackend> createStorageIoBackend(
+        IoBackendType type = IoBackendType::Auto,
+        size_t worker_threads = DEFAULT_IO_WORKER_THREADS);
+
+} // namespace equipment_tracker
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace equipment_tracker
+{
+    // Bit-scan, popcount and prefetch helpers: GCC/Clang builtins, MSVC intrinsics,
+    // plain C++ elsewhere (the code base is C++17, so no <bit>)
+
+    // Index of the lowest set bit; x must be non-zero
+    inline unsigned countTrailingZeros(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        // 32-bit targets scan each half
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<unsigned long>(x)))
+        {
+            return static_cast<unsigned>(index);
+        }
+        _BitScanForward(&index, static_cast<unsigned long>(x >> 32));
+        return static_cast<unsigned>(index) + 32;
+#else
+        unsigned index = 0;
+        while ((x & 1) == 0)
+        {
+            x >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    // Number of set bits
+    inline unsigned countOnes(uint32_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcount(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return static_cast<unsigned>(__popcnt(x));
+#else
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        return static_cast<unsigned>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+    }
+
+    // Hint that the cache line at address will be read soon; a no-op where
+    // the compiler offers no portable hint (including MSVC)
+    inline void prefetchForRead(const void *address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+    }
+
+} // namespace equipment_tracker
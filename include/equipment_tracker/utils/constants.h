@@ -1,5 +1,6 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 
 namespace equipment_tracker
 {
@@ -11,9 +12,108 @@ namespace equipment_tracker
     constexpr size_t DEFAULT_MAX_HISTORY_SIZE = 100;     // Maximum history entries per equipment
     constexpr double EARTH_RADIUS_METERS = 6371000.0;    // Earth radius in meters for distance calculations
     constexpr double MOVEMENT_SPEED_THRESHOLD = 0.5;     // Speed threshold (m/s) to consider equipment is moving
+    constexpr size_t MIN_INTERPOLATION_BATCH_PER_THREAD = 64; // Equipment per worker before a batch query is split
+    constexpr size_t DEFAULT_HISTORY_MEMORY_BUDGET = 32 * 1024 * 1024; // In-memory position history across the fleet (bytes)
+
+    // Proximity detection
+    constexpr double DEFAULT_PROXIMITY_THRESHOLD_METERS = 10.0; // Default alert distance between two machines
+    constexpr double PROXIMITY_EXIT_HYSTERESIS = 1.1;           // Pairs separate at threshold * hysteresis to avoid flapping
+
+    // Utilization counters
+    constexpr double UTILIZATION_MAX_GAP_SECONDS = 300.0; // Longer gaps between fixes count as neither moving nor idle
+
+    // Anomaly detection
+    constexpr uint64_t ANOMALY_WARMUP_SAMPLES = 100;          // Fixes learned before speed and area baselines are trusted
+    constexpr double ANOMALY_MAX_INTERVAL_SECONDS = 300.0;    // Longer gaps between fixes teach nothing about speed or hours
+    constexpr double ANOMALY_SPEED_ALPHA = 0.01;              // Weight of the newest moving interval in the speed baseline
+    constexpr double ANOMALY_SPEED_SIGMAS = 4.0;              // Deviations above the mean speed that count as unusual
+    constexpr double ANOMALY_MIN_SPEED_DEVIATION_MPS = 1.0;   // Deviation floor, so steady machines are not flagged for small changes
+    constexpr double ANOMALY_TELEPORT_SPEED_MPS = 70.0;       // Implied speed no ground machine reaches (252 km/h)
+    constexpr double ANOMALY_TELEPORT_MIN_METERS = 100.0;     // Shorter jumps are left to GPS noise
+    constexpr double ANOMALY_RARE_HOUR_SHARE = 0.005;         // Hours of the week with less of the moving time are off-hours
+    constexpr double ANOMALY_AREA_CELL_DEGREES = 0.005;       // Operating-area grid cell (about 500 m)
+    constexpr size_t ANOMALY_AREA_CELLS = 64;                 // Most visited cells remembered per machine
+    constexpr uint32_t ANOMALY_AREA_MIN_VISITS = 10;          // Fixes in a cell before it counts as operating area
+    constexpr int ANOMALY_REPEAT_SECONDS = 900;               // An anomaly type is reported at most this often per machine
+
+    // Map matching
+    constexpr double MAP_MATCH_SEARCH_METERS = 50.0;      // Road edges farther from a fix are not candidates
+    constexpr size_t MAP_MATCH_MAX_CANDIDATES = 8;        // Nearest edges kept per fix
+    constexpr double MAP_MATCH_MIN_SIGMA_METERS = 4.0;    // GPS noise floor when a fix reports better accuracy
+    constexpr double MAP_MATCH_BETA_METERS = 10.0;        // Tolerated difference between road and straight-line distance
+    constexpr double MAP_MATCH_MAX_GAP_SECONDS = 120.0;   // Longer gaps restart the match
+    constexpr double MAP_MATCH_CELL_METERS = 50.0;        // Spatial edge index cell
+    constexpr size_t MAP_MATCH_MAX_CELLS = 1 << 22;       // Larger graphs get coarser index cells
+
+    // Rule engine
+    constexpr double RULE_ZONE_CELL_DEGREES = 0.01; // Grid cell used to find the zones around a fix
+    constexpr size_t RULE_ZONE_MAX_CELLS = 4096;    // Zones covering more cells are tested on every fix instead
+
+    // Fleet map tiles
+    constexpr int FLEET_TILE_POINT_ZOOM = 14;   // Zoom from which tiles list individual machines
+    constexpr int FLEET_TILE_CLUSTER_BITS = 3;  // Cluster tiles are split into 2^bits x 2^bits cells
+    constexpr int FLEET_TILE_CELL_ZOOM = FLEET_TILE_POINT_ZOOM - 1 + FLEET_TILE_CLUSTER_BITS; // Finest aggregated zoom
+    constexpr int FLEET_TILE_MAX_ZOOM = 22;     // Deepest tile served
+    constexpr size_t FLEET_TILE_CACHE_ENTRIES = 65536; // Built tiles kept before the cache is reset
+
+    // Site-local geometry
+    constexpr double DEFAULT_SITE_RADIUS_METERS = 10000.0; // Extent of an auto-created site projection
+
+    // Event delivery
+    constexpr size_t DEFAULT_EVENT_QUEUE_CAPACITY = 1024; // Pending events per queued subscriber before the oldest is dropped
+    constexpr size_t UPLINK_EVENT_QUEUE_CAPACITY = 65536; // Fixes the server uplink may fall behind by before the oldest is dropped
 
     // Database configuration
     constexpr const char *DEFAULT_DB_PATH = "equipment_tracker.db";
+    constexpr size_t DEFAULT_CHANGE_BATCH_SIZE = 256; // Change records returned per feed read
+    constexpr uint64_t CHANGE_SEGMENT_BYTES = 64ull << 20; // Active change log size that triggers rotation
+    constexpr size_t CHANGE_INDEX_INTERVAL = 256;          // Change records between sparse index entries
+    constexpr size_t EQUIPMENT_UPDATE_BATCH_SIZE = 256;    // Pending equipment updates that trigger a pack write
+    constexpr int EQUIPMENT_UPDATE_MAX_DELAY_MS = 1000;    // Oldest pending update waits at most this long
+    constexpr uint64_t PACK_COMPACTION_MIN_BYTES = 1 << 20; // Superseded and deleted pack bytes before compacting...
+    constexpr double PACK_COMPACTION_RATIO = 0.5;           // ...once they are also this share of all pack bytes
+
+    // Storage I/O
+    constexpr size_t IO_SUBMIT_BATCH_SIZE = 64;      // Queued operations that trigger a submission
+    constexpr int IO_SUBMIT_MAX_DELAY_US = 2000;     // Oldest queued operation waits at most this long
+    constexpr size_t DEFAULT_IO_WORKER_THREADS = 2;  // Workers for the thread-pool I/O backend
+    constexpr unsigned IO_URING_QUEUE_DEPTH = 256;   // Submission queue entries for io_uring
+    constexpr uint64_t POSITION_SEGMENT_SIZE = 256 * 1024; // Position log segment size (~5.4k fixes)
+    constexpr size_t DIRECT_IO_ALIGNMENT = 4096;           // Buffer, offset and length alignment for O_DIRECT
+    constexpr size_t POSITION_VERIFY_BATCH_SEGMENTS = 16;  // Segments read per batch when verifying a log
+
+    // History tiers
+    constexpr int64_t HOT_HISTORY_WINDOW_SECONDS = 3600;               // Recent fixes answered from RAM
+    constexpr int64_t WARM_HISTORY_WINDOW_SECONDS = 30 * 24 * 3600;    // Uncompressed, memory-mapped segments; older is archived
+    constexpr size_t POSITION_MAPPED_SEGMENTS = 8;                      // Warm segments kept mapped per position log
+
+    // History rollups
+    constexpr size_t ROLLUP_LEVEL_COUNT = 4;
+    constexpr int64_t ROLLUP_LEVEL_SECONDS[ROLLUP_LEVEL_COUNT] = {60, 900, 3600, 86400}; // Bucket widths kept per machine, finest first
+
+    // History export
+    constexpr size_t EXPORT_BUFFER_SIZE = 256 * 1024;             // Bytes collected before each write to the output stream
+    constexpr size_t ARROW_BATCH_ROWS = 64 * 1024;                // Rows per Arrow record batch
+    constexpr size_t ARROW_EXPORT_QUEUE_BYTES = 64 * 1024 * 1024; // Encoded batches allowed to wait for the writer
+
+    // Shared-memory fleet state
+    constexpr const char *DEFAULT_FLEET_STATE_NAME = "/equipment_tracker_fleet";
+    constexpr size_t DEFAULT_FLEET_STATE_CAPACITY = 4096; // Machines a published table can hold
+    constexpr size_t FLEET_STATE_ID_SIZE = 64;            // Bytes per ID in a table slot, including the NUL
+
+    // Clustering
+    constexpr size_t CLUSTER_VIRTUAL_NODES = 128;                // Ring points per node; more points even out the partition
+    constexpr const char *CLUSTER_DEFAULT_ADDRESS = "127.0.0.1"; // Nodes listen on loopback unless told otherwise
+    constexpr int CLUSTER_REQUEST_TIMEOUT_MS = 5000;             // Router gives up on a node after this long
+    constexpr size_t CLUSTER_MAX_FRAME_SIZE = 64 * 1024 * 1024;  // Larger frames are treated as a protocol error
+    constexpr size_t CLUSTER_HANDOFF_CHUNK_FIXES = 4096;         // Stored fixes per frame when a machine moves between nodes
+
+    // Replication
+    constexpr size_t REPLICATION_BATCH_SIZE = 512;                   // Change records shipped per batch
+    constexpr int REPLICATION_RETRY_INTERVAL_MS = 200;               // Primary reconnects to the standby this often
+    constexpr int REPLICATION_SYNC_TIMEOUT_MS = 5000;                // Synchronous commit stops waiting after this long
+    constexpr size_t REPLICATION_MAX_FRAME_SIZE = 16 * 1024 * 1024;  // Larger frames are treated as a protocol error
+    constexpr const char *REPLICATION_CONSUMER = "replication";      // Change-feed consumer holding the acknowledged LSN
 
     // Network configuration
     constexpr const char *DEFAULT_SERVER_URL = "https://tracking.example.com/api";
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace equipment_tracker
+{
+    // CRC-32C (Castagnoli) of a buffer, as used by iSCSI, ext4 and SCTP
+    uint32_t crc32c(const void *data, size_t size);
+
+    // Continue a checksum: crc32cExtend(crc32c(a), b) == crc32c(a + b)
+    uint32_t crc32cExtend(uint32_t crc, const void *data, size_t size);
+
+    // True when the CPU's CRC32 instructions are used (SSE4.2 or ARMv8 CRC)
+    bool crc32cIsHardwareAccelerated();
+
+    // "sse4.2", "armv8" or "table"
+    const char *crc32cImplementation();
+
+    // Table-driven implementation, exposed for tests and benchmarks
+    uint32_t crc32cExtendSoftware(uint32_t crc, const void *data, size_t size);
+
+} // namespace equipment_tracker
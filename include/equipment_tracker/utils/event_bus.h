@@ -0,0 +1,341 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "equipment_tracker/utils/constants.h"
+
+namespace equipment_tracker
+{
+
+    enum class DeliveryMode
+    {
+        Synchronous, // Handler runs on the publishing thread
+        Queued       // Handler runs on the subscriber's own worker thread
+    };
+
+    using SubscriptionId = uint64_t;
+
+    /**
+     * @brief Delivery counters for one subscriber
+     */
+    struct SubscriberStats
+    {
+        SubscriptionId id{0};
+        std::string name;
+        DeliveryMode mode{DeliveryMode::Queued};
+        uint64_t published{0};  // Events offered to this subscriber
+        uint64_t delivered{0};  // Events its handler has finished
+        uint64_t dropped{0};    // Events discarded because its queue was full
+        uint64_t failed{0};     // Handler invocations that threw
+        size_t queue_depth{0};  // Events waiting right now
+        size_t queue_capacity{0}; // Queued only: depth at which the oldest event is dropped
+        std::chrono::nanoseconds last_lag{0}; // Publish-to-handler delay of the latest event
+        std::chrono::nanoseconds max_lag{0};  // Worst publish-to-handler delay seen
+    };
+
+    /**
+     * @brief Typed publish/subscribe bus with per-subscriber isolation
+     *
+     * Queued subscribers get a bounded queue and a dedicated worker thread, so
+     * a slow handler only backs up its own queue; when that queue is full the
+     * oldest event is dropped and counted rather than blocking the publisher.
+     * Synchronous subscribers run inline and are meant for cheap handlers.
+     *
+     * publish() never takes a lock shared with subscribe()/unsubscribe(): the
+     * subscriber list is an immutable vector swapped atomically on change.
+     */
+    template <typename Event>
+    class EventBus
+    {
+    public:
+        using Handler = std::function<void(const Event &event)>;
+
+        EventBus() : subscribers_(std::make_shared<const SubscriberList>()) {}
+
+        ~EventBus() { shutdown(); }
+
+        EventBus(const EventBus &) = delete;
+        EventBus &operator=(const EventBus &) = delete;
+
+        // Subscription management
+        SubscriptionId subscribe(std::string name, Handler handler,
+                                 DeliveryMode mode = DeliveryMode::Queued,
+                                 size_t queue_capacity = DEFAULT_EVENT_QUEUE_CAPACITY)
+        {
+            auto subscriber = std::make_shared<Subscriber>();
+            subscriber->stats.name = std::move(name);
+            subscriber->stats.mode = mode;
+            subscriber->handler = std::move(handler);
+            subscriber->capacity = std::max<size_t>(1, queue_capacity);
+
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            subscriber->stats.id = ++next_id_;
+
+            if (mode == DeliveryMode::Queued)
+            {
+                subscriber->worker = std::thread(&EventBus::runWorker, subscriber);
+            }
+
+            auto next = std::make_shared<SubscriberList>(*std::atomic_load(&subscribers_));
+            next->push_back(subscriber);
+            std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(next)));
+
+            return subscriber->stats.id;
+        }
+
+        bool unsubscribe(SubscriptionId id)
+        {
+            std::shared_ptr<Subscriber> removed;
+            {
+                std::lock_guard<std::mutex> lock(registry_mutex_);
+
+                auto next = std::make_shared<SubscriberList>(*std::atomic_load(&subscribers_));
+                auto it = std::find_if(next->begin(), next->end(),
+                                       [id](const auto &subscriber)
+                                       { return subscriber->stats.id == id; });
+                if (it == next->end())
+                {
+                    return false;
+                }
+
+                removed = *it;
+                next->erase(it);
+                std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(next)));
+            }
+
+            stopWorker(*removed);
+            return true;
+        }
+
+        // Deliver an event to every subscriber
+        void publish(const Event &event)
+        {
+            auto subscribers = std::atomic_load(&subscribers_);
+            const auto now = std::chrono::steady_clock::now();
+
+            for (const auto &subscriber : *subscribers)
+            {
+                if (subscriber->stats.mode == DeliveryMode::Synchronous)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(subscriber->mutex);
+                        ++subscriber->stats.published;
+                    }
+                    invoke(*subscriber, event, now);
+                    continue;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(subscriber->mutex);
+                    if (subscriber->stopping)
+                    {
+                        continue;
+                    }
+
+                    ++subscriber->stats.published;
+                    if (subscriber->queue.size() >= subscriber->capacity)
+                    {
+                        // Shed the stalest event rather than stall the publisher
+                        subscriber->queue.pop_front();
+                        ++subscriber->stats.dropped;
+                    }
+                    subscriber->queue.emplace_back(event, now);
+                }
+                subscriber->wake.notify_one();
+            }
+        }
+
+        // Block until every queued subscriber has processed what it was given
+        void flush()
+        {
+            auto subscribers = std::atomic_load(&subscribers_);
+
+            for (const auto &subscriber : *subscribers)
+            {
+                std::unique_lock<std::mutex> lock(subscriber->mutex);
+                subscriber->idle.wait(lock, [&]
+                                      { return subscriber->stopping ||
+                                               (subscriber->queue.empty() && !subscriber->busy); });
+            }
+        }
+
+        // Stop all workers; pending events are discarded
+        void shutdown()
+        {
+            std::shared_ptr<const SubscriberList> subscribers;
+            {
+                std::lock_guard<std::mutex> lock(registry_mutex_);
+                subscribers = std::atomic_load(&subscribers_);
+                std::atomic_store(&subscribers_, std::make_shared<const SubscriberList>());
+            }
+
+            for (const auto &subscriber : *subscribers)
+            {
+                stopWorker(*subscriber);
+            }
+        }
+
+        // Metrics
+        size_t subscriberCount() const { return std::atomic_load(&subscribers_)->size(); }
+
+        std::optional<SubscriberStats> getStats(SubscriptionId id) const
+        {
+            auto subscribers = std::atomic_load(&subscribers_);
+            for (const auto &subscriber : *subscribers)
+            {
+                if (subscriber->stats.id == id)
+                {
+                    return snapshotStats(*subscriber);
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::vector<SubscriberStats> getAllStats() const
+        {
+            auto subscribers = std::atomic_load(&subscribers_);
+
+            std::vector<SubscriberStats> result;
+            result.reserve(subscribers->size());
+            for (const auto &subscriber : *subscribers)
+            {
+                result.push_back(snapshotStats(*subscriber));
+            }
+            return result;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Subscriber
+        {
+            Handler handler;
+            size_t capacity{DEFAULT_EVENT_QUEUE_CAPACITY};
+
+            std::mutex mutex; // Guards everything below
+            std::condition_variable wake;
+            std::condition_variable idle;
+            std::deque<std::pair<Event, Clock::time_point>> queue;
+            SubscriberStats stats;
+            bool busy{false};
+            bool stopping{false};
+
+            std::thread worker;
+        };
+
+        using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+        std::shared_ptr<const SubscriberList> subscribers_;
+        std::mutex registry_mutex_; // Serializes subscribe/unsubscribe/shutdown
+        SubscriptionId next_id_{0};
+
+        static void invoke(Subscriber &subscriber, const Event &event, Clock::time_point published_at)
+        {
+            auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - published_at);
+
+            bool failed = false;
+            try
+            {
+                subscriber.handler(event);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Event subscriber '" << subscriber.stats.name << "' failed: " << e.what() << std::endl;
+                failed = true;
+            }
+
+            std::lock_guard<std::mutex> lock(subscriber.mutex);
+            ++subscriber.stats.delivered;
+            if (failed)
+            {
+                ++subscriber.stats.failed;
+            }
+            subscriber.stats.last_lag = lag;
+            subscriber.stats.max_lag = std::max(subscriber.stats.max_lag, lag);
+        }
+
+        static void runWorker(std::shared_ptr<Subscriber> subscriber)
+        {
+            std::unique_lock<std::mutex> lock(subscriber->mutex);
+
+            while (true)
+            {
+                subscriber->wake.wait(lock, [subscriber]
+                                      { return subscriber->stopping || !subscriber->queue.empty(); });
+                if (subscriber->stopping)
+                {
+                    break;
+                }
+
+                auto [event, published_at] = std::move(subscriber->queue.front());
+                subscriber->queue.pop_front();
+                subscriber->busy = true;
+
+                lock.unlock();
+                invoke(*subscriber, event, published_at);
+                lock.lock();
+
+                subscriber->busy = false;
+                if (subscriber->queue.empty())
+                {
+                    subscriber->idle.notify_all();
+                }
+            }
+
+            subscriber->idle.notify_all();
+        }
+
+        static void stopWorker(Subscriber &subscriber)
+        {
+            {
+                std::lock_guard<std::mutex> lock(subscriber.mutex);
+                subscriber.stopping = true;
+                subscriber.queue.clear();
+            }
+            subscriber.wake.notify_all();
+            subscriber.idle.notify_all();
+
+            if (!subscriber.worker.joinable())
+            {
+                return;
+            }
+
+            if (subscriber.worker.get_id() == std::this_thread::get_id())
+            {
+                // A handler unsubscribed itself; the worker owns a reference and exits on its own
+                subscriber.worker.detach();
+            }
+            else
+            {
+                subscriber.worker.join();
+            }
+        }
+
+        static SubscriberStats snapshotStats(Subscriber &subscriber)
+        {
+            std::lock_guard<std::mutex> lock(subscriber.mutex);
+            SubscriberStats stats = subscriber.stats;
+            stats.queue_depth = subscriber.queue.size();
+            if (stats.mode == DeliveryMode::Queued)
+            {
+                stats.queue_capacity = subscriber.capacity;
+            }
+            return stats;
+        }
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "equipment_tracker/utils/bit_utils.h"
+#include "equipment_tracker/utils/types.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Open-addressing hash map keyed by EquipmentId (Swiss-table style)
+     *
+     * Layout:
+     * - Entries live contiguously in insertion order, so iteration is a linear
+     *   scan and `for (auto &[id, value] : map)` works as with std::unordered_map.
+     * - A control byte per slot holds 7 bits of the hash (or empty/deleted);
+     *   lookups compare 8 control bytes at a time with SWAR bit tricks and only
+     *   touch an entry when its tag matches.
+     * - Lookups accept std::string_view, so callers never build a temporary
+     *   std::string.
+     * - Handles stay valid across inserts, rehashes and erasure of other
+     *   entries, unlike iterators and references (erase moves the last entry
+     *   into the hole).
+     *
+     * Not thread-safe; owners provide their own locking.
+     */
+    template <typename Value>
+    class FlatHashMap
+    {
+    public:
+        struct Entry
+        {
+            EquipmentId first;
+            Value second;
+        };
+
+        /**
+         * @brief Stable reference to an entry, invalidated only when it is erased
+         */
+        struct Handle
+        {
+            uint32_t index{0};
+            uint32_t generation{0};
+        };
+
+        using iterator = typename std::vector<Entry>::iterator;
+        using const_iterator = typename std::vector<Entry>::const_iterator;
+
+        FlatHashMap() = default;
+
+        // Capacity
+        size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+        size_t capacity() const { return capacity_; }
+
+        void reserve(size_t count)
+        {
+            size_t needed = GROUP_WIDTH;
+            while (needed * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR < count)
+            {
+                needed *= 2;
+            }
+            if (needed > capacity_)
+            {
+                rehash(needed);
+            }
+            entries_.reserve(count);
+            entry_hashes_.reserve(count);
+            entry_handles_.reserve(count);
+        }
+
+        void clear()
+        {
+            // Release rather than drop handles so stale ones never alias new entries
+            for (const auto &handle : entry_handles_)
+            {
+                releaseHandle(handle);
+            }
+
+            entries_.clear();
+            entry_hashes_.clear();
+            entry_handles_.clear();
+            ctrl_.assign(ctrl_.size(), CTRL_EMPTY);
+            deleted_ = 0;
+        }
+
+        // Iteration (insertion order until an erase)
+        iterator begin() { return entries_.begin(); }
+        iterator end() { return entries_.end(); }
+        const_iterator begin() const { return entries_.begin(); }
+        const_iterator end() const { return entries_.end(); }
+
+        // Lookup
+        iterator find(std::string_view key)
+        {
+            size_t index = findIndex(key, hashKey(key));
+            return index == NPOS ? entries_.end() : entries_.begin() + index;
+        }
+
+        const_iterator find(std::string_view key) const
+        {
+            size_t index = findIndex(key, hashKey(key));
+            return index == NPOS ? entries_.end() : entries_.begin() + index;
+        }
+
+        bool contains(std::string_view key) const
+        {
+            return findIndex(key, hashKey(key)) != NPOS;
+        }
+
+        size_t count(std::string_view key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        Value &at(std::string_view key)
+        {
+            auto it = find(key);
+            if (it == end())
+            {
+                throw std::out_of_range("FlatHashMap::at: key not found");
+            }
+            return it->second;
+        }
+
+        const Value &at(std::string_view key) const
+        {
+            auto it = find(key);
+            if (it == end())
+            {
+                throw std::out_of_range("FlatHashMap::at: key not found");
+            }
+            return it->second;
+        }
+
+        // Modifiers
+        /**
+         * @brief Insert a value constructed from args unless the key exists
+         * @return Iterator to the entry and whether an insertion happened
+         */
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(std::string_view key, Args &&...args)
+        {
+            size_t hash = hashKey(key);
+            size_t existing = findIndex(key, hash);
+            if (existing != NPOS)
+            {
+                return {entries_.begin() + existing, false};
+            }
+
+            if ((entries_.size() + deleted_ + 1) * MAX_LOAD_DENOMINATOR >
+                capacity_ * MAX_LOAD_NUMERATOR)
+            {
+                // Reclaim tombstones in place when they dominate, otherwise grow
+                size_t new_capacity = capacity_ == 0 ? GROUP_WIDTH : capacity_;
+                if (entries_.size() * 2 >= new_capacity * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR)
+                {
+                    new_capacity *= 2;
+                }
+                rehash(new_capacity);
+            }
+
+            uint32_t dense = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(Entry{EquipmentId(key), Value(std::forward<Args>(args)...)});
+            entry_hashes_.push_back(hash);
+            entry_handles_.push_back(allocateHandle(dense));
+
+            size_t slot = findInsertSlot(hash);
+            if (ctrl_[slot] == CTRL_DELETED)
+            {
+                --deleted_;
+            }
+            setCtrl(slot, tagOf(hash));
+            slots_[slot] = dense;
+
+            return {entries_.begin() + dense, true};
+        }
+
+        std::pair<iterator, bool> insert(std::string_view key, const Value &value)
+        {
+            return try_emplace(key, value);
+        }
+
+        /**
+         * @brief Remove the entry for key; the last entry moves into its place
+         * @return Number of entries removed (0 or 1)
+         */
+        size_t erase(std::string_view key)
+        {
+            size_t hash = hashKey(key);
+            size_t slot = findSlot(key, hash);
+            if (slot == NPOS)
+            {
+                return 0;
+            }
+
+            uint32_t dense = slots_[slot];
+            setCtrl(slot, CTRL_DELETED);
+            ++deleted_;
+            releaseHandle(entry_handles_[dense]);
+
+            uint32_t last = static_cast<uint32_t>(entries_.size() - 1);
+            if (dense != last)
+            {
+                // Re-point the slot and handle of the entry being moved
+                size_t moved_slot = findSlot(entries_[last].first, entry_hashes_[last]);
+                slots_[moved_slot] = dense;
+                handle_slots_[entry_handles_[last].index].dense = dense;
+
+                entries_[dense] = std::move(entries_[last]);
+                entry_hashes_[dense] = entry_hashes_[last];
+                entry_handles_[dense] = entry_handles_[last];
+            }
+
+            entries_.pop_back();
+            entry_hashes_.pop_back();
+            entry_handles_.pop_back();
+            return 1;
+        }
+
+        // Stable handles
+        std::optional<Handle> findHandle(std::string_view key) const
+        {
+            size_t index = findIndex(key, hashKey(key));
+            if (index == NPOS)
+            {
+                return std::nullopt;
+            }
+            return entry_handles_[index];
+        }
+
+        Entry *get(const Handle &handle)
+        {
+            return const_cast<Entry *>(static_cast<const FlatHashMap *>(this)->get(handle));
+        }
+
+        const Entry *get(const Handle &handle) const
+        {
+            if (handle.index >= handle_slots_.size())
+            {
+                return nullptr;
+            }
+
+            const HandleSlot &slot = handle_slots_[handle.index];
+            if (slot.generation != handle.generation || slot.dense == NO_ENTRY)
+            {
+                return nullptr;
+            }
+            return &entries_[slot.dense];
+        }
+
+    private:
+        using ctrl_t = int8_t;
+
+        static constexpr size_t GROUP_WIDTH = 8;
+        static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+        static constexpr size_t MAX_LOAD_DENOMINATOR = 8;
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+        static constexpr uint32_t NO_ENTRY = static_cast<uint32_t>(-1);
+
+        // Full slots hold a 7-bit tag (high bit clear); specials have it set
+        static constexpr ctrl_t CTRL_EMPTY = static_cast<ctrl_t>(0x80);
+        static constexpr ctrl_t CTRL_DELETED = static_cast<ctrl_t>(0xFE);
+
+        static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+        static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+        struct HandleSlot
+        {
+            uint32_t dense;
+            uint32_t generation;
+        };
+
+        std::vector<Entry> entries_;
+        std::vector<size_t> entry_hashes_;
+        std::vector<Handle> entry_handles_;
+
+        // ctrl_ has GROUP_WIDTH mirrored bytes past capacity_ so a group load
+        // never needs to wrap around
+        std::vector<ctrl_t> ctrl_;
+        std::vector<uint32_t> slots_;
+        size_t capacity_{0};
+        size_t deleted_{0};
+
+        std::vector<HandleSlot> handle_slots_;
+        std::vector<uint32_t> free_handles_;
+
+        static size_t hashKey(std::string_view key)
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+
+        static ctrl_t tagOf(size_t hash)
+        {
+            return static_cast<ctrl_t>(hash & 0x7F);
+        }
+
+        static size_t probeStart(size_t hash)
+        {
+            return hash >> 7;
+        }
+
+        uint64_t loadGroup(size_t pos) const
+        {
+            uint64_t group;
+            std::memcpy(&group, ctrl_.data() + pos, sizeof(group));
+            return group;
+        }
+
+        // Bytes equal to tag (may yield rare false positives; keys are compared anyway)
+        static uint64_t matchTag(uint64_t group, ctrl_t tag)
+        {
+            uint64_t x = group ^ (LSBS * static_cast<uint8_t>(tag));
+            return (x - LSBS) & ~x & MSBS;
+        }
+
+        static uint64_t matchEmpty(uint64_t group)
+        {
+            return group & ~(group << 6) & MSBS;
+        }
+
+        static uint64_t matchEmptyOrDeleted(uint64_t group)
+        {
+            return group & MSBS;
+        }
+
+        static size_t lowestByte(uint64_t mask)
+        {
+            // Group bytes are loaded little-endian: byte i maps to bits 8i..8i+7
+            return static_cast<size_t>(countTrailingZeros(mask)) / 8;
+        }
+
+        void setCtrl(size_t slot, ctrl_t value)
+        {
+            ctrl_[slot] = value;
+            if (slot < GROUP_WIDTH)
+            {
+                ctrl_[capacity_ + slot] = value;
+            }
+        }
+
+        size_t findSlot(std::string_view key, size_t hash) const
+        {
+            if (capacity_ == 0)
+            {
+                return NPOS;
+            }
+
+            const size_t mask = capacity_ - 1;
+            const ctrl_t tag = tagOf(hash);
+            size_t pos = probeStart(hash) & mask;
+
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH)
+            {
+                // Overlap the slot-array miss with the control-byte miss
+                prefetchForRead(slots_.data() + pos);
+                uint64_t group = loadGroup(pos);
+
+                for (uint64_t match = matchTag(group, tag); match != 0; match &= match - 1)
+                {
+                    size_t slot = (pos + lowestByte(match)) & mask;
+                    if (ctrl_[slot] == tag && entries_[slots_[slot]].first == key)
+                    {
+                        return slot;
+                    }
+                }
+
+                if (matchEmpty(group) != 0)
+                {
+                    return NPOS;
+                }
+
+                // Triangular probing visits every group when capacity is a power of two
+                pos = (pos + step) & mask;
+            }
+        }
+
+        size_t findIndex(std::string_view key, size_t hash) const
+        {
+            size_t slot = findSlot(key, hash);
+            return slot == NPOS ? NPOS : slots_[slot];
+        }
+
+        size_t findInsertSlot(size_t hash) const
+        {
+            const size_t mask = capacity_ - 1;
+            size_t pos = probeStart(hash) & mask;
+
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH)
+            {
+                uint64_t match = matchEmptyOrDeleted(loadGroup(pos));
+                if (match != 0)
+                {
+                    return (pos + lowestByte(match)) & mask;
+                }
+                pos = (pos + step) & mask;
+            }
+        }
+
+        void rehash(size_t new_capacity)
+        {
+            capacity_ = new_capacity;
+            ctrl_.assign(capacity_ + GROUP_WIDTH, CTRL_EMPTY);
+            slots_.assign(capacity_, 0);
+            deleted_ = 0;
+
+            for (uint32_t dense = 0; dense < entries_.size(); ++dense)
+            {
+                size_t slot = findInsertSlot(entry_hashes_[dense]);
+                setCtrl(slot, tagOf(entry_hashes_[dense]));
+                slots_[slot] = dense;
+            }
+        }
+
+        Handle allocateHandle(uint32_t dense)
+        {
+            if (!free_handles_.empty())
+            {
+                uint32_t index = free_handles_.back();
+                free_handles_.pop_back();
+                handle_slots_[index].dense = dense;
+                return Handle{index, handle_slots_[index].generation};
+            }
+
+            handle_slots_.push_back(HandleSlot{dense, 0});
+            return Handle{static_cast<uint32_t>(handle_slots_.size() - 1), 0};
+        }
+
+        void releaseHandle(const Handle &handle)
+        {
+            HandleSlot &slot = handle_slots_[handle.index];
+            slot.dense = NO_ENTRY;
+            ++slot.generation;
+            free_handles_.push_back(handle.index);
+        }
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "equipment_tracker/utils/bit_utils.h"
+#include "equipment_tracker/utils/types.h"
+
+namespace equipment_tracker
+{
+
+    /**
+     * @brief Immutable hash array mapped trie keyed by EquipmentId
+     *
+     * Every modification returns a new map that shares all untouched nodes with
+     * the original, so a new version costs O(log32 n) node copies rather than a
+     * copy of the whole map. Existing versions are never mutated and can be read
+     * from any thread without locking; nodes are reclaimed when the last version
+     * referencing them is released.
+     */
+    template <typename Value>
+    class PersistentHashMap
+    {
+    public:
+        PersistentHashMap() = default;
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        // Lookup; returns nullptr when the key is absent
+        const Value *find(std::string_view key) const
+        {
+            if (!root_)
+            {
+                return nullptr;
+            }
+
+            size_t hash = hashKey(key);
+            const Node *node = root_.get();
+
+            for (size_t depth = 0; depth < MAX_DEPTH; ++depth)
+            {
+                uint32_t bit = bitFor(hash, depth);
+                if ((node->bitmap & bit) == 0)
+                {
+                    return nullptr;
+                }
+
+                const Child &child = node->children[indexFor(node->bitmap, bit)];
+                if (child.leaf)
+                {
+                    return child.leaf->key == key ? &child.leaf->value : nullptr;
+                }
+                node = child.node.get();
+            }
+
+            for (const auto &leaf : node->collisions)
+            {
+                if (leaf->key == key)
+                {
+                    return &leaf->value;
+                }
+            }
+            return nullptr;
+        }
+
+        // Returns a new version with key mapped to value
+        PersistentHashMap set(const EquipmentId &key, Value value) const
+        {
+            auto leaf = std::make_shared<const Leaf>(Leaf{hashKey(key), key, std::move(value)});
+
+            bool added = false;
+            PersistentHashMap result;
+            result.root_ = insert(root_, 0, leaf, added);
+            result.size_ = size_ + (added ? 1 : 0);
+            return result;
+        }
+
+        // Returns a new version without key (or an identical version if absent)
+        PersistentHashMap erase(std::string_view key) const
+        {
+            if (!root_)
+            {
+                return *this;
+            }
+
+            bool removed = false;
+            PersistentHashMap result;
+            result.root_ = remove(root_, 0, hashKey(key), key, removed);
+            result.size_ = size_ - (removed ? 1 : 0);
+            return removed ? result : *this;
+        }
+
+        // Visit every entry; fn(const EquipmentId&, const Value&)
+        template <typename Fn>
+        void forEach(Fn &&fn) const
+        {
+            if (root_)
+            {
+                visit(*root_, fn);
+            }
+        }
+
+    private:
+        static constexpr size_t BITS_PER_LEVEL = 5;
+        static constexpr size_t MAX_DEPTH = (sizeof(size_t) * 8) / BITS_PER_LEVEL;
+
+        struct Leaf
+        {
+            size_t hash;
+            EquipmentId key;
+            Value value;
+        };
+
+        struct Node;
+
+        struct Child
+        {
+            std::shared_ptr<const Node> node;
+            std::shared_ptr<const Leaf> leaf;
+        };
+
+        struct Node
+        {
+            uint32_t bitmap{0};
+            std::vector<Child> children;                        // Branch levels
+            std::vector<std::shared_ptr<const Leaf>> collisions; // Past the last level
+        };
+
+        std::shared_ptr<const Node> root_;
+        size_t size_{0};
+
+        static size_t hashKey(std::string_view key)
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+
+        static uint32_t bitFor(size_t hash, size_t depth)
+        {
+            return uint32_t{1} << ((hash >> (depth * BITS_PER_LEVEL)) & 0x1F);
+        }
+
+        static size_t indexFor(uint32_t bitmap, uint32_t bit)
+        {
+            return static_cast<size_t>(countOnes(bitmap & (bit - 1)));
+        }
+
+        static std::shared_ptr<const Node> insert(const std::shared_ptr<const Node> &node,
+                                                  size_t depth,
+                                                  const std::shared_ptr<const Leaf> &leaf,
+                                                  bool &added)
+        {
+            auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+
+            if (depth >= MAX_DEPTH)
+            {
+                for (auto &existing : copy->collisions)
+                {
+                    if (existing->key == leaf->key)
+                    {
+                        existing = leaf;
+                        return copy;
+                    }
+                }
+                copy->collisions.push_back(leaf);
+                added = true;
+                return copy;
+            }
+
+            uint32_t bit = bitFor(leaf->hash, depth);
+            size_t index = indexFor(copy->bitmap, bit);
+
+            if ((copy->bitmap & bit) == 0)
+            {
+                copy->bitmap |= bit;
+                copy->children.insert(copy->children.begin() + index, Child{nullptr, leaf});
+                added = true;
+                return copy;
+            }
+
+            Child &child = copy->children[index];
+            if (child.leaf)
+            {
+                if (child.leaf->key == leaf->key)
+                {
+                    child.leaf = leaf;
+                    return copy;
+                }
+
+                // Two keys share this prefix: push both one level down
+                bool ignored = false;
+                auto subnode = insert(nullptr, depth + 1, child.leaf, ignored);
+                subnode = insert(subnode, depth + 1, leaf, added);
+                child = Child{subnode, nullptr};
+                return copy;
+            }
+
+            child.node = insert(child.node, depth + 1, leaf, added);
+            return copy;
+        }
+
+        static std::shared_ptr<const Node> remove(const std::shared_ptr<const Node> &node,
+                                                  size_t depth, size_t hash,
+                                                  std::string_view key, bool &removed)
+        {
+            if (depth >= MAX_DEPTH)
+            {
+                auto copy = std::make_shared<Node>(*node);
+                for (auto it = copy->collisions.begin(); it != copy->collisions.end(); ++it)
+                {
+                    if ((*it)->key == key)
+                    {
+                        copy->collisions.erase(it);
+                        removed = true;
+                        break;
+                    }
+                }
+                return copy->collisions.empty() ? nullptr : copy;
+            }
+
+            uint32_t bit = bitFor(hash, depth);
+            if ((node->bitmap & bit) == 0)
+            {
+                return node;
+            }
+
+            size_t index = indexFor(node->bitmap, bit);
+            const Child &child = node->children[index];
+
+            std::shared_ptr<const Node> replacement;
+            if (child.leaf)
+            {
+                if (child.leaf->key != key)
+                {
+                    return node;
+                }
+                removed = true;
+            }
+            else
+            {
+                replacement = remove(child.node, depth + 1, hash, key, removed);
+                if (!removed)
+                {
+                    return node;
+                }
+            }
+
+            auto copy = std::make_shared<Node>(*node);
+            if (replacement)
+            {
+                copy->children[index] = Child{replacement, nullptr};
+            }
+            else
+            {
+                copy->bitmap &= ~bit;
+                copy->children.erase(copy->children.begin() + index);
+            }
+
+            return copy->children.empty() ? nullptr : copy;
+        }
+
+        template <typename Fn>
+        static void visit(const Node &node, Fn &fn)
+        {
+            for (const auto &child : node.children)
+            {
+                if (child.leaf)
+                {
+                    fn(child.leaf->key, child.leaf->value);
+                }
+                else
+                {
+                    visit(*child.node, fn);
+                }
+            }
+            for (const auto &leaf : node.collisions)
+            {
+                fn(leaf->key, leaf->value);
+            }
+        }
+    };
+
+} // namespace equipment_tracker
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace equipment_tracker
+{
+    // Blocking TCP helpers for the cluster and replication transports. Every
+    // message is framed as its body length in decimal, a newline and the
+    // body. All functions fail (-1 / false) on platforms without POSIX sockets.
+
+    // Listen on address:port; port 0 picks a free port and is updated.
+    // Returns the listening socket, or -1
+    int listenTcp(const std::string &address, uint16_t &port);
+
+    // Connect with TCP_NODELAY; sends and receives time out after timeout_ms.
+    // Returns the socket, or -1
+    int connectTcp(const std::string &address, uint16_t port, int timeout_ms);
+
+    // Accept the next connection (TCP_NODELAY); -1 once the socket is shut down
+    int acceptTcp(int listen_fd);
+
+    // Wake threads blocked on the socket, then close it
+    void shutdownSocket(int fd);
+    void closeSocket(int fd);
+
+    // Send one frame
+    bool writeFrame(int fd, const std::string &body);
+
+    // Receive one frame; buffer keeps bytes read past it for the next call.
+    // False on disconnect, timeout or a malformed or oversized frame
+    bool readFrame(int fd, std::string &buffer, std::string &body, size_t max_size);
+
+} // namespace equipment_tracker
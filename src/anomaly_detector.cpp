@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cmath>
+#include "equipment_tracker/anomaly_detector.h"
+
+namespace equipment_tracker
+{
+
+    std::vector<AnomalyEvent> AnomalyDetector::observe(const EquipmentId &id, const Position &position)
+    {
+        std::vector<AnomalyEvent> events;
+        Timestamp now = position.getTimestamp();
+        double latitude = position.getLatitude();
+        double longitude = position.getLongitude();
+        uint64_t cell = cellKey(static_cast<int64_t>(std::floor(latitude / ANOMALY_AREA_CELL_DEGREES)),
+                                static_cast<int64_t>(std::floor(longitude / ANOMALY_AREA_CELL_DEGREES)));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto [it, inserted] = assets_.try_emplace(id);
+        Asset &asset = it->second;
+        if (inserted)
+        {
+            asset.last = position;
+            asset.first_seen = now;
+            asset.samples = 1;
+            learnArea(asset, cell);
+            return events;
+        }
+        if (now <= asset.last.getTimestamp())
+        {
+            return events;
+        }
+
+        double seconds = std::chrono::duration<double>(now - asset.last.getTimestamp()).count();
+        double meters = asset.last.distanceTo(position);
+        double speed = meters / seconds;
+        // Impossible speeds over short jumps are GPS noise: not reported, not learned
+        bool implausible = speed > ANOMALY_TELEPORT_SPEED_MPS;
+        bool teleport = implausible && meters > ANOMALY_TELEPORT_MIN_METERS;
+        bool moving = !implausible && seconds <= ANOMALY_MAX_INTERVAL_SECONDS && speed > MOVEMENT_SPEED_THRESHOLD;
+        auto hour = static_cast<size_t>(
+            std::chrono::duration_cast<std::chrono::hours>(now.time_since_epoch()).count() % HOURS_PER_WEEK);
+
+        auto report = [&](AnomalyType type)
+        {
+            Timestamp &last = asset.last_reported[static_cast<size_t>(type)];
+            if (last != Timestamp() && now - last < std::chrono::seconds(ANOMALY_REPEAT_SECONDS))
+            {
+                return;
+            }
+            last = now;
+            events.push_back(AnomalyEvent{id, type, position, speed, meters});
+        };
+
+        // Check against what was learned before this fix
+        if (teleport)
+        {
+            report(AnomalyType::Teleport);
+        }
+        if (moving && asset.moving_samples >= ANOMALY_WARMUP_SAMPLES &&
+            speed > asset.mean_speed + ANOMALY_SPEED_SIGMAS * std::max(std::sqrt(asset.speed_variance),
+                                                                       ANOMALY_MIN_SPEED_DEVIATION_MPS))
+        {
+            report(AnomalyType::UnusualSpeed);
+        }
+        if (moving && now - asset.first_seen >= std::chrono::hours(HOURS_PER_WEEK) &&
+            asset.hours_total >= ANOMALY_WARMUP_SAMPLES &&
+            asset.hours[hour] < ANOMALY_RARE_HOUR_SHARE * asset.hours_total)
+        {
+            report(AnomalyType::OffHoursMovement);
+        }
+        if (asset.samples >= ANOMALY_WARMUP_SAMPLES && !knownArea(asset, latitude, longitude))
+        {
+            report(AnomalyType::LeftOperatingArea);
+        }
+
+        // Learn from it. A teleport still moves the machine, so one faulty fix
+        // is not compared against every fix that follows
+        ++asset.samples;
+        learnArea(asset, cell);
+        if (moving)
+        {
+            ++asset.moving_samples;
+            learnSpeed(asset, speed);
+            learnHour(asset, hour);
+        }
+        asset.last = position;
+
+        return events;
+    }
+
+    void AnomalyDetector::remove(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        assets_.erase(id);
+    }
+
+    std::optional<AnomalyBaseline> AnomalyDetector::getBaseline(const EquipmentId &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = assets_.find(id);
+        if (it == assets_.end())
+        {
+            return std::nullopt;
+        }
+
+        const Asset &asset = it->second;
+        AnomalyBaseline baseline;
+        baseline.samples = asset.samples;
+        baseline.moving_samples = asset.moving_samples;
+        baseline.mean_speed_mps = asset.mean_speed;
+        baseline.speed_deviation_mps = std::sqrt(asset.speed_variance);
+        baseline.known_cells = static_cast<size_t>(std::count_if(
+            asset.cells.begin(), asset.cells.begin() + asset.cell_count,
+            [](const AreaCell &cell)
+            {
+                return cell.count - cell.error >= ANOMALY_AREA_MIN_VISITS;
+            }));
+        baseline.first_seen = asset.first_seen;
+        return baseline;
+    }
+
+    size_t AnomalyDetector::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return assets_.size();
+    }
+
+    uint64_t AnomalyDetector::cellKey(int64_t row, int64_t column)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) |
+               static_cast<uint32_t>(column);
+    }
+
+    bool AnomalyDetector::knownArea(const Asset &asset, double latitude, double longitude)
+    {
+        // The fix's cell or any neighbour, so crossing a cell edge is not a departure
+        auto row = static_cast<int64_t>(std::floor(latitude / ANOMALY_AREA_CELL_DEGREES));
+        auto column = static_cast<int64_t>(std::floor(longitude / ANOMALY_AREA_CELL_DEGREES));
+        for (uint32_t i = 0; i < asset.cell_count; ++i)
+        {
+            const AreaCell &cell = asset.cells[i];
+            if (cell.count - cell.error < ANOMALY_AREA_MIN_VISITS)
+            {
+                continue;
+            }
+            auto cell_row = static_cast<int32_t>(cell.key >> 32);
+            auto cell_column = static_cast<int32_t>(cell.key & 0xFFFFFFFFu);
+            if (std::abs(cell_row - row) <= 1 && std::abs(cell_column - column) <= 1)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AnomalyDetector::learnArea(Asset &asset, uint64_t key)
+    {
+        auto begin = asset.cells.begin();
+        auto end = begin + asset.cell_count;
+        auto found = std::find_if(begin, end,
+                                  [key](const AreaCell &cell)
+                                  {
+                                      return cell.key == key;
+                                  });
+        if (found != end)
+        {
+            ++found->count;
+            return;
+        }
+        if (asset.cell_count < asset.cells.size())
+        {
+            asset.cells[asset.cell_count++] = AreaCell{key, 1, 0};
+            return;
+        }
+
+        // Space-Saving: the least visited cell makes way and its count becomes
+        // the newcomer's error bound
+        auto least = std::min_element(begin, end,
+                                      [](const AreaCell &a, const AreaCell &b)
+                                      {
+                                          return a.count < b.count;
+                                      });
+        *least = AreaCell{key, least->count + 1, least->count};
+    }
+
+    void AnomalyDetector::learnHour(Asset &asset, size_t hour)
+    {
+        // Halve every slot before one saturates; the shares stay the same
+        if (asset.hours[hour] == UINT16_MAX)
+        {
+            asset.hours_total = 0;
+            for (auto &count : asset.hours)
+            {
+                count /= 2;
+                asset.hours_total += count;
+            }
+        }
+        ++asset.hours[hour];
+        ++asset.hours_total;
+    }
+
+    void AnomalyDetector::learnSpeed(Asset &asset, double speed_mps)
+    {
+        // Plain mean and variance until there are enough samples for the
+        // exponential weighting to take over
+        double alpha = std::max(1.0 / static_cast<double>(asset.moving_samples), ANOMALY_SPEED_ALPHA);
+        double difference = speed_mps - asset.mean_speed;
+        asset.mean_speed += alpha * difference;
+        asset.speed_variance = (1.0 - alpha) * (asset.speed_variance + alpha * difference * difference);
+    }
+
+} // namespace equipment_tracker
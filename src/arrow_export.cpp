@@ -0,0 +1,580 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "equipment_tracker/arrow_export.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        // Values from the Arrow format's Schema.fbs and Message.fbs
+        constexpr int16_t METADATA_V5 = 4;
+        constexpr uint8_t HEADER_SCHEMA = 1;
+        constexpr uint8_t HEADER_RECORD_BATCH = 3;
+        constexpr uint8_t TYPE_FLOATING_POINT = 3;
+        constexpr uint8_t TYPE_UTF8 = 5;
+        constexpr uint8_t TYPE_TIMESTAMP = 10;
+        constexpr int16_t PRECISION_DOUBLE = 2;
+        constexpr int16_t UNIT_NANOSECOND = 3;
+        constexpr uint32_t CONTINUATION = 0xFFFFFFFF;
+        constexpr char MAGIC[] = "ARROW1";
+        constexpr char FILE_HEADER[8] = {'A', 'R', 'R', 'O', 'W', '1', '\0', '\0'}; // Magic padded to 8 bytes
+        constexpr size_t ALIGNMENT = 8;
+
+        constexpr const char *DOUBLE_COLUMNS[] = {"latitude", "longitude", "altitude", "accuracy"};
+        constexpr size_t COLUMN_COUNT = 6;
+        constexpr size_t BUFFER_COUNT = 3 + 2 * (COLUMN_COUNT - 1); // utf8 has validity, offsets and data
+
+        size_t padded(size_t size)
+        {
+            return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        /**
+         * @brief Minimal Flatbuffers builder
+         *
+         * Like the reference implementation it fills the buffer back to
+         * front, so children are created before the tables that refer to
+         * them. Offsets are distances from the end of the buffer.
+         */
+        class FlatBufferBuilder
+        {
+        public:
+            using Offset = uint32_t;
+
+            uint32_t size() const { return static_cast<uint32_t>(buffer_.size() - head_); }
+
+            template <typename T>
+            void push(T value)
+            {
+                prep(sizeof(T), 0);
+                pushBytes(&value, sizeof(T));
+            }
+
+            void pushOffset(Offset target)
+            {
+                prep(sizeof(uint32_t), 0);
+                push<uint32_t>(size() + sizeof(uint32_t) - target);
+            }
+
+            Offset createString(std::string_view text)
+            {
+                prep(sizeof(uint32_t), text.size() + 1);
+                pushBytes("", 1);
+                pushBytes(text.data(), text.size());
+                push<uint32_t>(static_cast<uint32_t>(text.size()));
+                return size();
+            }
+
+            Offset createOffsetVector(const std::vector<Offset> &items)
+            {
+                prep(sizeof(uint32_t), items.size() * sizeof(uint32_t));
+                for (auto it = items.rbegin(); it != items.rend(); ++it)
+                {
+                    pushOffset(*it);
+                }
+                push<uint32_t>(static_cast<uint32_t>(items.size()));
+                return size();
+            }
+
+            // Vectors of structs: startStructVector(), push the fields of
+            // the last element first, then endStructVector()
+            void startStructVector(size_t struct_size, size_t count)
+            {
+                prep(sizeof(uint32_t), struct_size * count);
+                prep(ALIGNMENT, struct_size * count);
+            }
+
+            Offset endStructVector(size_t count)
+            {
+                push<uint32_t>(static_cast<uint32_t>(count));
+                return size();
+            }
+
+            void startTable()
+            {
+                fields_.clear();
+                table_start_ = size();
+            }
+
+            template <typename T>
+            void addScalar(uint16_t field, T value)
+            {
+                push(value);
+                fields_.push_back({field, size()});
+            }
+
+            void addOffset(uint16_t field, Offset target)
+            {
+                pushOffset(target);
+                fields_.push_back({field, size()});
+            }
+
+            Offset endTable()
+            {
+                push<int32_t>(0); // Replaced by the distance to the vtable
+                Offset table = size();
+
+                uint16_t slot_count = 0;
+                for (const auto &field : fields_)
+                {
+                    slot_count = std::max<uint16_t>(slot_count, field.id + 1);
+                }
+                std::vector<uint16_t> slots(slot_count, 0);
+                for (const auto &field : fields_)
+                {
+                    slots[field.id] = static_cast<uint16_t>(table - field.at);
+                }
+                for (auto it = slots.rbegin(); it != slots.rend(); ++it)
+                {
+                    push<uint16_t>(*it);
+                }
+                push<uint16_t>(static_cast<uint16_t>(table - table_start_));
+                push<uint16_t>(static_cast<uint16_t>(sizeof(uint16_t) * (2 + slot_count)));
+
+                int32_t vtable_distance = static_cast<int32_t>(size() - table);
+                std::memcpy(buffer_.data() + buffer_.size() - table, &vtable_distance, sizeof(vtable_distance));
+                return table;
+            }
+
+            std::string finish(Offset root)
+            {
+                prep(minalign_, sizeof(uint32_t));
+                pushOffset(root);
+                return std::string(buffer_.data() + head_, size());
+            }
+
+        private:
+            struct FieldLocation
+            {
+                uint16_t id;
+                Offset at;
+            };
+
+            std::vector<char> buffer_ = std::vector<char>(1024);
+            size_t head_{1024};
+            size_t minalign_{1};
+            Offset table_start_{0};
+            std::vector<FieldLocation> fields_;
+
+            // Pad so that size() is aligned after `additional` more bytes
+            void prep(size_t alignment, size_t additional)
+            {
+                minalign_ = std::max(minalign_, alignment);
+                size_t padding = (~(size() + additional) + 1) & (alignment - 1);
+                reserve(padding + additional);
+                head_ -= padding;
+                std::memset(buffer_.data() + head_, 0, padding);
+            }
+
+            void pushBytes(const void *data, size_t size)
+            {
+                reserve(size);
+                head_ -= size;
+                std::memcpy(buffer_.data() + head_, data, size);
+            }
+
+            void reserve(size_t bytes)
+            {
+                if (head_ >= bytes)
+                {
+                    return;
+                }
+                size_t used = size();
+                std::vector<char> grown(std::max(buffer_.size() * 2, used + bytes + 1024));
+                std::memcpy(grown.data() + grown.size() - used, buffer_.data() + head_, used);
+                head_ = grown.size() - used;
+                buffer_.swap(grown);
+            }
+        };
+
+        using Offset = FlatBufferBuilder::Offset;
+
+        Offset buildField(FlatBufferBuilder &builder, std::string_view name, uint8_t type_type, Offset type)
+        {
+            Offset name_offset = builder.createString(name);
+            Offset children = builder.createOffsetVector({});
+            builder.startTable();
+            builder.addOffset(0, name_offset);
+            builder.addOffset(3, type);
+            builder.addOffset(5, children);
+            builder.addScalar<uint8_t>(2, type_type);
+            builder.addScalar<uint8_t>(1, 0); // Not nullable
+            return builder.endTable();
+        }
+
+        Offset buildSchema(FlatBufferBuilder &builder)
+        {
+            std::vector<Offset> fields;
+
+            builder.startTable();
+            fields.push_back(buildField(builder, "equipment_id", TYPE_UTF8, builder.endTable()));
+
+            Offset timezone = builder.createString("UTC");
+            builder.startTable();
+            builder.addOffset(1, timezone);
+            builder.addScalar<int16_t>(0, UNIT_NANOSECOND);
+            fields.push_back(buildField(builder, "timestamp_ns", TYPE_TIMESTAMP, builder.endTable()));
+
+            for (const char *name : DOUBLE_COLUMNS)
+            {
+                builder.startTable();
+                builder.addScalar<int16_t>(0, PRECISION_DOUBLE);
+                fields.push_back(buildField(builder, name, TYPE_FLOATING_POINT, builder.endTable()));
+            }
+
+            Offset field_vector = builder.createOffsetVector(fields);
+            builder.startTable();
+            builder.addOffset(1, field_vector);
+            builder.addScalar<int16_t>(0, 0); // Little-endian
+            return builder.endTable();
+        }
+
+        std::string buildMessage(FlatBufferBuilder &builder, uint8_t header_type, Offset header, int64_t body_length)
+        {
+            builder.startTable();
+            builder.addScalar<int64_t>(3, body_length);
+            builder.addOffset(2, header);
+            builder.addScalar<int16_t>(0, METADATA_V5);
+            builder.addScalar<uint8_t>(1, header_type);
+            return builder.finish(builder.endTable());
+        }
+
+        // Continuation marker, metadata length, metadata and padding to 8 bytes
+        void appendEncapsulated(std::string &out, const std::string &metadata)
+        {
+            uint32_t continuation = CONTINUATION;
+            int32_t length = static_cast<int32_t>(padded(metadata.size() + 8) - 8);
+            out.append(reinterpret_cast<const char *>(&continuation), sizeof(continuation));
+            out.append(reinterpret_cast<const char *>(&length), sizeof(length));
+            out.append(metadata);
+            out.append(static_cast<size_t>(length) - metadata.size(), '\0');
+        }
+
+        struct EncodedBatch
+        {
+            std::string bytes; // Encapsulated message followed by its body
+            int32_t metadata_length{0};
+            int64_t body_length{0};
+            size_t rows{0};
+        };
+
+        /**
+         * @brief Column buffers of one record batch under construction
+         */
+        struct BatchColumns
+        {
+            std::vector<int64_t> timestamps;
+            std::vector<double> values[4];
+
+            size_t rows() const { return timestamps.size(); }
+
+            void add(const Position &position)
+            {
+                timestamps.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         position.getTimestamp().time_since_epoch())
+                                         .count());
+                values[0].push_back(position.getLatitude());
+                values[1].push_back(position.getLongitude());
+                values[2].push_back(position.getAltitude());
+                values[3].push_back(position.getAccuracy());
+            }
+
+            void clear()
+            {
+                timestamps.clear();
+                for (auto &column : values)
+                {
+                    column.clear();
+                }
+            }
+
+            EncodedBatch encode(const EquipmentId &id) const
+            {
+                size_t count = rows();
+                std::string offsets(sizeof(int32_t) * (count + 1), '\0');
+                for (size_t i = 0; i <= count; ++i)
+                {
+                    int32_t offset = static_cast<int32_t>(i * id.size());
+                    std::memcpy(&offsets[i * sizeof(int32_t)], &offset, sizeof(offset));
+                }
+                std::string ids;
+                ids.reserve(count * id.size());
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ids += id;
+                }
+
+                // Validity buffers are empty: no column has nulls
+                std::vector<std::string_view> buffers = {
+                    std::string_view(),
+                    offsets,
+                    ids,
+                    std::string_view(),
+                    std::string_view(reinterpret_cast<const char *>(timestamps.data()), count * sizeof(int64_t)),
+                };
+                for (const auto &column : values)
+                {
+                    buffers.push_back(std::string_view());
+                    buffers.push_back(std::string_view(reinterpret_cast<const char *>(column.data()),
+                                                       count * sizeof(double)));
+                }
+
+                int64_t body_length = 0;
+                for (const auto &buffer : buffers)
+                {
+                    body_length += padded(buffer.size());
+                }
+
+                FlatBufferBuilder builder;
+                builder.startStructVector(16, BUFFER_COUNT);
+                int64_t buffer_end = body_length;
+                for (auto it = buffers.rbegin(); it != buffers.rend(); ++it)
+                {
+                    buffer_end -= padded(it->size());
+                    builder.push<int64_t>(static_cast<int64_t>(it->size()));
+                    builder.push<int64_t>(buffer_end);
+                }
+                Offset buffer_vector = builder.endStructVector(BUFFER_COUNT);
+
+                builder.startStructVector(16, COLUMN_COUNT);
+                for (size_t i = 0; i < COLUMN_COUNT; ++i)
+                {
+                    builder.push<int64_t>(0); // null_count
+                    builder.push<int64_t>(static_cast<int64_t>(count));
+                }
+                Offset node_vector = builder.endStructVector(COLUMN_COUNT);
+
+                builder.startTable();
+                builder.addScalar<int64_t>(0, static_cast<int64_t>(count));
+                builder.addOffset(1, node_vector);
+                builder.addOffset(2, buffer_vector);
+                Offset record_batch = builder.endTable();
+
+                EncodedBatch batch;
+                batch.rows = count;
+                batch.body_length = body_length;
+                batch.bytes.reserve(512 + body_length);
+                appendEncapsulated(batch.bytes, buildMessage(builder, HEADER_RECORD_BATCH, record_batch, body_length));
+                batch.metadata_length = static_cast<int32_t>(batch.bytes.size());
+                for (const auto &buffer : buffers)
+                {
+                    batch.bytes.append(buffer);
+                    batch.bytes.append(padded(buffer.size()) - buffer.size(), '\0');
+                }
+                return batch;
+            }
+        };
+
+        struct FileBlock
+        {
+            int64_t offset;
+            int32_t metadata_length;
+            int64_t body_length;
+        };
+
+        std::string buildFooter(const std::vector<FileBlock> &blocks)
+        {
+            FlatBufferBuilder builder;
+            Offset schema = buildSchema(builder);
+
+            builder.startStructVector(24, blocks.size());
+            for (auto it = blocks.rbegin(); it != blocks.rend(); ++it)
+            {
+                builder.push<int64_t>(it->body_length);
+                builder.push<int32_t>(0); // Padding
+                builder.push<int32_t>(it->metadata_length);
+                builder.push<int64_t>(it->offset);
+            }
+            Offset record_batches = builder.endStructVector(blocks.size());
+            builder.startStructVector(24, 0);
+            Offset dictionaries = builder.endStructVector(0);
+
+            builder.startTable();
+            builder.addOffset(1, schema);
+            builder.addOffset(2, dictionaries);
+            builder.addOffset(3, record_batches);
+            builder.addScalar<int16_t>(0, METADATA_V5);
+            return builder.finish(builder.endTable());
+        }
+    } // namespace
+
+    ArrowExporter::ArrowExporter(DataStorage &storage, size_t threads, size_t batch_rows)
+        : storage_(storage),
+          threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+          batch_rows_(std::max<size_t>(batch_rows, 1))
+    {
+    }
+
+    bool ArrowExporter::exportHistory(const std::vector<EquipmentId> &ids, ArrowIpcFormat format,
+                                      std::ostream &out, const Timestamp &start, const Timestamp &end)
+    {
+        stats_ = ArrowExportStats();
+        bool ok = true;
+        auto write = [&](const char *data, size_t size)
+        {
+            out.write(data, static_cast<std::streamsize>(size));
+            stats_.bytes += size;
+            ok = ok && out.good();
+        };
+
+        if (format == ArrowIpcFormat::File)
+        {
+            write(FILE_HEADER, sizeof(FILE_HEADER));
+        }
+        {
+            FlatBufferBuilder builder;
+            Offset schema = buildSchema(builder);
+            std::string message;
+            appendEncapsulated(message, buildMessage(builder, HEADER_SCHEMA, schema, 0));
+            write(message.data(), message.size());
+        }
+
+        // Workers fill one queue per machine; the writer drains them in order
+        struct MachineQueue
+        {
+            std::deque<EncodedBatch> batches;
+            bool done{false};
+        };
+        std::vector<MachineQueue> queues(ids.size());
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t queued_bytes = 0;
+        size_t writing = 0;
+        bool failed = false;
+        std::atomic<size_t> next_machine{0};
+
+        auto produce = [&]()
+        {
+            BatchColumns columns;
+            for (size_t i = next_machine++; i < ids.size(); i = next_machine++)
+            {
+                auto emit = [&]()
+                {
+                    EncodedBatch batch = columns.encode(ids[i]);
+                    columns.clear();
+                    std::unique_lock<std::mutex> lock(mutex);
+                    // The machine being written never waits, so the queue cannot deadlock
+                    changed.wait(lock, [&]()
+                                 { return failed || i == writing || queued_bytes < ARROW_EXPORT_QUEUE_BYTES; });
+                    queued_bytes += batch.bytes.size();
+                    queues[i].batches.push_back(std::move(batch));
+                    changed.notify_all();
+                    return !failed;
+                };
+
+                bool keep_going = true;
+                storage_.scanPositionHistory(ids[i], start, end,
+                                             [&](const std::vector<Position> &chunk)
+                                             {
+                                                 for (const auto &position : chunk)
+                                                 {
+                                                     columns.add(position);
+                                                     if (columns.rows() == batch_rows_)
+                                                     {
+                                                         keep_going = emit();
+                                                         if (!keep_going)
+                                                         {
+                                                             return false;
+                                                         }
+                                                     }
+                                                 }
+                                                 return true;
+                                             });
+                if (keep_going && columns.rows() > 0)
+                {
+                    emit();
+                }
+                columns.clear();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                queues[i].done = true;
+                changed.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        size_t thread_count = std::min(threads_, ids.size());
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            workers.emplace_back(produce);
+        }
+
+        std::vector<FileBlock> blocks;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            bool counted = false;
+            for (;;)
+            {
+                EncodedBatch batch;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]()
+                                 { return !queues[i].batches.empty() || queues[i].done; });
+                    if (queues[i].batches.empty())
+                    {
+                        writing = i + 1;
+                        changed.notify_all();
+                        break;
+                    }
+                    batch = std::move(queues[i].batches.front());
+                    queues[i].batches.pop_front();
+                    queued_bytes -= batch.bytes.size();
+                    changed.notify_all();
+                }
+
+                if (ok)
+                {
+                    blocks.push_back({static_cast<int64_t>(stats_.bytes), batch.metadata_length, batch.body_length});
+                    write(batch.bytes.data(), batch.bytes.size());
+                    stats_.rows += batch.rows;
+                    ++stats_.batches;
+                    if (!counted)
+                    {
+                        ++stats_.equipment;
+                        counted = true;
+                    }
+                }
+                if (!ok)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    failed = true;
+                    changed.notify_all();
+                }
+            }
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        uint32_t end_of_stream[2] = {CONTINUATION, 0};
+        write(reinterpret_cast<const char *>(end_of_stream), sizeof(end_of_stream));
+        if (format == ArrowIpcFormat::File)
+        {
+            std::string footer = buildFooter(blocks);
+            int32_t footer_length = static_cast<int32_t>(footer.size());
+            write(footer.data(), footer.size());
+            write(reinterpret_cast<const char *>(&footer_length), sizeof(footer_length));
+            write(MAGIC, sizeof(MAGIC) - 1);
+        }
+
+        out.flush();
+        if (!ok || !out.good())
+        {
+            std::cerr << "Arrow export failed: output stream error" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace equipment_tracker
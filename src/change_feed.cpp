@@ -0,0 +1,757 @@
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include "equipment_tracker/change_feed.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        int64_t toNanoseconds(const Timestamp &timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        Timestamp fromNanoseconds(int64_t ns)
+        {
+            return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(ns)));
+        }
+
+        // Fields are tab-separated, so tabs, newlines and backslashes are escaped
+        std::string escape(const std::string &value)
+        {
+            std::string result;
+            result.reserve(value.size());
+            for (char c : value)
+            {
+                switch (c)
+                {
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                default:
+                    result += c;
+                }
+            }
+            return result;
+        }
+
+        std::string unescape(const std::string &value)
+        {
+            std::string result;
+            result.reserve(value.size());
+            for (size_t i = 0; i < value.size(); ++i)
+            {
+                if (value[i] == '\\' && i + 1 < value.size())
+                {
+                    char next = value[++i];
+                    result += next == 't' ? '\t' : next == 'n' ? '\n' : next;
+                }
+                else
+                {
+                    result += value[i];
+                }
+            }
+            return result;
+        }
+
+        char typeCode(ChangeType type)
+        {
+            switch (type)
+            {
+            case ChangeType::EquipmentSaved:
+                return 'E';
+            case ChangeType::EquipmentDeleted:
+                return 'D';
+            case ChangeType::PositionSaved:
+                return 'P';
+            }
+            return '?';
+        }
+
+        ChangeRecord equipmentSavedRecord(const Equipment &equipment)
+        {
+            ChangeRecord record;
+            record.type = ChangeType::EquipmentSaved;
+            record.equipment_id = equipment.getId();
+            record.name = equipment.getName();
+            record.equipment_type = equipment.getType();
+            record.status = equipment.getStatus();
+            record.position = equipment.getLastPosition();
+            record.utilization = equipment.getUtilization();
+            return record;
+        }
+
+        ChangeRecord equipmentDeletedRecord(const EquipmentId &id)
+        {
+            ChangeRecord record;
+            record.type = ChangeType::EquipmentDeleted;
+            record.equipment_id = id;
+            return record;
+        }
+    } // namespace
+
+    ChangeFeed::ChangeFeed(std::string directory, uint64_t segment_bytes)
+        : directory_(std::move(directory)),
+          segment_bytes_(segment_bytes)
+    {
+    }
+
+    bool ChangeFeed::open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (is_open_)
+        {
+            return true;
+        }
+
+        try
+        {
+            std::filesystem::create_directories(directory_ + "/offsets");
+
+            segments_.clear();
+
+            // Sealed segments, oldest first; their names carry the first LSN
+            std::vector<uint64_t> sealed;
+            for (const auto &entry : std::filesystem::directory_iterator(directory_))
+            {
+                std::string name = entry.path().filename().string();
+                if (name.size() > 12 && name.compare(0, 8, "changes-") == 0 &&
+                    name.compare(name.size() - 4, 4, ".log") == 0)
+                {
+                    try
+                    {
+                        sealed.push_back(std::stoull(name.substr(8, name.size() - 12)));
+                    }
+                    catch (const std::exception &)
+                    {
+                        std::cerr << "ChangeFeed ignoring " << entry.path() << std::endl;
+                    }
+                }
+            }
+            std::sort(sealed.begin(), sealed.end());
+
+            for (uint64_t first_lsn : sealed)
+            {
+                Segment segment;
+                segment.first_lsn = first_lsn;
+                if (!loadSegmentIndex(segment))
+                {
+                    scanSegment(segmentPath(first_lsn, ".log"), first_lsn, segment);
+                    writeSegmentIndex(segment);
+                }
+                if (!segments_.empty() && segment.first_lsn != segments_.back().last_lsn + 1)
+                {
+                    std::cerr << "ChangeFeed gap before LSN " << segment.first_lsn << std::endl;
+                }
+                segments_.push_back(std::move(segment));
+            }
+
+            // Only the active segment is scanned, stopping at the first torn or out-of-order line
+            std::string path = getLogPath();
+            Segment active;
+            uint64_t expected = segments_.empty() ? 0 : segments_.back().last_lsn + 1;
+            if (std::filesystem::exists(path))
+            {
+                scanSegment(path, expected, active);
+                if (std::filesystem::file_size(path) != active.size)
+                {
+                    std::cerr << "ChangeFeed discarding incomplete tail of " << path << std::endl;
+                    std::filesystem::resize_file(path, active.size);
+                }
+            }
+            else if (expected != 0)
+            {
+                active.first_lsn = expected;
+                active.last_lsn = expected - 1;
+            }
+            segments_.push_back(std::move(active));
+
+            log_.open(path, std::ios::binary | std::ios::app);
+            if (!log_.is_open())
+            {
+                std::cerr << "Failed to open change log: " << path << std::endl;
+                return false;
+            }
+
+            dropConsumedSegments();
+            is_open_ = true;
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "ChangeFeed open error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void ChangeFeed::close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (log_.is_open())
+        {
+            log_.close();
+        }
+        is_open_ = false;
+    }
+
+    bool ChangeFeed::isOpen() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return is_open_;
+    }
+
+    uint64_t ChangeFeed::appendEquipmentSaved(const Equipment &equipment)
+    {
+        return append(equipmentSavedRecord(equipment));
+    }
+
+    uint64_t ChangeFeed::appendEquipmentDeleted(const EquipmentId &id)
+    {
+        return append(equipmentDeletedRecord(id));
+    }
+
+    uint64_t ChangeFeed::appendPositionSaved(const EquipmentId &id, const Position &position)
+    {
+        ChangeRecord record;
+        record.type = ChangeType::PositionSaved;
+        record.equipment_id = id;
+        record.position = position;
+        return append(std::move(record));
+    }
+
+    uint64_t ChangeFeed::appendEquipmentSavedBatch(const std::vector<Equipment> &equipment)
+    {
+        std::vector<ChangeRecord> records;
+        records.reserve(equipment.size());
+        for (const auto &item : equipment)
+        {
+            records.push_back(equipmentSavedRecord(item));
+        }
+        return appendAll(std::move(records));
+    }
+
+    uint64_t ChangeFeed::appendEquipmentDeletedBatch(const std::vector<EquipmentId> &ids)
+    {
+        std::vector<ChangeRecord> records;
+        records.reserve(ids.size());
+        for (const auto &id : ids)
+        {
+            records.push_back(equipmentDeletedRecord(id));
+        }
+        return appendAll(std::move(records));
+    }
+
+    uint64_t ChangeFeed::append(ChangeRecord record)
+    {
+        std::vector<ChangeRecord> records;
+        records.push_back(std::move(record));
+        return appendAll(std::move(records));
+    }
+
+    uint64_t ChangeFeed::appendAll(std::vector<ChangeRecord> records)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (!is_open_ || records.empty())
+        {
+            return 0;
+        }
+
+        Timestamp committed_at = getCurrentTimestamp();
+        std::string lines;
+        std::vector<uint64_t> line_offsets;
+        line_offsets.reserve(records.size());
+        for (auto &record : records)
+        {
+            record.lsn = segments_.back().last_lsn + line_offsets.size() + 1;
+            record.committed_at = committed_at;
+
+            line_offsets.push_back(lines.size());
+            lines += encode(record);
+            lines += '\n';
+        }
+
+        // A batch never straddles two segments
+        if (segments_.back().size > 0 && segments_.back().size + lines.size() > segment_bytes_)
+        {
+            rotate();
+        }
+
+        log_.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+        log_.flush();
+        if (!log_)
+        {
+            std::cerr << "Failed to append to change log: " << getLogPath() << std::endl;
+            log_.clear();
+            return 0;
+        }
+
+        Segment &active = segments_.back();
+        for (uint64_t offset : line_offsets)
+        {
+            uint64_t lsn = ++active.last_lsn;
+            if ((lsn - active.first_lsn) % CHANGE_INDEX_INTERVAL == 0)
+            {
+                active.index.emplace_back(lsn, active.size + offset);
+            }
+        }
+        active.size += lines.size();
+        uint64_t last_lsn = active.last_lsn;
+        auto hook = commit_hook_;
+        lock.unlock();
+
+        appended_.notify_all();
+        if (hook)
+        {
+            hook(last_lsn);
+        }
+        return last_lsn;
+    }
+
+    bool ChangeFeed::waitForChanges(uint64_t after_lsn, std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return appended_.wait_for(lock, timeout,
+                                  [this, after_lsn]
+                                  {
+                                      return !segments_.empty() && segments_.back().last_lsn > after_lsn;
+                                  });
+    }
+
+    void ChangeFeed::setCommitHook(std::function<void(uint64_t)> hook)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commit_hook_ = std::move(hook);
+    }
+
+    std::vector<ChangeRecord> ChangeFeed::read(uint64_t after_lsn, size_t max_records) const
+    {
+        std::vector<ChangeRecord> result;
+
+        uint64_t next = after_lsn + 1;
+        uint64_t last;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!is_open_)
+            {
+                return result;
+            }
+
+            // Records before the oldest retained segment are gone
+            next = std::max(next, segments_.front().first_lsn);
+            if (next > segments_.back().last_lsn)
+            {
+                return result;
+            }
+            uint64_t available = segments_.back().last_lsn - next + 1;
+            last = next - 1 + std::min<uint64_t>(available, max_records);
+        }
+
+        try
+        {
+            // One pass per segment the batch touches
+            while (next <= last)
+            {
+                std::ifstream file;
+                uint64_t line_lsn;
+                uint64_t segment_last;
+                {
+                    // Opened under the lock so a concurrent rotation cannot swap the file
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto segment = std::find_if(segments_.begin(), segments_.end(),
+                                                [next](const Segment &candidate)
+                                                {
+                                                    return candidate.last_lsn >= next;
+                                                });
+                    if (segment == segments_.end())
+                    {
+                        break;
+                    }
+
+                    // Retention may have moved on while unlocked
+                    next = std::max(next, segment->first_lsn);
+                    auto entry = std::upper_bound(segment->index.begin(), segment->index.end(), next,
+                                                  [](uint64_t lsn, const std::pair<uint64_t, uint64_t> &item)
+                                                  {
+                                                      return lsn < item.first;
+                                                  });
+                    --entry;
+
+                    file.open(pathOf(*segment), std::ios::binary);
+                    file.seekg(static_cast<std::streamoff>(entry->second));
+                    line_lsn = entry->first;
+                    segment_last = std::min(segment->last_lsn, last);
+                }
+
+                std::string line;
+                while (next <= segment_last && std::getline(file, line))
+                {
+                    // Skip forward from the sparse index entry without decoding
+                    if (line_lsn++ < next)
+                    {
+                        continue;
+                    }
+
+                    auto record = decode(line);
+                    if (!record || record->lsn != next)
+                    {
+                        std::cerr << "ChangeFeed skipping malformed record after LSN " << next - 1 << std::endl;
+                        return result;
+                    }
+                    result.push_back(std::move(*record));
+                    ++next;
+                }
+
+                if (next <= segment_last)
+                {
+                    break; // Segment shorter than its index claims
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "ChangeFeed read error: " << e.what() << std::endl;
+        }
+
+        return result;
+    }
+
+    bool ChangeFeed::commitOffset(const std::string &consumer, uint64_t lsn)
+    {
+        try
+        {
+            // Write then rename so a crash never leaves a half-written offset
+            std::string path = offsetPath(consumer);
+            std::string temp_path = path + ".tmp";
+            {
+                std::ofstream file(temp_path, std::ios::trunc);
+                if (!file.is_open())
+                {
+                    std::cerr << "Failed to open file for writing: " << temp_path << std::endl;
+                    return false;
+                }
+                file << lsn << std::endl;
+            }
+            std::filesystem::rename(temp_path, path);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "ChangeFeed commitOffset error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    uint64_t ChangeFeed::getOffset(const std::string &consumer) const
+    {
+        std::ifstream file(offsetPath(consumer));
+        uint64_t lsn = 0;
+        if (file.is_open())
+        {
+            file >> lsn;
+        }
+        return lsn;
+    }
+
+    std::vector<ChangeRecord> ChangeFeed::readNext(const std::string &consumer, size_t max_records) const
+    {
+        return read(getOffset(consumer), max_records);
+    }
+
+    uint64_t ChangeFeed::getLatestLsn() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return segments_.empty() ? 0 : segments_.back().last_lsn;
+    }
+
+    uint64_t ChangeFeed::getOldestLsn() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &segment : segments_)
+        {
+            if (segment.last_lsn >= segment.first_lsn)
+            {
+                return segment.first_lsn;
+            }
+        }
+        return 0;
+    }
+
+    size_t ChangeFeed::getSegmentCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return segments_.size();
+    }
+
+    std::string ChangeFeed::offsetPath(const std::string &consumer) const
+    {
+        return directory_ + "/offsets/" + consumer + ".offset";
+    }
+
+    std::string ChangeFeed::segmentPath(uint64_t first_lsn, const char *extension) const
+    {
+        // Zero-padded so the names sort in LSN order
+        std::ostringstream name;
+        name << directory_ << "/changes-" << std::setw(20) << std::setfill('0') << first_lsn << extension;
+        return name.str();
+    }
+
+    std::string ChangeFeed::pathOf(const Segment &segment) const
+    {
+        return &segment == &segments_.back() ? getLogPath() : segmentPath(segment.first_lsn, ".log");
+    }
+
+    void ChangeFeed::scanSegment(const std::string &path, uint64_t first_lsn, Segment &segment)
+    {
+        segment = Segment{};
+        segment.first_lsn = first_lsn == 0 ? 1 : first_lsn;
+        segment.last_lsn = segment.first_lsn - 1;
+
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (in.eof())
+            {
+                break; // No trailing newline: the last append never completed
+            }
+
+            auto record = decode(line);
+            if (!record)
+            {
+                break;
+            }
+            if (first_lsn == 0 && segment.index.empty())
+            {
+                // Unknown start: the oldest retained segment begins wherever it begins
+                segment.first_lsn = record->lsn;
+                segment.last_lsn = record->lsn - 1;
+            }
+            if (record->lsn != segment.last_lsn + 1)
+            {
+                break;
+            }
+
+            if ((record->lsn - segment.first_lsn) % CHANGE_INDEX_INTERVAL == 0)
+            {
+                segment.index.emplace_back(record->lsn, segment.size);
+            }
+            segment.last_lsn = record->lsn;
+            segment.size += line.size() + 1;
+        }
+    }
+
+    bool ChangeFeed::loadSegmentIndex(Segment &segment) const
+    {
+        std::ifstream in(segmentPath(segment.first_lsn, ".idx"));
+        uint64_t first_lsn = 0;
+        if (!(in >> first_lsn >> segment.last_lsn >> segment.size) || first_lsn != segment.first_lsn)
+        {
+            return false;
+        }
+
+        uint64_t lsn = 0;
+        uint64_t offset = 0;
+        while (in >> lsn >> offset)
+        {
+            segment.index.emplace_back(lsn, offset);
+        }
+
+        std::error_code error;
+        return !segment.index.empty() && segment.index.front().first == segment.first_lsn &&
+               std::filesystem::file_size(segmentPath(segment.first_lsn, ".log"), error) == segment.size;
+    }
+
+    bool ChangeFeed::writeSegmentIndex(const Segment &segment) const
+    {
+        // Write then rename so a crash never leaves a half-written index
+        std::string path = segmentPath(segment.first_lsn, ".idx");
+        std::string temp_path = path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            if (!file.is_open())
+            {
+                std::cerr << "Failed to open file for writing: " << temp_path << std::endl;
+                return false;
+            }
+            file << segment.first_lsn << ' ' << segment.last_lsn << ' ' << segment.size << '\n';
+            for (const auto &entry : segment.index)
+            {
+                file << entry.first << ' ' << entry.second << '\n';
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temp_path, path, error);
+        return !error;
+    }
+
+    bool ChangeFeed::rotate()
+    {
+        Segment &active = segments_.back();
+        std::string sealed_path = segmentPath(active.first_lsn, ".log");
+
+        log_.close();
+        std::error_code error;
+        std::filesystem::rename(getLogPath(), sealed_path, error);
+        if (error)
+        {
+            // Keep appending to the current file rather than lose changes
+            std::cerr << "Failed to seal change log segment: " << error.message() << std::endl;
+            log_.open(getLogPath(), std::ios::binary | std::ios::app);
+            return false;
+        }
+        writeSegmentIndex(active);
+
+        Segment next;
+        next.first_lsn = active.last_lsn + 1;
+        next.last_lsn = active.last_lsn;
+        segments_.push_back(std::move(next));
+
+        log_.open(getLogPath(), std::ios::binary | std::ios::trunc);
+        dropConsumedSegments();
+        return true;
+    }
+
+    void ChangeFeed::dropConsumedSegments()
+    {
+        // The newest sealed segment stays so the LSN sequence survives a restart
+        // while changes.log is still empty
+        uint64_t consumed = minimumConsumerOffset();
+        while (segments_.size() > 2 && segments_.front().last_lsn <= consumed)
+        {
+            std::error_code error;
+            std::filesystem::remove(segmentPath(segments_.front().first_lsn, ".log"), error);
+            std::filesystem::remove(segmentPath(segments_.front().first_lsn, ".idx"), error);
+            segments_.erase(segments_.begin());
+        }
+    }
+
+    uint64_t ChangeFeed::minimumConsumerOffset() const
+    {
+        uint64_t minimum = segments_.back().last_lsn;
+
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory_ + "/offsets", error))
+        {
+            if (entry.path().extension() == ".offset")
+            {
+                std::ifstream file(entry.path());
+                uint64_t lsn = 0;
+                file >> lsn;
+                minimum = std::min(minimum, lsn);
+            }
+        }
+        return minimum;
+    }
+
+    std::string ChangeFeed::encode(const ChangeRecord &record)
+    {
+        std::ostringstream out;
+        out << record.lsn << '\t'
+            << typeCode(record.type) << '\t'
+            << escape(record.equipment_id) << '\t'
+            << toNanoseconds(record.committed_at) << '\t'
+            << escape(record.name) << '\t'
+            << static_cast<int>(record.equipment_type) << '\t'
+            << static_cast<int>(record.status) << '\t';
+
+        if (record.position)
+        {
+            out << std::fixed << std::setprecision(10)
+                << "1\t"
+                << record.position->getLatitude() << '\t'
+                << record.position->getLongitude() << '\t'
+                << record.position->getAltitude() << '\t'
+                << record.position->getAccuracy() << '\t'
+                << toNanoseconds(record.position->getTimestamp());
+        }
+        else
+        {
+            out << "0\t0\t0\t0\t0\t0";
+        }
+
+        out << std::defaultfloat << std::setprecision(17) << '\t'
+            << record.utilization.moving_seconds << '\t'
+            << record.utilization.idle_seconds << '\t'
+            << record.utilization.distance_meters;
+
+        return out.str();
+    }
+
+    std::optional<ChangeRecord> ChangeFeed::decode(const std::string &line)
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t'))
+        {
+            fields.push_back(field);
+        }
+
+        if ((fields.size() != 13 && fields.size() != 16) || fields[1].size() != 1)
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            ChangeRecord record;
+            record.lsn = std::stoull(fields[0]);
+
+            switch (fields[1][0])
+            {
+            case 'E':
+                record.type = ChangeType::EquipmentSaved;
+                break;
+            case 'D':
+                record.type = ChangeType::EquipmentDeleted;
+                break;
+            case 'P':
+                record.type = ChangeType::PositionSaved;
+                break;
+            default:
+                return std::nullopt;
+            }
+
+            record.equipment_id = unescape(fields[2]);
+            record.committed_at = fromNanoseconds(std::stoll(fields[3]));
+            record.name = unescape(fields[4]);
+            record.equipment_type = static_cast<EquipmentType>(std::stoi(fields[5]));
+            record.status = static_cast<EquipmentStatus>(std::stoi(fields[6]));
+
+            if (fields[7] == "1")
+            {
+                record.position = Position(std::stod(fields[8]), std::stod(fields[9]),
+                                           std::stod(fields[10]), std::stod(fields[11]),
+                                           fromNanoseconds(std::stoll(fields[12])));
+            }
+
+            if (fields.size() == 16)
+            {
+                record.utilization.moving_seconds = std::stod(fields[13]);
+                record.utilization.idle_seconds = std::stod(fields[14]);
+                record.utilization.distance_meters = std::stod(fields[15]);
+            }
+
+            return record;
+        }
+        catch (const std::exception &)
+        {
+            return std::nullopt;
+        }
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,811 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include "equipment_tracker/cluster.h"
+#include "equipment_tracker/equipment_tracker_service.h"
+#include "equipment_tracker/utils/socket_io.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        // Percent-escape the bytes that delimit fields and records
+        std::string escapeField(const std::string &field)
+        {
+            std::string escaped;
+            escaped.reserve(field.size());
+            for (unsigned char c : field)
+            {
+                if (c == '%' || c == '\t' || c == '\n' || c == '\r' || c == ' ')
+                {
+                    char hex[4];
+                    std::snprintf(hex, sizeof(hex), "%%%02X", c);
+                    escaped += hex;
+                }
+                else
+                {
+                    escaped += static_cast<char>(c);
+                }
+            }
+            return escaped;
+        }
+
+        std::optional<std::string> unescapeField(const std::string &field)
+        {
+            std::string plain;
+            plain.reserve(field.size());
+            for (size_t i = 0; i < field.size(); ++i)
+            {
+                if (field[i] != '%')
+                {
+                    plain += field[i];
+                    continue;
+                }
+                if (i + 2 >= field.size() || !std::isxdigit(static_cast<unsigned char>(field[i + 1])) ||
+                    !std::isxdigit(static_cast<unsigned char>(field[i + 2])))
+                {
+                    return std::nullopt;
+                }
+                plain += static_cast<char>(std::strtol(field.substr(i + 1, 2).c_str(), nullptr, 16));
+                i += 2;
+            }
+            return plain;
+        }
+
+        std::vector<std::string> splitLines(const std::string &body)
+        {
+            std::vector<std::string> lines;
+            size_t start = 0;
+            while (start <= body.size())
+            {
+                size_t end = body.find('\n', start);
+                if (end == std::string::npos)
+                {
+                    lines.push_back(body.substr(start));
+                    break;
+                }
+                lines.push_back(body.substr(start, end - start));
+                start = end + 1;
+            }
+            return lines;
+        }
+
+        // Split "<command> <argument>" at the first space
+        std::pair<std::string, std::string> splitCommand(const std::string &line)
+        {
+            size_t space = line.find(' ');
+            if (space == std::string::npos)
+            {
+                return {line, ""};
+            }
+            return {line.substr(0, space), line.substr(space + 1)};
+        }
+
+        std::string equipmentList(const std::vector<Equipment> &equipment)
+        {
+            std::string body = "OK";
+            for (const auto &item : equipment)
+            {
+                body += '\n';
+                body += encodeClusterEquipment(item);
+            }
+            return body;
+        }
+
+        std::vector<Equipment> decodeEquipmentList(const std::string &response)
+        {
+            std::vector<Equipment> equipment;
+            auto lines = splitLines(response);
+            for (size_t i = 1; i < lines.size(); ++i)
+            {
+                auto item = decodeClusterEquipment(lines[i]);
+                if (item)
+                {
+                    equipment.push_back(std::move(*item));
+                }
+            }
+            return equipment;
+        }
+    } // namespace
+
+    std::string encodeClusterPosition(const Position &position)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%.17g %.17g %.17g %.17g %lld",
+                      position.getLatitude(), position.getLongitude(),
+                      position.getAltitude(), position.getAccuracy(),
+                      static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 position.getTimestamp().time_since_epoch())
+                                                 .count()));
+        return line;
+    }
+
+    std::optional<Position> decodeClusterPosition(const std::string &line)
+    {
+        const char *cursor = line.c_str();
+        char *end = nullptr;
+        double values[4];
+        for (double &value : values)
+        {
+            value = std::strtod(cursor, &end);
+            if (end == cursor)
+            {
+                return std::nullopt;
+            }
+            cursor = end;
+        }
+
+        long long timestamp_ns = std::strtoll(cursor, &end, 10);
+        if (end == cursor || *end != '\0')
+        {
+            return std::nullopt;
+        }
+
+        return Position(values[0], values[1], values[2], values[3],
+                        Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                            std::chrono::nanoseconds(timestamp_ns))));
+    }
+
+    std::string encodeClusterEquipment(const Equipment &equipment)
+    {
+        auto position = equipment.getLastPosition();
+        const UtilizationCounters &counters = equipment.getUtilization();
+        char utilization[80];
+        std::snprintf(utilization, sizeof(utilization), "%.17g %.17g %.17g",
+                      counters.moving_seconds, counters.idle_seconds, counters.distance_meters);
+        return escapeField(equipment.getId()) + "\t" +
+               std::to_string(static_cast<int>(equipment.getType())) + "\t" +
+               std::to_string(static_cast<int>(equipment.getStatus())) + "\t" +
+               escapeField(equipment.getName()) + "\t" +
+               (position ? encodeClusterPosition(*position) : "-") + "\t" +
+               utilization;
+    }
+
+    std::optional<Equipment> decodeClusterEquipment(const std::string &line)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        for (size_t tab = line.find('\t'); tab != std::string::npos; tab = line.find('\t', start))
+        {
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        fields.push_back(line.substr(start));
+        if (fields.size() != 5 && fields.size() != 6)
+        {
+            return std::nullopt;
+        }
+
+        auto id = unescapeField(fields[0]);
+        auto name = unescapeField(fields[3]);
+        if (!id || id->empty() || !name || fields[1].size() != 1 || fields[2].size() != 1 ||
+            fields[1][0] < '0' || fields[1][0] > '0' + static_cast<int>(EquipmentType::Other) ||
+            fields[2][0] < '0' || fields[2][0] > '0' + static_cast<int>(EquipmentStatus::Unknown))
+        {
+            return std::nullopt;
+        }
+
+        Equipment equipment(*id, static_cast<EquipmentType>(fields[1][0] - '0'), *name);
+        equipment.setStatus(static_cast<EquipmentStatus>(fields[2][0] - '0'));
+        if (fields[4] != "-")
+        {
+            auto position = decodeClusterPosition(fields[4]);
+            if (!position)
+            {
+                return std::nullopt;
+            }
+            equipment.setLastPosition(*position);
+        }
+        if (fields.size() == 6)
+        {
+            // Records from older nodes carry no utilization counters
+            UtilizationCounters counters;
+            if (std::sscanf(fields[5].c_str(), "%lg %lg %lg", &counters.moving_seconds, &counters.idle_seconds,
+                            &counters.distance_meters) != 3)
+            {
+                return std::nullopt;
+            }
+            equipment.setUtilization(counters);
+        }
+        return equipment;
+    }
+
+    ClusterNode::ClusterNode(EquipmentTrackerService &service, std::string address, uint16_t port)
+        : service_(service), address_(std::move(address)), port_(port)
+    {
+    }
+
+    ClusterNode::~ClusterNode()
+    {
+        stop();
+    }
+
+    bool ClusterNode::start()
+    {
+        if (listen_fd_ >= 0)
+        {
+            return true;
+        }
+
+        int fd = listenTcp(address_, port_);
+        if (fd < 0)
+        {
+            std::cerr << "Cluster node failed to listen on " << address_ << ":" << port_ << ": "
+                      << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        listen_fd_ = fd;
+        stopping_ = false;
+        accept_thread_ = std::thread(&ClusterNode::acceptLoop, this);
+        return true;
+    }
+
+    void ClusterNode::stop()
+    {
+        if (listen_fd_ < 0)
+        {
+            return;
+        }
+
+        // Shutting the sockets down wakes the threads blocked on them
+        stopping_ = true;
+        shutdownSocket(listen_fd_);
+        if (accept_thread_.joinable())
+        {
+            accept_thread_.join();
+        }
+        closeSocket(listen_fd_);
+        listen_fd_ = -1;
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (int fd : connections_)
+            {
+                shutdownSocket(fd);
+            }
+            threads.swap(connection_threads_);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ClusterNode::acceptLoop()
+    {
+        while (!stopping_)
+        {
+            int fd = acceptTcp(listen_fd_);
+            if (fd < 0)
+            {
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.insert(fd);
+            connection_threads_.emplace_back(&ClusterNode::serveConnection, this, fd);
+        }
+    }
+
+    void ClusterNode::serveConnection(int fd)
+    {
+        std::string buffer;
+        std::string request;
+        while (readFrame(fd, buffer, request, CLUSTER_MAX_FRAME_SIZE))
+        {
+            if (!writeFrame(fd, handleRequest(request)))
+            {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.erase(fd);
+        closeSocket(fd);
+    }
+
+    std::string ClusterNode::handleRequest(const std::string &request)
+    {
+        auto lines = splitLines(request);
+        auto [command, argument] = splitCommand(lines[0]);
+
+        if (command == "PING")
+        {
+            return "OK";
+        }
+        if (command == "ADD" || command == "IMPORT")
+        {
+            auto equipment = lines.size() >= 2 ? decodeClusterEquipment(lines[1]) : std::nullopt;
+            if (!equipment)
+            {
+                return "ERR malformed equipment";
+            }
+
+            // An import brings the machine's recent history from its previous node
+            std::vector<Position> history;
+            for (size_t i = 2; i < lines.size(); ++i)
+            {
+                auto position = decodeClusterPosition(lines[i]);
+                if (!position)
+                {
+                    return "ERR malformed position";
+                }
+                history.push_back(*position);
+            }
+            equipment->setPositionHistory(history);
+
+            if (!service_.addEquipment(*equipment))
+            {
+                return "ERR rejected";
+            }
+            for (const auto &position : history)
+            {
+                service_.getDataStorage().savePosition(equipment->getId(), position);
+            }
+            return "OK";
+        }
+        if (command == "STATUS")
+        {
+            int status = std::atoi(argument.c_str());
+            if (argument.size() != 1 || status < 0 || status > static_cast<int>(EquipmentStatus::Unknown))
+            {
+                return "ERR malformed status";
+            }
+            return equipmentList(service_.findEquipmentByStatus(static_cast<EquipmentStatus>(status)));
+        }
+        if (command == "AREA")
+        {
+            double bounds[4];
+            const char *cursor = argument.c_str();
+            for (double &bound : bounds)
+            {
+                char *end = nullptr;
+                bound = std::strtod(cursor, &end);
+                if (end == cursor)
+                {
+                    return "ERR malformed area";
+                }
+                cursor = end;
+            }
+            return equipmentList(service_.findEquipmentInArea(bounds[0], bounds[1], bounds[2], bounds[3]));
+        }
+        if (command == "ALL")
+        {
+            return equipmentList(service_.getAllEquipment());
+        }
+        if (command == "IDS")
+        {
+            std::string body = "OK";
+            service_.getFleetSnapshot()->forEach(
+                [&body](const Equipment &equipment)
+                {
+                    body += '\n';
+                    body += escapeField(equipment.getId());
+                });
+            return body;
+        }
+
+        if (command == "HANDOFF")
+        {
+            char target_address[256];
+            char id_field[1024];
+            unsigned target_port = 0;
+            auto id = std::sscanf(argument.c_str(), "%1023s %255s %u", id_field, target_address, &target_port) == 3
+                          ? unescapeField(id_field)
+                          : std::nullopt;
+            if (!id || id->empty() || target_port == 0 || target_port > 65535)
+            {
+                return "ERR malformed handoff";
+            }
+            return handOff(*id, target_address, static_cast<uint16_t>(target_port));
+        }
+
+        // The remaining commands name one machine
+        auto id = unescapeField(argument);
+        if (!id || id->empty())
+        {
+            return "ERR unknown command";
+        }
+
+        if (command == "REMOVE")
+        {
+            return service_.removeEquipment(*id) ? "OK" : "NONE";
+        }
+        if (command == "POSITION")
+        {
+            auto position = lines.size() >= 2 ? decodeClusterPosition(lines[1]) : std::nullopt;
+            if (!position)
+            {
+                return "ERR malformed position";
+            }
+            return service_.updateEquipmentPosition(*id, *position) ? "OK" : "NONE";
+        }
+        if (command == "APPEND")
+        {
+            std::vector<Position> history;
+            for (size_t i = 1; i < lines.size(); ++i)
+            {
+                auto position = decodeClusterPosition(lines[i]);
+                if (!position)
+                {
+                    return "ERR malformed position";
+                }
+                history.push_back(*position);
+            }
+            return service_.importPositionHistory(*id, history) ? "OK" : "NONE";
+        }
+        if (command == "GET")
+        {
+            auto equipment = service_.getEquipment(*id);
+            return equipment ? "OK\n" + encodeClusterEquipment(*equipment) : "NONE";
+        }
+        if (command == "EXPORT")
+        {
+            auto equipment = service_.getEquipment(*id);
+            if (!equipment)
+            {
+                return "NONE";
+            }
+            std::string body = "OK\n" + encodeClusterEquipment(*equipment);
+            for (const auto &position : equipment->getPositionHistory())
+            {
+                body += '\n';
+                body += encodeClusterPosition(position);
+            }
+            return body;
+        }
+        return "ERR unknown command";
+    }
+
+    std::string ClusterNode::handOff(const EquipmentId &id, const std::string &address, uint16_t port)
+    {
+        auto equipment = service_.getEquipment(id);
+        if (!equipment)
+        {
+            return "NONE";
+        }
+
+        int fd = connectTcp(address, port, CLUSTER_REQUEST_TIMEOUT_MS);
+        if (fd < 0)
+        {
+            return "ERR unreachable";
+        }
+        std::string buffer;
+        auto call = [&](const std::string &request)
+        {
+            std::string response;
+            return writeFrame(fd, request) && readFrame(fd, buffer, response, CLUSTER_MAX_FRAME_SIZE) &&
+                   response == "OK";
+        };
+
+        // The record carries the utilization counters; the recent tail is
+        // not sent separately, since the new node reads it back from storage
+        equipment->setPositionHistory({});
+        bool created = call("IMPORT\n" + encodeClusterEquipment(*equipment));
+        bool copied = created;
+
+        // Stream the full stored history, archives included, in bounded frames
+        std::string request;
+        size_t pending = 0;
+        auto flush = [&]()
+        {
+            bool sent = pending == 0 || call(request);
+            request.clear();
+            pending = 0;
+            return sent;
+        };
+        if (created)
+        {
+            service_.getDataStorage().scanPositionHistory(
+                id, Timestamp(), Timestamp::max(),
+                [&](const std::vector<Position> &chunk)
+                {
+                    for (const auto &position : chunk)
+                    {
+                        if (pending == 0)
+                        {
+                            request = "APPEND " + escapeField(id);
+                        }
+                        request += '\n';
+                        request += encodeClusterPosition(position);
+                        if (++pending == CLUSTER_HANDOFF_CHUNK_FIXES && !flush())
+                        {
+                            copied = false;
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+            copied = copied && flush();
+        }
+
+        // A partial copy is dropped so the machine stays whole on this node
+        if (created && !copied)
+        {
+            call("REMOVE " + escapeField(id));
+        }
+        closeSocket(fd);
+        return copied ? "OK" : "ERR handoff failed";
+    }
+
+    ClusterRouter::ClusterRouter(size_t virtual_nodes)
+        : ring_(virtual_nodes)
+    {
+    }
+
+    ClusterRouter::~ClusterRouter()
+    {
+        for (auto &[name, peer] : peers_)
+        {
+            if (peer->fd >= 0)
+            {
+                closeSocket(peer->fd);
+            }
+        }
+    }
+
+    std::optional<std::string> ClusterRouter::call(Peer &peer, const std::string &request)
+    {
+        std::lock_guard<std::mutex> lock(peer.mutex);
+
+        if (peer.fd < 0)
+        {
+            peer.fd = connectTcp(peer.address, peer.port, CLUSTER_REQUEST_TIMEOUT_MS);
+            peer.buffer.clear();
+            if (peer.fd < 0)
+            {
+                return std::nullopt;
+            }
+        }
+
+        std::string response;
+        if (!writeFrame(peer.fd, request) || !readFrame(peer.fd, peer.buffer, response, CLUSTER_MAX_FRAME_SIZE))
+        {
+            // The next call reconnects
+            std::cerr << "Cluster node " << peer.address << ":" << peer.port << " did not answer." << std::endl;
+            closeSocket(peer.fd);
+            peer.fd = -1;
+            return std::nullopt;
+        }
+        return response;
+    }
+
+    std::shared_ptr<ClusterRouter::Peer> ClusterRouter::ownerPeer(const EquipmentId &id) const
+    {
+        auto owner = ring_.ownerOf(id);
+        if (!owner)
+        {
+            std::cerr << "Cluster has no nodes." << std::endl;
+            return nullptr;
+        }
+        return peers_.at(*owner);
+    }
+
+    std::optional<size_t> ClusterRouter::addNode(const std::string &node, const std::string &address, uint16_t port)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+
+        if (ring_.hasNode(node))
+        {
+            std::cerr << "Cluster node " << node << " is already a member." << std::endl;
+            return std::nullopt;
+        }
+
+        auto peer = std::make_shared<Peer>();
+        peer->address = address;
+        peer->port = port;
+        if (call(*peer, "PING") != std::optional<std::string>("OK"))
+        {
+            std::cerr << "Cluster node " << node << " is unreachable." << std::endl;
+            return std::nullopt;
+        }
+
+        // Only machines whose owner becomes the new node move
+        ConsistentHashRing next = ring_;
+        next.addNode(node);
+        size_t moved = 0;
+        for (auto &[name, existing] : peers_)
+        {
+            auto ids = listIds(*existing);
+            if (!ids)
+            {
+                std::cerr << "Cluster node " << name << " could not be rebalanced." << std::endl;
+                continue;
+            }
+            for (const auto &id : *ids)
+            {
+                if (next.ownerOf(id) == node && moveEquipment(id, *existing, *peer))
+                {
+                    ++moved;
+                }
+            }
+        }
+
+        peers_.emplace(node, std::move(peer));
+        ring_ = std::move(next);
+        return moved;
+    }
+
+    std::optional<size_t> ClusterRouter::removeNode(const std::string &node)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+
+        if (!ring_.hasNode(node))
+        {
+            std::cerr << "Cluster node " << node << " is not a member." << std::endl;
+            return std::nullopt;
+        }
+        if (ring_.size() == 1)
+        {
+            std::cerr << "The last cluster node cannot be removed." << std::endl;
+            return std::nullopt;
+        }
+
+        // The leaving node's machines go to their successors on the ring
+        ConsistentHashRing next = ring_;
+        next.removeNode(node);
+        auto leaving = peers_.at(node);
+        size_t moved = 0;
+        auto ids = listIds(*leaving);
+        if (!ids)
+        {
+            std::cerr << "Cluster node " << node << " is unreachable; its machines were not moved." << std::endl;
+        }
+        for (const auto &id : ids ? *ids : std::vector<EquipmentId>())
+        {
+            if (moveEquipment(id, *leaving, *peers_.at(*next.ownerOf(id))))
+            {
+                ++moved;
+            }
+        }
+
+        peers_.erase(node);
+        ring_ = std::move(next);
+        return moved;
+    }
+
+    std::vector<std::string> ClusterRouter::getNodes() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return ring_.getNodes();
+    }
+
+    std::optional<std::string> ClusterRouter::ownerOf(const EquipmentId &id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return ring_.ownerOf(id);
+    }
+
+    bool ClusterRouter::addEquipment(const Equipment &equipment)
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto peer = ownerPeer(equipment.getId());
+        return peer && call(*peer, "ADD\n" + encodeClusterEquipment(equipment)) == std::optional<std::string>("OK");
+    }
+
+    bool ClusterRouter::removeEquipment(const EquipmentId &id)
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto peer = ownerPeer(id);
+        return peer && call(*peer, "REMOVE " + escapeField(id)) == std::optional<std::string>("OK");
+    }
+
+    bool ClusterRouter::updateEquipmentPosition(const EquipmentId &id, const Position &position)
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto peer = ownerPeer(id);
+        return peer && call(*peer, "POSITION " + escapeField(id) + "\n" + encodeClusterPosition(position)) ==
+                           std::optional<std::string>("OK");
+    }
+
+    std::optional<Equipment> ClusterRouter::getEquipment(const EquipmentId &id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto peer = ownerPeer(id);
+        auto response = peer ? call(*peer, "GET " + escapeField(id)) : std::nullopt;
+        if (!response || response->compare(0, 3, "OK\n") != 0)
+        {
+            return std::nullopt;
+        }
+        return decodeClusterEquipment(response->substr(3));
+    }
+
+    std::vector<Equipment> ClusterRouter::getAllEquipment() const
+    {
+        return gather("ALL");
+    }
+
+    std::vector<Equipment> ClusterRouter::findEquipmentByStatus(EquipmentStatus status) const
+    {
+        return gather("STATUS " + std::to_string(static_cast<int>(status)));
+    }
+
+    std::vector<Equipment> ClusterRouter::findEquipmentInArea(double lat1, double lon1,
+                                                              double lat2, double lon2) const
+    {
+        char request[128];
+        std::snprintf(request, sizeof(request), "AREA %.17g %.17g %.17g %.17g", lat1, lon1, lat2, lon2);
+        return gather(request);
+    }
+
+    std::vector<Equipment> ClusterRouter::gather(const std::string &request) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+
+        // Every node is asked at once; the slowest one sets the latency
+        std::vector<std::future<std::optional<std::string>>> responses;
+        responses.reserve(peers_.size());
+        for (const auto &[name, peer] : peers_)
+        {
+            responses.push_back(std::async(std::launch::async,
+                                           [peer = peer, &request]
+                                           {
+                                               return call(*peer, request);
+                                           }));
+        }
+
+        std::vector<Equipment> result;
+        for (auto &response : responses)
+        {
+            auto body = response.get();
+            if (!body || body->compare(0, 2, "OK") != 0)
+            {
+                std::cerr << "Cluster query returned partial results." << std::endl;
+                continue;
+            }
+            auto equipment = decodeEquipmentList(*body);
+            std::move(equipment.begin(), equipment.end(), std::back_inserter(result));
+        }
+
+        std::sort(result.begin(), result.end(),
+                  [](const Equipment &a, const Equipment &b)
+                  {
+                      return a.getId() < b.getId();
+                  });
+        return result;
+    }
+
+    std::optional<std::vector<EquipmentId>> ClusterRouter::listIds(Peer &peer)
+    {
+        auto response = call(peer, "IDS");
+        if (!response || response->compare(0, 2, "OK") != 0)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<EquipmentId> ids;
+        auto lines = splitLines(*response);
+        for (size_t i = 1; i < lines.size(); ++i)
+        {
+            auto id = unescapeField(lines[i]);
+            if (id && !id->empty())
+            {
+                ids.push_back(std::move(*id));
+            }
+        }
+        return ids;
+    }
+
+    bool ClusterRouter::moveEquipment(const EquipmentId &id, Peer &from, Peer &to)
+    {
+        // The old node copies the record and its whole stored history to the
+        // new one before it is removed, so a failure leaves it on the old node
+        std::string request = "HANDOFF " + escapeField(id) + " " + to.address + " " + std::to_string(to.port);
+        if (call(from, request) != std::optional<std::string>("OK"))
+        {
+            std::cerr << "Cluster could not move " << id << "; it stays on its previous node." << std::endl;
+            return false;
+        }
+        return call(from, "REMOVE " + escapeField(id)) == std::optional<std::string>("OK");
+    }
+
+} // namespace equipment_tracker
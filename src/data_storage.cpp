@@ -5,17 +5,200 @@
 #include <algorithm>
 #include <ctime>
 #include <iomanip>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <unordered_set>
 #include "equipment_tracker/data_storage.h"
+#include "equipment_tracker/utils/crc32c.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace equipment_tracker
 {
 
+    namespace
+    {
+        constexpr const char *CHECKSUM_KEY = "checksum=";
+        constexpr size_t CHECKSUM_LINE_SIZE = 9 + 8 + 1; // key, 8 hex digits, newline
+
+        // Prefix a record file's content with the CRC-32C of that content
+        std::string withChecksumLine(const std::string &content)
+        {
+            char line[CHECKSUM_LINE_SIZE + 1];
+            std::snprintf(line, sizeof(line), "%s%08x\n", CHECKSUM_KEY,
+                          static_cast<unsigned int>(crc32c(content.data(), content.size())));
+            return line + content;
+        }
+
+        // Remove and check the checksum line. Files written before checksums
+        // existed have none and pass unchanged
+        bool stripChecksumLine(std::string &content)
+        {
+            if (content.compare(0, std::strlen(CHECKSUM_KEY), CHECKSUM_KEY) != 0)
+            {
+                return true;
+            }
+            if (content.size() < CHECKSUM_LINE_SIZE || content[CHECKSUM_LINE_SIZE - 1] != '\n')
+            {
+                return false;
+            }
+
+            unsigned long expected = std::strtoul(content.substr(std::strlen(CHECKSUM_KEY), 8).c_str(), nullptr, 16);
+            content.erase(0, CHECKSUM_LINE_SIZE);
+            return crc32c(content.data(), content.size()) == expected;
+        }
+
+        // Serialized equipment record, checksum line first
+        std::string formatEquipmentRecord(const Equipment &equipment)
+        {
+            std::ostringstream file;
+            file << "id=" << equipment.getId() << std::endl;
+            file << "name=" << equipment.getName() << std::endl;
+            file << "type=" << static_cast<int>(equipment.getType()) << std::endl;
+            file << "status=" << static_cast<int>(equipment.getStatus()) << std::endl;
+
+            // Write last position if available
+            auto last_pos = equipment.getLastPosition();
+            if (last_pos)
+            {
+                file << std::fixed << std::setprecision(10);
+                file << "last_position=" << last_pos->getLatitude() << ","
+                     << last_pos->getLongitude() << ","
+                     << last_pos->getAltitude() << ","
+                     << last_pos->getAccuracy() << ","
+                     << std::chrono::system_clock::to_time_t(last_pos->getTimestamp())
+                     << std::endl;
+            }
+
+            // Cumulative counters: moving seconds, idle seconds, meters
+            auto utilization = equipment.getUtilization();
+            if (utilization.operatingSeconds() > 0.0)
+            {
+                file << std::fixed << std::setprecision(3);
+                file << "utilization=" << utilization.moving_seconds << ","
+                     << utilization.idle_seconds << ","
+                     << utilization.distance_meters << std::endl;
+            }
+
+            // A torn or bit-rotted file fails the checksum on load
+            return withChecksumLine(file.str());
+        }
+
+        constexpr const char *PACK_SAVED = "saved";
+        constexpr const char *PACK_DELETED = "deleted";
+
+        // Pack entry: "<kind> <id length> <record length>\n", the ID, then the
+        // record exactly as an <id>.txt file would hold it
+        std::string packEntryHeader(const char *kind, const EquipmentId &id, size_t record_length)
+        {
+            return kind + (' ' + std::to_string(id.size()) + ' ' + std::to_string(record_length) + '\n');
+        }
+
+        void appendPackEntry(std::string &pack, const char *kind, const EquipmentId &id, const std::string &record)
+        {
+            pack += packEntryHeader(kind, id, record.size());
+            pack += id;
+            pack += record;
+        }
+
+        int openForOverwrite(const std::string &path)
+        {
+#ifdef _WIN32
+            return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+            return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+        }
+
+        void closeFile(int fd)
+        {
+#ifdef _WIN32
+            _close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+    } // namespace
+
     // For simplicity, this implementation uses a file-based storage
     // A real implementation would use SQLite or another database
 
-    DataStorage::DataStorage(const std::string &db_path)
-        : db_path_(db_path), is_initialized_(false)
+    DataStorage::DataStorage(const std::string &db_path, IoBackendType io_backend,
+                             const PositionLogOptions &log_options)
+        : db_path_(db_path), is_initialized_(false), change_feed_(db_path + "/cdc"),
+          io_(createStorageIoBackend(io_backend)), log_options_(log_options)
+    {
+        if (!io_)
+        {
+            std::cerr << "Requested I/O backend unavailable; using thread pool." << std::endl;
+            io_ = createStorageIoBackend(IoBackendType::ThreadPool);
+        }
+    }
+
+    DataStorage::~DataStorage()
+    {
+        {
+            std::lock_guard<std::mutex> lock(reclaim_mutex_);
+            reclaim_stop_ = true;
+        }
+        reclaim_condition_.notify_all();
+        if (reclaim_thread_.joinable())
+        {
+            reclaim_thread_.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(archive_mutex_);
+            archive_stop_ = true;
+        }
+        archive_condition_.notify_all();
+        if (archive_thread_.joinable())
+        {
+            archive_thread_.join();
+        }
+
+        flush();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        position_logs_.clear();
+    }
+
+    bool DataStorage::flush()
     {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        bool updates_written = writePendingUpdates();
+
+        // Syncs only cover writes that have completed
+        io_->wait();
+        for (auto &[_, log] : position_logs_)
+        {
+            log->writeTail();
+        }
+        io_->wait();
+
+        auto ok = std::make_shared<std::atomic<bool>>(true);
+        for (auto &[_, log] : position_logs_)
+        {
+            log->submitSync(ok);
+        }
+        io_->wait();
+
+        for (auto &[_, log] : position_logs_)
+        {
+            log->releaseSealed();
+        }
+        return ok->load() && updates_written;
     }
 
     bool DataStorage::initialize()
@@ -42,6 +225,26 @@ namespace equipment_tracker
 
             // Initialize the database structure
             initDatabase();
+            loadEquipmentPacks();
+
+            if (!reclaim_thread_.joinable())
+            {
+                // Resume reclaiming tombstones left by an earlier run
+                for (const auto &entry : std::filesystem::directory_iterator(db_path_ + "/tombstones"))
+                {
+                    scheduleReclamation(entry.path());
+                }
+                reclaim_thread_ = std::thread(&DataStorage::reclaimLoop, this);
+            }
+            if (!archive_thread_.joinable())
+            {
+                archive_thread_ = std::thread(&DataStorage::archiveLoop, this);
+            }
+
+            if (!change_feed_.open())
+            {
+                return false;
+            }
 
             is_initialized_ = true;
             return true;
@@ -73,39 +276,82 @@ namespace equipment_tracker
 
             // Save equipment to file
             std::string filename = equipment_dir + "/" + equipment.getId() + ".txt";
-            std::ofstream file(filename);
+            std::ofstream out(filename, std::ios::binary);
 
-            if (!file.is_open())
+            if (!out.is_open())
             {
                 std::cerr << "Failed to open file for writing: " << filename << std::endl;
                 return false;
             }
 
             // Write equipment data
-            file << "id=" << equipment.getId() << std::endl;
-            file << "name=" << equipment.getName() << std::endl;
-            file << "type=" << static_cast<int>(equipment.getType()) << std::endl;
-            file << "status=" << static_cast<int>(equipment.getStatus()) << std::endl;
+            out << formatEquipmentRecord(equipment);
+            out.close();
+            pending_updates_.erase(equipment.getId());
+            change_feed_.appendEquipmentSaved(equipment);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "DataStorage saveEquipment error: " << e.what() << std::endl;
+            return false;
+        }
+    }
 
-            // Write last position if available
-            auto last_pos = equipment.getLastPosition();
-            if (last_pos)
+    bool DataStorage::saveEquipmentBatch(const std::vector<Equipment> &equipment)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return false;
+        }
+
+        // The batch supersedes any update still pending for the same records
+        for (const auto &item : equipment)
+        {
+            pending_updates_.erase(item.getId());
+        }
+        return saveEquipmentBatchInternal(equipment);
+    }
+
+    bool DataStorage::saveEquipmentBatchInternal(const std::vector<Equipment> &equipment)
+    {
+        try
+        {
+            // The whole batch goes to disk as one pack file
+            std::string pack;
+            std::vector<PackedRecord> records;
+            records.reserve(equipment.size());
+            for (const auto &item : equipment)
             {
-                file << std::fixed << std::setprecision(10);
-                file << "last_position=" << last_pos->getLatitude() << ","
-                     << last_pos->getLongitude() << ","
-                     << last_pos->getAltitude() << ","
-                     << last_pos->getAccuracy() << ","
-                     << std::chrono::system_clock::to_time_t(last_pos->getTimestamp())
-                     << std::endl;
+                std::string record = formatEquipmentRecord(item);
+                appendPackEntry(pack, PACK_SAVED, item.getId(), record);
+                records.push_back({0, pack.size() - record.size(), record.size()});
+            }
+
+            uint64_t number = writeEquipmentPack(pack);
+            if (number == 0)
+            {
+                return false;
+            }
+
+            // Files from earlier single saves would shadow the packed records
+            std::error_code error;
+            for (size_t i = 0; i < equipment.size(); ++i)
+            {
+                records[i].pack = number;
+                packed_equipment_[equipment[i].getId()] = records[i];
+                std::filesystem::remove(db_path_ + "/equipment/" + equipment[i].getId() + ".txt", error);
             }
 
-            file.close();
+            maybeCompactEquipmentPacks();
+            change_feed_.appendEquipmentSavedBatch(equipment);
             return true;
         }
         catch (const std::exception &e)
         {
-            std::cerr << "DataStorage saveEquipment error: " << e.what() << std::endl;
+            std::cerr << "DataStorage saveEquipmentBatch error: " << e.what() << std::endl;
             return false;
         }
     }
@@ -113,10 +359,16 @@ namespace equipment_tracker
     std::optional<Equipment> DataStorage::loadEquipment(const EquipmentId &id)
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        return loadEquipmentInternal(id);
+        return loadEquipmentInternal(id, true);
+    }
+
+    std::optional<Equipment> DataStorage::loadEquipmentRecord(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return loadEquipmentInternal(id, false);
     }
 
-    std::optional<Equipment> DataStorage::loadEquipmentInternal(const EquipmentId &id)
+    std::optional<Equipment> DataStorage::loadEquipmentInternal(const EquipmentId &id, bool with_history)
     {
         if (!is_initialized_ && !initializeInternal())
         {
@@ -125,20 +377,42 @@ namespace equipment_tracker
 
         try
         {
-            // Check if equipment file exists
+            // A pending update wins over a single-save file, which wins over a
+            // packed record
             std::string filename = db_path_ + "/equipment/" + id + ".txt";
-            if (!std::filesystem::exists(filename))
+            std::string content;
+            auto pending = pending_updates_.find(id);
+            if (pending != pending_updates_.end())
             {
-                return std::nullopt;
+                content = formatEquipmentRecord(pending->second);
             }
+            else if (std::filesystem::exists(filename))
+            {
+                std::ifstream in(filename, std::ios::binary);
+                if (!in.is_open())
+                {
+                    std::cerr << "Failed to open file for reading: " << filename << std::endl;
+                    return std::nullopt;
+                }
 
-            // Open file for reading
-            std::ifstream file(filename);
-            if (!file.is_open())
+                content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                in.close();
+            }
+            else
+            {
+                auto packed = packed_equipment_.find(id);
+                if (packed == packed_equipment_.end() || !readPackedRecord(packed->second, content))
+                {
+                    return std::nullopt;
+                }
+                filename = packPath(packed->second.pack).string();
+            }
+            if (!stripChecksumLine(content))
             {
-                std::cerr << "Failed to open file for reading: " << filename << std::endl;
+                std::cerr << "Checksum mismatch, skipping corrupt record: " << filename << std::endl;
                 return std::nullopt;
             }
+            std::istringstream file(content);
 
             // Read equipment data
             std::string line;
@@ -146,6 +420,7 @@ namespace equipment_tracker
             EquipmentType type = EquipmentType::Other;
             EquipmentStatus status = EquipmentStatus::Unknown;
             std::optional<Position> last_position;
+            UtilizationCounters utilization;
 
             while (std::getline(file, line))
             {
@@ -192,14 +467,21 @@ namespace equipment_tracker
                                 std::chrono::system_clock::from_time_t(timestamp));
                         }
                     }
+                    else if (key == "utilization")
+                    {
+                        char separator;
+                        std::istringstream counters(value);
+                        counters >> utilization.moving_seconds >> separator
+                                 >> utilization.idle_seconds >> separator
+                                 >> utilization.distance_meters;
+                    }
                 }
             }
 
-            file.close();
-
             // Create equipment object
             Equipment equipment(id, type, name);
             equipment.setStatus(status);
+            equipment.setUtilization(utilization);
 
             if (last_position)
             {
@@ -207,10 +489,12 @@ namespace equipment_tracker
             }
 
             // Load position history (call internal version without locking)
-            auto history = getPositionHistoryInternal(id);
-            for (const auto &pos : history)
+            if (with_history)
             {
-                equipment.recordPosition(pos);
+                for (const auto &pos : getPositionHistoryInternal(id))
+                {
+                    equipment.recordPosition(pos);
+                }
             }
 
             return std::optional<Equipment>(std::move(equipment));
@@ -224,8 +508,44 @@ namespace equipment_tracker
 
     bool DataStorage::updateEquipment(const Equipment &equipment)
     {
-        // For this simple implementation, save and update are the same
-        return saveEquipment(equipment);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return false;
+        }
+
+        // Called on every fix: hold the record and write updates in batches
+        auto now = std::chrono::steady_clock::now();
+        if (pending_updates_.empty())
+        {
+            oldest_pending_update_ = now;
+        }
+        pending_updates_.insert_or_assign(equipment.getId(), equipment);
+
+        if (pending_updates_.size() >= EQUIPMENT_UPDATE_BATCH_SIZE ||
+            now - oldest_pending_update_ >= std::chrono::milliseconds(EQUIPMENT_UPDATE_MAX_DELAY_MS))
+        {
+            return writePendingUpdates();
+        }
+        return true;
+    }
+
+    bool DataStorage::writePendingUpdates()
+    {
+        if (pending_updates_.empty())
+        {
+            return true;
+        }
+
+        std::vector<Equipment> batch;
+        batch.reserve(pending_updates_.size());
+        for (auto &[_, equipment] : pending_updates_)
+        {
+            batch.push_back(std::move(equipment));
+        }
+        pending_updates_.clear();
+        return saveEquipmentBatchInternal(batch);
     }
 
     bool DataStorage::deleteEquipment(const EquipmentId &id)
@@ -239,20 +559,18 @@ namespace equipment_tracker
 
         try
         {
-            // Delete equipment file
-            std::string filename = db_path_ + "/equipment/" + id + ".txt";
-            if (std::filesystem::exists(filename))
+            if (!removePackedRecords({id}))
             {
-                std::filesystem::remove(filename);
+                return false;
             }
 
-            // Delete position history directory
-            std::string history_dir = db_path_ + "/positions/" + id;
-            if (std::filesystem::exists(history_dir))
-            {
-                std::filesystem::remove_all(history_dir);
-            }
+            // Move the record and its history under a tombstone: two renames,
+            // however long the history. The reclaimer deletes the files later
+            std::filesystem::path tombstone = newTombstonePath(id);
+            moveToTombstone(id, tombstone);
+            scheduleReclamation(tombstone);
 
+            change_feed_.appendEquipmentDeleted(id);
             return true;
         }
         catch (const std::exception &e)
@@ -273,40 +591,40 @@ namespace equipment_tracker
 
         try
         {
-            // Create positions directory
-            std::string positions_dir = db_path_ + "/positions";
-            if (!std::filesystem::exists(positions_dir))
+            PositionLog *log = openPositionLog(id, true);
+
+            // Opened first: a rollup is rebuilt from the fixes stored before this one
+            HistoryRollup *rollup = openRollup(id, true);
+
+            // Queue the append; the backend batches it with other writes
+            if (!log || !log->append(position))
             {
-                std::filesystem::create_directory(positions_dir);
+                return false;
             }
-
-            // Create equipment directory
-            std::string equipment_dir = positions_dir + "/" + id;
-            if (!std::filesystem::exists(equipment_dir))
+            if (rollup)
             {
-                std::filesystem::create_directory(equipment_dir);
+                rollup->add(position);
             }
-
-            // Create filename based on timestamp
-            auto timestamp = std::chrono::system_clock::to_time_t(position.getTimestamp());
-            std::string filename = equipment_dir + "/" + std::to_string(timestamp) + ".txt";
-
-            // Save position to file
-            std::ofstream file(filename);
-            if (!file.is_open())
+            if (auto cutoff = log->takeArchiveCutoff())
             {
-                std::cerr << "Failed to open file for writing: " << filename << std::endl;
-                return false;
+                scheduleArchiving(id, *cutoff);
             }
 
-            file << std::fixed << std::setprecision(10);
-            file << "latitude=" << position.getLatitude() << std::endl;
-            file << "longitude=" << position.getLongitude() << std::endl;
-            file << "altitude=" << position.getAltitude() << std::endl;
-            file << "accuracy=" << position.getAccuracy() << std::endl;
-            file << "timestamp=" << timestamp << std::endl;
+            auto hot = hot_history_.find(id);
+            if (hot != hot_history_.end() && position.getTimestamp() >= hot->second.covered_from)
+            {
+                auto &fixes = hot->second.fixes;
+                auto later = std::upper_bound(fixes.begin(), fixes.end(), position,
+                                              [](const Position &a, const Position &b)
+                                              {
+                                                  return a.getTimestamp() < b.getTimestamp();
+                                              });
+                fixes.insert(later, position);
+                trimHotHistory(hot->second, fixes.back().getTimestamp() -
+                                                std::chrono::seconds(HOT_HISTORY_WINDOW_SECONDS));
+            }
 
-            file.close();
+            change_feed_.appendPositionSaved(id, position);
             return true;
         }
         catch (const std::exception &e)
@@ -339,93 +657,70 @@ namespace equipment_tracker
 
         try
         {
-            // Check if equipment position directory exists
-            std::string directory = db_path_ + "/positions/" + id;
-            if (!std::filesystem::exists(directory))
-            {
-                return result;
-            }
-
             // Convert timestamps to time_t
             time_t start_time = std::chrono::system_clock::to_time_t(start);
             time_t end_time = std::chrono::system_clock::to_time_t(end);
 
-            // Collect all position files
-            std::vector<std::filesystem::path> position_files;
-            for (const auto &entry : std::filesystem::directory_iterator(directory))
+            auto inRange = [&](time_t timestamp)
             {
-                if (entry.is_regular_file())
+                return timestamp >= start_time && timestamp <= end_time;
+            };
+
+            // Fixes stored one file per fix by earlier versions
+            for (const auto &path : listLegacyPositionFiles(id))
+            {
+                time_t timestamp = std::stoull(path.stem().string());
+                if (inRange(timestamp))
                 {
-                    position_files.push_back(entry.path());
+                    auto position = readPositionFile(path, timestamp);
+                    if (position)
+                    {
+                        result.push_back(std::move(*position));
+                    }
                 }
             }
 
-            // Sort files by name (which is based on timestamp)
-            std::sort(position_files.begin(), position_files.end());
+            // Fixes in the append log. The bounds are compared in whole seconds
+            Timestamp first = std::chrono::system_clock::from_time_t(start_time);
+            Timestamp last = std::chrono::system_clock::from_time_t(end_time) +
+                             std::chrono::seconds(1) - Timestamp::duration(1);
 
-            // Load positions within time range
-            for (const auto &path : position_files)
+            // Recent ranges load the equipment into the hot tier
+            Timestamp now = getCurrentTimestamp();
+            auto cached = hot_history_.find(id);
+            HotHistory *hot = cached != hot_history_.end() ? &cached->second : nullptr;
+            if (!hot && first >= now - std::chrono::seconds(HOT_HISTORY_WINDOW_SECONDS))
             {
-                std::string filename = path.filename().string();
+                hot = primeHotHistory(id, now);
+            }
 
-                // Extract timestamp from filename
-                size_t dot_pos = filename.find('.');
-                if (dot_pos != std::string::npos)
+            if (hot && first >= hot->covered_from)
+            {
+                for (const auto &position : hot->fixes)
                 {
-                    std::string timestamp_str = filename.substr(0, dot_pos);
-                    time_t timestamp = std::stoull(timestamp_str);
-
-                    // Check if within time range
-                    if (timestamp >= start_time && timestamp <= end_time)
+                    if (inRange(std::chrono::system_clock::to_time_t(position.getTimestamp())))
                     {
-                        // Load position from file
-                        std::ifstream file(path);
-                        if (file.is_open())
-                        {
-                            double latitude = 0.0;
-                            double longitude = 0.0;
-                            double altitude = 0.0;
-                            double accuracy = DEFAULT_POSITION_ACCURACY;
-
-                            std::string line;
-                            while (std::getline(file, line))
-                            {
-                                size_t pos = line.find('=');
-                                if (pos != std::string::npos)
-                                {
-                                    std::string key = line.substr(0, pos);
-                                    std::string value = line.substr(pos + 1);
-
-                                    if (key == "latitude")
-                                    {
-                                        latitude = std::stod(value);
-                                    }
-                                    else if (key == "longitude")
-                                    {
-                                        longitude = std::stod(value);
-                                    }
-                                    else if (key == "altitude")
-                                    {
-                                        altitude = std::stod(value);
-                                    }
-                                    else if (key == "accuracy")
-                                    {
-                                        accuracy = std::stod(value);
-                                    }
-                                }
-                            }
-
-                            file.close();
-
-                            // Create position and add to result
-                            result.emplace_back(
-                                latitude, longitude, altitude, accuracy,
-                                std::chrono::system_clock::from_time_t(timestamp));
-                        }
+                        result.push_back(position);
+                    }
+                }
+            }
+            else if (PositionLog *log = openPositionLog(id, false))
+            {
+                for (auto &position : log->readRange(first, last))
+                {
+                    if (inRange(std::chrono::system_clock::to_time_t(position.getTimestamp())))
+                    {
+                        result.push_back(std::move(position));
                     }
                 }
             }
 
+            std::stable_sort(result.begin(), result.end(),
+                             [](const Position &a, const Position &b)
+                             {
+                                 return a.getTimestamp() < b.getTimestamp();
+                             });
+
             return result;
         }
         catch (const std::exception &e)
@@ -435,45 +730,643 @@ namespace equipment_tracker
         }
     }
 
-    std::vector<Equipment> DataStorage::getAllEquipment()
+    bool DataStorage::scanPositionHistory(
+        const EquipmentId &id,
+        const Timestamp &start,
+        const Timestamp &end,
+        const std::function<bool(const std::vector<Position> &)> &visit)
     {
-        std::vector<Equipment> result;
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        if (!is_initialized_ && !initializeInternal())
+        std::vector<Position> chunk;
+        bool found = false;
         {
-            return result;
-        }
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        try
-        {
-            // Check if equipment directory exists
-            std::string directory = db_path_ + "/equipment";
-            if (!std::filesystem::exists(directory))
+            if (!is_initialized_ && !initializeInternal())
             {
-                return result;
+                return false;
             }
 
-            // Iterate through all equipment files
-            for (const auto &entry : std::filesystem::directory_iterator(directory))
+            // Fixes stored one file per fix by earlier versions come first
+            try
             {
-                if (entry.is_regular_file())
+                for (const auto &path : listLegacyPositionFiles(id))
                 {
-                    std::string filename = entry.path().filename().string();
-
-                    // Extract equipment ID from filename
-                    size_t dot_pos = filename.find('.');
-                    if (dot_pos != std::string::npos)
+                    auto position = readPositionFile(path, std::stoull(path.stem().string()));
+                    if (position && position->getTimestamp() >= start && position->getTimestamp() <= end)
                     {
-                        std::string id = filename.substr(0, dot_pos);
+                        chunk.push_back(std::move(*position));
+                    }
+                }
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "DataStorage scanPositionHistory error: " << e.what() << std::endl;
+            }
+            std::sort(chunk.begin(), chunk.end(),
+                      [](const Position &a, const Position &b)
+                      {
+                          return a.getTimestamp() < b.getTimestamp();
+                      });
+            found = !chunk.empty() || openPositionLog(id, false) != nullptr;
+        }
+
+        if (!chunk.empty() && !visit(chunk))
+        {
+            return found;
+        }
+
+        size_t next_segment = 0;
+        for (;;)
+        {
+            chunk.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                PositionLog *log = openPositionLog(id, false);
+                if (!log || !log->readRangeChunk(start, end, next_segment, chunk))
+                {
+                    break;
+                }
+            }
+            if (!chunk.empty() && !visit(chunk))
+            {
+                break;
+            }
+        }
+        return found;
+    }
+
+    std::vector<PositionAggregate> DataStorage::getAggregatedHistory(
+        const EquipmentId &id,
+        const Timestamp &start,
+        const Timestamp &end,
+        std::chrono::seconds bucket_width)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!HistoryRollup::supportsWidth(bucket_width))
+        {
+            std::cerr << "Aggregation bucket width must be a whole number of minutes, got "
+                      << bucket_width.count() << " s" << std::endl;
+            return {};
+        }
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return {};
+        }
+
+        try
+        {
+            HistoryRollup *rollup = openRollup(id, false);
+            return rollup ? rollup->query(start, end, bucket_width) : std::vector<PositionAggregate>();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "DataStorage getAggregatedHistory error: " << e.what() << std::endl;
+            return {};
+        }
+    }
+
+    std::vector<Position> DataStorage::getRecentPositions(const EquipmentId &id, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<Position> result;
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return result;
+        }
+
+        try
+        {
+            // Legacy files are named by timestamp; only the newest are read
+            auto files = listLegacyPositionFiles(id);
+            std::vector<std::pair<time_t, std::filesystem::path>> legacy;
+            legacy.reserve(files.size());
+            for (const auto &path : files)
+            {
+                legacy.emplace_back(static_cast<time_t>(std::stoull(path.stem().string())), path);
+            }
+            std::sort(legacy.begin(), legacy.end());
+
+            size_t first = legacy.size() > count ? legacy.size() - count : 0;
+            for (size_t i = first; i < legacy.size(); ++i)
+            {
+                auto position = readPositionFile(legacy[i].second, legacy[i].first);
+                if (position)
+                {
+                    result.push_back(std::move(*position));
+                }
+            }
+
+            PositionLog *log = openPositionLog(id, false);
+            if (log)
+            {
+                auto recent = log->readRecent(count);
+                result.insert(result.end(), recent.begin(), recent.end());
+            }
+
+            std::stable_sort(result.begin(), result.end(),
+                             [](const Position &a, const Position &b)
+                             {
+                                 return a.getTimestamp() < b.getTimestamp();
+                             });
+            if (result.size() > count)
+            {
+                result.erase(result.begin(), result.end() - count);
+            }
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "DataStorage getRecentPositions error: " << e.what() << std::endl;
+            return result;
+        }
+    }
+
+    std::vector<Position> DataStorage::getBracketingPositions(
+        const EquipmentId &id,
+        const Timestamp &at)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<Position> result;
+
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return result;
+        }
+
+        try
+        {
+            // Time index over both layouts; legacy files are only opened when selected
+            struct IndexEntry
+            {
+                Timestamp time;
+                std::optional<Position> position;
+                std::filesystem::path legacy_file;
+            };
+
+            std::vector<IndexEntry> index;
+            for (const auto &path : listLegacyPositionFiles(id))
+            {
+                time_t timestamp = std::stoull(path.stem().string());
+                index.push_back(IndexEntry{std::chrono::system_clock::from_time_t(timestamp), std::nullopt, path});
+            }
+            for (auto &position : readBracketingWindow(id, at))
+            {
+                Timestamp time = position.getTimestamp();
+                index.push_back(IndexEntry{time, std::move(position), {}});
+            }
+
+            std::stable_sort(index.begin(), index.end(),
+                             [](const IndexEntry &a, const IndexEntry &b)
+                             {
+                                 return a.time < b.time;
+                             });
+
+            auto load = [&](const IndexEntry &entry)
+            {
+                if (entry.position)
+                {
+                    result.push_back(*entry.position);
+                    return;
+                }
+
+                auto position = readPositionFile(entry.legacy_file,
+                                                 std::chrono::system_clock::to_time_t(entry.time));
+                if (position)
+                {
+                    result.push_back(std::move(*position));
+                }
+            };
+
+            auto after = std::lower_bound(
+                index.begin(), index.end(), at,
+                [](const IndexEntry &entry, const Timestamp &value)
+                {
+                    return entry.time < value;
+                });
+
+            // Exact hit: a single fix answers the query
+            if (after != index.end() && after->time == at)
+            {
+                load(*after);
+                return result;
+            }
+
+            if (after != index.begin())
+            {
+                load(*std::prev(after));
+            }
+
+            if (after != index.end())
+            {
+                load(*after);
+            }
+
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "DataStorage getBracketingPositions error: " << e.what() << std::endl;
+            return result;
+        }
+    }
+
+    PositionLog *DataStorage::openPositionLog(const EquipmentId &id, bool create)
+    {
+        auto it = position_logs_.find(id);
+        if (it != position_logs_.end())
+        {
+            return it->second.get();
+        }
+
+        auto log = std::make_unique<PositionLog>(std::filesystem::path(db_path_) / "positions" / id,
+                                                 *io_, log_options_);
+        if (!log->open(create))
+        {
+            return nullptr;
+        }
+
+        return position_logs_.emplace(id, std::move(log)).first->second.get();
+    }
+
+    HistoryRollup *DataStorage::openRollup(const EquipmentId &id, bool create)
+    {
+        auto it = rollups_.find(id);
+        if (it != rollups_.end())
+        {
+            return it->second.get();
+        }
+
+        std::filesystem::path directory = std::filesystem::path(db_path_) / "positions" / id;
+        if (!create && !std::filesystem::exists(directory))
+        {
+            return nullptr;
+        }
+
+        // Open buckets are not stored; replay the fixes they cover
+        auto rollup = std::make_unique<HistoryRollup>(directory);
+        auto replay_from = rollup->open();
+        Timestamp start = replay_from ? Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                                            std::chrono::nanoseconds(*replay_from)))
+                                      : Timestamp();
+
+        std::vector<Position> fixes;
+        for (const auto &path : listLegacyPositionFiles(id))
+        {
+            auto position = readPositionFile(path, std::stoull(path.stem().string()));
+            if (position && position->getTimestamp() >= start)
+            {
+                fixes.push_back(std::move(*position));
+            }
+        }
+        std::sort(fixes.begin(), fixes.end(),
+                  [](const Position &a, const Position &b)
+                  {
+                      return a.getTimestamp() < b.getTimestamp();
+                  });
+
+        PositionLog *log = openPositionLog(id, false);
+        size_t next_segment = 0;
+        do
+        {
+            for (const auto &fix : fixes)
+            {
+                rollup->add(fix, true);
+            }
+            fixes.clear();
+        } while (log && log->readRangeChunk(start, Timestamp::max(), next_segment, fixes));
+
+        return rollups_.emplace(id, std::move(rollup)).first->second.get();
+    }
+
+    void DataStorage::closePositionLog(const EquipmentId &id)
+    {
+        auto it = position_logs_.find(id);
+        if (it == position_logs_.end())
+        {
+            return;
+        }
+
+        // Let queued writes land before the descriptors go away
+        io_->wait();
+        position_logs_.erase(it);
+    }
+
+    std::vector<Position> DataStorage::readBracketingWindow(const EquipmentId &id, const Timestamp &at)
+    {
+        PositionLog *log = openPositionLog(id, false);
+        if (!log)
+        {
+            return {};
+        }
+
+        std::vector<std::pair<Timestamp, Timestamp>> ranges;
+        if (!log->getSegmentRanges(ranges))
+        {
+            return log->readAll();
+        }
+
+        // A segment's earliest fix before t, or its latest if it ends before
+        // t, bounds the fix just before t from below; likewise from above
+        std::optional<Timestamp> from;
+        std::optional<Timestamp> to;
+        for (const auto &range : ranges)
+        {
+            if (range.first <= at)
+            {
+                Timestamp below = range.second <= at ? range.second : range.first;
+                from = from ? std::max(*from, below) : below;
+            }
+            if (range.second >= at)
+            {
+                Timestamp above = range.first >= at ? range.first : range.second;
+                to = to ? std::min(*to, above) : above;
+            }
+        }
+
+        // Only the segments overlapping [from, to] are read
+        std::vector<Position> positions;
+        size_t next_segment = 0;
+        while (log->readRangeChunk(from.value_or(at), to.value_or(at), next_segment, positions))
+        {
+        }
+        return positions;
+    }
+
+    DataStorage::HotHistory *DataStorage::primeHotHistory(const EquipmentId &id, const Timestamp &now)
+    {
+        auto it = hot_history_.find(id);
+        if (it != hot_history_.end())
+        {
+            return &it->second;
+        }
+
+        PositionLog *log = openPositionLog(id, false);
+        if (!log)
+        {
+            return nullptr;
+        }
+
+        // Loaded once from the newest segments, then kept current by savePosition()
+        HotHistory hot;
+        hot.covered_from = now - std::chrono::seconds(HOT_HISTORY_WINDOW_SECONDS);
+        for (auto &position : log->readRange(hot.covered_from, Timestamp::max()))
+        {
+            hot.fixes.push_back(std::move(position));
+        }
+        std::stable_sort(hot.fixes.begin(), hot.fixes.end(),
+                         [](const Position &a, const Position &b)
+                         {
+                             return a.getTimestamp() < b.getTimestamp();
+                         });
+
+        return &hot_history_.emplace(id, std::move(hot)).first->second;
+    }
+
+    void DataStorage::trimHotHistory(HotHistory &hot, const Timestamp &cutoff)
+    {
+        if (cutoff <= hot.covered_from)
+        {
+            return;
+        }
+
+        hot.covered_from = cutoff;
+        while (!hot.fixes.empty() && hot.fixes.front().getTimestamp() < cutoff)
+        {
+            hot.fixes.pop_front();
+        }
+    }
+
+    size_t DataStorage::maintainHistoryTiers(const Timestamp &now)
+    {
+        std::vector<EquipmentId> ids;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!is_initialized_ && !initializeInternal())
+            {
+                return 0;
+            }
+
+            // Equipment that stopped reporting leaves the hot tier entirely
+            Timestamp hot_cutoff = now - std::chrono::seconds(HOT_HISTORY_WINDOW_SECONDS);
+            for (auto it = hot_history_.begin(); it != hot_history_.end();)
+            {
+                trimHotHistory(it->second, hot_cutoff);
+                it = it->second.fixes.empty() ? hot_history_.erase(it) : std::next(it);
+            }
+
+            try
+            {
+                std::filesystem::path positions_dir = std::filesystem::path(db_path_) / "positions";
+                if (!std::filesystem::exists(positions_dir))
+                {
+                    return 0;
+                }
+
+                for (const auto &entry : std::filesystem::directory_iterator(positions_dir))
+                {
+                    if (entry.is_directory() && openPositionLog(entry.path().filename().string(), false))
+                    {
+                        ids.push_back(entry.path().filename().string());
+                    }
+                }
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "DataStorage maintainHistoryTiers error: " << e.what() << std::endl;
+            }
+        }
+
+        size_t archived = 0;
+        Timestamp warm_cutoff = now - std::chrono::seconds(WARM_HISTORY_WINDOW_SECONDS);
+        for (const auto &id : ids)
+        {
+            archived += archiveHistory(id, warm_cutoff);
+        }
+        return archived;
+    }
+
+    HistoryTierStats DataStorage::getHistoryTierStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        HistoryTierStats stats;
+        for (const auto &[id, hot] : hot_history_)
+        {
+            ++stats.hot_equipment;
+            stats.hot_fixes += hot.fixes.size();
+            stats.hot_bytes += sizeof(HotHistory) + id.capacity() + hot.fixes.size() * sizeof(Position);
+        }
+
+        for (const auto &[id, log] : position_logs_)
+        {
+            PositionLogTiers tiers = log->getTiers();
+            stats.logs.warm_segments += tiers.warm_segments;
+            stats.logs.warm_bytes += tiers.warm_bytes;
+            stats.logs.mapped_bytes += tiers.mapped_bytes;
+            stats.logs.cold_segments += tiers.cold_segments;
+            stats.logs.cold_bytes += tiers.cold_bytes;
+            stats.logs.cold_fixes += tiers.cold_fixes;
+        }
+        return stats;
+    }
+
+    std::vector<std::filesystem::path> DataStorage::listLegacyPositionFiles(const EquipmentId &id)
+    {
+        std::vector<std::filesystem::path> files;
+
+        std::filesystem::path directory = std::filesystem::path(db_path_) / "positions" / id;
+        if (!std::filesystem::exists(directory))
+        {
+            return files;
+        }
+
+        for (const auto &entry : std::filesystem::directory_iterator(directory))
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != ".txt")
+            {
+                continue;
+            }
+
+            std::string stem = entry.path().stem().string();
+            if (!stem.empty() && std::all_of(stem.begin(), stem.end(), ::isdigit))
+            {
+                files.push_back(entry.path());
+            }
+        }
+
+        return files;
+    }
+
+    std::optional<Position> DataStorage::readPositionFile(
+        const std::filesystem::path &path,
+        time_t timestamp)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return std::nullopt;
+        }
+
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double altitude = 0.0;
+        double accuracy = DEFAULT_POSITION_ACCURACY;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t pos = line.find('=');
+            if (pos != std::string::npos)
+            {
+                std::string key = line.substr(0, pos);
+                std::string value = line.substr(pos + 1);
+
+                if (key == "latitude")
+                {
+                    latitude = std::stod(value);
+                }
+                else if (key == "longitude")
+                {
+                    longitude = std::stod(value);
+                }
+                else if (key == "altitude")
+                {
+                    altitude = std::stod(value);
+                }
+                else if (key == "accuracy")
+                {
+                    accuracy = std::stod(value);
+                }
+            }
+        }
+
+        file.close();
+
+        return Position(latitude, longitude, altitude, accuracy,
+                        std::chrono::system_clock::from_time_t(timestamp));
+    }
+
+    std::vector<Equipment> DataStorage::getAllEquipment()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return getAllEquipmentInternal(true);
+    }
+
+    std::vector<Equipment> DataStorage::getAllEquipmentRecords()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return getAllEquipmentInternal(false);
+    }
+
+    std::vector<Equipment> DataStorage::getAllEquipmentInternal(bool with_history)
+    {
+        std::vector<Equipment> result;
+
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return result;
+        }
+
+        try
+        {
+            // Check if equipment directory exists
+            std::string directory = db_path_ + "/equipment";
+            if (!std::filesystem::exists(directory))
+            {
+                return result;
+            }
+
+            // Iterate through all equipment files, then the packed records
+            // they do not shadow
+            std::unordered_set<EquipmentId> seen;
+            for (const auto &entry : std::filesystem::directory_iterator(directory))
+            {
+                if (entry.is_regular_file())
+                {
+                    std::string filename = entry.path().filename().string();
+
+                    // Extract equipment ID from filename
+                    size_t dot_pos = filename.find('.');
+                    if (dot_pos != std::string::npos)
+                    {
+                        std::string id = filename.substr(0, dot_pos);
 
                         // Load equipment (call internal version without locking)
-                        auto equipment = loadEquipmentInternal(id);
+                        auto equipment = loadEquipmentInternal(id, with_history);
                         if (equipment)
                         {
                             result.push_back(std::move(*equipment));
                         }
+                        seen.insert(id);
+                    }
+                }
+            }
+
+            for (const auto &[id, _] : packed_equipment_)
+            {
+                if (seen.insert(id).second)
+                {
+                    auto equipment = loadEquipmentInternal(id, with_history);
+                    if (equipment)
+                    {
+                        result.push_back(std::move(*equipment));
+                    }
+                }
+            }
+
+            // Updates to records that were never written
+            for (const auto &[id, _] : pending_updates_)
+            {
+                if (seen.count(id) == 0)
+                {
+                    auto equipment = loadEquipmentInternal(id, with_history);
+                    if (equipment)
+                    {
+                        result.push_back(std::move(*equipment));
                     }
                 }
             }
@@ -556,12 +1449,499 @@ namespace equipment_tracker
         return result;
     }
 
+    bool DataStorage::deleteEquipmentBatch(const std::vector<EquipmentId> &ids)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!is_initialized_ && !initializeInternal())
+        {
+            return false;
+        }
+
+        try
+        {
+            if (!removePackedRecords(ids))
+            {
+                return false;
+            }
+
+            // One tombstone for the whole batch, one subdirectory per machine
+            std::filesystem::path tombstone = newTombstonePath("batch");
+            for (const auto &id : ids)
+            {
+                moveToTombstone(id, tombstone / id);
+            }
+            scheduleReclamation(tombstone);
+
+            change_feed_.appendEquipmentDeletedBatch(ids);
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "DataStorage deleteEquipmentBatch error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void DataStorage::loadEquipmentPacks()
+    {
+        packed_equipment_.clear();
+        pack_bytes_ = 0;
+
+        std::vector<std::pair<uint64_t, std::filesystem::path>> packs;
+        for (const auto &entry : std::filesystem::directory_iterator(db_path_ + "/equipment/packs"))
+        {
+            unsigned long long number = 0;
+            if (entry.is_regular_file() &&
+                std::sscanf(entry.path().filename().string().c_str(), "pack-%llu.pack", &number) == 1)
+            {
+                packs.emplace_back(number, entry.path());
+            }
+        }
+        std::sort(packs.begin(), packs.end());
+
+        // Replayed oldest first, so later saves and deletions win
+        for (const auto &[number, path] : packs)
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            pack_bytes_ += content.size();
+
+            size_t offset = 0;
+            while (offset < content.size())
+            {
+                size_t newline = content.find('\n', offset);
+                std::istringstream header(content.substr(offset, newline - offset));
+                std::string kind;
+                size_t id_length = 0;
+                size_t record_length = 0;
+                if (newline == std::string::npos || !(header >> kind >> id_length >> record_length) ||
+                    content.size() - newline - 1 < id_length + record_length)
+                {
+                    // A batch torn by a crash; its change-feed entries were never written
+                    std::cerr << "Ignoring truncated equipment pack tail: " << path << std::endl;
+                    break;
+                }
+
+                EquipmentId id = content.substr(newline + 1, id_length);
+                uint64_t record_offset = newline + 1 + id_length;
+                if (kind == PACK_SAVED)
+                {
+                    packed_equipment_[id] = {number, record_offset, record_length};
+                }
+                else
+                {
+                    packed_equipment_.erase(id);
+                }
+                offset = record_offset + record_length;
+            }
+
+            next_pack_ = std::max(next_pack_, number + 1);
+        }
+    }
+
+    uint64_t DataStorage::writeEquipmentPack(const std::string &content)
+    {
+        uint64_t number = next_pack_++;
+        std::string path = packPath(number).string();
+        int fd = openForOverwrite(path);
+        if (fd < 0)
+        {
+            std::cerr << "Failed to open file for writing: " << path << std::endl;
+            return 0;
+        }
+
+        auto ok = std::make_shared<std::atomic<bool>>(true);
+        io_->submitWrite(fd, IoBuffer::copyOf(content.data(), content.size()), 0,
+                         [ok, size = content.size()](IoResult &result)
+                         {
+                             if (result.result != static_cast<int64_t>(size))
+                             {
+                                 *ok = false;
+                             }
+                         });
+        io_->wait();
+
+        // Synced before the batch is acknowledged or any shadowing file removed
+        io_->submitSync(fd,
+                        [ok](IoResult &result)
+                        {
+                            if (result.result < 0)
+                            {
+                                *ok = false;
+                            }
+                        });
+        io_->wait();
+        closeFile(fd);
+
+        if (!ok->load())
+        {
+            std::cerr << "Failed to write equipment pack: " << path << std::endl;
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            return 0;
+        }
+        pack_bytes_ += content.size();
+        return number;
+    }
+
+    std::filesystem::path DataStorage::packPath(uint64_t pack) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "pack-%016llu.pack", static_cast<unsigned long long>(pack));
+        return std::filesystem::path(db_path_) / "equipment" / "packs" / name;
+    }
+
+    bool DataStorage::readPackedRecord(const PackedRecord &record, std::string &content)
+    {
+        std::ifstream in(packPath(record.pack), std::ios::binary);
+        content.resize(record.length);
+        if (!in.seekg(static_cast<std::streamoff>(record.offset)) ||
+            !in.read(content.data(), static_cast<std::streamsize>(record.length)))
+        {
+            std::cerr << "Failed to read packed record from " << packPath(record.pack) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool DataStorage::removePackedRecords(const std::vector<EquipmentId> &ids)
+    {
+        // Packs are immutable, so deletions are recorded in a pack of their own
+        std::string markers;
+        for (const auto &id : ids)
+        {
+            if (packed_equipment_.count(id) != 0)
+            {
+                appendPackEntry(markers, PACK_DELETED, id, "");
+            }
+        }
+        if (markers.empty())
+        {
+            return true;
+        }
+        if (writeEquipmentPack(markers) == 0)
+        {
+            return false;
+        }
+
+        for (const auto &id : ids)
+        {
+            packed_equipment_.erase(id);
+        }
+        maybeCompactEquipmentPacks();
+        return true;
+    }
+
+    void DataStorage::maybeCompactEquipmentPacks()
+    {
+        uint64_t live_bytes = 0;
+        for (const auto &[id, record] : packed_equipment_)
+        {
+            live_bytes += packEntryHeader(PACK_SAVED, id, record.length).size() + id.size() + record.length;
+        }
+
+        uint64_t garbage_bytes = pack_bytes_ - std::min(pack_bytes_, live_bytes);
+        if (garbage_bytes >= PACK_COMPACTION_MIN_BYTES &&
+            static_cast<double>(garbage_bytes) >= PACK_COMPACTION_RATIO * static_cast<double>(pack_bytes_))
+        {
+            compactEquipmentPacks();
+        }
+    }
+
+    bool DataStorage::compactEquipmentPacks()
+    {
+        // Copy the live records pack by pack, reading each pack file once
+        std::vector<std::pair<PackedRecord, EquipmentId>> live;
+        live.reserve(packed_equipment_.size());
+        for (const auto &[id, record] : packed_equipment_)
+        {
+            live.push_back({record, id});
+        }
+        std::sort(live.begin(), live.end(),
+                  [](const auto &a, const auto &b)
+                  {
+                      return std::tie(a.first.pack, a.first.offset) < std::tie(b.first.pack, b.first.offset);
+                  });
+
+        std::string pack;
+        std::string source;
+        uint64_t loaded = 0;
+        std::vector<std::pair<EquipmentId, PackedRecord>> moved;
+        moved.reserve(live.size());
+        for (const auto &[record, id] : live)
+        {
+            if (record.pack != loaded)
+            {
+                std::ifstream in(packPath(record.pack), std::ios::binary);
+                source.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                loaded = record.pack;
+            }
+            if (record.offset + record.length > source.size())
+            {
+                std::cerr << "Equipment pack compaction skipped, cannot read " << packPath(record.pack) << std::endl;
+                return false;
+            }
+
+            std::string content = source.substr(record.offset, record.length);
+            appendPackEntry(pack, PACK_SAVED, id, content);
+            moved.push_back({id, {0, pack.size() - content.size(), content.size()}});
+        }
+
+        // The compacted pack is synced before anything it replaces goes away;
+        // after a crash in between, replaying old and new packs gives the same state
+        uint64_t first_kept = next_pack_;
+        if (!pack.empty())
+        {
+            first_kept = writeEquipmentPack(pack);
+            if (first_kept == 0)
+            {
+                return false;
+            }
+            for (auto &[id, record] : moved)
+            {
+                record.pack = first_kept;
+                packed_equipment_[id] = record;
+            }
+        }
+
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(db_path_ + "/equipment/packs", error))
+        {
+            unsigned long long number = 0;
+            if (std::sscanf(entry.path().filename().string().c_str(), "pack-%llu.pack", &number) == 1 &&
+                number < first_kept)
+            {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+        pack_bytes_ = pack.size();
+        return true;
+    }
+
+    std::filesystem::path DataStorage::newTombstonePath(const std::string &name)
+    {
+        return std::filesystem::path(db_path_) / "tombstones" /
+               (name + "." + std::to_string(getCurrentTimestamp().time_since_epoch().count()) +
+                "." + std::to_string(++tombstone_sequence_));
+    }
+
+    void DataStorage::moveToTombstone(const EquipmentId &id, const std::filesystem::path &destination)
+    {
+        closePositionLog(id);
+        hot_history_.erase(id);
+        rollups_.erase(id);
+        pending_updates_.erase(id);
+        std::filesystem::path equipment_file = std::filesystem::path(db_path_) / "equipment" / (id + ".txt");
+        std::filesystem::path history_dir = std::filesystem::path(db_path_) / "positions" / id;
+        std::filesystem::create_directories(destination);
+
+        std::error_code error;
+        if (std::filesystem::exists(equipment_file))
+        {
+            std::filesystem::rename(equipment_file, destination / "equipment.txt", error);
+            if (error)
+            {
+                std::filesystem::remove(equipment_file);
+            }
+        }
+        if (std::filesystem::exists(history_dir))
+        {
+            std::filesystem::rename(history_dir, destination / "positions", error);
+            if (error)
+            {
+                // Not renameable (e.g. open elsewhere on Windows): delete in place
+                std::cerr << "Tombstone rename failed for " << history_dir << ": " << error.message() << std::endl;
+                std::filesystem::remove_all(history_dir);
+            }
+        }
+    }
+
+    size_t DataStorage::getPendingReclamationCount() const
+    {
+        std::lock_guard<std::mutex> lock(reclaim_mutex_);
+        return reclaim_queue_.size() + (reclaim_busy_ ? 1 : 0);
+    }
+
+    void DataStorage::waitForReclamation()
+    {
+        std::unique_lock<std::mutex> lock(reclaim_mutex_);
+        if (!reclaim_thread_.joinable())
+        {
+            return;
+        }
+        reclaim_condition_.wait(lock,
+                                [this]
+                                {
+                                    return (reclaim_queue_.empty() && !reclaim_busy_) || reclaim_stop_;
+                                });
+    }
+
+    void DataStorage::scheduleReclamation(const std::filesystem::path &tombstone)
+    {
+        {
+            std::lock_guard<std::mutex> lock(reclaim_mutex_);
+            reclaim_queue_.push_back(tombstone);
+        }
+        reclaim_condition_.notify_all();
+    }
+
+    void DataStorage::reclaimLoop()
+    {
+        std::unique_lock<std::mutex> lock(reclaim_mutex_);
+        while (true)
+        {
+            reclaim_condition_.wait(lock,
+                                    [this]
+                                    {
+                                        return reclaim_stop_ || !reclaim_queue_.empty();
+                                    });
+            if (reclaim_stop_)
+            {
+                return;
+            }
+
+            std::filesystem::path tombstone = reclaim_queue_.front();
+            reclaim_queue_.pop_front();
+            reclaim_busy_ = true;
+            lock.unlock();
+
+            // File by file, so shutdown never waits on a large history
+            std::error_code error;
+            std::vector<std::filesystem::path> files;
+            for (std::filesystem::recursive_directory_iterator it(tombstone, error), end; !error && it != end;
+                 it.increment(error))
+            {
+                if (it->is_regular_file(error))
+                {
+                    files.push_back(it->path());
+                }
+            }
+            for (const auto &file : files)
+            {
+                if (reclaim_stop_)
+                {
+                    break;
+                }
+                std::filesystem::remove(file, error);
+            }
+            if (!reclaim_stop_)
+            {
+                std::filesystem::remove_all(tombstone, error);
+            }
+            if (error)
+            {
+                std::cerr << "DataStorage reclamation error in " << tombstone << ": " << error.message() << std::endl;
+            }
+
+            lock.lock();
+            reclaim_busy_ = false;
+            reclaim_condition_.notify_all();
+        }
+    }
+
+    size_t DataStorage::archiveHistory(const EquipmentId &id, const Timestamp &cutoff)
+    {
+        // Plan and commit under the lock; compress and write without it, so
+        // ingest is never held up by archiving
+        std::vector<PositionLog::ArchiveJob> jobs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = position_logs_.find(id);
+            if (it == position_logs_.end())
+            {
+                return 0;
+            }
+            jobs = it->second->planArchive(cutoff);
+        }
+        if (jobs.empty())
+        {
+            return 0;
+        }
+
+        for (auto &job : jobs)
+        {
+            PositionLog::writeArchive(job);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = position_logs_.find(id);
+        if (it == position_logs_.end() || it->second->getGeneration() != jobs.front().generation)
+        {
+            // Closed meanwhile; a reopened log plans afresh, even one that
+            // happens to live at the old log's address
+            PositionLog::discardArchive(jobs);
+            return 0;
+        }
+        return it->second->commitArchive(jobs);
+    }
+
+    void DataStorage::waitForArchiving()
+    {
+        std::unique_lock<std::mutex> lock(archive_mutex_);
+        if (!archive_thread_.joinable())
+        {
+            return;
+        }
+        archive_condition_.wait(lock,
+                                [this]
+                                {
+                                    return (archive_queue_.empty() && !archive_busy_) || archive_stop_;
+                                });
+    }
+
+    void DataStorage::scheduleArchiving(const EquipmentId &id, const Timestamp &cutoff)
+    {
+        {
+            std::lock_guard<std::mutex> lock(archive_mutex_);
+            archive_queue_.emplace_back(id, cutoff);
+        }
+        archive_condition_.notify_all();
+    }
+
+    void DataStorage::archiveLoop()
+    {
+        std::unique_lock<std::mutex> lock(archive_mutex_);
+        while (true)
+        {
+            archive_condition_.wait(lock,
+                                    [this]
+                                    {
+                                        return archive_stop_ || !archive_queue_.empty();
+                                    });
+            if (archive_stop_)
+            {
+                return;
+            }
+
+            auto [id, cutoff] = archive_queue_.front();
+            archive_queue_.pop_front();
+            archive_busy_ = true;
+            lock.unlock();
+
+            try
+            {
+                archiveHistory(id, cutoff);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "DataStorage archiving error for " << id << ": " << e.what() << std::endl;
+            }
+
+            lock.lock();
+            archive_busy_ = false;
+            archive_condition_.notify_all();
+        }
+    }
+
     void DataStorage::initDatabase()
     {
         // Create database directory structure
         std::filesystem::create_directory(db_path_);
         std::filesystem::create_directory(db_path_ + "/equipment");
+        std::filesystem::create_directory(db_path_ + "/equipment/packs");
         std::filesystem::create_directory(db_path_ + "/positions");
+        std::filesystem::create_directory(db_path_ + "/tombstones");
     }
 
     bool DataStorage::executeQuery(const std::string &query)
@@ -7,6 +7,26 @@
 namespace equipment_tracker
 {
 
+    void UtilizationCounters::add(const Position &from, const Position &to)
+    {
+        double seconds = std::chrono::duration<double>(to.getTimestamp() - from.getTimestamp()).count();
+        if (seconds <= 0.0 || seconds > UTILIZATION_MAX_GAP_SECONDS)
+        {
+            return;
+        }
+
+        double meters = from.distanceTo(to);
+        if (meters / seconds > MOVEMENT_SPEED_THRESHOLD)
+        {
+            moving_seconds += seconds;
+            distance_meters += meters;
+        }
+        else
+        {
+            idle_seconds += seconds;
+        }
+    }
+
     Equipment::Equipment(EquipmentId id, EquipmentType type, std::string name)
         : id_(std::move(id)),
           type_(type),
@@ -26,6 +46,8 @@ namespace equipment_tracker
 
         // Move the position data
         last_position_ = std::move(other.last_position_);
+        utilization_ = other.utilization_;
+        newest_fix_ = std::move(other.newest_fix_);
         position_history_ = std::move(other.position_history_);
         max_history_size_ = other.max_history_size_;
 
@@ -46,6 +68,8 @@ namespace equipment_tracker
             name_ = std::move(other.name_);
             status_ = other.status_;
             last_position_ = std::move(other.last_position_);
+            utilization_ = other.utilization_;
+            newest_fix_ = std::move(other.newest_fix_);
             position_history_ = std::move(other.position_history_);
             max_history_size_ = other.max_history_size_;
 
@@ -67,6 +91,8 @@ namespace equipment_tracker
 
         // Copy the position data
         last_position_ = other.last_position_;
+        utilization_ = other.utilization_;
+        newest_fix_ = other.newest_fix_;
         position_history_ = other.position_history_;
     }
 
@@ -83,6 +109,8 @@ namespace equipment_tracker
             name_ = other.name_;
             status_ = other.status_;
             last_position_ = other.last_position_;
+            utilization_ = other.utilization_;
+            newest_fix_ = other.newest_fix_;
             position_history_ = other.position_history_;
             max_history_size_ = other.max_history_size_;
         }
@@ -111,6 +139,34 @@ namespace equipment_tracker
         last_position_ = position;
     }
 
+    UtilizationCounters Equipment::getUtilization() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return utilization_;
+    }
+
+    void Equipment::setUtilization(const UtilizationCounters &utilization)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        utilization_ = utilization;
+    }
+
+    void Equipment::updateUtilization(const Position &position)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const std::optional<Position> &from = newest_fix_ ? newest_fix_ : last_position_;
+        if (from && position.getTimestamp() <= from->getTimestamp())
+        {
+            return;
+        }
+        if (from)
+        {
+            utilization_.add(*from, position);
+        }
+        newest_fix_ = position;
+    }
+
     void Equipment::recordPosition(const Position &position)
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -137,6 +193,17 @@ namespace equipment_tracker
         return position_history_;
     }
 
+    void Equipment::setPositionHistory(std::vector<Position> history)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (history.size() > max_history_size_)
+        {
+            history.erase(history.begin(), history.end() - max_history_size_);
+        }
+        position_history_ = std::move(history);
+    }
+
     void Equipment::clearPositionHistory()
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -1,14 +1,33 @@
 #include <iostream>
+#include <unordered_set>
 #include <algorithm>
+#include <thread>
 #include "equipment_tracker/equipment_tracker_service.h"
 
 namespace equipment_tracker
 {
 
-    EquipmentTrackerService::EquipmentTrackerService()
+    namespace
+    {
+        // Fleet records carry no history; it is kept by the history cache
+        Equipment withoutHistory(const Equipment &equipment)
+        {
+            Equipment record = equipment;
+            record.clearPositionHistory();
+            return record;
+        }
+    } // namespace
+
+    EquipmentTrackerService::EquipmentTrackerService(const std::string &db_path)
         : gps_tracker_(std::make_unique<GPSTracker>()),
-          data_storage_(std::make_unique<DataStorage>()),
+          data_storage_(std::make_unique<DataStorage>(db_path)),
           network_manager_(std::make_unique<NetworkManager>()),
+          proximity_engine_(std::make_unique<ProximityEngine>(site_projections_)),
+          history_cache_(
+              [this](const EquipmentId &id, size_t max_positions)
+              {
+                  return data_storage_->getRecentPositions(id, max_positions);
+              }),
           is_running_(false)
     {
 
@@ -19,6 +38,59 @@ namespace equipment_tracker
                 this->handlePositionUpdate(lat, lon, alt, timestamp);
             });
 
+        // Forward accepted fixes to the server off the ingest thread. The
+        // handler only hands the fix to the network queue, but the first one
+        // waits for the connection, so the uplink gets a deeper queue than
+        // analytics subscribers before it starts shedding fixes
+        position_bus_.subscribe(
+            "uplink",
+            [this](const PositionEvent &event)
+            {
+                network_manager_->sendPositionUpdate(event.equipment_id, event.position);
+            },
+            DeliveryMode::Queued, UPLINK_EVENT_QUEUE_CAPACITY);
+
+        // Anomaly detection learns from the same stream, also off the ingest thread
+        position_bus_.subscribe(
+            "anomaly",
+            [this](const PositionEvent &event)
+            {
+                auto anomalies = anomaly_detector_.observe(event.equipment_id, event.position);
+                if (anomalies.empty())
+                {
+                    return;
+                }
+
+                AnomalyCallback callback;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    callback = anomaly_callback_;
+                }
+                if (callback)
+                {
+                    for (const auto &anomaly : anomalies)
+                    {
+                        callback(anomaly);
+                    }
+                }
+            });
+
+        // Map matching also follows the stream off the ingest thread
+        position_bus_.subscribe(
+            "map-match",
+            [this](const PositionEvent &event)
+            {
+                std::shared_ptr<MapMatcher> matcher;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    matcher = map_matcher_;
+                }
+                if (matcher)
+                {
+                    matcher->match(event.equipment_id, event.position);
+                }
+            });
+
         // Register command handler
         network_manager_->registerCommandHandler(
             [this](const std::string &command)
@@ -30,6 +102,11 @@ namespace equipment_tracker
     EquipmentTrackerService::~EquipmentTrackerService()
     {
         stop();
+        position_bus_.shutdown();
+
+        // The uplink connects on demand even when the service was never
+        // started; its worker calls back into members destroyed before it
+        network_manager_->disconnect();
     }
 
     void EquipmentTrackerService::start()
@@ -73,11 +150,23 @@ namespace equipment_tracker
         // Disconnect from server
         network_manager_->disconnect();
 
+        // Make queued position writes durable
+        data_storage_->flush();
+
         is_running_ = false;
 
         std::cout << "Equipment Tracker Service stopped." << std::endl;
     }
 
+    void EquipmentTrackerService::cacheHistory(const Equipment &equipment)
+    {
+        auto history = equipment.getPositionHistory();
+        if (!history.empty())
+        {
+            history_cache_.put(equipment.getId(), std::move(history));
+        }
+    }
+
     bool EquipmentTrackerService::addEquipment(const Equipment &equipment)
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -89,14 +178,27 @@ namespace equipment_tracker
             return false;
         }
 
-        // Add to map and storage
-        equipment_map_.insert({equipment.getId(), equipment});
-        return data_storage_->saveEquipment(equipment);
+        // Stored first, so a failed save leaves nothing served; any history
+        // the record carries moves to the cache
+        if (!data_storage_->saveEquipment(equipment))
+        {
+            return false;
+        }
+        Equipment record = withoutHistory(equipment);
+        equipment_map_.try_emplace(equipment.getId(), record);
+        cacheHistory(equipment);
+        fleet_.publish(fleet_.acquire()->withEquipment(record));
+        if (fleet_state_)
+        {
+            fleet_state_->publish(record);
+        }
+        fleet_tiles_.update(record);
+        return true;
     }
 
     bool EquipmentTrackerService::removeEquipment(const EquipmentId &id)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
 
         // Check if equipment exists
         if (equipment_map_.find(id) == equipment_map_.end())
@@ -105,52 +207,317 @@ namespace equipment_tracker
             return false;
         }
 
-        // Remove from map and storage
+        // Remove from storage, then from memory; storage only tombstones the
+        // data here, so ingest is not blocked while a long history is deleted
+        if (!data_storage_->deleteEquipment(id))
+        {
+            return false;
+        }
         equipment_map_.erase(id);
-        return data_storage_->deleteEquipment(id);
+        fleet_.publish(fleet_.acquire()->withoutEquipment(id));
+        if (fleet_state_)
+        {
+            fleet_state_->remove(id);
+        }
+        fleet_tiles_.remove(id);
+        history_cache_.erase(id);
+        local_positions_.erase(id);
+        auto events = proximity_engine_->remove(id);
+        auto alerts = rule_engine_.remove(id);
+        anomaly_detector_.remove(id);
+        if (map_matcher_)
+        {
+            map_matcher_->remove(id);
+        }
+
+        lock.unlock();
+        dispatchProximityEvents(events);
+        dispatchRuleAlerts(alerts);
+
+        return true;
     }
 
-    std::optional<Equipment> EquipmentTrackerService::getEquipment(const EquipmentId &id) const
+    std::vector<bool> EquipmentTrackerService::addEquipmentBatch(const std::vector<Equipment> &equipment)
     {
+        std::vector<bool> accepted(equipment.size(), false);
+        std::vector<Equipment> added;
+        std::vector<size_t> sources; // Index in equipment of each added record
+        added.reserve(equipment.size());
+        sources.reserve(equipment.size());
+
         std::lock_guard<std::mutex> lock(mutex_);
 
-        auto it = equipment_map_.find(id);
-        if (it == equipment_map_.end())
+        std::unordered_set<EquipmentId> batch_ids;
+        for (size_t i = 0; i < equipment.size(); ++i)
         {
-            return std::nullopt;
+            const auto &id = equipment[i].getId();
+            if (id.empty())
+            {
+                std::cerr << "Equipment without an ID rejected." << std::endl;
+                continue;
+            }
+            if (equipment_map_.count(id) != 0 || !batch_ids.insert(id).second)
+            {
+                std::cerr << "Equipment with ID " << id << " already exists." << std::endl;
+                continue;
+            }
+
+            added.push_back(withoutHistory(equipment[i]));
+            sources.push_back(i);
         }
 
-        return it->second;
+        // Stored first: a failed save leaves the batch out of memory too, so
+        // the flags match what is stored and a retry can succeed
+        if (added.empty() || !data_storage_->saveEquipmentBatch(added))
+        {
+            return accepted;
+        }
+
+        equipment_map_.reserve(equipment_map_.size() + added.size());
+        for (size_t k = 0; k < added.size(); ++k)
+        {
+            equipment_map_.try_emplace(added[k].getId(), added[k]);
+            cacheHistory(equipment[sources[k]]);
+            accepted[sources[k]] = true;
+        }
+
+        fleet_.publish(fleet_.acquire()->withChanges(added, {}));
+        if (fleet_state_)
+        {
+            for (const auto &record : added)
+            {
+                fleet_state_->publish(record);
+            }
+        }
+        for (const auto &record : added)
+        {
+            fleet_tiles_.update(record);
+        }
+        return accepted;
     }
 
-    std::vector<Equipment> EquipmentTrackerService::getAllEquipment() const
+    std::vector<bool> EquipmentTrackerService::updateEquipmentBatch(const std::vector<Equipment> &equipment)
     {
+        std::vector<bool> accepted(equipment.size(), false);
+        std::vector<Equipment> updated;
+        std::vector<size_t> sources;
+        updated.reserve(equipment.size());
+        sources.reserve(equipment.size());
+
         std::lock_guard<std::mutex> lock(mutex_);
 
-        std::vector<Equipment> result;
-        result.reserve(equipment_map_.size());
+        for (size_t i = 0; i < equipment.size(); ++i)
+        {
+            auto it = equipment_map_.find(equipment[i].getId());
+            if (it == equipment_map_.end())
+            {
+                std::cerr << "Equipment with ID " << equipment[i].getId() << " does not exist." << std::endl;
+                continue;
+            }
+            if (it->second.getType() != equipment[i].getType())
+            {
+                std::cerr << "Equipment type of " << equipment[i].getId() << " cannot change." << std::endl;
+                continue;
+            }
+
+            Equipment record = it->second;
+            record.setName(equipment[i].getName());
+            record.setStatus(equipment[i].getStatus());
+            updated.push_back(std::move(record));
+            sources.push_back(i);
+        }
 
-        for (const auto &[_, equipment] : equipment_map_)
+        // Stored first, then applied in memory, so a failed save changes nothing
+        if (updated.empty() || !data_storage_->saveEquipmentBatch(updated))
         {
-            result.push_back(equipment);
+            return accepted;
         }
 
+        for (size_t k = 0; k < updated.size(); ++k)
+        {
+            equipment_map_.at(updated[k].getId()) = updated[k];
+            accepted[sources[k]] = true;
+        }
+
+        fleet_.publish(fleet_.acquire()->withChanges(updated, {}));
+        if (fleet_state_)
+        {
+            for (const auto &record : updated)
+            {
+                fleet_state_->publish(record);
+            }
+        }
+        for (const auto &record : updated)
+        {
+            fleet_tiles_.update(record);
+        }
+        return accepted;
+    }
+
+    std::vector<bool> EquipmentTrackerService::removeEquipmentBatch(const std::vector<EquipmentId> &ids)
+    {
+        std::vector<bool> accepted(ids.size(), false);
+        std::vector<EquipmentId> removed;
+        std::vector<size_t> sources;
+        std::vector<ProximityEvent> events;
+        std::vector<RuleAlert> alerts;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        std::unordered_set<EquipmentId> batch_ids;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (equipment_map_.count(ids[i]) == 0 || !batch_ids.insert(ids[i]).second)
+            {
+                std::cerr << "Equipment with ID " << ids[i] << " does not exist." << std::endl;
+                continue;
+            }
+            removed.push_back(ids[i]);
+            sources.push_back(i);
+        }
+
+        // Deleted from storage first; on failure every machine stays live
+        if (removed.empty() || !data_storage_->deleteEquipmentBatch(removed))
+        {
+            return accepted;
+        }
+
+        for (size_t k = 0; k < removed.size(); ++k)
+        {
+            const auto &id = removed[k];
+            equipment_map_.erase(id);
+            if (fleet_state_)
+            {
+                fleet_state_->remove(id);
+            }
+            fleet_tiles_.remove(id);
+            history_cache_.erase(id);
+            local_positions_.erase(id);
+            auto cleared = proximity_engine_->remove(id);
+            events.insert(events.end(), cleared.begin(), cleared.end());
+            anomaly_detector_.remove(id);
+            if (map_matcher_)
+            {
+                map_matcher_->remove(id);
+            }
+            auto cleared_alerts = rule_engine_.remove(id);
+            alerts.insert(alerts.end(), cleared_alerts.begin(), cleared_alerts.end());
+            accepted[sources[k]] = true;
+        }
+        fleet_.publish(fleet_.acquire()->withChanges({}, removed));
+
+        lock.unlock();
+        dispatchProximityEvents(events);
+        dispatchRuleAlerts(alerts);
+
+        return accepted;
+    }
+
+    std::optional<Equipment> EquipmentTrackerService::getEquipment(const EquipmentId &id) const
+    {
+        auto equipment = fleet_.acquire()->find(id);
+        if (!equipment)
+        {
+            return std::nullopt;
+        }
+
+        Equipment result = *equipment;
+        result.setPositionHistory(history_cache_.get(id));
         return result;
     }
 
-    std::vector<Equipment> EquipmentTrackerService::findEquipmentByStatus(EquipmentStatus status) const
+    bool EquipmentTrackerService::importPositionHistory(const EquipmentId &id, const std::vector<Position> &positions)
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        std::vector<Equipment> result;
+        if (equipment_map_.find(id) == equipment_map_.end())
+        {
+            std::cerr << "Equipment with ID " << id << " does not exist." << std::endl;
+            return false;
+        }
 
-        for (const auto &[_, equipment] : equipment_map_)
+        bool saved = true;
+        for (const auto &position : positions)
         {
-            if (equipment.getStatus() == status)
+            saved = data_storage_->savePosition(id, position) && saved;
+        }
+        history_cache_.erase(id);
+        return saved;
+    }
+
+    std::vector<Position> EquipmentTrackerService::getPositionHistory(const EquipmentId &id) const
+    {
+        if (!fleet_.acquire()->find(id))
+        {
+            return {};
+        }
+        return history_cache_.get(id);
+    }
+
+    void EquipmentTrackerService::setHistoryMemoryBudget(size_t bytes)
+    {
+        history_cache_.setBudget(bytes);
+    }
+
+    HistoryCacheStats EquipmentTrackerService::getHistoryCacheStats() const
+    {
+        return history_cache_.getStats();
+    }
+
+    std::vector<Equipment> EquipmentTrackerService::getAllEquipment() const
+    {
+        auto snapshot = fleet_.acquire();
+
+        std::vector<Equipment> result;
+        result.reserve(snapshot->size());
+
+        snapshot->forEach(
+            [&result](const Equipment &equipment)
             {
                 result.push_back(equipment);
-            }
+            });
+
+        return result;
+    }
+
+    std::optional<UtilizationCounters> EquipmentTrackerService::getUtilization(const EquipmentId &id) const
+    {
+        auto equipment = fleet_.acquire()->find(id);
+        if (!equipment)
+        {
+            return std::nullopt;
         }
+        return equipment->getUtilization();
+    }
+
+    std::vector<std::pair<EquipmentId, UtilizationCounters>> EquipmentTrackerService::getFleetUtilization() const
+    {
+        auto snapshot = fleet_.acquire();
+
+        std::vector<std::pair<EquipmentId, UtilizationCounters>> result;
+        result.reserve(snapshot->size());
+
+        snapshot->forEach(
+            [&result](const Equipment &equipment)
+            {
+                result.emplace_back(equipment.getId(), equipment.getUtilization());
+            });
+
+        return result;
+    }
+
+    std::vector<Equipment> EquipmentTrackerService::findEquipmentByStatus(EquipmentStatus status) const
+    {
+        std::vector<Equipment> result;
+
+        fleet_.acquire()->forEach(
+            [&](const Equipment &equipment)
+            {
+                if (equipment.getStatus() == status)
+                {
+                    result.push_back(equipment);
+                }
+            });
 
         return result;
     }
@@ -165,28 +532,98 @@ namespace equipment_tracker
         double lat2, double lon2) const
     {
 
-        std::lock_guard<std::mutex> lock(mutex_);
-
         std::vector<Equipment> result;
 
-        for (const auto &[_, equipment] : equipment_map_)
-        {
-            auto position = equipment.getLastPosition();
-
-            if (!position)
+        fleet_.acquire()->forEach(
+            [&](const Equipment &equipment)
             {
-                continue;
-            }
+                auto position = equipment.getLastPosition();
+
+                if (!position)
+                {
+                    return;
+                }
+
+                double lat = position->getLatitude();
+                double lon = position->getLongitude();
+
+                // Check if position is within bounds
+                if (lat >= std::min(lat1, lat2) && lat <= std::max(lat1, lat2) &&
+                    lon >= std::min(lon1, lon2) && lon <= std::max(lon1, lon2))
+                {
+                    result.push_back(equipment);
+                }
+            });
 
-            double lat = position->getLatitude();
-            double lon = position->getLongitude();
+        return result;
+    }
 
-            // Check if position is within bounds
-            if (lat >= std::min(lat1, lat2) && lat <= std::max(lat1, lat2) &&
-                lon >= std::min(lon1, lon2) && lon <= std::max(lon1, lon2))
+    std::vector<std::optional<Position>> EquipmentTrackerService::getPositionsAt(
+        const std::vector<EquipmentId> &ids,
+        const Timestamp &at,
+        InterpolationMethod method) const
+    {
+        std::vector<std::optional<Position>> result(ids.size());
+
+        // Every worker answers from the same version of the fleet
+        auto snapshot = fleet_.acquire();
+
+        auto resolveRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
             {
-                result.push_back(equipment);
+                auto equipment = snapshot->find(ids[i]);
+                if (!equipment)
+                {
+                    continue;
+                }
+                std::vector<Position> history = history_cache_.get(ids[i]);
+
+                // Recent instants are answered from memory
+                result[i] = interpolateHistory(history, at, method);
+                if (result[i])
+                {
+                    continue;
+                }
+
+                // Older instants need the bracketing fixes from storage
+                auto bracket = data_storage_->getBracketingPositions(ids[i], at);
+                if (bracket.size() == 2)
+                {
+                    result[i] = interpolatePosition(bracket[0], bracket[1], at, method);
+                }
+                else if (bracket.size() == 1 &&
+                         std::chrono::system_clock::to_time_t(bracket[0].getTimestamp()) ==
+                             std::chrono::system_clock::to_time_t(at))
+                {
+                    result[i] = bracket[0];
+                    result[i]->setTimestamp(at);
+                }
             }
+        };
+
+        size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t thread_count = std::min(max_threads,
+                                       ids.size() / MIN_INTERPOLATION_BATCH_PER_THREAD);
+
+        if (thread_count <= 1)
+        {
+            resolveRange(0, ids.size());
+            return result;
+        }
+
+        // Each worker fills a disjoint slice of the result
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count);
+        size_t chunk = (ids.size() + thread_count - 1) / thread_count;
+        for (size_t begin = 0; begin < ids.size(); begin += chunk)
+        {
+            workers.emplace_back(resolveRange, begin, std::min(begin + chunk, ids.size()));
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
         }
 
         return result;
@@ -215,14 +652,28 @@ namespace equipment_tracker
 
         std::cout << "Loading equipment from storage..." << std::endl;
 
-        auto equipment_list = data_storage_->getAllEquipment();
+        // Records only: history is refetched into the cache when first read
+        auto equipment_list = data_storage_->getAllEquipmentRecords();
 
         equipment_map_.clear();
-        for (const auto &equipment : equipment_list)
+        auto snapshot = std::make_shared<const FleetSnapshot>();
+        if (fleet_state_)
+        {
+            fleet_state_->clear();
+        }
+        fleet_tiles_.clear();
+        for (auto &equipment : equipment_list)
         {
-            equipment_map_.insert({equipment.getId(), equipment});
+            equipment_map_.try_emplace(equipment.getId(), equipment);
+            snapshot = snapshot->withEquipment(equipment);
+            if (fleet_state_)
+            {
+                fleet_state_->publish(equipment);
+            }
+            fleet_tiles_.update(equipment);
             std::cout << "  Loaded " << equipment.toString() << std::endl;
         }
+        fleet_.publish(snapshot);
 
         std::cout << "Loaded " << equipment_map_.size() << " equipment items." << std::endl;
     }
@@ -248,26 +699,245 @@ namespace equipment_tracker
 
         std::cout << "Position update received for equipment " << *equipment_id << "." << std::endl;
 
-        // Update equipment position
-        std::lock_guard<std::mutex> lock(mutex_);
+        updateEquipmentPosition(*equipment_id, position);
+    }
+
+    bool EquipmentTrackerService::updateEquipmentPosition(
+        const EquipmentId &id, const Position &position)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
 
-        auto it = equipment_map_.find(*equipment_id);
+        auto it = equipment_map_.find(id);
         if (it == equipment_map_.end())
         {
-            std::cerr << "Equipment with ID " << *equipment_id << " not found." << std::endl;
-            return;
+            std::cerr << "Equipment with ID " << id << " not found." << std::endl;
+            return false;
         }
 
-        // Update equipment
-        it->second.recordPosition(position);
+        // Update equipment; its history is kept by the history cache
+        it->second.updateUtilization(position);
+        it->second.setLastPosition(position);
         it->second.setStatus(EquipmentStatus::Active);
 
         // Save to database
-        data_storage_->savePosition(*equipment_id, position);
+        data_storage_->savePosition(id, position);
+        history_cache_.record(id, position);
         data_storage_->updateEquipment(it->second);
+        fleet_.publish(fleet_.acquire()->withEquipment(it->second));
+        if (fleet_state_)
+        {
+            fleet_state_->publish(it->second);
+        }
+        fleet_tiles_.update(it->second);
+
+        // Project once; all site-local geometry works from the cached fix
+        LocalFix local_fix = site_projections_.project(position);
+        local_positions_[id] = local_fix;
+
+        // Safety checks against the rest of the fleet
+        EquipmentType type = it->second.getType();
+        auto events = proximity_engine_->update(id, type, local_fix, position.getTimestamp());
+        auto alerts = rule_engine_.evaluate(id, type, position);
+
+        lock.unlock();
+        dispatchProximityEvents(events);
+        dispatchRuleAlerts(alerts);
+
+        // Fan out to subscribers (server uplink, analytics, ...)
+        position_bus_.publish(PositionEvent{id, type, position});
 
-        // Send to server
-        network_manager_->sendPositionUpdate(*equipment_id, position);
+        return true;
+    }
+
+    std::shared_ptr<const FleetSnapshot> EquipmentTrackerService::getFleetSnapshot() const
+    {
+        return fleet_.acquire();
+    }
+
+    std::shared_ptr<const FleetTile> EquipmentTrackerService::getFleetTile(int zoom, uint32_t x, uint32_t y) const
+    {
+        return fleet_tiles_.getTile(zoom, x, y);
+    }
+
+    bool EquipmentTrackerService::startFleetStatePublishing(const std::string &name, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto table = std::make_unique<FleetStateTable>(name, capacity);
+        if (!table->create())
+        {
+            return false;
+        }
+
+        // Later changes are published as they happen, under the same lock
+        bool complete = true;
+        fleet_.acquire()->forEach(
+            [&](const Equipment &equipment)
+            {
+                complete = table->publish(equipment) && complete;
+            });
+
+        fleet_state_ = std::move(table);
+        return complete;
+    }
+
+    void EquipmentTrackerService::stopFleetStatePublishing()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fleet_state_.reset();
+    }
+
+    uint32_t EquipmentTrackerService::addSite(
+        const std::string &name, double latitude, double longitude, double radius_meters)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return site_projections_.addSite(name, latitude, longitude, radius_meters);
+    }
+
+    std::optional<LocalFix> EquipmentTrackerService::getLocalPosition(const EquipmentId &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = local_positions_.find(id);
+        if (it == local_positions_.end())
+        {
+            return std::nullopt;
+        }
+
+        return it->second;
+    }
+
+    void EquipmentTrackerService::registerProximityCallback(ProximityCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        proximity_callback_ = std::move(callback);
+    }
+
+    bool EquipmentTrackerService::setProximityThreshold(EquipmentType type, double meters)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return proximity_engine_->setThreshold(type, meters);
+    }
+
+    std::vector<std::pair<EquipmentId, EquipmentId>> EquipmentTrackerService::getProximityPairs() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return proximity_engine_->getActivePairs();
+    }
+
+    bool EquipmentTrackerService::setRules(const std::vector<RuleZone> &zones,
+                                           const std::vector<RuleDefinition> &rules,
+                                           std::chrono::minutes utc_offset)
+    {
+        auto plan = RulePlan::compile(zones, rules, utc_offset);
+        if (!plan)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        rule_engine_.setPlan(std::move(plan));
+        return true;
+    }
+
+    void EquipmentTrackerService::registerRuleCallback(RuleAlertCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rule_callback_ = std::move(callback);
+    }
+
+    std::vector<std::pair<EquipmentId, std::string>> EquipmentTrackerService::getActiveRuleAlerts() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rule_engine_.getActiveAlerts();
+    }
+
+    void EquipmentTrackerService::registerAnomalyCallback(AnomalyCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        anomaly_callback_ = std::move(callback);
+    }
+
+    std::optional<AnomalyBaseline> EquipmentTrackerService::getAnomalyBaseline(const EquipmentId &id) const
+    {
+        return anomaly_detector_.getBaseline(id);
+    }
+
+    bool EquipmentTrackerService::setRoadGraph(const RoadGraph &graph)
+    {
+        if (graph.getEdges().empty())
+        {
+            std::cerr << "Road graph has no edges." << std::endl;
+            return false;
+        }
+        auto matcher = std::make_shared<MapMatcher>(graph);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_matcher_ = std::move(matcher);
+        return true;
+    }
+
+    std::optional<MatchedPosition> EquipmentTrackerService::getMatchedPosition(const EquipmentId &id) const
+    {
+        std::shared_ptr<MapMatcher> matcher;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            matcher = map_matcher_;
+        }
+        if (!matcher)
+        {
+            return std::nullopt;
+        }
+        return matcher->getMatch(id);
+    }
+
+    void EquipmentTrackerService::dispatchProximityEvents(const std::vector<ProximityEvent> &events)
+    {
+        if (events.empty())
+        {
+            return;
+        }
+
+        ProximityCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = proximity_callback_;
+        }
+
+        if (!callback)
+        {
+            return;
+        }
+
+        // Invoked without the service lock so handlers may query the service
+        for (const auto &event : events)
+        {
+            callback(event);
+        }
+    }
+
+    void EquipmentTrackerService::dispatchRuleAlerts(const std::vector<RuleAlert> &alerts)
+    {
+        if (alerts.empty())
+        {
+            return;
+        }
+
+        RuleAlertCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = rule_callback_;
+        }
+
+        if (!callback)
+        {
+            return;
+        }
+
+        for (const auto &alert : alerts)
+        {
+            callback(alert);
+        }
     }
 
     void EquipmentTrackerService::handleRemoteCommand(const std::string &command)
@@ -302,4 +972,4 @@ namespace equipment_tracker
         return equipment_map_.begin()->first;
     }
 
-} // namespace equipment_tracker
\ No newline at end of file
+} // namespace equipment_tracker
@@ -0,0 +1,62 @@
+#include "equipment_tracker/fleet_snapshot.h"
+
+namespace equipment_tracker
+{
+
+    std::shared_ptr<const Equipment> FleetSnapshot::find(std::string_view id) const
+    {
+        const auto *equipment = equipment_.find(id);
+        return equipment ? *equipment : nullptr;
+    }
+
+    std::shared_ptr<const FleetSnapshot> FleetSnapshot::withEquipment(const Equipment &equipment) const
+    {
+        auto next = std::make_shared<FleetSnapshot>();
+        next->equipment_ = equipment_.set(equipment.getId(), std::make_shared<const Equipment>(equipment));
+        next->version_ = version_ + 1;
+        return next;
+    }
+
+    std::shared_ptr<const FleetSnapshot> FleetSnapshot::withoutEquipment(const EquipmentId &id) const
+    {
+        auto next = std::make_shared<FleetSnapshot>();
+        next->equipment_ = equipment_.erase(id);
+        next->version_ = version_ + 1;
+        return next;
+    }
+
+    std::shared_ptr<const FleetSnapshot> FleetSnapshot::withChanges(const std::vector<Equipment> &upserts,
+                                                                    const std::vector<EquipmentId> &removals) const
+    {
+        auto next = std::make_shared<FleetSnapshot>();
+        next->equipment_ = equipment_;
+        for (const auto &equipment : upserts)
+        {
+            next->equipment_ = next->equipment_.set(equipment.getId(), std::make_shared<const Equipment>(equipment));
+        }
+        for (const auto &id : removals)
+        {
+            next->equipment_ = next->equipment_.erase(id);
+        }
+        next->version_ = version_ + 1;
+        return next;
+    }
+
+    FleetSnapshotPublisher::FleetSnapshotPublisher()
+        : current_(std::make_shared<const FleetSnapshot>())
+    {
+    }
+
+    std::shared_ptr<const FleetSnapshot> FleetSnapshotPublisher::acquire() const
+    {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    void FleetSnapshotPublisher::publish(std::shared_ptr<const FleetSnapshot> snapshot)
+    {
+        uint64_t version = snapshot->getVersion();
+        std::atomic_store_explicit(&current_, std::move(snapshot), std::memory_order_release);
+        version_.store(version, std::memory_order_release);
+    }
+
+} // namespace equipment_tracker
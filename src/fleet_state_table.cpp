@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include "equipment_tracker/fleet_state_table.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr char FLEET_STATE_MAGIC[8] = {'E', 'T', 'F', 'L', 'E', 'E', 'T', '\0'};
+        constexpr int SEQLOCK_READ_ATTEMPTS = 100000; // A writer that died mid-update leaves the slot odd
+
+        struct RegionHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t header_size;
+            uint32_t slot_size;
+            uint32_t capacity;
+            std::atomic<uint32_t> slot_count; // High-water mark of assigned slots
+            uint32_t reserved;
+            std::atomic<uint64_t> generation;
+            char padding[24];
+        };
+
+        struct Slot
+        {
+            std::atomic<uint32_t> sequence; // Odd while the record is being written
+            uint32_t reserved;
+            FleetStateRecord record;
+        };
+
+        static_assert(sizeof(RegionHeader) == 64, "fleet state header layout changed");
+        static_assert(sizeof(FleetStateRecord) == 120, "fleet state record layout changed");
+        static_assert(sizeof(Slot) == 128, "fleet state slot layout changed");
+        static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                      "shared-memory atomics must be lock-free");
+
+        const RegionHeader *headerOf(const char *region)
+        {
+            return reinterpret_cast<const RegionHeader *>(region);
+        }
+
+        const Slot *slotsOf(const char *region)
+        {
+            return reinterpret_cast<const Slot *>(region + sizeof(RegionHeader));
+        }
+
+        int64_t timestampNs(const Timestamp &timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        // Copy a slot between two equal, even reads of its sequence
+        bool readRecord(const Slot &slot, FleetStateRecord &record)
+        {
+            for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; ++attempt)
+            {
+                uint32_t before = slot.sequence.load(std::memory_order_acquire);
+                if (before & 1)
+                {
+                    std::this_thread::yield(); // The writer may have been preempted mid-update
+                    continue;
+                }
+
+                std::memcpy(&record, &slot.record, sizeof(record));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace
+
+    std::optional<Position> FleetStateRecord::getPosition() const
+    {
+        if (!has_position)
+        {
+            return std::nullopt;
+        }
+        return Position(latitude, longitude, altitude, accuracy,
+                        Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                            std::chrono::nanoseconds(timestamp_ns))));
+    }
+
+    FleetStateTable::FleetStateTable(std::string name, size_t capacity)
+        : name_(std::move(name)), capacity_(capacity)
+    {
+    }
+
+    FleetStateTable::~FleetStateTable()
+    {
+#ifndef _WIN32
+        if (region_)
+        {
+            ::munmap(region_, region_size_);
+            ::shm_unlink(name_.c_str());
+        }
+#endif
+    }
+
+    bool FleetStateTable::create()
+    {
+#ifdef _WIN32
+        std::cerr << "Shared-memory fleet state is not supported on this platform." << std::endl;
+        return false;
+#else
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (region_)
+        {
+            return true;
+        }
+
+        // A region left behind by a crashed writer is replaced, not reused
+        ::shm_unlink(name_.c_str());
+        int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Failed to create shared memory " << name_ << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        region_size_ = sizeof(RegionHeader) + capacity_ * sizeof(Slot);
+        void *region = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(region_size_)) == 0)
+        {
+            region = ::mmap(nullptr, region_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (region == MAP_FAILED)
+        {
+            std::cerr << "Failed to map shared memory " << name_ << ": " << std::strerror(errno) << std::endl;
+            ::shm_unlink(name_.c_str());
+            return false;
+        }
+        region_ = static_cast<char *>(region);
+
+        // The region is zero-filled: every slot free, every sequence even
+        auto *header = new (region_) RegionHeader();
+        header->version = FLEET_STATE_LAYOUT_VERSION;
+        header->header_size = sizeof(RegionHeader);
+        header->slot_size = sizeof(Slot);
+        header->capacity = static_cast<uint32_t>(capacity_);
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            new (region_ + sizeof(RegionHeader) + i * sizeof(Slot)) Slot();
+        }
+
+        // Readers check the magic last
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, FLEET_STATE_MAGIC, sizeof(FLEET_STATE_MAGIC));
+        return true;
+#endif
+    }
+
+    bool FleetStateTable::publish(const Equipment &equipment)
+    {
+        const EquipmentId &id = equipment.getId();
+        if (id.empty() || id.size() >= FLEET_STATE_ID_SIZE)
+        {
+            std::cerr << "Equipment ID does not fit the fleet state table: " << id << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!region_)
+        {
+            return false;
+        }
+
+        auto *header = reinterpret_cast<RegionHeader *>(region_);
+        auto *slots = reinterpret_cast<Slot *>(region_ + sizeof(RegionHeader));
+
+        FleetStateRecord record{};
+        uint32_t slot;
+        auto it = slots_.find(id);
+        if (it != slots_.end())
+        {
+            slot = it->second;
+            record.updates = slots[slot].record.updates + 1;
+        }
+        else
+        {
+            if (!free_slots_.empty())
+            {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            }
+            else if (header->slot_count.load(std::memory_order_relaxed) < capacity_)
+            {
+                slot = header->slot_count.load(std::memory_order_relaxed);
+                header->slot_count.store(slot + 1, std::memory_order_release);
+            }
+            else
+            {
+                std::cerr << "Fleet state table " << name_ << " is full." << std::endl;
+                return false;
+            }
+            slots_.emplace(id, slot);
+            record.updates = 1;
+        }
+
+        std::memcpy(record.id, id.data(), id.size());
+        record.type = static_cast<uint8_t>(equipment.getType());
+        record.status = static_cast<uint8_t>(equipment.getStatus());
+        auto position = equipment.getLastPosition();
+        if (position)
+        {
+            record.has_position = 1;
+            record.latitude = position->getLatitude();
+            record.longitude = position->getLongitude();
+            record.altitude = position->getAltitude();
+            record.accuracy = position->getAccuracy();
+            record.timestamp_ns = timestampNs(position->getTimestamp());
+        }
+
+        writeSlot(slot, &record);
+        return true;
+    }
+
+    bool FleetStateTable::remove(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = slots_.find(id);
+        if (!region_ || it == slots_.end())
+        {
+            return false;
+        }
+
+        writeSlot(it->second, nullptr);
+        free_slots_.push_back(it->second);
+        slots_.erase(it);
+        return true;
+    }
+
+    void FleetStateTable::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (const auto &entry : slots_)
+        {
+            writeSlot(entry.second, nullptr);
+            free_slots_.push_back(entry.second);
+        }
+        slots_.clear();
+    }
+
+    size_t FleetStateTable::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+
+    void FleetStateTable::writeSlot(uint32_t slot, const FleetStateRecord *record)
+    {
+        auto *header = reinterpret_cast<RegionHeader *>(region_);
+        auto &target = reinterpret_cast<Slot *>(region_ + sizeof(RegionHeader))[slot];
+
+        uint32_t sequence = target.sequence.load(std::memory_order_relaxed);
+        target.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (record)
+        {
+            std::memcpy(&target.record, record, sizeof(*record));
+        }
+        else
+        {
+            std::memset(&target.record, 0, sizeof(target.record)); // Free
+        }
+
+        target.sequence.store(sequence + 2, std::memory_order_release);
+        header->generation.fetch_add(1, std::memory_order_release);
+    }
+
+    FleetStateReader::~FleetStateReader()
+    {
+        close();
+    }
+
+    bool FleetStateReader::open(const std::string &name)
+    {
+        close();
+#ifdef _WIN32
+        (void)name;
+        return false;
+#else
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        void *region = MAP_FAILED;
+        if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(RegionHeader))
+        {
+            region_size_ = static_cast<size_t>(info.st_size);
+            region = ::mmap(nullptr, region_size_, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (region == MAP_FAILED)
+        {
+            return false;
+        }
+        region_ = static_cast<const char *>(region);
+
+        // Only a layout this build understands is read
+        const RegionHeader *header = headerOf(region_);
+        bool known = std::memcmp(header->magic, FLEET_STATE_MAGIC, sizeof(FLEET_STATE_MAGIC)) == 0 &&
+                     header->version == FLEET_STATE_LAYOUT_VERSION &&
+                     header->header_size == sizeof(RegionHeader) &&
+                     header->slot_size == sizeof(Slot) &&
+                     sizeof(RegionHeader) + static_cast<size_t>(header->capacity) * sizeof(Slot) <= region_size_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!known)
+        {
+            std::cerr << "Unrecognized fleet state layout in " << name << std::endl;
+            close();
+            return false;
+        }
+
+        capacity_ = header->capacity;
+        return true;
+#endif
+    }
+
+    void FleetStateReader::close()
+    {
+#ifndef _WIN32
+        if (region_)
+        {
+            ::munmap(const_cast<char *>(region_), region_size_);
+        }
+#endif
+        region_ = nullptr;
+        region_size_ = 0;
+        capacity_ = 0;
+        index_.clear();
+        indexed_generation_ = 0;
+    }
+
+    uint64_t FleetStateReader::getGeneration() const
+    {
+        return region_ ? headerOf(region_)->generation.load(std::memory_order_acquire) : 0;
+    }
+
+    size_t FleetStateReader::getSlotCount() const
+    {
+        return region_ ? std::min<size_t>(headerOf(region_)->slot_count.load(std::memory_order_acquire), capacity_)
+                       : 0;
+    }
+
+    bool FleetStateReader::readSlot(size_t slot, FleetStateRecord &record) const
+    {
+        if (!region_ || slot >= capacity_)
+        {
+            return false;
+        }
+        return readRecord(slotsOf(region_)[slot], record) && record.id[0] != '\0';
+    }
+
+    std::optional<FleetStateRecord> FleetStateReader::find(const EquipmentId &id) const
+    {
+        if (!region_ || id.empty() || id.size() >= FLEET_STATE_ID_SIZE)
+        {
+            return std::nullopt;
+        }
+
+        // The cached slot is trusted only if it still holds this ID
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            auto it = index_.find(id);
+            FleetStateRecord record;
+            if (it != index_.end() && readSlot(it->second, record) && id == record.id)
+            {
+                return record;
+            }
+            if (pass == 0 && indexed_generation_ != getGeneration())
+            {
+                rebuildIndex();
+            }
+            else
+            {
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<FleetStateRecord> FleetStateReader::readAll() const
+    {
+        std::vector<FleetStateRecord> records;
+        size_t count = getSlotCount();
+        records.reserve(count);
+
+        FleetStateRecord record;
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            if (readSlot(slot, record))
+            {
+                records.push_back(record);
+            }
+        }
+        return records;
+    }
+
+    void FleetStateReader::rebuildIndex() const
+    {
+        indexed_generation_ = getGeneration();
+        index_.clear();
+
+        FleetStateRecord record;
+        size_t count = getSlotCount();
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            if (readSlot(slot, record))
+            {
+                index_.emplace(record.id, slot);
+            }
+        }
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+#include "equipment_tracker/fleet_tiles.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr double MERCATOR_MAX_LATITUDE = 85.0511287798066;
+        constexpr double PI = 3.14159265358979323846;
+
+        std::shared_ptr<const FleetTile> emptyTile(int zoom, uint32_t x, uint32_t y)
+        {
+            auto tile = std::make_shared<FleetTile>();
+            tile->zoom = zoom;
+            tile->x = x;
+            tile->y = y;
+            return tile;
+        }
+    } // namespace
+
+    void FleetTileIndex::update(const Equipment &equipment)
+    {
+        auto position = equipment.getLastPosition();
+        if (!position)
+        {
+            remove(equipment.getId());
+            return;
+        }
+
+        TilePoint point{equipment.getId(), equipment.getType(), equipment.getStatus(),
+                        position->getLatitude(), position->getLongitude()};
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = machines_.find(point.id);
+        if (it != machines_.end())
+        {
+            subtract(it->second);
+            it->second = point;
+        }
+        else
+        {
+            machines_.emplace(point.id, point);
+        }
+        add(point);
+    }
+
+    void FleetTileIndex::remove(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = machines_.find(id);
+        if (it == machines_.end())
+        {
+            return;
+        }
+        subtract(it->second);
+        machines_.erase(it);
+    }
+
+    void FleetTileIndex::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        machines_.clear();
+        cells_.clear();
+        buckets_.clear();
+        cache_.clear();
+    }
+
+    size_t FleetTileIndex::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return machines_.size();
+    }
+
+    std::shared_ptr<const FleetTile> FleetTileIndex::getTile(int zoom, uint32_t x, uint32_t y) const
+    {
+        if (zoom < 0 || zoom > FLEET_TILE_MAX_ZOOM)
+        {
+            return nullptr;
+        }
+        uint64_t tiles_per_side = uint64_t(1) << zoom;
+        if (x >= tiles_per_side || y >= tiles_per_side)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t key = tileKey(zoom, x, y);
+
+        // The entry a tile is built from carries the version it is valid for
+        const Cell *cell = nullptr;
+        const Bucket *bucket = nullptr;
+        uint64_t version = 0;
+        if (zoom < FLEET_TILE_POINT_ZOOM)
+        {
+            auto it = cells_.find(key);
+            if (it != cells_.end())
+            {
+                cell = &it->second;
+                version = cell->version;
+            }
+        }
+        else
+        {
+            int shift = zoom - FLEET_TILE_POINT_ZOOM;
+            auto it = buckets_.find(tileKey(FLEET_TILE_POINT_ZOOM, x >> shift, y >> shift));
+            if (it != buckets_.end())
+            {
+                bucket = &it->second;
+                version = bucket->version;
+            }
+        }
+
+        if (!cell && !bucket)
+        {
+            cache_.erase(key);
+            return emptyTile(zoom, x, y);
+        }
+
+        auto cached = cache_.find(key);
+        if (cached != cache_.end() && cached->second.version == version)
+        {
+            return cached->second.tile;
+        }
+
+        auto tile = cell ? buildClusterTile(zoom, x, y, cell->count) : buildPointTile(zoom, x, y, *bucket);
+        if (cache_.size() >= FLEET_TILE_CACHE_ENTRIES && cached == cache_.end())
+        {
+            cache_.clear();
+        }
+        cache_[key] = CachedTile{version, tile};
+        return tile;
+    }
+
+    std::pair<uint32_t, uint32_t> FleetTileIndex::tileFor(double latitude, double longitude, int zoom)
+    {
+        double tiles_per_side = std::ldexp(1.0, zoom);
+        double lat = std::clamp(latitude, -MERCATOR_MAX_LATITUDE, MERCATOR_MAX_LATITUDE) * PI / 180.0;
+        double lon = std::remainder(longitude, 360.0); // -180 to 180
+
+        double x = (lon + 180.0) / 360.0 * tiles_per_side;
+        double y = (1.0 - std::asinh(std::tan(lat)) / PI) / 2.0 * tiles_per_side;
+        double last = tiles_per_side - 1.0;
+        return {static_cast<uint32_t>(std::clamp(std::floor(x), 0.0, last)),
+                static_cast<uint32_t>(std::clamp(std::floor(y), 0.0, last))};
+    }
+
+    uint64_t FleetTileIndex::tileKey(int zoom, uint32_t x, uint32_t y)
+    {
+        return (static_cast<uint64_t>(zoom) << 58) | (static_cast<uint64_t>(x) << 29) | y;
+    }
+
+    void FleetTileIndex::add(const TilePoint &point)
+    {
+        auto [x, y] = tileFor(point.latitude, point.longitude, FLEET_TILE_CELL_ZOOM);
+        for (int zoom = FLEET_TILE_CELL_ZOOM; zoom >= 0; --zoom)
+        {
+            int shift = FLEET_TILE_CELL_ZOOM - zoom;
+            Cell &cell = cells_[tileKey(zoom, x >> shift, y >> shift)];
+            ++cell.count;
+            cell.latitude_sum += point.latitude;
+            cell.longitude_sum += point.longitude;
+            cell.version = ++next_version_;
+        }
+
+        int shift = FLEET_TILE_CELL_ZOOM - FLEET_TILE_POINT_ZOOM;
+        Bucket &bucket = buckets_[tileKey(FLEET_TILE_POINT_ZOOM, x >> shift, y >> shift)];
+        bucket.points[point.id] = point;
+        bucket.version = ++next_version_;
+    }
+
+    void FleetTileIndex::subtract(const TilePoint &point)
+    {
+        auto [x, y] = tileFor(point.latitude, point.longitude, FLEET_TILE_CELL_ZOOM);
+        for (int zoom = FLEET_TILE_CELL_ZOOM; zoom >= 0; --zoom)
+        {
+            int shift = FLEET_TILE_CELL_ZOOM - zoom;
+            auto it = cells_.find(tileKey(zoom, x >> shift, y >> shift));
+            if (it == cells_.end())
+            {
+                continue;
+            }
+            // Dropped when empty, so rounding errors in the sums never accumulate
+            if (--it->second.count == 0)
+            {
+                cells_.erase(it);
+                continue;
+            }
+            it->second.latitude_sum -= point.latitude;
+            it->second.longitude_sum -= point.longitude;
+            it->second.version = ++next_version_;
+        }
+
+        int shift = FLEET_TILE_CELL_ZOOM - FLEET_TILE_POINT_ZOOM;
+        auto it = buckets_.find(tileKey(FLEET_TILE_POINT_ZOOM, x >> shift, y >> shift));
+        if (it != buckets_.end())
+        {
+            it->second.points.erase(point.id);
+            it->second.version = ++next_version_;
+            if (it->second.points.empty())
+            {
+                buckets_.erase(it);
+            }
+        }
+    }
+
+    std::shared_ptr<const FleetTile> FleetTileIndex::buildClusterTile(int zoom, uint32_t x, uint32_t y,
+                                                                      uint32_t count) const
+    {
+        auto tile = std::make_shared<FleetTile>();
+        tile->zoom = zoom;
+        tile->x = x;
+        tile->y = y;
+        tile->count = count;
+
+        // Cells are the tile's descendants FLEET_TILE_CLUSTER_BITS levels down
+        constexpr uint32_t side = 1u << FLEET_TILE_CLUSTER_BITS;
+        for (uint32_t cell_y = 0; cell_y < side; ++cell_y)
+        {
+            for (uint32_t cell_x = 0; cell_x < side; ++cell_x)
+            {
+                auto it = cells_.find(tileKey(zoom + FLEET_TILE_CLUSTER_BITS,
+                                              (x << FLEET_TILE_CLUSTER_BITS) + cell_x,
+                                              (y << FLEET_TILE_CLUSTER_BITS) + cell_y));
+                if (it != cells_.end())
+                {
+                    const Cell &cell = it->second;
+                    tile->clusters.push_back({cell.latitude_sum / cell.count, cell.longitude_sum / cell.count,
+                                              cell.count});
+                }
+            }
+        }
+        return tile;
+    }
+
+    std::shared_ptr<const FleetTile> FleetTileIndex::buildPointTile(int zoom, uint32_t x, uint32_t y,
+                                                                    const Bucket &bucket) const
+    {
+        auto tile = std::make_shared<FleetTile>();
+        tile->zoom = zoom;
+        tile->x = x;
+        tile->y = y;
+
+        for (const auto &[id, point] : bucket.points)
+        {
+            if (zoom == FLEET_TILE_POINT_ZOOM || tileFor(point.latitude, point.longitude, zoom) == std::make_pair(x, y))
+            {
+                tile->points.push_back(point);
+            }
+        }
+        std::sort(tile->points.begin(), tile->points.end(),
+                  [](const TilePoint &a, const TilePoint &b)
+                  {
+                      return a.id < b.id;
+                  });
+        tile->count = static_cast<uint32_t>(tile->points.size());
+        return tile;
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include "equipment_tracker/hash_ring.h"
+
+namespace equipment_tracker
+{
+
+    ConsistentHashRing::ConsistentHashRing(size_t virtual_nodes)
+        : virtual_nodes_(std::max<size_t>(virtual_nodes, 1))
+    {
+    }
+
+    bool ConsistentHashRing::addNode(const std::string &node)
+    {
+        if (!nodes_.insert(node).second)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < virtual_nodes_; ++i)
+        {
+            points_.emplace_back(hash(node + "#" + std::to_string(i)), node);
+        }
+        std::sort(points_.begin(), points_.end());
+        return true;
+    }
+
+    bool ConsistentHashRing::removeNode(const std::string &node)
+    {
+        if (nodes_.erase(node) == 0)
+        {
+            return false;
+        }
+
+        points_.erase(std::remove_if(points_.begin(), points_.end(),
+                                     [&node](const std::pair<uint64_t, std::string> &point)
+                                     {
+                                         return point.second == node;
+                                     }),
+                      points_.end());
+        return true;
+    }
+
+    std::optional<std::string> ConsistentHashRing::ownerOf(std::string_view key) const
+    {
+        if (points_.empty())
+        {
+            return std::nullopt;
+        }
+
+        // First point at or after the key, wrapping around the ring
+        uint64_t position = hash(key);
+        auto it = std::lower_bound(points_.begin(), points_.end(), position,
+                                   [](const std::pair<uint64_t, std::string> &point, uint64_t value)
+                                   {
+                                       return point.first < value;
+                                   });
+        return it == points_.end() ? points_.front().second : it->second;
+    }
+
+    uint64_t ConsistentHashRing::hash(std::string_view key)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : key)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+
+        // FNV alone clusters similar IDs ("EQ-1", "EQ-2"); mix the bits (MurmurHash3 fmix64)
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+} // namespace equipment_tracker
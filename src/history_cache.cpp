@@ -0,0 +1,239 @@
+#include <utility>
+#include "equipment_tracker/history_cache.h"
+
+namespace equipment_tracker
+{
+
+    HistoryCache::HistoryCache(Loader loader, size_t budget_bytes, size_t max_positions)
+        : loader_(std::move(loader)), max_positions_(max_positions), budget_bytes_(budget_bytes)
+    {
+    }
+
+    std::vector<Position> HistoryCache::get(const EquipmentId &id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto it = index_.find(id);
+            if (it != index_.end())
+            {
+                ++hits_;
+                Entry &entry = entries_[it->second];
+                entry.referenced = true;
+                return entry.history;
+            }
+
+            ++misses_;
+            loading_.try_emplace(id);
+        }
+
+        // Storage reads can be slow; other equipment stays available meanwhile
+        std::vector<Position> history = loader_ ? loader_(id, max_positions_) : std::vector<Position>();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto refetch = loading_.find(id);
+        if (refetch == loading_.end())
+        {
+            // A concurrent refetch of the same equipment finished first
+            return history;
+        }
+
+        // Fixes recorded during the read that it may not have seen
+        for (const auto &position : refetch->second.recorded)
+        {
+            if (history.empty() || history.back().getTimestamp() < position.getTimestamp())
+            {
+                history.push_back(position);
+            }
+        }
+        if (history.size() > max_positions_)
+        {
+            history.erase(history.begin(), history.end() - max_positions_);
+        }
+
+        bool cancelled = refetch->second.cancelled;
+        loading_.erase(refetch);
+        if (cancelled || index_.count(id) != 0)
+        {
+            return history;
+        }
+
+        insert(id, history);
+        evict();
+        return history;
+    }
+
+    void HistoryCache::record(const EquipmentId &id, const Position &position)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index_.find(id);
+        if (it == index_.end())
+        {
+            auto refetch = loading_.find(id);
+            if (refetch != loading_.end())
+            {
+                refetch->second.recorded.push_back(position);
+            }
+            return;
+        }
+
+        Entry &entry = entries_[it->second];
+        if (entry.history.size() >= max_positions_)
+        {
+            entry.history.erase(entry.history.begin());
+        }
+        entry.history.push_back(position);
+        entry.referenced = true;
+
+        account(entry);
+        evict();
+    }
+
+    void HistoryCache::put(const EquipmentId &id, std::vector<Position> history)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (history.size() > max_positions_)
+        {
+            history.erase(history.begin(), history.end() - max_positions_);
+        }
+
+        auto it = index_.find(id);
+        if (it != index_.end())
+        {
+            Entry &entry = entries_[it->second];
+            entry.history = std::move(history);
+            entry.referenced = true;
+            account(entry);
+        }
+        else
+        {
+            insert(id, std::move(history));
+        }
+
+        auto refetch = loading_.find(id);
+        if (refetch != loading_.end())
+        {
+            refetch->second.cancelled = true; // Superseded
+        }
+        evict();
+    }
+
+    void HistoryCache::erase(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index_.find(id);
+        if (it != index_.end())
+        {
+            release(it->second);
+        }
+
+        auto refetch = loading_.find(id);
+        if (refetch != loading_.end())
+        {
+            refetch->second.cancelled = true;
+        }
+    }
+
+    void HistoryCache::setBudget(size_t budget_bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_bytes_ = budget_bytes;
+        evict();
+    }
+
+    HistoryCacheStats HistoryCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        HistoryCacheStats stats;
+        stats.hits = hits_;
+        stats.misses = misses_;
+        stats.evictions = evictions_;
+        stats.resident_entries = index_.size();
+        stats.resident_bytes = resident_bytes_;
+        stats.budget_bytes = budget_bytes_;
+        return stats;
+    }
+
+    bool HistoryCache::isResident(const EquipmentId &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.count(id) != 0;
+    }
+
+    void HistoryCache::insert(const EquipmentId &id, std::vector<Position> history)
+    {
+        size_t slot;
+        if (!free_entries_.empty())
+        {
+            slot = free_entries_.back();
+            free_entries_.pop_back();
+        }
+        else
+        {
+            slot = entries_.size();
+            entries_.emplace_back();
+        }
+
+        Entry &entry = entries_[slot];
+        entry.id = id;
+        entry.history = std::move(history);
+        entry.referenced = true;
+        entry.occupied = true;
+        entry.bytes = 0;
+        account(entry);
+
+        index_.emplace(id, slot);
+    }
+
+    void HistoryCache::account(Entry &entry)
+    {
+        // The entry, its history buffer and its index node (which copies the ID), roughly
+        size_t bytes = sizeof(Entry) + entry.history.capacity() * sizeof(Position) +
+                       sizeof(std::pair<const EquipmentId, size_t>) + 2 * entry.id.capacity();
+        resident_bytes_ = resident_bytes_ - entry.bytes + bytes;
+        entry.bytes = bytes;
+    }
+
+    void HistoryCache::release(size_t slot)
+    {
+        Entry &entry = entries_[slot];
+        resident_bytes_ -= entry.bytes;
+        index_.erase(entry.id);
+
+        entry = Entry(); // Frees the history buffer
+        free_entries_.push_back(slot);
+    }
+
+    void HistoryCache::evict()
+    {
+        // CLOCK: referenced entries get a second chance, the rest go
+        while (resident_bytes_ > budget_bytes_ && !index_.empty())
+        {
+            if (hand_ >= entries_.size())
+            {
+                hand_ = 0;
+            }
+
+            Entry &entry = entries_[hand_];
+            if (entry.occupied)
+            {
+                if (entry.referenced)
+                {
+                    entry.referenced = false;
+                }
+                else
+                {
+                    release(hand_);
+                    ++evictions_;
+                }
+            }
+            ++hand_;
+        }
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include "equipment_tracker/history_export.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        int64_t toNanoseconds(const Timestamp &timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        std::string quoteJson(std::string_view text)
+        {
+            static const char hex[] = "0123456789abcdef";
+            std::string quoted = "\"";
+            for (char c : text)
+            {
+                unsigned char byte = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\')
+                {
+                    quoted += '\\';
+                    quoted += c;
+                }
+                else if (byte < 0x20)
+                {
+                    quoted += "\\u00";
+                    quoted += hex[byte >> 4];
+                    quoted += hex[byte & 0xF];
+                }
+                else
+                {
+                    quoted += c;
+                }
+            }
+            quoted += '"';
+            return quoted;
+        }
+
+        // Quoted only when it contains a separator, quote or line break
+        std::string quoteCsv(const std::string &text)
+        {
+            if (text.find_first_of(",\"\r\n") == std::string::npos)
+            {
+                return text;
+            }
+            std::string quoted = "\"";
+            for (char c : text)
+            {
+                quoted += c;
+                if (c == '"')
+                {
+                    quoted += '"';
+                }
+            }
+            quoted += '"';
+            return quoted;
+        }
+
+        // [lon,lat,alt]
+        void appendCoordinates(BufferedSink &sink, const Position &position)
+        {
+            sink.append('[');
+            sink.appendDouble(position.getLongitude());
+            sink.append(',');
+            sink.appendDouble(position.getLatitude());
+            sink.append(',');
+            sink.appendDouble(position.getAltitude());
+            sink.append(']');
+        }
+    } // namespace
+
+    BufferedSink::BufferedSink(std::ostream &out, size_t capacity)
+        : out_(out), buffer_(std::max<size_t>(capacity, 64))
+    {
+    }
+
+    BufferedSink::~BufferedSink()
+    {
+        flush();
+    }
+
+    char *BufferedSink::reserve(size_t bytes)
+    {
+        if (buffer_.size() - used_ < bytes)
+        {
+            flush();
+            if (buffer_.size() < bytes)
+            {
+                buffer_.resize(bytes);
+            }
+        }
+        return buffer_.data() + used_;
+    }
+
+    void BufferedSink::append(std::string_view text)
+    {
+        if (text.size() > buffer_.size())
+        {
+            // Too big to be worth copying
+            flush();
+            out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+            bytes_flushed_ += text.size();
+            return;
+        }
+        std::memcpy(reserve(text.size()), text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void BufferedSink::append(char c)
+    {
+        *reserve(1) = c;
+        ++used_;
+    }
+
+    void BufferedSink::appendInteger(int64_t value)
+    {
+        char *first = reserve(24);
+        used_ += std::to_chars(first, first + 24, value).ptr - first;
+    }
+
+    void BufferedSink::appendDouble(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            append(std::string_view("null"));
+            return;
+        }
+        char *first = reserve(32);
+        used_ += std::to_chars(first, first + 32, value).ptr - first;
+    }
+
+    void BufferedSink::appendJsonString(std::string_view text)
+    {
+        append(quoteJson(text));
+    }
+
+    bool BufferedSink::flush()
+    {
+        if (used_ > 0)
+        {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+            bytes_flushed_ += used_;
+            used_ = 0;
+        }
+        return out_.good();
+    }
+
+    HistoryExporter::HistoryExporter(DataStorage &storage)
+        : storage_(storage)
+    {
+    }
+
+    bool HistoryExporter::exportHistory(const std::vector<EquipmentId> &ids, HistoryExportFormat format,
+                                        std::ostream &out, const Timestamp &start, const Timestamp &end)
+    {
+        stats_ = HistoryExportStats();
+        BufferedSink sink(out);
+
+        bool geojson = format == HistoryExportFormat::GeoJsonPoints ||
+                       format == HistoryExportFormat::GeoJsonLineStrings;
+        if (format == HistoryExportFormat::Csv)
+        {
+            sink.append(std::string_view("equipment_id,timestamp_ns,latitude,longitude,altitude,accuracy\n"));
+        }
+        else if (geojson)
+        {
+            sink.append(std::string_view("{\"type\":\"FeatureCollection\",\"features\":["));
+        }
+
+        bool first_feature = true;
+        auto beginFeature = [&]()
+        {
+            sink.append(std::string_view(first_feature ? "\n" : ",\n"));
+            first_feature = false;
+        };
+
+        for (const auto &id : ids)
+        {
+            // The ID is escaped once per machine, not once per fix
+            std::string json_id = quoteJson(id);
+            std::string csv_id = quoteCsv(id);
+
+            uint64_t fixes = 0;
+            std::optional<Position> first_fix;
+            int64_t first_ns = 0;
+            int64_t last_ns = 0;
+
+            storage_.scanPositionHistory(
+                id, start, end,
+                [&](const std::vector<Position> &chunk)
+                {
+                    for (const auto &position : chunk)
+                    {
+                        int64_t timestamp_ns = toNanoseconds(position.getTimestamp());
+                        switch (format)
+                        {
+                        case HistoryExportFormat::Csv:
+                            sink.append(csv_id);
+                            sink.append(',');
+                            sink.appendInteger(timestamp_ns);
+                            sink.append(',');
+                            sink.appendDouble(position.getLatitude());
+                            sink.append(',');
+                            sink.appendDouble(position.getLongitude());
+                            sink.append(',');
+                            sink.appendDouble(position.getAltitude());
+                            sink.append(',');
+                            sink.appendDouble(position.getAccuracy());
+                            sink.append('\n');
+                            break;
+                        case HistoryExportFormat::Ndjson:
+                            sink.append(std::string_view("{\"equipment_id\":"));
+                            sink.append(json_id);
+                            sink.append(std::string_view(",\"timestamp_ns\":"));
+                            sink.appendInteger(timestamp_ns);
+                            sink.append(std::string_view(",\"latitude\":"));
+                            sink.appendDouble(position.getLatitude());
+                            sink.append(std::string_view(",\"longitude\":"));
+                            sink.appendDouble(position.getLongitude());
+                            sink.append(std::string_view(",\"altitude\":"));
+                            sink.appendDouble(position.getAltitude());
+                            sink.append(std::string_view(",\"accuracy\":"));
+                            sink.appendDouble(position.getAccuracy());
+                            sink.append(std::string_view("}\n"));
+                            break;
+                        case HistoryExportFormat::GeoJsonPoints:
+                            beginFeature();
+                            sink.append(std::string_view("{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":"));
+                            appendCoordinates(sink, position);
+                            sink.append(std::string_view("},\"properties\":{\"equipment_id\":"));
+                            sink.append(json_id);
+                            sink.append(std::string_view(",\"timestamp_ns\":"));
+                            sink.appendInteger(timestamp_ns);
+                            sink.append(std::string_view(",\"accuracy\":"));
+                            sink.appendDouble(position.getAccuracy());
+                            sink.append(std::string_view("}}"));
+                            break;
+                        case HistoryExportFormat::GeoJsonLineStrings:
+                            // The geometry type depends on whether a second fix follows
+                            if (fixes == 0)
+                            {
+                                first_fix = position;
+                                first_ns = timestamp_ns;
+                            }
+                            else
+                            {
+                                if (fixes == 1)
+                                {
+                                    beginFeature();
+                                    sink.append(std::string_view("{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\",\"coordinates\":["));
+                                    appendCoordinates(sink, *first_fix);
+                                }
+                                sink.append(',');
+                                appendCoordinates(sink, position);
+                            }
+                            break;
+                        }
+                        last_ns = timestamp_ns;
+                        ++fixes;
+                    }
+                    return sink.good();
+                });
+
+            if (fixes == 0)
+            {
+                continue;
+            }
+            ++stats_.equipment;
+            stats_.fixes += fixes;
+
+            if (format == HistoryExportFormat::GeoJsonLineStrings)
+            {
+                if (fixes == 1)
+                {
+                    beginFeature();
+                    sink.append(std::string_view("{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":"));
+                    appendCoordinates(sink, *first_fix);
+                    sink.append('}');
+                }
+                else
+                {
+                    sink.append(std::string_view("]}"));
+                }
+                sink.append(std::string_view(",\"properties\":{\"equipment_id\":"));
+                sink.append(json_id);
+                sink.append(std::string_view(",\"fixes\":"));
+                sink.appendInteger(static_cast<int64_t>(fixes));
+                sink.append(std::string_view(",\"start_ns\":"));
+                sink.appendInteger(first_ns);
+                sink.append(std::string_view(",\"end_ns\":"));
+                sink.appendInteger(last_ns);
+                sink.append(std::string_view("}}"));
+            }
+        }
+
+        if (geojson)
+        {
+            sink.append(std::string_view("\n]}\n"));
+        }
+        bool ok = sink.flush();
+        stats_.bytes = sink.getBytesWritten();
+        return ok;
+    }
+
+} // namespace equipment_tracker
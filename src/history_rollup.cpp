@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "equipment_tracker/history_rollup.h"
+#include "equipment_tracker/position_log.h"
+#include "equipment_tracker/utils/crc32c.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr size_t FIRST_OFFSET = 16;
+        constexpr size_t LAST_OFFSET = FIRST_OFFSET + POSITION_RECORD_SIZE;
+        constexpr size_t VALUES_OFFSET = LAST_OFFSET + POSITION_RECORD_SIZE;
+        constexpr size_t VALUE_COUNT = 11;
+        constexpr size_t CRC_OFFSET = VALUES_OFFSET + VALUE_COUNT * sizeof(double);
+        static_assert(CRC_OFFSET + 2 * sizeof(uint32_t) == ROLLUP_RECORD_SIZE, "rollup record layout");
+
+        int64_t toNanoseconds(const Timestamp &timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        Timestamp fromNanoseconds(int64_t ns)
+        {
+            return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(ns)));
+        }
+
+        // Start of the bucket of the given width holding ns, also before the epoch
+        int64_t bucketStart(int64_t ns, int64_t width_ns)
+        {
+            int64_t start = ns / width_ns * width_ns;
+            return start > ns ? start - width_ns : start;
+        }
+
+        bool readRecord(std::istream &in, uint64_t index, RollupBucket &bucket)
+        {
+            char record[ROLLUP_RECORD_SIZE];
+            in.seekg(static_cast<std::streamoff>(index * ROLLUP_RECORD_SIZE));
+            return in.read(record, sizeof(record)) && RollupBucket::decode(record, bucket);
+        }
+    } // namespace
+
+    void RollupBucket::add(const Position &fix, double leg_meters, double leg_seconds)
+    {
+        if (samples == 0)
+        {
+            first = fix;
+            last = fix;
+            min_latitude = max_latitude = fix.getLatitude();
+            min_longitude = max_longitude = fix.getLongitude();
+            min_altitude = max_altitude = fix.getAltitude();
+        }
+        else
+        {
+            if (fix.getTimestamp() < first.getTimestamp())
+            {
+                first = fix;
+            }
+            if (fix.getTimestamp() >= last.getTimestamp())
+            {
+                last = fix;
+            }
+            min_latitude = std::min(min_latitude, fix.getLatitude());
+            max_latitude = std::max(max_latitude, fix.getLatitude());
+            min_longitude = std::min(min_longitude, fix.getLongitude());
+            max_longitude = std::max(max_longitude, fix.getLongitude());
+            min_altitude = std::min(min_altitude, fix.getAltitude());
+            max_altitude = std::max(max_altitude, fix.getAltitude());
+        }
+
+        ++samples;
+        latitude_sum += fix.getLatitude();
+        longitude_sum += fix.getLongitude();
+        altitude_sum += fix.getAltitude();
+        distance_meters += leg_meters;
+        if (leg_seconds > 0.0)
+        {
+            max_speed_mps = std::max(max_speed_mps, leg_meters / leg_seconds);
+        }
+    }
+
+    void RollupBucket::merge(const RollupBucket &other)
+    {
+        if (other.samples == 0)
+        {
+            return;
+        }
+        if (samples == 0)
+        {
+            int64_t start = start_ns;
+            *this = other;
+            start_ns = start;
+            return;
+        }
+
+        if (other.first.getTimestamp() < first.getTimestamp())
+        {
+            first = other.first;
+        }
+        if (other.last.getTimestamp() >= last.getTimestamp())
+        {
+            last = other.last;
+        }
+        samples += other.samples;
+        min_latitude = std::min(min_latitude, other.min_latitude);
+        max_latitude = std::max(max_latitude, other.max_latitude);
+        min_longitude = std::min(min_longitude, other.min_longitude);
+        max_longitude = std::max(max_longitude, other.max_longitude);
+        min_altitude = std::min(min_altitude, other.min_altitude);
+        max_altitude = std::max(max_altitude, other.max_altitude);
+        latitude_sum += other.latitude_sum;
+        longitude_sum += other.longitude_sum;
+        altitude_sum += other.altitude_sum;
+        distance_meters += other.distance_meters;
+        max_speed_mps = std::max(max_speed_mps, other.max_speed_mps);
+    }
+
+    PositionAggregate RollupBucket::toAggregate(int64_t width_ns) const
+    {
+        PositionAggregate aggregate;
+        aggregate.bucket_start = fromNanoseconds(start_ns);
+        aggregate.bucket_end = fromNanoseconds(start_ns + width_ns);
+        aggregate.samples = samples;
+        aggregate.first = first;
+        aggregate.last = last;
+        aggregate.min_latitude = min_latitude;
+        aggregate.max_latitude = max_latitude;
+        aggregate.min_longitude = min_longitude;
+        aggregate.max_longitude = max_longitude;
+        aggregate.min_altitude = min_altitude;
+        aggregate.max_altitude = max_altitude;
+        if (samples > 0)
+        {
+            aggregate.avg_latitude = latitude_sum / samples;
+            aggregate.avg_longitude = longitude_sum / samples;
+            aggregate.avg_altitude = altitude_sum / samples;
+        }
+        aggregate.distance_meters = distance_meters;
+        aggregate.max_speed_mps = max_speed_mps;
+        return aggregate;
+    }
+
+    void RollupBucket::encode(char *out) const
+    {
+        std::memset(out, 0, ROLLUP_RECORD_SIZE);
+        std::memcpy(out, &start_ns, sizeof(start_ns));
+        std::memcpy(out + 8, &samples, sizeof(samples));
+        encodePositionRecord(first, out + FIRST_OFFSET);
+        encodePositionRecord(last, out + LAST_OFFSET);
+
+        const double values[VALUE_COUNT] = {min_latitude, max_latitude, min_longitude, max_longitude,
+                                            min_altitude, max_altitude, latitude_sum, longitude_sum,
+                                            altitude_sum, distance_meters, max_speed_mps};
+        std::memcpy(out + VALUES_OFFSET, values, sizeof(values));
+
+        uint32_t crc = crc32c(out, CRC_OFFSET);
+        std::memcpy(out + CRC_OFFSET, &crc, sizeof(crc));
+    }
+
+    bool RollupBucket::decode(const char *data, RollupBucket &bucket)
+    {
+        uint32_t crc;
+        std::memcpy(&crc, data + CRC_OFFSET, sizeof(crc));
+        if (crc != crc32c(data, CRC_OFFSET))
+        {
+            return false;
+        }
+
+        auto first = decodePositionRecords(data + FIRST_OFFSET, POSITION_RECORD_SIZE);
+        auto last = decodePositionRecords(data + LAST_OFFSET, POSITION_RECORD_SIZE);
+        if (first.size() != 1 || last.size() != 1)
+        {
+            return false;
+        }
+
+        std::memcpy(&bucket.start_ns, data, sizeof(bucket.start_ns));
+        std::memcpy(&bucket.samples, data + 8, sizeof(bucket.samples));
+        bucket.first = first[0];
+        bucket.last = last[0];
+
+        double values[VALUE_COUNT];
+        std::memcpy(values, data + VALUES_OFFSET, sizeof(values));
+        bucket.min_latitude = values[0];
+        bucket.max_latitude = values[1];
+        bucket.min_longitude = values[2];
+        bucket.max_longitude = values[3];
+        bucket.min_altitude = values[4];
+        bucket.max_altitude = values[5];
+        bucket.latitude_sum = values[6];
+        bucket.longitude_sum = values[7];
+        bucket.altitude_sum = values[8];
+        bucket.distance_meters = values[9];
+        bucket.max_speed_mps = values[10];
+        return bucket.samples > 0;
+    }
+
+    HistoryRollup::HistoryRollup(const std::filesystem::path &directory)
+        : directory_(directory)
+    {
+        for (size_t i = 0; i < ROLLUP_LEVEL_COUNT; ++i)
+        {
+            levels_[i].width_ns = ROLLUP_LEVEL_SECONDS[i] * 1000000000LL;
+            levels_[i].path = directory_ / ("rollup-" + std::to_string(ROLLUP_LEVEL_SECONDS[i]) + ".bin");
+        }
+    }
+
+    std::optional<int64_t> HistoryRollup::open()
+    {
+        std::optional<int64_t> replay_from;
+        bool complete = true;
+
+        for (auto &level : levels_)
+        {
+            level.records = 0;
+            level.last_stored_start.reset();
+            level.open.reset();
+
+            std::error_code error;
+            uint64_t size = std::filesystem::file_size(level.path, error);
+            if (error)
+            {
+                complete = false;
+                continue;
+            }
+
+            // Drop a torn or corrupt tail; replay rebuilds what it held
+            level.records = size / ROLLUP_RECORD_SIZE;
+            RollupBucket last;
+            {
+                std::ifstream in(level.path, std::ios::binary);
+                while (level.records > 0 && !readRecord(in, level.records - 1, last))
+                {
+                    --level.records;
+                }
+            }
+            if (level.records * ROLLUP_RECORD_SIZE != size)
+            {
+                std::cerr << "Rollup " << level.path << " truncated to " << level.records << " records" << std::endl;
+                std::filesystem::resize_file(level.path, level.records * ROLLUP_RECORD_SIZE, error);
+            }
+            if (level.records == 0)
+            {
+                complete = false;
+                continue;
+            }
+
+            level.last_stored_start = last.start_ns;
+            int64_t stored_until = last.start_ns + level.width_ns;
+            if (!replay_from || stored_until < *replay_from)
+            {
+                // Every fix before this point is stored, the latest in this record
+                replay_from = stored_until;
+                previous_ = last.last;
+            }
+        }
+
+        if (!complete)
+        {
+            previous_.reset();
+            return std::nullopt;
+        }
+        return replay_from;
+    }
+
+    bool HistoryRollup::add(const Position &fix, bool replay)
+    {
+        int64_t timestamp_ns = toNanoseconds(fix.getTimestamp());
+
+        // Distance and speed only follow fixes in time order
+        double leg_meters = 0.0;
+        double leg_seconds = 0.0;
+        bool in_order = !previous_ || fix.getTimestamp() >= previous_->getTimestamp();
+        if (previous_ && in_order)
+        {
+            leg_meters = previous_->distanceTo(fix);
+            leg_seconds = std::chrono::duration<double>(fix.getTimestamp() - previous_->getTimestamp()).count();
+        }
+        if (in_order)
+        {
+            previous_ = fix;
+        }
+
+        bool ok = true;
+        for (auto &level : levels_)
+        {
+            int64_t start = bucketStart(timestamp_ns, level.width_ns);
+            bool stored = level.last_stored_start && start <= *level.last_stored_start;
+            if (stored && replay)
+            {
+                continue;
+            }
+
+            if (stored || (level.open && start < level.open->start_ns))
+            {
+                // Late fix for a bucket that is already closed (or was empty)
+                RollupBucket late;
+                late.start_ns = start;
+                late.add(fix, 0.0, 0.0);
+                ok = mergeStored(level, late) && ok;
+                continue;
+            }
+
+            if (level.open && start > level.open->start_ns)
+            {
+                ok = append(level, *level.open) && ok;
+                level.open.reset();
+            }
+            if (!level.open)
+            {
+                level.open = RollupBucket();
+                level.open->start_ns = start;
+            }
+            level.open->add(fix, in_order ? leg_meters : 0.0, leg_seconds);
+        }
+        return ok;
+    }
+
+    std::vector<PositionAggregate> HistoryRollup::query(const Timestamp &start, const Timestamp &end,
+                                                        std::chrono::seconds width) const
+    {
+        std::vector<PositionAggregate> result;
+        if (!supportsWidth(width) || end < start)
+        {
+            return result;
+        }
+
+        // The coarsest level whose buckets nest in the requested ones
+        int64_t width_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(width).count();
+        const Level *source = &levels_[0];
+        for (const auto &level : levels_)
+        {
+            if (width_ns % level.width_ns == 0)
+            {
+                source = &level;
+            }
+        }
+
+        int64_t from_ns = bucketStart(toNanoseconds(start), width_ns);
+        int64_t to_ns = bucketStart(toNanoseconds(end), width_ns) + width_ns - 1;
+
+        auto buckets = readStored(*source, from_ns, to_ns);
+        if (source->open && source->open->start_ns >= from_ns && source->open->start_ns <= to_ns)
+        {
+            buckets.push_back(*source->open);
+        }
+
+        RollupBucket current;
+        for (const auto &bucket : buckets)
+        {
+            int64_t bucket_start = bucketStart(bucket.start_ns, width_ns);
+            if (current.samples > 0 && bucket_start != current.start_ns)
+            {
+                result.push_back(current.toAggregate(width_ns));
+                current = RollupBucket();
+            }
+            current.start_ns = bucket_start;
+            current.merge(bucket);
+        }
+        if (current.samples > 0)
+        {
+            result.push_back(current.toAggregate(width_ns));
+        }
+        return result;
+    }
+
+    bool HistoryRollup::supportsWidth(std::chrono::seconds width)
+    {
+        return width.count() > 0 && width.count() % ROLLUP_LEVEL_SECONDS[0] == 0;
+    }
+
+    bool HistoryRollup::append(Level &level, const RollupBucket &bucket)
+    {
+        char record[ROLLUP_RECORD_SIZE];
+        bucket.encode(record);
+
+        std::ofstream out(level.path, std::ios::binary | std::ios::app);
+        if (!out.write(record, sizeof(record)))
+        {
+            std::cerr << "Failed to append rollup record to " << level.path << std::endl;
+            return false;
+        }
+        ++level.records;
+        level.last_stored_start = bucket.start_ns;
+        return true;
+    }
+
+    bool HistoryRollup::mergeStored(Level &level, const RollupBucket &bucket)
+    {
+        if (level.records == 0 || bucket.start_ns > *level.last_stored_start)
+        {
+            return append(level, bucket);
+        }
+
+        std::fstream file(level.path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+        {
+            std::cerr << "Failed to open rollup " << level.path << std::endl;
+            return false;
+        }
+
+        // First record starting at or after the bucket
+        uint64_t low = 0;
+        uint64_t high = level.records;
+        RollupBucket stored;
+        while (low < high)
+        {
+            uint64_t middle = low + (high - low) / 2;
+            if (!readRecord(file, middle, stored))
+            {
+                std::cerr << "Corrupt rollup record in " << level.path << std::endl;
+                return false;
+            }
+            if (stored.start_ns < bucket.start_ns)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        std::string tail;
+        RollupBucket merged = bucket;
+        if (low < level.records && readRecord(file, low, stored) && stored.start_ns == bucket.start_ns)
+        {
+            stored.merge(bucket);
+            merged = stored;
+        }
+        else
+        {
+            // Shift the later records up by one to make room
+            tail.resize((level.records - low) * ROLLUP_RECORD_SIZE);
+            file.seekg(static_cast<std::streamoff>(low * ROLLUP_RECORD_SIZE));
+            file.read(tail.data(), static_cast<std::streamsize>(tail.size()));
+            ++level.records;
+        }
+
+        char record[ROLLUP_RECORD_SIZE];
+        merged.encode(record);
+        file.clear();
+        file.seekp(static_cast<std::streamoff>(low * ROLLUP_RECORD_SIZE));
+        file.write(record, sizeof(record));
+        file.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+        if (!file)
+        {
+            std::cerr << "Failed to update rollup " << level.path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<RollupBucket> HistoryRollup::readStored(const Level &level, int64_t from_ns, int64_t to_ns) const
+    {
+        std::vector<RollupBucket> buckets;
+        if (level.records == 0)
+        {
+            return buckets;
+        }
+
+        std::ifstream in(level.path, std::ios::binary);
+        if (!in)
+        {
+            return buckets;
+        }
+
+        // Records are sorted by start; skip to the first one in range
+        uint64_t low = 0;
+        uint64_t high = level.records;
+        RollupBucket bucket;
+        while (low < high)
+        {
+            uint64_t middle = low + (high - low) / 2;
+            if (readRecord(in, middle, bucket) && bucket.start_ns < from_ns)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        std::vector<char> block(ROLLUP_RECORD_SIZE * 256);
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(low * ROLLUP_RECORD_SIZE));
+        for (uint64_t index = low; index < level.records;)
+        {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(level.records - index, 256));
+            if (!in.read(block.data(), static_cast<std::streamsize>(count * ROLLUP_RECORD_SIZE)))
+            {
+                break;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!RollupBucket::decode(block.data() + i * ROLLUP_RECORD_SIZE, bucket))
+                {
+                    std::cerr << "Skipping corrupt rollup record in " << level.path << std::endl;
+                    continue;
+                }
+                if (bucket.start_ns > to_ns)
+                {
+                    return buckets;
+                }
+                buckets.push_back(bucket);
+            }
+            index += count;
+        }
+        return buckets;
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,373 @@
+#include <algorithm>
+#include <cmath>
+#include "equipment_tracker/local_projection.h"
+
+// Define M_PI if not available
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        // WGS84 ellipsoid
+        constexpr double WGS84_SEMI_MAJOR_AXIS = 6378137.0;
+        constexpr double WGS84_ECCENTRICITY_SQ = 6.69437999014e-3;
+
+        constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+        // Sites whose origin is this close to the antimeridian need wrapping
+        constexpr double ANTIMERIDIAN_MARGIN_DEG = 10.0;
+
+        // Bring a longitude difference into [-180, 180]
+        inline double wrapLongitudeDelta(double delta)
+        {
+            if (delta > 180.0)
+            {
+                return delta - 360.0;
+            }
+            if (delta < -180.0)
+            {
+                return delta + 360.0;
+            }
+            return delta;
+        }
+    } // namespace
+
+    LocalProjection::LocalProjection(double origin_latitude, double origin_longitude)
+        : origin_lat_(origin_latitude),
+          origin_lon_(origin_longitude)
+    {
+        double phi = origin_latitude * DEG_TO_RAD;
+        double sin_phi = std::sin(phi);
+        double w = 1.0 - WGS84_ECCENTRICITY_SQ * sin_phi * sin_phi;
+
+        // Meridional (M) and prime vertical (N) radii of curvature
+        double m = WGS84_SEMI_MAJOR_AXIS * (1.0 - WGS84_ECCENTRICITY_SQ) / (w * std::sqrt(w));
+        double n = WGS84_SEMI_MAJOR_AXIS / std::sqrt(w);
+
+        meters_per_deg_lat_ = m * DEG_TO_RAD;
+        meters_per_deg_lon_ = n * std::cos(phi) * DEG_TO_RAD;
+
+        // d(N cos(phi))/d(phi) = -M sin(phi)
+        convergence_ = -m * sin_phi * DEG_TO_RAD * DEG_TO_RAD;
+    }
+
+    LocalPoint LocalProjection::project(double latitude, double longitude) const
+    {
+        double dlat = latitude - origin_lat_;
+        double dlon = wrapLongitudeDelta(longitude - origin_lon_);
+
+        LocalPoint point;
+        point.east = static_cast<float>(dlon * (meters_per_deg_lon_ + convergence_ * dlat));
+        point.north = static_cast<float>(dlat * meters_per_deg_lat_);
+        return point;
+    }
+
+    LocalPoint LocalProjection::project(const Position &position) const
+    {
+        return project(position.getLatitude(), position.getLongitude());
+    }
+
+    void LocalProjection::unproject(const LocalPoint &point, double &latitude, double &longitude) const
+    {
+        double dlat = point.north / meters_per_deg_lat_;
+        double dlon = point.east / (meters_per_deg_lon_ + convergence_ * dlat);
+
+        latitude = origin_lat_ + dlat;
+        longitude = origin_lon_ + dlon;
+        if (longitude > 180.0)
+        {
+            longitude -= 360.0;
+        }
+        else if (longitude < -180.0)
+        {
+            longitude += 360.0;
+        }
+    }
+
+    void LocalProjection::projectBatch(const double *latitudes, const double *longitudes, size_t count,
+                                       float *east, float *north) const
+    {
+        // Hoist members into locals so the compiler can prove no aliasing
+        const double origin_lat = origin_lat_;
+        const double origin_lon = origin_lon_;
+        const double k_lat = meters_per_deg_lat_;
+        const double k_lon = meters_per_deg_lon_;
+        const double k_conv = convergence_;
+
+        if (std::abs(origin_lon) > 180.0 - ANTIMERIDIAN_MARGIN_DEG)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                double dlat = latitudes[i] - origin_lat;
+                double dlon = wrapLongitudeDelta(longitudes[i] - origin_lon);
+                east[i] = static_cast<float>(dlon * (k_lon + k_conv * dlat));
+                north[i] = static_cast<float>(dlat * k_lat);
+            }
+            return;
+        }
+
+        // Common case: no wrapping, so the loop is straight-line arithmetic
+        for (size_t i = 0; i < count; ++i)
+        {
+            double dlat = latitudes[i] - origin_lat;
+            double dlon = longitudes[i] - origin_lon;
+            east[i] = static_cast<float>(dlon * (k_lon + k_conv * dlat));
+            north[i] = static_cast<float>(dlat * k_lat);
+        }
+    }
+
+    SiteProjectionRegistry::SiteProjectionRegistry(double default_radius_meters)
+        : default_radius_meters_(default_radius_meters),
+          // Tile side of radius * sqrt(2) puts the corners on the radius
+          tile_degrees_(default_radius_meters * std::sqrt(2.0) / (EARTH_RADIUS_METERS * DEG_TO_RAD))
+    {
+    }
+
+    uint32_t SiteProjectionRegistry::addSite(const std::string &name, double latitude, double longitude,
+                                             double radius_meters)
+    {
+        sites_.push_back(Site{name, LocalProjection(latitude, longitude), radius_meters});
+        registered_.push_back(static_cast<uint32_t>(sites_.size() - 1));
+
+        // Anything sharing ground with the new site must check it near every fix
+        for (uint32_t index = 0; index + 1 < sites_.size(); ++index)
+        {
+            if (overlaps(sites_[index], sites_.back()))
+            {
+                sites_[index].overlapped = true;
+                sites_.back().overlapped = sites_.back().overlapped || !sites_[index].tile;
+            }
+        }
+
+        return static_cast<uint32_t>(sites_.size() - 1);
+    }
+
+    std::optional<uint32_t> SiteProjectionRegistry::findSite(double latitude, double longitude) const
+    {
+        // Overlapping registered sites resolve to the nearest origin
+        std::optional<uint32_t> best;
+        double best_distance_sq = 0.0;
+        for (uint32_t index : registered_)
+        {
+            const Site &site = sites_[index];
+            LocalPoint point = site.projection.project(latitude, longitude);
+            double distance_sq = static_cast<double>(point.east) * point.east +
+                                 static_cast<double>(point.north) * point.north;
+            if (distance_sq <= site.radius_meters * site.radius_meters &&
+                (!best || distance_sq < best_distance_sq))
+            {
+                best = index;
+                best_distance_sq = distance_sq;
+            }
+        }
+
+        if (best)
+        {
+            return best;
+        }
+
+        int64_t row = tileRow(latitude);
+        auto tile = tiles_.find(tileKey(row, tileColumn(row, longitude)));
+        if (tile != tiles_.end())
+        {
+            return tile->second;
+        }
+
+        return std::nullopt;
+    }
+
+    LocalFix SiteProjectionRegistry::project(const Position &position)
+    {
+        auto site = findSite(position.getLatitude(), position.getLongitude());
+        if (!site)
+        {
+            int64_t row = tileRow(position.getLatitude());
+            int64_t column = tileColumn(row, position.getLongitude());
+            Site tile = makeTile(row, column);
+            for (uint32_t index : registered_)
+            {
+                tile.overlapped = tile.overlapped || overlaps(tile, sites_[index]);
+            }
+            sites_.push_back(std::move(tile));
+            site = static_cast<uint32_t>(sites_.size() - 1);
+            tiles_.emplace(tileKey(row, column), *site);
+        }
+
+        LocalFix fix;
+        fix.site = *site;
+        fix.point = sites_[*site].projection.project(position);
+        return fix;
+    }
+
+    std::vector<uint32_t> SiteProjectionRegistry::sitesNear(double latitude, double longitude,
+                                                            double meters) const
+    {
+        std::vector<uint32_t> result;
+        for (uint32_t index : registered_)
+        {
+            if (edgeDistance(sites_[index], latitude, longitude) <= meters)
+            {
+                result.push_back(index);
+            }
+        }
+
+        int64_t row = tileRow(latitude);
+        int64_t column = tileColumn(row, longitude);
+        auto own = tiles_.find(tileKey(row, column));
+        if (own != tiles_.end())
+        {
+            result.push_back(own->second);
+
+            // Well inside its own tile, no other tile can be close
+            if (edgeDistance(sites_[own->second], latitude, longitude) < -meters)
+            {
+                return result;
+            }
+        }
+
+        int64_t rows = tileRow(90.0) + 1;
+        for (int64_t r = row - 1; r <= row + 1; ++r)
+        {
+            if (r < 0 || r >= rows)
+            {
+                continue;
+            }
+
+            // Column widths differ between rows, so look up the point's column in each
+            int64_t columns = tileColumns(r);
+            int64_t centre = tileColumn(r, longitude);
+            for (int64_t c = centre - 1; c <= centre + 1; ++c)
+            {
+                int64_t wrapped = (c % columns + columns) % columns;
+                auto tile = tiles_.find(tileKey(r, wrapped));
+                if (tile == tiles_.end() ||
+                    std::find(result.begin(), result.end(), tile->second) != result.end())
+                {
+                    continue;
+                }
+
+                if (edgeDistance(sites_[tile->second], latitude, longitude) <= meters)
+                {
+                    result.push_back(tile->second);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    bool SiteProjectionRegistry::nearEdge(const LocalFix &fix, double meters) const
+    {
+        const Site &site = sites_.at(fix.site);
+        if (!site.tile)
+        {
+            // Fixes outside every registered site go to tiles, so only the rim
+            // and overlaps with other registered sites can be close to them
+            double inner = site.radius_meters - meters;
+            return site.overlapped || inner <= 0.0 ||
+                   static_cast<double>(fix.point.east) * fix.point.east +
+                           static_cast<double>(fix.point.north) * fix.point.north >
+                       inner * inner;
+        }
+
+        return site.overlapped ||
+               std::abs(fix.point.east) > site.inner_east - meters ||
+               std::abs(fix.point.north) > site.inner_north - meters;
+    }
+
+    int64_t SiteProjectionRegistry::tileRow(double latitude) const
+    {
+        auto rows = static_cast<int64_t>(std::ceil(180.0 / tile_degrees_));
+        auto row = static_cast<int64_t>(std::floor((latitude + 90.0) / tile_degrees_));
+        return std::clamp<int64_t>(row, 0, rows - 1);
+    }
+
+    int64_t SiteProjectionRegistry::tileColumns(int64_t row) const
+    {
+        // Whole columns per row keep every tile close to square and avoid a
+        // sliver at the antimeridian
+        double centre = std::min(90.0, -90.0 + (static_cast<double>(row) + 0.5) * tile_degrees_);
+        auto columns = static_cast<int64_t>(std::floor(360.0 * std::cos(centre * DEG_TO_RAD) / tile_degrees_));
+        return std::max<int64_t>(columns, 1);
+    }
+
+    int64_t SiteProjectionRegistry::tileColumn(int64_t row, double longitude) const
+    {
+        int64_t columns = tileColumns(row);
+        auto column = static_cast<int64_t>(std::floor((longitude + 180.0) * static_cast<double>(columns) / 360.0));
+        return std::clamp<int64_t>(column, 0, columns - 1);
+    }
+
+    uint64_t SiteProjectionRegistry::tileKey(int64_t row, int64_t column)
+    {
+        return (static_cast<uint64_t>(row) << 32) | static_cast<uint32_t>(column);
+    }
+
+    SiteProjectionRegistry::Site SiteProjectionRegistry::makeTile(int64_t row, int64_t column) const
+    {
+        double width = 360.0 / static_cast<double>(tileColumns(row));
+        double south = -90.0 + static_cast<double>(row) * tile_degrees_;
+        double north = std::min(90.0, south + tile_degrees_);
+        double west = -180.0 + static_cast<double>(column) * width;
+        double east = west + width;
+
+        Site site{"tile-" + std::to_string(row) + "-" + std::to_string(column),
+                  LocalProjection((south + north) / 2.0, (west + east) / 2.0),
+                  default_radius_meters_};
+        site.tile = true;
+        site.south = south;
+        site.north = north;
+        site.west = west;
+        site.east = east;
+
+        // East-west extent is narrowest on the poleward edge
+        double poleward = std::abs(south) > std::abs(north) ? south : north;
+        site.inner_east = std::min(std::abs(site.projection.project(poleward, west).east),
+                                   std::abs(site.projection.project(poleward, east).east));
+        site.inner_north = std::min(std::abs(site.projection.project(south, site.projection.getOriginLongitude()).north),
+                                    std::abs(site.projection.project(north, site.projection.getOriginLongitude()).north));
+        return site;
+    }
+
+    bool SiteProjectionRegistry::overlaps(const Site &a, const Site &b)
+    {
+        // Conservative: bounding circles, with slack for a tile's corners
+        auto bound = [](const Site &site)
+        {
+            return site.tile ? site.radius_meters * 1.1 : site.radius_meters;
+        };
+        LocalPoint centre = a.projection.project(b.projection.getOriginLatitude(),
+                                                 b.projection.getOriginLongitude());
+        return std::hypot(static_cast<double>(centre.east), static_cast<double>(centre.north)) <=
+               bound(a) + bound(b);
+    }
+
+    double SiteProjectionRegistry::edgeDistance(const Site &site, double latitude, double longitude)
+    {
+        // Signed: negative inside the site, by the distance to its nearest edge
+        LocalPoint point = site.projection.project(latitude, longitude);
+        if (!site.tile)
+        {
+            return std::hypot(static_cast<double>(point.east), static_cast<double>(point.north)) -
+                   site.radius_meters;
+        }
+
+        // Edges measured through the point, in the tile's own plane
+        double west = site.projection.project(latitude, site.west).east;
+        double east = site.projection.project(latitude, site.east).east;
+        double south = site.projection.project(site.south, longitude).north;
+        double north = site.projection.project(site.north, longitude).north;
+        double dx = std::max(west - point.east, point.east - east);
+        double dy = std::max(south - point.north, point.north - north);
+        if (dx <= 0.0 && dy <= 0.0)
+        {
+            return std::max(dx, dy);
+        }
+        return std::hypot(std::max(dx, 0.0), std::max(dy, 0.0));
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,522 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include "equipment_tracker/map_matcher.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+        // Projection centred on the graph's bounding box
+        LocalProjection centreOf(const RoadGraph &graph)
+        {
+            const auto &nodes = graph.getNodes();
+            if (nodes.empty())
+            {
+                return LocalProjection(0.0, 0.0);
+            }
+            auto [south, north] = std::minmax_element(nodes.begin(), nodes.end(),
+                                                      [](const RoadGraph::Node &a, const RoadGraph::Node &b)
+                                                      {
+                                                          return a.latitude < b.latitude;
+                                                      });
+            auto [west, east] = std::minmax_element(nodes.begin(), nodes.end(),
+                                                    [](const RoadGraph::Node &a, const RoadGraph::Node &b)
+                                                    {
+                                                        return a.longitude < b.longitude;
+                                                    });
+            return LocalProjection((south->latitude + north->latitude) / 2.0,
+                                   (west->longitude + east->longitude) / 2.0);
+        }
+
+        // Closest point to p on the segment from a to b, and its distance from a
+        LocalPoint closestOnSegment(const LocalPoint &a, const LocalPoint &b, const LocalPoint &p, float &along)
+        {
+            float de = b.east - a.east;
+            float dn = b.north - a.north;
+            float length_squared = de * de + dn * dn;
+            float t = length_squared > 0.0f
+                          ? std::clamp(((p.east - a.east) * de + (p.north - a.north) * dn) / length_squared, 0.0f, 1.0f)
+                          : 0.0f;
+            along = t * std::sqrt(length_squared);
+            return LocalPoint{a.east + t * de, a.north + t * dn};
+        }
+    } // namespace
+
+    uint32_t RoadGraph::addNode(double latitude, double longitude)
+    {
+        nodes_.push_back(Node{latitude, longitude});
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    bool RoadGraph::addEdge(uint32_t from, uint32_t to)
+    {
+        if (from >= nodes_.size() || to >= nodes_.size() || from == to)
+        {
+            return false;
+        }
+        edges_.push_back(Edge{from, to});
+        return true;
+    }
+
+    std::optional<RoadGraph> RoadGraph::parse(std::istream &in)
+    {
+        RoadGraph graph;
+        std::unordered_map<std::string, uint32_t> names;
+        std::string line;
+        size_t line_number = 0;
+
+        while (std::getline(in, line))
+        {
+            ++line_number;
+            std::istringstream fields(line);
+            std::string kind;
+            if (!(fields >> kind) || kind[0] == '#')
+            {
+                continue;
+            }
+
+            bool valid = false;
+            if (kind == "node")
+            {
+                std::string name;
+                double latitude = 0.0;
+                double longitude = 0.0;
+                valid = fields >> name >> latitude >> longitude && std::abs(latitude) <= 90.0 &&
+                        std::abs(longitude) <= 180.0 && names.emplace(name, graph.nodes_.size()).second;
+                if (valid)
+                {
+                    graph.addNode(latitude, longitude);
+                }
+            }
+            else if (kind == "edge")
+            {
+                std::string from;
+                std::string to;
+                if (fields >> from >> to)
+                {
+                    auto first = names.find(from);
+                    auto second = names.find(to);
+                    valid = first != names.end() && second != names.end() &&
+                            graph.addEdge(first->second, second->second);
+                }
+            }
+
+            std::string extra;
+            if (!valid || fields >> extra)
+            {
+                std::cerr << "Road graph line " << line_number << " is malformed: " << line << std::endl;
+                return std::nullopt;
+            }
+        }
+        return graph;
+    }
+
+    std::optional<RoadGraph> RoadGraph::load(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cerr << "Failed to open road graph: " << path << std::endl;
+            return std::nullopt;
+        }
+        return parse(file);
+    }
+
+    MapMatcher::MapMatcher(const RoadGraph &graph)
+        : projection_(centreOf(graph)), edges_(graph.getEdges())
+    {
+        // Project every node in one pass over structure-of-arrays coordinates
+        const auto &nodes = graph.getNodes();
+        std::vector<double> latitudes(nodes.size());
+        std::vector<double> longitudes(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            latitudes[i] = nodes[i].latitude;
+            longitudes[i] = nodes[i].longitude;
+        }
+        std::vector<float> east(nodes.size());
+        std::vector<float> north(nodes.size());
+        projection_.projectBatch(latitudes.data(), longitudes.data(), nodes.size(), east.data(), north.data());
+
+        points_.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            points_[i].east = east[i];
+            points_[i].north = north[i];
+        }
+
+        // Both directions of every edge, grouped by node
+        adjacency_offsets_.assign(points_.size() + 1, 0);
+        for (const auto &edge : edges_)
+        {
+            lengths_.push_back(points_[edge.from].distanceTo(points_[edge.to]));
+            ++adjacency_offsets_[edge.from + 1];
+            ++adjacency_offsets_[edge.to + 1];
+        }
+        for (size_t i = 1; i < adjacency_offsets_.size(); ++i)
+        {
+            adjacency_offsets_[i] += adjacency_offsets_[i - 1];
+        }
+        adjacency_.resize(adjacency_offsets_.back());
+        std::vector<uint32_t> cursor(adjacency_offsets_.begin(), adjacency_offsets_.end() - 1);
+        for (uint32_t i = 0; i < edges_.size(); ++i)
+        {
+            adjacency_[cursor[edges_[i].from]++] = {edges_[i].to, i};
+            adjacency_[cursor[edges_[i].to]++] = {edges_[i].from, i};
+        }
+
+        node_distances_.assign(points_.size(), UNREACHABLE);
+        edge_stamps_.assign(edges_.size(), 0);
+        buildIndex();
+    }
+
+    std::optional<MatchedPosition> MapMatcher::match(const EquipmentId &id, const Position &position)
+    {
+        LocalPoint fix = projection_.project(position);
+        Timestamp now = position.getTimestamp();
+        auto sigma = static_cast<float>(std::max(position.getAccuracy(), MAP_MATCH_MIN_SIGMA_METERS));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto [it, inserted] = tracks_.try_emplace(id);
+        Track &track = it->second;
+        if (!inserted && now <= track.last_time)
+        {
+            return std::nullopt;
+        }
+        bool restart = track.candidates.empty() ||
+                       std::chrono::duration<double>(now - track.last_time).count() > MAP_MATCH_MAX_GAP_SECONDS;
+        track.last_time = now;
+
+        // Too close to the last fix to tell the direction of travel
+        float straight = fix.distanceTo(track.anchor);
+        if (!restart && straight < 2.0f * sigma)
+        {
+            track.current->route_meters = 0.0;
+            track.current->timestamp = now;
+            return track.current;
+        }
+
+        auto candidates = findCandidates(fix, static_cast<float>(MAP_MATCH_SEARCH_METERS), sigma,
+                                         MAP_MATCH_MAX_CANDIDATES);
+        if (candidates.empty())
+        {
+            track.candidates.clear();
+            return std::nullopt;
+        }
+
+        if (!restart)
+        {
+            // One Viterbi step: the best previous candidate for each new one
+            std::vector<double> best(candidates.size(), -std::numeric_limits<double>::infinity());
+            std::vector<double> routes(candidates.size(), 0.0);
+            std::vector<double> distances(candidates.size(), 0.0);
+            float limit = 2.0f * straight + 2.0f * static_cast<float>(MAP_MATCH_SEARCH_METERS);
+            for (const auto &previous : track.candidates)
+            {
+                searchRoutes(previous, limit);
+                for (size_t j = 0; j < candidates.size(); ++j)
+                {
+                    double route = routeTo(previous, candidates[j]);
+                    if (std::isinf(route))
+                    {
+                        continue;
+                    }
+                    double score = previous.score - std::abs(route - straight) / MAP_MATCH_BETA_METERS;
+                    if (score > best[j])
+                    {
+                        best[j] = score;
+                        routes[j] = route;
+                        distances[j] = previous.distance + route;
+                    }
+                }
+            }
+
+            // No road path from any previous candidate: start over from this fix
+            restart = std::all_of(best.begin(), best.end(), [](double score)
+                                  { return std::isinf(score); });
+            if (!restart)
+            {
+                for (size_t j = 0; j < candidates.size(); ++j)
+                {
+                    candidates[j].score += best[j];
+                    candidates[j].route = routes[j];
+                    candidates[j].distance = distances[j];
+                }
+                candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                                [](const Candidate &candidate)
+                                                {
+                                                    return std::isinf(candidate.score);
+                                                }),
+                                 candidates.end());
+            }
+        }
+
+        if (restart && track.current)
+        {
+            track.restart_route = track.current->total_route_meters;
+        }
+
+        // Keep scores near zero so long tracks do not underflow
+        auto best = std::max_element(candidates.begin(), candidates.end(),
+                                     [](const Candidate &a, const Candidate &b)
+                                     {
+                                         return a.score < b.score;
+                                     });
+        double top = best->score;
+        for (auto &candidate : candidates)
+        {
+            candidate.score -= top;
+        }
+
+        track.anchor = fix;
+        MatchedPosition matched = report(track, *best, now);
+        track.candidates = std::move(candidates);
+        return matched;
+    }
+
+    std::optional<MatchedPosition> MapMatcher::getMatch(const EquipmentId &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tracks_.find(id);
+        if (it == tracks_.end())
+        {
+            return std::nullopt;
+        }
+        return it->second.current;
+    }
+
+    void MapMatcher::remove(const EquipmentId &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tracks_.erase(id);
+    }
+
+    size_t MapMatcher::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tracks_.size();
+    }
+
+    std::vector<uint32_t> MapMatcher::edgesNear(double latitude, double longitude, double radius_meters) const
+    {
+        LocalPoint point = projection_.project(latitude, longitude);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<uint32_t> edges;
+        for (const auto &candidate : findCandidates(point, static_cast<float>(radius_meters), 1.0f, edges_.size()))
+        {
+            edges.push_back(candidate.edge);
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    }
+
+    void MapMatcher::buildIndex()
+    {
+        cell_offsets_.assign(1, 0);
+        if (points_.empty())
+        {
+            return;
+        }
+
+        // Pad by the search radius so fixes just off the outermost roads still hit the grid
+        auto pad = static_cast<float>(MAP_MATCH_SEARCH_METERS);
+        LocalPoint low{points_[0].east, points_[0].north};
+        LocalPoint high = low;
+        for (const auto &point : points_)
+        {
+            low = LocalPoint{std::min(low.east, point.east), std::min(low.north, point.north)};
+            high = LocalPoint{std::max(high.east, point.east), std::max(high.north, point.north)};
+        }
+        grid_origin_ = LocalPoint{low.east - pad, low.north - pad};
+        float width = high.east - low.east + 2.0f * pad;
+        float height = high.north - low.north + 2.0f * pad;
+        auto cellsFor = [&](float cell)
+        {
+            return static_cast<double>(std::ceil(width / cell)) * std::ceil(height / cell);
+        };
+        while (cellsFor(cell_meters_) > MAP_MATCH_MAX_CELLS)
+        {
+            cell_meters_ *= 2.0f;
+        }
+        grid_columns_ = std::max(1u, static_cast<uint32_t>(std::ceil(width / cell_meters_)));
+        grid_rows_ = std::max(1u, static_cast<uint32_t>(std::ceil(height / cell_meters_)));
+
+        // Each edge goes in every cell its bounding box touches: count, then fill
+        auto forEachCell = [&](const RoadGraph::Edge &edge, const std::function<void(uint32_t)> &visit)
+        {
+            const LocalPoint &a = points_[edge.from];
+            const LocalPoint &b = points_[edge.to];
+            auto first_column = static_cast<uint32_t>((std::min(a.east, b.east) - grid_origin_.east) / cell_meters_);
+            auto last_column = static_cast<uint32_t>((std::max(a.east, b.east) - grid_origin_.east) / cell_meters_);
+            auto first_row = static_cast<uint32_t>((std::min(a.north, b.north) - grid_origin_.north) / cell_meters_);
+            auto last_row = static_cast<uint32_t>((std::max(a.north, b.north) - grid_origin_.north) / cell_meters_);
+            for (uint32_t row = first_row; row <= std::min(last_row, grid_rows_ - 1); ++row)
+            {
+                for (uint32_t column = first_column; column <= std::min(last_column, grid_columns_ - 1); ++column)
+                {
+                    visit(row * grid_columns_ + column);
+                }
+            }
+        };
+
+        cell_offsets_.assign(static_cast<size_t>(grid_columns_) * grid_rows_ + 1, 0);
+        for (const auto &edge : edges_)
+        {
+            forEachCell(edge, [&](uint32_t cell)
+                        { ++cell_offsets_[cell + 1]; });
+        }
+        for (size_t i = 1; i < cell_offsets_.size(); ++i)
+        {
+            cell_offsets_[i] += cell_offsets_[i - 1];
+        }
+        cell_edges_.resize(cell_offsets_.back());
+        std::vector<uint32_t> cursor(cell_offsets_.begin(), cell_offsets_.end() - 1);
+        for (uint32_t i = 0; i < edges_.size(); ++i)
+        {
+            forEachCell(edges_[i], [&](uint32_t cell)
+                        { cell_edges_[cursor[cell]++] = i; });
+        }
+    }
+
+    std::vector<MapMatcher::Candidate> MapMatcher::findCandidates(const LocalPoint &fix, float radius, float sigma,
+                                                              size_t limit) const
+    {
+        std::vector<Candidate> candidates;
+        if (cell_edges_.empty())
+        {
+            return candidates;
+        }
+
+        auto first_column = static_cast<int64_t>(std::floor((fix.east - radius - grid_origin_.east) / cell_meters_));
+        auto last_column = static_cast<int64_t>(std::floor((fix.east + radius - grid_origin_.east) / cell_meters_));
+        auto first_row = static_cast<int64_t>(std::floor((fix.north - radius - grid_origin_.north) / cell_meters_));
+        auto last_row = static_cast<int64_t>(std::floor((fix.north + radius - grid_origin_.north) / cell_meters_));
+        first_column = std::max<int64_t>(first_column, 0);
+        first_row = std::max<int64_t>(first_row, 0);
+        last_column = std::min<int64_t>(last_column, grid_columns_ - 1);
+        last_row = std::min<int64_t>(last_row, grid_rows_ - 1);
+
+        // An edge spanning several cells is tested once
+        if (++stamp_ == 0)
+        {
+            std::fill(edge_stamps_.begin(), edge_stamps_.end(), 0);
+            stamp_ = 1;
+        }
+        for (int64_t row = first_row; row <= last_row; ++row)
+        {
+            for (int64_t column = first_column; column <= last_column; ++column)
+            {
+                auto cell = static_cast<size_t>(row * grid_columns_ + column);
+                for (uint32_t k = cell_offsets_[cell]; k < cell_offsets_[cell + 1]; ++k)
+                {
+                    uint32_t edge = cell_edges_[k];
+                    if (edge_stamps_[edge] == stamp_)
+                    {
+                        continue;
+                    }
+                    edge_stamps_[edge] = stamp_;
+
+                    float along = 0.0f;
+                    LocalPoint point = closestOnSegment(points_[edges_[edge].from], points_[edges_[edge].to], fix, along);
+                    float error = point.distanceTo(fix);
+                    if (error <= radius)
+                    {
+                        double z = error / sigma;
+                        candidates.push_back(Candidate{edge, along, point, error, -0.5 * z * z, 0.0, 0.0});
+                    }
+                }
+            }
+        }
+
+        if (candidates.size() > limit)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + limit, candidates.end(),
+                             [](const Candidate &a, const Candidate &b)
+                             {
+                                 return a.error < b.error;
+                             });
+            candidates.resize(limit);
+        }
+        return candidates;
+    }
+
+    void MapMatcher::searchRoutes(const Candidate &from, float limit)
+    {
+        // Dijkstra from both ends of the candidate's edge, no further than the limit
+        for (uint32_t node : touched_nodes_)
+        {
+            node_distances_[node] = UNREACHABLE;
+        }
+        touched_nodes_.clear();
+        heap_.clear();
+
+        auto relax = [&](uint32_t node, float distance)
+        {
+            if (distance > limit || distance >= node_distances_[node])
+            {
+                return;
+            }
+            if (node_distances_[node] == UNREACHABLE)
+            {
+                touched_nodes_.push_back(node);
+            }
+            node_distances_[node] = distance;
+            heap_.emplace_back(distance, node);
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+        };
+
+        const RoadGraph::Edge &edge = edges_[from.edge];
+        relax(edge.from, from.offset);
+        relax(edge.to, lengths_[from.edge] - from.offset);
+        while (!heap_.empty())
+        {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+            auto [distance, node] = heap_.back();
+            heap_.pop_back();
+            if (distance > node_distances_[node])
+            {
+                continue;
+            }
+            for (uint32_t k = adjacency_offsets_[node]; k < adjacency_offsets_[node + 1]; ++k)
+            {
+                relax(adjacency_[k].first, distance + lengths_[adjacency_[k].second]);
+            }
+        }
+    }
+
+    double MapMatcher::routeTo(const Candidate &from, const Candidate &to) const
+    {
+        if (from.edge == to.edge)
+        {
+            return std::abs(to.offset - from.offset);
+        }
+        const RoadGraph::Edge &edge = edges_[to.edge];
+        return std::min(node_distances_[edge.from] + to.offset,
+                        node_distances_[edge.to] + (lengths_[to.edge] - to.offset));
+    }
+
+    MatchedPosition MapMatcher::report(Track &track, const Candidate &best, const Timestamp &at) const
+    {
+        MatchedPosition matched;
+        matched.edge = best.edge;
+        matched.offset_meters = best.offset;
+        projection_.unproject(best.point, matched.latitude, matched.longitude);
+        matched.error_meters = best.error;
+        matched.route_meters = best.route;
+        matched.total_route_meters = track.restart_route + best.distance;
+        matched.timestamp = at;
+        track.current = matched;
+        return matched;
+    }
+
+} // namespace equipment_tracker
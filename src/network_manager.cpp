@@ -5,7 +5,9 @@
 #include <sstream>
 #include <ctime>
 #include <random>
+#include <cstdio>
 #include "equipment_tracker/network_manager.h"
+#include "equipment_tracker/utils/crc32c.h"
 
 namespace equipment_tracker
 {
@@ -193,27 +195,7 @@ namespace equipment_tracker
             const auto &id = update.first;
             const auto &position = update.second;
 
-            // Create JSON-like payload (in a real implementation, would use a JSON library)
-            std::stringstream ss;
-            auto time_t = std::chrono::system_clock::to_time_t(position.getTimestamp());
-            std::tm tm;
-#ifdef _WIN32
-            gmtime_s(&tm, &time_t);
-#else
-            // For non-Windows platforms
-            gmtime_r(&time_t, &tm);
-#endif
-
-            ss << "{"
-               << "\"id\":\"" << id << "\","
-               << "\"latitude\":" << position.getLatitude() << ","
-               << "\"longitude\":" << position.getLongitude() << ","
-               << "\"altitude\":" << position.getAltitude() << ","
-               << "\"accuracy\":" << position.getAccuracy() << ","
-               << "\"timestamp\":\"" << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ") << "\""
-               << "}";
-
-            std::string payload = ss.str();
+            std::string payload = formatPositionPayload(id, position);
 
             // Send to server (in a real implementation, would use HTTP or another protocol)
             std::cout << "Sending position update to server: " << payload << std::endl;
@@ -225,6 +207,58 @@ namespace equipment_tracker
         return true;
     }
 
+    std::string NetworkManager::formatPositionPayload(const EquipmentId &id, const Position &position)
+    {
+        // Create JSON-like payload (in a real implementation, would use a JSON library)
+        std::stringstream ss;
+        auto time_t = std::chrono::system_clock::to_time_t(position.getTimestamp());
+        std::tm tm;
+#ifdef _WIN32
+        gmtime_s(&tm, &time_t);
+#else
+        // For non-Windows platforms
+        gmtime_r(&time_t, &tm);
+#endif
+
+        ss << "{"
+           << "\"id\":\"" << id << "\","
+           << "\"latitude\":" << position.getLatitude() << ","
+           << "\"longitude\":" << position.getLongitude() << ","
+           << "\"altitude\":" << position.getAltitude() << ","
+           << "\"accuracy\":" << position.getAccuracy() << ","
+           << "\"timestamp\":\"" << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ") << "\""
+           << "}";
+
+        // The receiver drops the checksum field and recomputes over the rest
+        std::string body = ss.str();
+        char checksum[24];
+        std::snprintf(checksum, sizeof(checksum), ",\"crc32c\":\"%08x\"}",
+                      static_cast<unsigned int>(crc32c(body.data(), body.size())));
+
+        body.pop_back();
+        return body + checksum;
+    }
+
+    bool NetworkManager::verifyPayloadChecksum(const std::string &payload)
+    {
+        const std::string field = ",\"crc32c\":\"";
+        size_t pos = payload.rfind(field);
+        if (pos == std::string::npos || payload.size() != pos + field.size() + 10 ||
+            payload.compare(payload.size() - 2, 2, "\"}") != 0)
+        {
+            return false;
+        }
+
+        std::string digits = payload.substr(pos + field.size(), 8);
+        if (digits.find_first_not_of("0123456789abcdef") != std::string::npos)
+        {
+            return false;
+        }
+
+        std::string body = payload.substr(0, pos) + "}";
+        return crc32c(body.data(), body.size()) == std::stoul(digits, nullptr, 16);
+    }
+
     bool NetworkManager::sendRequest(const std::string &endpoint, const std::string &data)
     {
         if (!is_connected_)
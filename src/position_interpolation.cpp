@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "equipment_tracker/position_interpolation.h"
+
+// Define M_PI if not available
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr double DEG_TO_RAD = M_PI / 180.0;
+        constexpr double RAD_TO_DEG = 180.0 / M_PI;
+
+        // Below this angular separation (radians) slerp degenerates; fall back to linear
+        constexpr double MIN_SLERP_ANGLE = 1e-12;
+
+        double lerp(double a, double b, double t)
+        {
+            return a + (b - a) * t;
+        }
+
+        // Interpolate longitudes along the shorter arc so that fixes on either
+        // side of the antimeridian do not sweep across the whole globe
+        double lerpLongitude(double lon1, double lon2, double t)
+        {
+            double delta = lon2 - lon1;
+            if (delta > 180.0)
+            {
+                delta -= 360.0;
+            }
+            else if (delta < -180.0)
+            {
+                delta += 360.0;
+            }
+
+            double lon = lon1 + delta * t;
+            if (lon > 180.0)
+            {
+                lon -= 360.0;
+            }
+            else if (lon < -180.0)
+            {
+                lon += 360.0;
+            }
+            return lon;
+        }
+
+        void slerpLatLon(double lat1, double lon1, double lat2, double lon2, double t,
+                         double &lat_out, double &lon_out)
+        {
+            double phi1 = lat1 * DEG_TO_RAD;
+            double phi2 = lat2 * DEG_TO_RAD;
+            double lambda1 = lon1 * DEG_TO_RAD;
+            double lambda2 = lon2 * DEG_TO_RAD;
+
+            // Unit vectors on the sphere
+            double x1 = std::cos(phi1) * std::cos(lambda1);
+            double y1 = std::cos(phi1) * std::sin(lambda1);
+            double z1 = std::sin(phi1);
+            double x2 = std::cos(phi2) * std::cos(lambda2);
+            double y2 = std::cos(phi2) * std::sin(lambda2);
+            double z2 = std::sin(phi2);
+
+            double dot = std::clamp(x1 * x2 + y1 * y2 + z1 * z2, -1.0, 1.0);
+            double omega = std::acos(dot);
+            double sin_omega = std::sin(omega);
+
+            if (omega < MIN_SLERP_ANGLE || sin_omega < MIN_SLERP_ANGLE)
+            {
+                lat_out = lerp(lat1, lat2, t);
+                lon_out = lerpLongitude(lon1, lon2, t);
+                return;
+            }
+
+            double a = std::sin((1.0 - t) * omega) / sin_omega;
+            double b = std::sin(t * omega) / sin_omega;
+
+            double x = a * x1 + b * x2;
+            double y = a * y1 + b * y2;
+            double z = a * z1 + b * z2;
+
+            lat_out = std::atan2(z, std::sqrt(x * x + y * y)) * RAD_TO_DEG;
+            lon_out = std::atan2(y, x) * RAD_TO_DEG;
+        }
+    } // namespace
+
+    Position interpolatePosition(const Position &before, const Position &after,
+                                 const Timestamp &at, InterpolationMethod method)
+    {
+        auto span = after.getTimestamp() - before.getTimestamp();
+        double t = 0.0;
+        if (span.count() > 0)
+        {
+            auto offset = at - before.getTimestamp();
+            t = std::clamp(static_cast<double>(offset.count()) / static_cast<double>(span.count()),
+                           0.0, 1.0);
+        }
+
+        double latitude = 0.0;
+        double longitude = 0.0;
+
+        if (method == InterpolationMethod::GreatCircle)
+        {
+            slerpLatLon(before.getLatitude(), before.getLongitude(),
+                        after.getLatitude(), after.getLongitude(), t,
+                        latitude, longitude);
+        }
+        else
+        {
+            latitude = lerp(before.getLatitude(), after.getLatitude(), t);
+            longitude = lerpLongitude(before.getLongitude(), after.getLongitude(), t);
+        }
+
+        // Altitude follows the fixes linearly; the estimate is never more
+        // accurate than the worse of the two bracketing fixes
+        return Position(latitude, longitude,
+                        lerp(before.getAltitude(), after.getAltitude(), t),
+                        std::max(before.getAccuracy(), after.getAccuracy()),
+                        at);
+    }
+
+    std::optional<Position> interpolateHistory(const std::vector<Position> &history,
+                                               const Timestamp &at,
+                                               InterpolationMethod method)
+    {
+        if (history.empty() ||
+            at < history.front().getTimestamp() ||
+            at > history.back().getTimestamp())
+        {
+            return std::nullopt;
+        }
+
+        // First fix strictly after the requested instant
+        auto after = std::upper_bound(
+            history.begin(), history.end(), at,
+            [](const Timestamp &value, const Position &position)
+            {
+                return value < position.getTimestamp();
+            });
+
+        if (after == history.begin())
+        {
+            return std::nullopt;
+        }
+
+        auto before = std::prev(after);
+        if (after == history.end() || before->getTimestamp() == at)
+        {
+            Position exact = *before;
+            exact.setTimestamp(at);
+            return exact;
+        }
+
+        return interpolatePosition(*before, *after, at, method);
+    }
+
+} // namespace equipment_tracker
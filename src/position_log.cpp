@@ -0,0 +1,1588 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include "equipment_tracker/position_log.h"
+#include "equipment_tracker/utils/crc32c.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        // Source of PositionLog::getGeneration()
+        std::atomic<uint64_t> next_generation{1};
+
+        constexpr size_t RECORD_KIND_OFFSET = 40;
+        constexpr size_t RECORD_CRC_OFFSET = 44;
+        constexpr char SEGMENT_MAGIC[8] = {'E', 'T', 'P', 'O', 'S', 'L', 'O', 'G'};
+        constexpr uint32_t SEGMENT_FORMAT_VERSION = 2;
+        constexpr char ARCHIVE_MAGIC[8] = {'E', 'T', 'P', 'O', 'S', 'A', 'R', 'C'};
+        constexpr uint32_t ARCHIVE_FORMAT_VERSION = 1;
+        constexpr size_t ARCHIVE_HEADER_SIZE = 48;
+
+        // Footer payload: fix count, CRC-32C, then the earliest and latest fix
+        constexpr size_t FOOTER_FIRST_OFFSET = 16;
+        constexpr size_t FOOTER_LAST_OFFSET = 24;
+
+        bool isZeroRecord(const char *record, size_t size = POSITION_RECORD_SIZE)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (record[i] != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::string segmentFilename(uint64_t index)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "segment-%08llu.log", static_cast<unsigned long long>(index));
+            return name;
+        }
+
+        std::string archiveFilename(uint64_t index)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "archive-%08llu.arc", static_cast<unsigned long long>(index));
+            return name;
+        }
+
+        std::optional<uint64_t> parseIndexedFilename(const std::string &name, const std::string &prefix,
+                                                     const std::string &suffix)
+        {
+            if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                return std::nullopt;
+            }
+
+            std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            if (!std::all_of(digits.begin(), digits.end(), ::isdigit))
+            {
+                return std::nullopt;
+            }
+            return std::stoull(digits);
+        }
+
+        std::optional<uint64_t> parseSegmentFilename(const std::string &name)
+        {
+            if (name == POSITION_LOG_FILENAME)
+            {
+                return 0;
+            }
+            return parseIndexedFilename(name, "segment-", ".log");
+        }
+
+        int openFile(const std::filesystem::path &path, bool create, bool direct)
+        {
+#ifdef _WIN32
+            (void)direct;
+            int flags = _O_RDWR | _O_BINARY | (create ? _O_CREAT : 0);
+            return _open(path.string().c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+            int flags = O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0);
+#ifdef O_DIRECT
+            if (direct)
+            {
+                flags |= O_DIRECT;
+            }
+#else
+            (void)direct;
+#endif
+            return ::open(path.c_str(), flags, 0644);
+#endif
+        }
+
+        int openForScan(const std::filesystem::path &path)
+        {
+#ifdef _WIN32
+            return _open(path.string().c_str(), _O_RDONLY | _O_BINARY);
+#else
+            return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+        }
+
+        void closeFile(int fd)
+        {
+#ifdef _WIN32
+            _close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+
+        std::filesystem::path archiveTempPath(const std::filesystem::path &target)
+        {
+            std::filesystem::path temp_path = target;
+            temp_path += ".tmp";
+            return temp_path;
+        }
+
+        // Plain blocking file access for archiving, which runs outside the
+        // log's owner and so cannot share the owner's I/O backend queue
+        bool readWholeFile(const std::filesystem::path &path, std::string &out)
+        {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in)
+            {
+                return false;
+            }
+            out.resize(static_cast<size_t>(in.tellg()));
+            in.seekg(0);
+            return static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(out.size())));
+        }
+
+        bool writeDurably(const std::filesystem::path &path, const std::string &data)
+        {
+            int fd = openFile(path, true, false);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            size_t written = 0;
+            while (written < data.size())
+            {
+#ifdef _WIN32
+                int count = _write(fd, data.data() + written, static_cast<unsigned>(data.size() - written));
+#else
+                ssize_t count = ::write(fd, data.data() + written, data.size() - written);
+#endif
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (count <= 0)
+                {
+                    break;
+                }
+                written += static_cast<size_t>(count);
+            }
+
+#ifdef _WIN32
+            bool ok = written == data.size() && _commit(fd) == 0;
+#else
+            bool ok = written == data.size() && ::fsync(fd) == 0;
+#endif
+            closeFile(fd);
+            return ok;
+        }
+
+        // Reserve blocks without changing the file size, so size still marks the data end
+        void preallocate(int fd, uint64_t length)
+        {
+#ifdef __linux__
+            if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(length)) != 0 &&
+                errno != EOPNOTSUPP)
+            {
+                std::cerr << "PositionLog preallocation failed: " << std::strerror(errno) << std::endl;
+            }
+#else
+            (void)fd;
+            (void)length;
+#endif
+        }
+
+        enum class AccessAdvice
+        {
+            Sequential, // About to be read front to back
+            DontNeed    // Drop cached pages
+        };
+
+        void advise(int fd, AccessAdvice advice)
+        {
+#ifdef __linux__
+            posix_fadvise(fd, 0, 0, advice == AccessAdvice::Sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_DONTNEED);
+#else
+            (void)fd;
+            (void)advice;
+#endif
+        }
+
+        uint64_t roundUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Fill in the kind and checksum of a record whose payload is already set
+        void sealRecord(char *record, PositionRecordKind kind)
+        {
+            uint32_t kind_value = static_cast<uint32_t>(kind);
+            std::memcpy(record + RECORD_KIND_OFFSET, &kind_value, sizeof(kind_value));
+            uint32_t crc = crc32c(record, RECORD_CRC_OFFSET);
+            std::memcpy(record + RECORD_CRC_OFFSET, &crc, sizeof(crc));
+        }
+
+        bool recordIntact(const char *record)
+        {
+            uint32_t stored;
+            std::memcpy(&stored, record + RECORD_CRC_OFFSET, sizeof(stored));
+            return crc32c(record, RECORD_CRC_OFFSET) == stored;
+        }
+
+        PositionRecordKind recordKind(const char *record)
+        {
+            uint32_t kind;
+            std::memcpy(&kind, record + RECORD_KIND_OFFSET, sizeof(kind));
+            return static_cast<PositionRecordKind>(kind);
+        }
+
+        void encodeSegmentHeader(char *out)
+        {
+            std::memset(out, 0, POSITION_RECORD_SIZE);
+            std::memcpy(out, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+            std::memcpy(out + sizeof(SEGMENT_MAGIC), &SEGMENT_FORMAT_VERSION, sizeof(SEGMENT_FORMAT_VERSION));
+            sealRecord(out, PositionRecordKind::SegmentHeader);
+        }
+
+        void encodeSegmentFooter(uint64_t fixes, uint32_t crc, int64_t first_ns, int64_t last_ns, char *out)
+        {
+            std::memset(out, 0, POSITION_RECORD_SIZE);
+            std::memcpy(out, &fixes, sizeof(fixes));
+            std::memcpy(out + sizeof(fixes), &crc, sizeof(crc));
+            std::memcpy(out + FOOTER_FIRST_OFFSET, &first_ns, sizeof(first_ns));
+            std::memcpy(out + FOOTER_LAST_OFFSET, &last_ns, sizeof(last_ns));
+            sealRecord(out, PositionRecordKind::SegmentFooter);
+        }
+
+        // Whether a segment image starts with a header (otherwise it is legacy)
+        bool hasSegmentHeader(const char *data, size_t size)
+        {
+            return size >= POSITION_RECORD_SIZE && recordIntact(data) &&
+                   recordKind(data) == PositionRecordKind::SegmentHeader &&
+                   std::memcmp(data, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0;
+        }
+
+        // Offset of the first all-zero record (or the last whole record boundary)
+        size_t findDataEnd(const char *data, size_t size)
+        {
+            size_t end = 0;
+            while (end + POSITION_RECORD_SIZE <= size && !isZeroRecord(data + end))
+            {
+                end += POSITION_RECORD_SIZE;
+            }
+            return end;
+        }
+
+        int64_t timestampNs(const Timestamp &timestamp)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+        }
+
+        Position decodeFix(const char *record)
+        {
+            int64_t timestamp_ns;
+            double fields[4];
+            std::memcpy(&timestamp_ns, record, sizeof(timestamp_ns));
+            std::memcpy(fields, record + sizeof(timestamp_ns), sizeof(fields));
+
+            Timestamp timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                std::chrono::nanoseconds(timestamp_ns)));
+            return Position(fields[0], fields[1], fields[2], fields[3], timestamp);
+        }
+
+        // Account for one segment image in check, decoding its fixes into out
+        // when given. Without out, a sealed segment whose footer checksum
+        // matches is accepted after a single CRC pass.
+        void scanSegment(const char *data, size_t size, PositionLogCheck &check, std::vector<Position> *out)
+        {
+            ++check.segments;
+            check.bytes += size;
+
+            if (!hasSegmentHeader(data, size))
+            {
+                auto fixes = decodeLegacyPositionRecords(data, size);
+                check.records += fixes.size();
+                if (out)
+                {
+                    out->insert(out->end(), fixes.begin(), fixes.end());
+                }
+                return;
+            }
+
+            size_t end = findDataEnd(data, size);
+            const char *last = data + end - POSITION_RECORD_SIZE;
+            if (end >= 2 * POSITION_RECORD_SIZE && recordIntact(last) &&
+                recordKind(last) == PositionRecordKind::SegmentFooter)
+            {
+                uint64_t fixes;
+                uint32_t expected;
+                std::memcpy(&fixes, last, sizeof(fixes));
+                std::memcpy(&expected, last + sizeof(fixes), sizeof(expected));
+
+                if (crc32c(data, end - POSITION_RECORD_SIZE) == expected)
+                {
+                    if (!out)
+                    {
+                        check.records += fixes;
+                        return;
+                    }
+                }
+                else
+                {
+                    ++check.corrupt_segments;
+                }
+            }
+
+            size_t corrupt = 0;
+            auto fixes = decodePositionRecords(data, end, &corrupt);
+            check.records += fixes.size();
+            check.corrupt_records += corrupt;
+            if (out)
+            {
+                out->insert(out->end(), fixes.begin(), fixes.end());
+            }
+        }
+
+        struct ArchiveHeader
+        {
+            uint32_t crc{0};
+            uint64_t fixes{0};
+            int64_t first_ns{0};
+            int64_t last_ns{0};
+            uint64_t body_size{0};
+        };
+
+        std::string buildArchive(const std::vector<Position> &fixes, int64_t first_ns, int64_t last_ns)
+        {
+            std::string body = encodePositionArchive(fixes);
+
+            char header[ARCHIVE_HEADER_SIZE] = {};
+            uint32_t crc = crc32c(body.data(), body.size());
+            uint64_t count = fixes.size();
+            uint64_t body_size = body.size();
+            std::memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+            std::memcpy(header + 8, &ARCHIVE_FORMAT_VERSION, sizeof(ARCHIVE_FORMAT_VERSION));
+            std::memcpy(header + 12, &crc, sizeof(crc));
+            std::memcpy(header + 16, &count, sizeof(count));
+            std::memcpy(header + 24, &first_ns, sizeof(first_ns));
+            std::memcpy(header + 32, &last_ns, sizeof(last_ns));
+            std::memcpy(header + 40, &body_size, sizeof(body_size));
+
+            return std::string(header, sizeof(header)) + body;
+        }
+
+        bool parseArchiveHeader(const char *data, size_t size, ArchiveHeader &header)
+        {
+            uint32_t version;
+            if (size < ARCHIVE_HEADER_SIZE || std::memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0)
+            {
+                return false;
+            }
+            std::memcpy(&version, data + 8, sizeof(version));
+            std::memcpy(&header.crc, data + 12, sizeof(header.crc));
+            std::memcpy(&header.fixes, data + 16, sizeof(header.fixes));
+            std::memcpy(&header.first_ns, data + 24, sizeof(header.first_ns));
+            std::memcpy(&header.last_ns, data + 32, sizeof(header.last_ns));
+            std::memcpy(&header.body_size, data + 40, sizeof(header.body_size));
+            return version == ARCHIVE_FORMAT_VERSION;
+        }
+
+        // Archives are checked as a whole; a damaged one yields no fixes
+        void scanArchive(const char *data, size_t size, PositionLogCheck &check, std::vector<Position> *out)
+        {
+            ++check.segments;
+            check.bytes += size;
+
+            ArchiveHeader header;
+            if (!parseArchiveHeader(data, size, header) || header.body_size > size - ARCHIVE_HEADER_SIZE ||
+                crc32c(data + ARCHIVE_HEADER_SIZE, header.body_size) != header.crc)
+            {
+                ++check.corrupt_segments;
+                return;
+            }
+            if (!out)
+            {
+                check.records += header.fixes;
+                return;
+            }
+
+            std::vector<Position> fixes;
+            if (!decodePositionArchive(data + ARCHIVE_HEADER_SIZE, header.body_size, fixes) ||
+                fixes.size() != header.fixes)
+            {
+                ++check.corrupt_segments;
+                return;
+            }
+            check.records += fixes.size();
+            out->insert(out->end(), fixes.begin(), fixes.end());
+        }
+
+        void scanStored(const char *data, size_t size, bool archived, PositionLogCheck &check,
+                        std::vector<Position> *out)
+        {
+            if (archived)
+            {
+                scanArchive(data, size, check, out);
+            }
+            else
+            {
+                scanSegment(data, size, check, out);
+            }
+        }
+
+        void reportCorrupt(const PositionLogCheck &check, const std::filesystem::path &directory)
+        {
+            if (check.corrupt_records > 0 || check.corrupt_segments > 0)
+            {
+                std::cerr << "PositionLog skipped " << check.corrupt_records << " corrupt records and "
+                          << check.corrupt_segments << " corrupt archives or segments in " << directory << std::endl;
+            }
+        }
+
+        void putVarint(std::string &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        bool getVarint(const char *&data, const char *end, uint64_t &value)
+        {
+            value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                if (data == end)
+                {
+                    return false;
+                }
+                uint8_t byte = static_cast<uint8_t>(*data++);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // XOR with the previous value: a control byte (0 when unchanged, else
+        // 0x80 | leading zero bytes << 3 | trailing zero bytes), then the rest
+        void putXor(std::string &out, uint64_t value)
+        {
+            if (value == 0)
+            {
+                out.push_back(0);
+                return;
+            }
+
+            unsigned leading = 0;
+            while (((value >> (56 - 8 * leading)) & 0xFF) == 0)
+            {
+                ++leading;
+            }
+            unsigned trailing = 0;
+            while (((value >> (8 * trailing)) & 0xFF) == 0)
+            {
+                ++trailing;
+            }
+
+            out.push_back(static_cast<char>(0x80 | (leading << 3) | trailing));
+            uint64_t middle = value >> (8 * trailing);
+            for (unsigned i = 0; i < 8 - leading - trailing; ++i)
+            {
+                out.push_back(static_cast<char>(middle >> (8 * i)));
+            }
+        }
+
+        bool getXor(const char *&data, const char *end, uint64_t &value)
+        {
+            if (data == end)
+            {
+                return false;
+            }
+
+            uint8_t control = static_cast<uint8_t>(*data++);
+            if (control == 0)
+            {
+                value = 0;
+                return true;
+            }
+
+            unsigned leading = (control >> 3) & 7;
+            unsigned trailing = control & 7;
+            if ((control & 0x80) == 0 || leading + trailing > 7)
+            {
+                return false;
+            }
+
+            unsigned length = 8 - leading - trailing;
+            if (static_cast<size_t>(end - data) < length)
+            {
+                return false;
+            }
+
+            uint64_t middle = 0;
+            for (unsigned i = 0; i < length; ++i)
+            {
+                middle |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+            }
+            data += length;
+            value = middle << (8 * trailing);
+            return true;
+        }
+    } // namespace
+
+    void encodePositionRecord(const Position &position, char *out)
+    {
+        int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   position.getTimestamp().time_since_epoch())
+                                   .count();
+        double fields[4] = {position.getLatitude(), position.getLongitude(),
+                            position.getAltitude(), position.getAccuracy()};
+
+        std::memcpy(out, &timestamp_ns, sizeof(timestamp_ns));
+        std::memcpy(out + sizeof(timestamp_ns), fields, sizeof(fields));
+        sealRecord(out, PositionRecordKind::Fix);
+    }
+
+    std::vector<Position> decodePositionRecords(const char *data, size_t size, size_t *corrupt_records)
+    {
+        std::vector<Position> positions;
+        positions.reserve(size / POSITION_RECORD_SIZE);
+
+        for (size_t offset = 0; offset + POSITION_RECORD_SIZE <= size; offset += POSITION_RECORD_SIZE)
+        {
+            const char *record = data + offset;
+            if (isZeroRecord(record))
+            {
+                break; // Preallocated or padded space
+            }
+
+            if (!recordIntact(record))
+            {
+                if (corrupt_records)
+                {
+                    ++*corrupt_records;
+                }
+                continue;
+            }
+
+            if (recordKind(record) == PositionRecordKind::Fix)
+            {
+                positions.push_back(decodeFix(record));
+            }
+        }
+
+        return positions;
+    }
+
+    std::vector<Position> decodeLegacyPositionRecords(const char *data, size_t size)
+    {
+        std::vector<Position> positions;
+        positions.reserve(size / LEGACY_POSITION_RECORD_SIZE);
+
+        for (size_t offset = 0; offset + LEGACY_POSITION_RECORD_SIZE <= size;
+             offset += LEGACY_POSITION_RECORD_SIZE)
+        {
+            if (isZeroRecord(data + offset, LEGACY_POSITION_RECORD_SIZE))
+            {
+                break;
+            }
+            positions.push_back(decodeFix(data + offset));
+        }
+
+        return positions;
+    }
+
+    std::string encodePositionArchive(const std::vector<Position> &positions)
+    {
+        std::string out;
+        out.reserve(positions.size() * 24);
+        putVarint(out, positions.size());
+
+        // Unsigned arithmetic wraps instead of overflowing on wild timestamps
+        uint64_t previous_ns = 0;
+        uint64_t previous_delta = 0;
+        uint64_t previous_fields[4] = {};
+        for (const auto &position : positions)
+        {
+            uint64_t timestamp_ns = static_cast<uint64_t>(timestampNs(position.getTimestamp()));
+            uint64_t delta = timestamp_ns - previous_ns;
+            int64_t delta_of_delta = static_cast<int64_t>(delta - previous_delta);
+            putVarint(out, (static_cast<uint64_t>(delta_of_delta) << 1) ^ static_cast<uint64_t>(delta_of_delta >> 63));
+            previous_ns = timestamp_ns;
+            previous_delta = delta;
+
+            double fields[4] = {position.getLatitude(), position.getLongitude(),
+                                position.getAltitude(), position.getAccuracy()};
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint64_t bits;
+                std::memcpy(&bits, &fields[i], sizeof(bits));
+                putXor(out, bits ^ previous_fields[i]);
+                previous_fields[i] = bits;
+            }
+        }
+        return out;
+    }
+
+    bool decodePositionArchive(const char *data, size_t size, std::vector<Position> &out)
+    {
+        const char *end = data + size;
+        uint64_t count;
+        if (!getVarint(data, end, count) || count > size)
+        {
+            return false;
+        }
+        out.reserve(out.size() + count);
+
+        uint64_t previous_ns = 0;
+        uint64_t previous_delta = 0;
+        uint64_t previous_fields[4] = {};
+        for (uint64_t n = 0; n < count; ++n)
+        {
+            uint64_t zigzag;
+            if (!getVarint(data, end, zigzag))
+            {
+                return false;
+            }
+            uint64_t delta_of_delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+            previous_delta += delta_of_delta;
+            previous_ns += previous_delta;
+
+            double fields[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint64_t difference;
+                if (!getXor(data, end, difference))
+                {
+                    return false;
+                }
+                previous_fields[i] ^= difference;
+                std::memcpy(&fields[i], &previous_fields[i], sizeof(fields[i]));
+            }
+
+            Timestamp timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                std::chrono::nanoseconds(static_cast<int64_t>(previous_ns))));
+            out.emplace_back(fields[0], fields[1], fields[2], fields[3], timestamp);
+        }
+        return data == end;
+    }
+
+    PositionLog::PositionLog(std::filesystem::path directory, StorageIoBackend &io,
+                             PositionLogOptions options)
+        : directory_(std::move(directory)),
+          io_(io),
+          options_(options),
+          direct_io_(options.direct_io),
+          generation_(next_generation.fetch_add(1, std::memory_order_relaxed))
+    {
+        // Room for a header, one fix and the footer
+        options_.segment_size = std::max<uint64_t>(options_.segment_size, 3 * POSITION_RECORD_SIZE);
+        if (direct_io_)
+        {
+            tail_block_ = IoBuffer(DIRECT_IO_ALIGNMENT, DIRECT_IO_ALIGNMENT);
+            std::memset(tail_block_.data(), 0, tail_block_.size());
+        }
+    }
+
+    PositionLog::~PositionLog()
+    {
+        for (auto &segment : segments_)
+        {
+            unmapSegment(segment);
+            if (segment.fd >= 0)
+            {
+                closeFile(segment.fd);
+            }
+        }
+    }
+
+    bool PositionLog::open(bool create)
+    {
+        if (!std::filesystem::exists(directory_))
+        {
+            if (!create)
+            {
+                return false;
+            }
+            std::filesystem::create_directories(directory_);
+        }
+
+        for (const auto &entry : std::filesystem::directory_iterator(directory_))
+        {
+            if (!entry.is_regular_file())
+            {
+                continue;
+            }
+
+            std::string name = entry.path().filename().string();
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0)
+            {
+                // An archive that was never completed; its segment is intact
+                std::error_code error;
+                std::filesystem::remove(entry.path(), error);
+                continue;
+            }
+
+            auto index = parseSegmentFilename(name);
+            auto archive_index = parseIndexedFilename(name, "archive-", ".arc");
+            if (index || archive_index)
+            {
+                Segment segment;
+                segment.index = index ? *index : *archive_index;
+                segment.path = entry.path();
+                segment.size = entry.file_size();
+                segment.sealed = true;
+                segment.archived = archive_index.has_value();
+                segments_.push_back(std::move(segment));
+            }
+        }
+
+        // Archives sort ahead of a segment with the same index, which is then a
+        // leftover from an interrupted archiving step
+        std::sort(segments_.begin(), segments_.end(),
+                  [](const Segment &a, const Segment &b)
+                  {
+                      return a.index < b.index || (a.index == b.index && a.archived && !b.archived);
+                  });
+        segments_.erase(std::unique(segments_.begin(), segments_.end(),
+                                    [](const Segment &a, const Segment &b)
+                                    {
+                                        if (a.index != b.index)
+                                        {
+                                            return false;
+                                        }
+                                        std::error_code error;
+                                        std::filesystem::remove(b.path, error);
+                                        return true;
+                                    }),
+                        segments_.end());
+
+        if (segments_.empty())
+        {
+            return create && startSegment();
+        }
+        if (segments_.back().archived)
+        {
+            return true; // The next append starts a new segment
+        }
+
+        // Reopen the newest segment for appending and find where its data ends
+        Segment &active = segments_.back();
+        active.sealed = false;
+        if (!openSegment(active, false))
+        {
+            return false;
+        }
+
+        uint64_t file_size = active.size;
+        std::vector<char> contents;
+        if (file_size > 0)
+        {
+            io_.submitRead(active.fd, IoBuffer(roundUp(file_size, DIRECT_IO_ALIGNMENT), DIRECT_IO_ALIGNMENT), 0,
+                           [&contents](IoResult &result)
+                           {
+                               if (result.result > 0)
+                               {
+                                   contents.assign(result.buffer.data(), result.buffer.data() + result.result);
+                               }
+                           });
+            io_.wait();
+        }
+
+        if (!contents.empty() && !hasSegmentHeader(contents.data(), contents.size()))
+        {
+            // Unchecked layout: keep it read-only and start a new segment on the next append
+            active.sealed = true;
+            closeFile(active.fd);
+            active.fd = -1;
+            return true;
+        }
+
+        // Stop at padding, then drop torn records; the next append overwrites them
+        uint64_t size = findDataEnd(contents.data(), contents.size());
+        while (size > POSITION_RECORD_SIZE && !recordIntact(contents.data() + size - POSITION_RECORD_SIZE))
+        {
+            size -= POSITION_RECORD_SIZE;
+        }
+
+        active.size = size;
+        active.crc = crc32c(contents.data(), size);
+        for (const auto &fix : decodePositionRecords(contents.data(), size))
+        {
+            int64_t timestamp_ns = timestampNs(fix.getTimestamp());
+            active.first_ns = active.fixes == 0 ? timestamp_ns : std::min(active.first_ns, timestamp_ns);
+            active.last_ns = active.fixes == 0 ? timestamp_ns : std::max(active.last_ns, timestamp_ns);
+            ++active.fixes;
+        }
+        active.range_known = true;
+
+        if (direct_io_)
+        {
+            tail_block_offset_ = size / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            std::memset(tail_block_.data(), 0, tail_block_.size());
+            std::memcpy(tail_block_.data(), contents.data() + tail_block_offset_, size - tail_block_offset_);
+        }
+
+        if (size == 0)
+        {
+            // Created but its header never reached the disk
+            char header[POSITION_RECORD_SIZE];
+            encodeSegmentHeader(header);
+            appendRecord(active, header);
+        }
+        else if (recordKind(contents.data() + size - POSITION_RECORD_SIZE) == PositionRecordKind::SegmentFooter)
+        {
+            // Sealed just before the next segment was created
+            active.sealed = true;
+            closeFile(active.fd);
+            active.fd = -1;
+        }
+
+        return true;
+    }
+
+    bool PositionLog::append(const Position &position)
+    {
+        bool rotated = false;
+        if (segments_.empty() || segments_.back().sealed ||
+            segments_.back().size + 2 * POSITION_RECORD_SIZE > options_.segment_size)
+        {
+            if (!segments_.empty() && !segments_.back().sealed)
+            {
+                sealActiveSegment();
+            }
+            if (!startSegment())
+            {
+                return false;
+            }
+            rotated = true;
+        }
+
+        Segment &active = segments_.back();
+        char record[POSITION_RECORD_SIZE];
+        encodePositionRecord(position, record);
+        appendRecord(active, record);
+
+        int64_t timestamp_ns = timestampNs(position.getTimestamp());
+        active.first_ns = active.fixes == 0 ? timestamp_ns : std::min(active.first_ns, timestamp_ns);
+        active.last_ns = active.fixes == 0 ? timestamp_ns : std::max(active.last_ns, timestamp_ns);
+        active.range_known = true;
+        ++active.fixes;
+
+        // Aged segments are demoted to the cold tier by the owner, off this path
+        if (rotated && options_.archive_after_seconds > 0)
+        {
+            archive_cutoff_ = position.getTimestamp() - std::chrono::seconds(options_.archive_after_seconds);
+        }
+        return true;
+    }
+
+    std::vector<Position> PositionLog::readAll()
+    {
+        auto images = readImages(0, segments_.size());
+
+        PositionLogCheck check;
+        std::vector<Position> positions;
+        for (const auto &image : images)
+        {
+            scanStored(image.buffer.data(), image.size, image.archived, check, &positions);
+        }
+
+        reportCorrupt(check, directory_);
+        return positions;
+    }
+
+    std::vector<Position> PositionLog::readRecent(size_t count)
+    {
+        PositionLogCheck check;
+        std::vector<Position> positions;
+        for (size_t last = segments_.size(); last > 0 && positions.size() < count; --last)
+        {
+            std::vector<Position> segment_positions;
+            for (const auto &image : readImages(last - 1, last))
+            {
+                scanStored(image.buffer.data(), image.size, image.archived, check, &segment_positions);
+            }
+            positions.insert(positions.begin(), segment_positions.begin(), segment_positions.end());
+        }
+
+        reportCorrupt(check, directory_);
+        if (positions.size() > count)
+        {
+            positions.erase(positions.begin(), positions.end() - count);
+        }
+        return positions;
+    }
+
+    PositionLogCheck PositionLog::verify()
+    {
+        // A few segments per batch keeps reads in flight without holding the whole history
+        PositionLogCheck check;
+        for (size_t first = 0; first < segments_.size(); first += POSITION_VERIFY_BATCH_SEGMENTS)
+        {
+            size_t last = std::min(segments_.size(), first + POSITION_VERIFY_BATCH_SEGMENTS);
+            for (const auto &image : readImages(first, last))
+            {
+                scanStored(image.buffer.data(), image.size, image.archived, check, nullptr);
+            }
+        }
+        return check;
+    }
+
+    std::vector<Position> PositionLog::readRange(const Timestamp &start, const Timestamp &end)
+    {
+        std::vector<Position> positions;
+        size_t next_segment = 0;
+        while (readRangeChunk(start, end, next_segment, positions))
+        {
+        }
+        return positions;
+    }
+
+    bool PositionLog::readRangeChunk(const Timestamp &start, const Timestamp &end,
+                                     size_t &next_segment, std::vector<Position> &out)
+    {
+        // Queued appends must land before segments are mapped or read
+        io_.wait();
+
+        int64_t start_ns = timestampNs(start);
+        int64_t end_ns = timestampNs(end);
+
+        for (; next_segment < segments_.size(); ++next_segment)
+        {
+            Segment &segment = segments_[next_segment];
+            bool active = next_segment + 1 == segments_.size() && !segment.sealed;
+            if (!active)
+            {
+                learnRange(segment);
+            }
+            if (segment.range_known && (segment.last_ns < start_ns || segment.first_ns > end_ns))
+            {
+                continue;
+            }
+
+            PositionLogCheck check;
+            std::vector<Position> fixes;
+            if (!active && !segment.archived && mapSegment(segment))
+            {
+                scanSegment(segment.map, segment.map_size, check, &fixes);
+            }
+            else
+            {
+                for (const auto &image : readImages(next_segment, next_segment + 1))
+                {
+                    scanStored(image.buffer.data(), image.size, image.archived, check, &fixes);
+                }
+            }
+            reportCorrupt(check, directory_);
+
+            for (auto &fix : fixes)
+            {
+                int64_t timestamp_ns = timestampNs(fix.getTimestamp());
+                if (timestamp_ns >= start_ns && timestamp_ns <= end_ns)
+                {
+                    out.push_back(std::move(fix));
+                }
+            }
+            ++next_segment;
+            return true;
+        }
+        return false;
+    }
+
+    bool PositionLog::getSegmentRanges(std::vector<std::pair<Timestamp, Timestamp>> &ranges)
+    {
+        // Footers of recently sealed segments may still be queued
+        io_.wait();
+
+        for (size_t i = 0; i < segments_.size(); ++i)
+        {
+            Segment &segment = segments_[i];
+            bool active = i + 1 == segments_.size() && !segment.sealed;
+            if (active && segment.fixes == 0)
+            {
+                continue;
+            }
+            if (!active)
+            {
+                learnRange(segment);
+                if (!segment.range_known)
+                {
+                    return false;
+                }
+            }
+            if (segment.first_ns <= segment.last_ns)
+            {
+                ranges.emplace_back(Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                                        std::chrono::nanoseconds(segment.first_ns))),
+                                    Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+                                        std::chrono::nanoseconds(segment.last_ns))));
+            }
+        }
+        return true;
+    }
+
+    size_t PositionLog::archiveBefore(const Timestamp &cutoff)
+    {
+        std::vector<ArchiveJob> jobs = planArchive(cutoff);
+        for (auto &job : jobs)
+        {
+            writeArchive(job);
+        }
+        return commitArchive(jobs);
+    }
+
+    std::vector<PositionLog::ArchiveJob> PositionLog::planArchive(const Timestamp &cutoff)
+    {
+        int64_t cutoff_ns = timestampNs(cutoff);
+
+        // Sealed segments must be complete on disk before another thread reads them
+        io_.wait();
+
+        std::vector<ArchiveJob> jobs;
+        for (auto &segment : segments_)
+        {
+            if (!segment.sealed || segment.archived || segment.archiving)
+            {
+                continue;
+            }
+
+            learnRange(segment);
+            if (segment.range_known && segment.last_ns < cutoff_ns)
+            {
+                ArchiveJob job;
+                job.generation = generation_;
+                job.segment = segment.index;
+                job.source = segment.path;
+                job.target = directory_ / archiveFilename(segment.index);
+                job.first_ns = segment.first_ns;
+                job.last_ns = segment.last_ns;
+                jobs.push_back(std::move(job));
+                segment.archiving = true;
+            }
+        }
+        return jobs;
+    }
+
+    bool PositionLog::writeArchive(ArchiveJob &job)
+    {
+        std::string image;
+        if (!readWholeFile(job.source, image))
+        {
+            std::cerr << "PositionLog failed to read segment for archiving: " << job.source << std::endl;
+            return false;
+        }
+
+        PositionLogCheck check;
+        std::vector<Position> fixes;
+        scanSegment(image.data(), image.size(), check, &fixes);
+        if (check.corrupt_records > 0 || check.corrupt_segments > 0)
+        {
+            // Compressing would make the damage unrecoverable by other tools
+            std::cerr << "PositionLog leaving damaged segment uncompressed: " << job.source << std::endl;
+            return false;
+        }
+
+        // The archive is durable before the segment it replaces goes away
+        std::string archive = buildArchive(fixes, job.first_ns, job.last_ns);
+        std::filesystem::path temp_path = archiveTempPath(job.target);
+        std::error_code error;
+        std::filesystem::remove(temp_path, error);
+        if (!writeDurably(temp_path, archive))
+        {
+            std::cerr << "PositionLog archive write failed: " << temp_path << std::endl;
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        job.size = archive.size();
+        job.fixes = fixes.size();
+        job.written = true;
+        return true;
+    }
+
+    size_t PositionLog::commitArchive(std::vector<ArchiveJob> &jobs)
+    {
+        size_t archived = 0;
+        for (auto &job : jobs)
+        {
+            auto it = std::find_if(segments_.begin(), segments_.end(),
+                                   [&job](const Segment &segment)
+                                   {
+                                       return segment.index == job.segment;
+                                   });
+            bool current = job.generation == generation_ && it != segments_.end() &&
+                           it->archiving && it->path == job.source;
+            if (current)
+            {
+                it->archiving = false;
+            }
+
+            std::error_code error;
+            std::filesystem::path temp_path = archiveTempPath(job.target);
+            if (!current || !job.written)
+            {
+                std::filesystem::remove(temp_path, error);
+                continue;
+            }
+
+            std::filesystem::rename(temp_path, job.target, error);
+            if (error)
+            {
+                std::cerr << "PositionLog archive rename failed: " << job.target << std::endl;
+                std::filesystem::remove(temp_path, error);
+                continue;
+            }
+
+            Segment &segment = *it;
+            unmapSegment(segment);
+            if (segment.fd >= 0)
+            {
+                closeFile(segment.fd);
+                segment.fd = -1;
+            }
+            std::filesystem::remove(segment.path, error);
+
+            segment.path = job.target;
+            segment.size = job.size;
+            segment.fixes = job.fixes;
+            segment.archived = true;
+            segment.dirty = false;
+            ++archived;
+        }
+        return archived;
+    }
+
+    void PositionLog::discardArchive(const std::vector<ArchiveJob> &jobs)
+    {
+        std::error_code error;
+        for (const auto &job : jobs)
+        {
+            std::filesystem::remove(archiveTempPath(job.target), error);
+        }
+    }
+
+    std::optional<Timestamp> PositionLog::takeArchiveCutoff()
+    {
+        std::optional<Timestamp> cutoff;
+        cutoff.swap(archive_cutoff_);
+        return cutoff;
+    }
+
+    PositionLogTiers PositionLog::getTiers() const
+    {
+        PositionLogTiers tiers;
+        for (const auto &segment : segments_)
+        {
+            if (segment.archived)
+            {
+                ++tiers.cold_segments;
+                tiers.cold_bytes += segment.size;
+                tiers.cold_fixes += segment.fixes;
+            }
+            else
+            {
+                ++tiers.warm_segments;
+                tiers.warm_bytes += segment.size;
+                tiers.mapped_bytes += segment.map_size;
+            }
+        }
+        return tiers;
+    }
+
+    bool PositionLog::mapSegment(Segment &segment)
+    {
+#ifdef _WIN32
+        (void)segment;
+        return false; // Read through the I/O backend instead
+#else
+        if (segment.map)
+        {
+            return true;
+        }
+
+        int fd = openForScan(segment.path);
+        if (fd < 0)
+        {
+            return false;
+        }
+        size_t size = static_cast<size_t>(std::filesystem::file_size(segment.path));
+        void *map = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        closeFile(fd);
+        if (map == MAP_FAILED)
+        {
+            return false;
+        }
+
+        segment.map = static_cast<const char *>(map);
+        segment.map_size = size;
+        mapped_.push_back(segment.index);
+
+        // Bound the mappings a long history holds open
+        while (mapped_.size() > POSITION_MAPPED_SEGMENTS)
+        {
+            uint64_t oldest = mapped_.front();
+            for (auto &other : segments_)
+            {
+                if (other.index == oldest && other.map)
+                {
+                    unmapSegment(other);
+                    break;
+                }
+            }
+            if (!mapped_.empty() && mapped_.front() == oldest)
+            {
+                mapped_.pop_front();
+            }
+        }
+        return segment.map != nullptr;
+#endif
+    }
+
+    void PositionLog::unmapSegment(Segment &segment)
+    {
+#ifndef _WIN32
+        if (segment.map)
+        {
+            ::munmap(const_cast<char *>(segment.map), segment.map_size);
+            mapped_.erase(std::remove(mapped_.begin(), mapped_.end(), segment.index), mapped_.end());
+        }
+#endif
+        segment.map = nullptr;
+        segment.map_size = 0;
+    }
+
+    void PositionLog::learnRange(Segment &segment)
+    {
+        if (segment.range_known)
+        {
+            return;
+        }
+
+        // Archive headers and segment footers record the range
+        char record[ARCHIVE_HEADER_SIZE];
+        static_assert(ARCHIVE_HEADER_SIZE == POSITION_RECORD_SIZE, "header and footer share a read");
+        if (segment.size >= sizeof(record))
+        {
+            std::ifstream in(segment.path, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(segment.archived ? 0 : segment.size - sizeof(record)));
+            if (in.read(record, sizeof(record)))
+            {
+                ArchiveHeader header;
+                if (segment.archived && parseArchiveHeader(record, sizeof(record), header))
+                {
+                    segment.fixes = header.fixes;
+                    segment.first_ns = header.first_ns;
+                    segment.last_ns = header.last_ns;
+                    segment.range_known = true;
+                    return;
+                }
+                if (!segment.archived && recordIntact(record) &&
+                    recordKind(record) == PositionRecordKind::SegmentFooter)
+                {
+                    std::memcpy(&segment.first_ns, record + FOOTER_FIRST_OFFSET, sizeof(segment.first_ns));
+                    std::memcpy(&segment.last_ns, record + FOOTER_LAST_OFFSET, sizeof(segment.last_ns));
+                    segment.range_known = segment.first_ns != 0 || segment.last_ns != 0;
+                }
+            }
+        }
+        if (segment.range_known || segment.archived)
+        {
+            return;
+        }
+
+        // Older footer, padded direct I/O tail or legacy layout: scan the fixes
+        std::vector<Position> fixes;
+        PositionLogCheck check;
+        bool was_mapped = segment.map != nullptr;
+        if (!mapSegment(segment))
+        {
+            return;
+        }
+        scanSegment(segment.map, segment.map_size, check, &fixes);
+        if (!was_mapped)
+        {
+            unmapSegment(segment);
+        }
+
+        segment.first_ns = std::numeric_limits<int64_t>::max();
+        segment.last_ns = std::numeric_limits<int64_t>::min();
+        for (const auto &fix : fixes)
+        {
+            segment.first_ns = std::min(segment.first_ns, timestampNs(fix.getTimestamp()));
+            segment.last_ns = std::max(segment.last_ns, timestampNs(fix.getTimestamp()));
+        }
+        segment.range_known = true;
+    }
+
+    std::vector<PositionLog::SegmentImage> PositionLog::readImages(size_t first, size_t last)
+    {
+        // Read-your-writes: queued appends must land before the scan
+        io_.wait();
+
+        struct Scan
+        {
+            int fd{-1};
+            bool owned{false}; // Opened just for this scan
+            SegmentImage image;
+        };
+        std::vector<Scan> scans(last - first);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const Segment &segment = segments_[i];
+            Scan &scan = scans[i - first];
+            bool active = i + 1 == segments_.size() && !segment.sealed;
+
+            uint64_t length;
+            size_t alignment = alignof(std::max_align_t);
+            if (active)
+            {
+                scan.fd = segment.fd;
+                length = direct_io_ ? tail_block_offset_ : segment.size;
+                alignment = direct_io_ ? DIRECT_IO_ALIGNMENT : alignment;
+            }
+            else
+            {
+                // Sealed history is read once, sequentially, through the page cache
+                scan.fd = openForScan(segment.path);
+                scan.owned = true;
+                if (scan.fd < 0)
+                {
+                    std::cerr << "Failed to open file for reading: " << segment.path << std::endl;
+                    continue;
+                }
+                advise(scan.fd, AccessAdvice::Sequential);
+                length = std::filesystem::file_size(segment.path);
+            }
+
+            scan.image.archived = segment.archived;
+            if (length == 0)
+            {
+                continue;
+            }
+
+            // All segment reads go to the backend together and complete in one wait
+            io_.submitRead(scan.fd, IoBuffer(length, alignment), 0,
+                           [&scan](IoResult &result)
+                           {
+                               if (result.result < 0)
+                               {
+                                   std::cerr << "PositionLog read error: "
+                                             << std::strerror(static_cast<int>(-result.result)) << std::endl;
+                                   return;
+                               }
+                               scan.image.size = static_cast<size_t>(result.result);
+                               scan.image.buffer = std::move(result.buffer);
+                           });
+        }
+        io_.wait();
+
+        std::vector<SegmentImage> images;
+        images.reserve(scans.size());
+        for (size_t i = first; i < last; ++i)
+        {
+            Scan &scan = scans[i - first];
+            if (scan.owned && scan.fd >= 0)
+            {
+                advise(scan.fd, AccessAdvice::DontNeed);
+                closeFile(scan.fd);
+            }
+
+            bool active = i + 1 == segments_.size() && !segments_[i].sealed;
+            if (active && direct_io_)
+            {
+                // The unwritten tail lives in memory
+                SegmentImage joined{IoBuffer(segments_[i].size), static_cast<size_t>(segments_[i].size)};
+                size_t on_disk = std::min<size_t>(scan.image.size, tail_block_offset_);
+                std::memset(joined.buffer.data(), 0, joined.size);
+                if (on_disk > 0)
+                {
+                    std::memcpy(joined.buffer.data(), scan.image.buffer.data(), on_disk);
+                }
+                std::memcpy(joined.buffer.data() + tail_block_offset_, tail_block_.data(),
+                            joined.size - tail_block_offset_);
+                scan.image = std::move(joined);
+            }
+
+            images.push_back(std::move(scan.image));
+        }
+
+        return images;
+    }
+
+    void PositionLog::writeTail()
+    {
+        if (!direct_io_ || segments_.empty() || segments_.back().sealed)
+        {
+            return;
+        }
+
+        Segment &active = segments_.back();
+        if (active.size > tail_block_offset_)
+        {
+            writeBlock(active, tail_block_.data(), tail_block_offset_);
+        }
+    }
+
+    void PositionLog::submitSync(const std::shared_ptr<std::atomic<bool>> &ok)
+    {
+        for (auto &segment : segments_)
+        {
+            if (!segment.dirty || segment.fd < 0)
+            {
+                continue;
+            }
+
+            io_.submitSync(segment.fd,
+                           [ok](IoResult &result)
+                           {
+                               if (result.result < 0)
+                               {
+                                   std::cerr << "PositionLog sync error: "
+                                             << std::strerror(static_cast<int>(-result.result)) << std::endl;
+                                   *ok = false;
+                               }
+                           });
+            segment.dirty = false;
+        }
+    }
+
+    void PositionLog::releaseSealed()
+    {
+        for (auto &segment : segments_)
+        {
+            if (segment.sealed && !segment.dirty && segment.fd >= 0)
+            {
+                // Durable and never written again: no reason to keep it cached
+                advise(segment.fd, AccessAdvice::DontNeed);
+                closeFile(segment.fd);
+                segment.fd = -1;
+            }
+        }
+    }
+
+    bool PositionLog::openSegment(Segment &segment, bool create)
+    {
+        segment.fd = openFile(segment.path, create, direct_io_);
+
+        if (segment.fd < 0 && direct_io_ && errno == EINVAL)
+        {
+            // Filesystems such as tmpfs reject O_DIRECT
+            std::cerr << "Direct I/O unsupported for " << segment.path << "; using buffered I/O." << std::endl;
+            direct_io_ = false;
+            segment.fd = openFile(segment.path, create, false);
+        }
+
+        if (segment.fd < 0)
+        {
+            std::cerr << "Failed to open file for writing: " << segment.path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool PositionLog::startSegment()
+    {
+        Segment segment;
+        segment.index = segments_.empty() ? 1 : segments_.back().index + 1;
+        segment.path = directory_ / segmentFilename(segment.index);
+
+        if (!openSegment(segment, true))
+        {
+            return false;
+        }
+
+        if (options_.preallocate)
+        {
+            preallocate(segment.fd, roundUp(options_.segment_size, DIRECT_IO_ALIGNMENT));
+        }
+
+        tail_block_offset_ = 0;
+        if (direct_io_)
+        {
+            std::memset(tail_block_.data(), 0, tail_block_.size());
+        }
+
+        segments_.push_back(std::move(segment));
+
+        char header[POSITION_RECORD_SIZE];
+        encodeSegmentHeader(header);
+        appendRecord(segments_.back(), header);
+        return true;
+    }
+
+    void PositionLog::sealActiveSegment()
+    {
+        Segment &active = segments_.back();
+
+        if (active.size > 0 && active.fd >= 0)
+        {
+            char footer[POSITION_RECORD_SIZE];
+            encodeSegmentFooter(active.fixes, active.crc, active.first_ns, active.last_ns, footer);
+            appendRecord(active, footer);
+        }
+
+        // The last partial block is written once, now that it can no longer grow
+        writeTail();
+        active.sealed = true;
+
+        if (!active.dirty)
+        {
+            closeFile(active.fd);
+            active.fd = -1;
+        }
+    }
+
+    void PositionLog::appendRecord(Segment &segment, const char *record)
+    {
+        if (!direct_io_)
+        {
+            io_.submitWrite(segment.fd, IoBuffer::copyOf(record, POSITION_RECORD_SIZE), segment.size);
+        }
+        else
+        {
+            // Fill the tail block; a record may straddle into the next block
+            size_t copied = 0;
+            while (copied < POSITION_RECORD_SIZE)
+            {
+                size_t in_block = static_cast<size_t>(segment.size + copied - tail_block_offset_);
+                size_t chunk = std::min(POSITION_RECORD_SIZE - copied, DIRECT_IO_ALIGNMENT - in_block);
+                std::memcpy(tail_block_.data() + in_block, record + copied, chunk);
+                copied += chunk;
+
+                if (in_block + chunk == DIRECT_IO_ALIGNMENT)
+                {
+                    writeBlock(segment, tail_block_.data(), tail_block_offset_);
+                    tail_block_offset_ += DIRECT_IO_ALIGNMENT;
+                    std::memset(tail_block_.data(), 0, tail_block_.size());
+                }
+            }
+        }
+
+        segment.size += POSITION_RECORD_SIZE;
+        segment.crc = crc32cExtend(segment.crc, record, POSITION_RECORD_SIZE);
+        segment.dirty = true;
+    }
+
+    void PositionLog::writeBlock(Segment &segment, const char *data, uint64_t offset)
+    {
+        io_.submitWrite(segment.fd, IoBuffer::copyOf(data, DIRECT_IO_ALIGNMENT, DIRECT_IO_ALIGNMENT), offset);
+    }
+
+} // namespace equipment_tracker
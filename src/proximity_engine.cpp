@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "equipment_tracker/proximity_engine.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        ProximityEvent makeEvent(const EquipmentId &a, const EquipmentId &b,
+                                 ProximityEventType type, double distance,
+                                 const Timestamp &timestamp)
+        {
+            // Report each pair in a canonical order so consumers can key on it
+            if (b < a)
+            {
+                return ProximityEvent{b, a, type, distance, timestamp};
+            }
+            return ProximityEvent{a, b, type, distance, timestamp};
+        }
+
+        // The grid cell size derives from the thresholds, so they must be positive distances
+        bool isValidThreshold(double meters)
+        {
+            return std::isfinite(meters) && meters > 0.0;
+        }
+
+        double defaultThreshold(double meters)
+        {
+            if (!isValidThreshold(meters))
+            {
+                std::cerr << "Invalid proximity threshold " << meters << ", using "
+                          << DEFAULT_PROXIMITY_THRESHOLD_METERS << " m." << std::endl;
+                return DEFAULT_PROXIMITY_THRESHOLD_METERS;
+            }
+            return meters;
+        }
+    } // namespace
+
+    ProximityEngine::ProximityEngine(double default_threshold_meters)
+        : cell_size_(defaultThreshold(default_threshold_meters)),
+          sites_(&own_sites_)
+    {
+        std::fill(std::begin(thresholds_), std::end(thresholds_), cell_size_);
+    }
+
+    ProximityEngine::ProximityEngine(SiteProjectionRegistry &sites, double default_threshold_meters)
+        : cell_size_(defaultThreshold(default_threshold_meters)),
+          sites_(&sites)
+    {
+        std::fill(std::begin(thresholds_), std::end(thresholds_), cell_size_);
+    }
+
+    bool ProximityEngine::setThreshold(EquipmentType type, double meters)
+    {
+        if (!isValidThreshold(meters))
+        {
+            std::cerr << "Invalid proximity threshold " << meters << " rejected." << std::endl;
+            return false;
+        }
+        thresholds_[static_cast<size_t>(type)] = meters;
+
+        double max_threshold = *std::max_element(std::begin(thresholds_), std::end(thresholds_));
+        if (max_threshold != cell_size_)
+        {
+            cell_size_ = max_threshold;
+            rebuildGrid();
+        }
+        return true;
+    }
+
+    double ProximityEngine::getThreshold(EquipmentType type) const
+    {
+        return thresholds_[static_cast<size_t>(type)];
+    }
+
+    double ProximityEngine::getPairThreshold(EquipmentType a, EquipmentType b) const
+    {
+        return std::max(getThreshold(a), getThreshold(b));
+    }
+
+    std::vector<ProximityEvent> ProximityEngine::update(
+        const EquipmentId &id, EquipmentType type, const Position &position)
+    {
+        return update(id, type, sites_->project(position), position.getTimestamp());
+    }
+
+    std::vector<ProximityEvent> ProximityEngine::update(
+        const EquipmentId &id, EquipmentType type,
+        const LocalFix &fix, const Timestamp &timestamp)
+    {
+        std::vector<ProximityEvent> events;
+
+        uint32_t slot;
+        auto it = index_.find(id);
+        if (it != index_.end())
+        {
+            slot = it->second;
+        }
+        else
+        {
+            if (!free_slots_.empty())
+            {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            }
+            else
+            {
+                slot = static_cast<uint32_t>(assets_.size());
+                assets_.emplace_back();
+            }
+            index_.emplace(id, slot);
+            assets_[slot].id = id;
+        }
+
+        auto cell_x = static_cast<int64_t>(std::floor(fix.point.east / cell_size_));
+        auto cell_y = static_cast<int64_t>(std::floor(fix.point.north / cell_size_));
+
+        {
+            Asset &asset = assets_[slot];
+            asset.type = type;
+
+            if (asset.active &&
+                (asset.site != fix.site || asset.cell_x != cell_x || asset.cell_y != cell_y))
+            {
+                removeFromGrid(slot);
+                asset.active = false;
+            }
+
+            asset.site = fix.site;
+            asset.point = fix.point;
+            asset.cell_x = cell_x;
+            asset.cell_y = cell_y;
+
+            if (!asset.active)
+            {
+                insertIntoGrid(slot);
+                asset.active = true;
+            }
+        }
+
+        // Pairs that separated since the last update
+        std::vector<uint32_t> current = assets_[slot].neighbours;
+        for (uint32_t other : current)
+        {
+            const Asset &asset = assets_[slot];
+            const Asset &neighbour = assets_[other];
+            double limit = getPairThreshold(asset.type, neighbour.type) * PROXIMITY_EXIT_HYSTERESIS;
+            double distance = distanceBetween(asset, neighbour);
+
+            if (distance > limit)
+            {
+                unlink(assets_[slot].neighbours, other);
+                unlink(assets_[other].neighbours, slot);
+                events.push_back(makeEvent(asset.id, neighbour.id, ProximityEventType::Exited,
+                                           distance, timestamp));
+            }
+        }
+
+        // Pairs that came together; only the surrounding cells can qualify
+        findEntered(slot, fix.site, fix.point, timestamp, events);
+
+        // Near a site boundary, machines across it are compared in their own site's plane
+        if (sites_->nearEdge(fix, cell_size_))
+        {
+            double latitude = 0.0;
+            double longitude = 0.0;
+            sites_->getSite(fix.site).projection.unproject(fix.point, latitude, longitude);
+            for (uint32_t site : sites_->sitesNear(latitude, longitude, cell_size_))
+            {
+                if (site != fix.site)
+                {
+                    findEntered(slot, site, sites_->getSite(site).projection.project(latitude, longitude),
+                                timestamp, events);
+                }
+            }
+        }
+
+        return events;
+    }
+
+    std::vector<ProximityEvent> ProximityEngine::remove(const EquipmentId &id)
+    {
+        std::vector<ProximityEvent> events;
+
+        auto it = index_.find(id);
+        if (it == index_.end())
+        {
+            return events;
+        }
+
+        uint32_t slot = it->second;
+        Asset &asset = assets_[slot];
+        const Timestamp now = getCurrentTimestamp();
+
+        for (uint32_t other : asset.neighbours)
+        {
+            Asset &neighbour = assets_[other];
+            unlink(neighbour.neighbours, slot);
+            events.push_back(makeEvent(asset.id, neighbour.id, ProximityEventType::Exited,
+                                       distanceBetween(asset, neighbour), now));
+        }
+
+        if (asset.active)
+        {
+            removeFromGrid(slot);
+        }
+
+        assets_[slot] = Asset{};
+        free_slots_.push_back(slot);
+        index_.erase(it);
+
+        return events;
+    }
+
+    std::vector<std::pair<EquipmentId, EquipmentId>> ProximityEngine::getActivePairs() const
+    {
+        std::vector<std::pair<EquipmentId, EquipmentId>> pairs;
+
+        for (uint32_t slot = 0; slot < assets_.size(); ++slot)
+        {
+            for (uint32_t other : assets_[slot].neighbours)
+            {
+                if (slot < other)
+                {
+                    const auto &a = assets_[slot].id;
+                    const auto &b = assets_[other].id;
+                    pairs.emplace_back(std::min(a, b), std::max(a, b));
+                }
+            }
+        }
+
+        return pairs;
+    }
+
+    uint64_t ProximityEngine::cellKey(uint32_t site, int64_t cell_x, int64_t cell_y)
+    {
+        // 16 bits of site, 24 bits per cell coordinate (cells span whole sites)
+        constexpr uint64_t CELL_MASK = (uint64_t{1} << 24) - 1;
+        return (static_cast<uint64_t>(site & 0xFFFF) << 48) |
+               ((static_cast<uint64_t>(cell_x) & CELL_MASK) << 24) |
+               (static_cast<uint64_t>(cell_y) & CELL_MASK);
+    }
+
+    LocalPoint ProximityEngine::pointIn(const Asset &asset, uint32_t site) const
+    {
+        if (asset.site == site)
+        {
+            return asset.point;
+        }
+
+        double latitude = 0.0;
+        double longitude = 0.0;
+        sites_->getSite(asset.site).projection.unproject(asset.point, latitude, longitude);
+        return sites_->getSite(site).projection.project(latitude, longitude);
+    }
+
+    float ProximityEngine::distanceBetween(const Asset &a, const Asset &b) const
+    {
+        // Pairs across a boundary are measured in the second machine's site plane
+        return pointIn(a, b.site).distanceTo(b.point);
+    }
+
+    void ProximityEngine::findEntered(uint32_t slot, uint32_t site, const LocalPoint &point,
+                                      const Timestamp &timestamp, std::vector<ProximityEvent> &events)
+    {
+        auto cell_x = static_cast<int64_t>(std::floor(point.east / cell_size_));
+        auto cell_y = static_cast<int64_t>(std::floor(point.north / cell_size_));
+
+        for (int64_t dx = -1; dx <= 1; ++dx)
+        {
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                auto cell = grid_.find(cellKey(site, cell_x + dx, cell_y + dy));
+                if (cell == grid_.end())
+                {
+                    continue;
+                }
+
+                for (uint32_t other : cell->second)
+                {
+                    Asset &asset = assets_[slot];
+                    Asset &neighbour = assets_[other];
+
+                    // Cell keys keep only 16 bits of the site
+                    if (other == slot || neighbour.site != site ||
+                        std::find(asset.neighbours.begin(), asset.neighbours.end(), other) !=
+                            asset.neighbours.end())
+                    {
+                        continue;
+                    }
+
+                    float threshold = static_cast<float>(getPairThreshold(asset.type, neighbour.type));
+                    float distance_sq = point.distanceSquaredTo(neighbour.point);
+
+                    if (distance_sq <= threshold * threshold)
+                    {
+                        asset.neighbours.push_back(other);
+                        neighbour.neighbours.push_back(slot);
+                        events.push_back(makeEvent(asset.id, neighbour.id, ProximityEventType::Entered,
+                                                   std::sqrt(distance_sq), timestamp));
+                    }
+                }
+            }
+        }
+    }
+
+    void ProximityEngine::insertIntoGrid(uint32_t slot)
+    {
+        const Asset &asset = assets_[slot];
+        grid_[cellKey(asset.site, asset.cell_x, asset.cell_y)].push_back(slot);
+    }
+
+    void ProximityEngine::removeFromGrid(uint32_t slot)
+    {
+        const Asset &asset = assets_[slot];
+        auto cell = grid_.find(cellKey(asset.site, asset.cell_x, asset.cell_y));
+        if (cell == grid_.end())
+        {
+            return;
+        }
+
+        unlink(cell->second, slot);
+        if (cell->second.empty())
+        {
+            grid_.erase(cell);
+        }
+    }
+
+    void ProximityEngine::rebuildGrid()
+    {
+        grid_.clear();
+
+        for (uint32_t slot = 0; slot < assets_.size(); ++slot)
+        {
+            Asset &asset = assets_[slot];
+            if (!asset.active)
+            {
+                continue;
+            }
+
+            asset.cell_x = static_cast<int64_t>(std::floor(asset.point.east / cell_size_));
+            asset.cell_y = static_cast<int64_t>(std::floor(asset.point.north / cell_size_));
+            insertIntoGrid(slot);
+        }
+    }
+
+    void ProximityEngine::unlink(std::vector<uint32_t> &list, uint32_t slot)
+    {
+        auto it = std::find(list.begin(), list.end(), slot);
+        if (it != list.end())
+        {
+            // Order is irrelevant, so swap-and-pop keeps removal O(1)
+            *it = list.back();
+            list.pop_back();
+        }
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,547 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "equipment_tracker/replication.h"
+#include "equipment_tracker/utils/socket_io.h"
+#include "equipment_tracker/utils/time_utils.h"
+
+namespace equipment_tracker
+{
+
+    ReplicationPrimary::ReplicationPrimary(DataStorage &storage, std::string standby_address,
+                                           uint16_t standby_port, ReplicationCommitMode mode)
+        : storage_(storage), address_(std::move(standby_address)), port_(standby_port), mode_(mode)
+    {
+    }
+
+    ReplicationPrimary::~ReplicationPrimary()
+    {
+        stop();
+    }
+
+    bool ReplicationPrimary::start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (running_)
+        {
+            return true;
+        }
+        if (!storage_.initialize())
+        {
+            std::cerr << "Replication could not initialize the primary's storage." << std::endl;
+            return false;
+        }
+
+        // Resume from the last acknowledgement until the standby says otherwise
+        acked_lsn_ = storage_.getChangeFeed().getOffset(REPLICATION_CONSUMER);
+        shipped_lsn_ = acked_lsn_;
+        fenced_ = false;
+        running_ = true;
+        storage_.getChangeFeed().setCommitHook(
+            [this](uint64_t lsn)
+            {
+                onCommit(lsn);
+            });
+        shipper_ = std::thread(&ReplicationPrimary::shipLoop, this);
+        return true;
+    }
+
+    void ReplicationPrimary::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+            {
+                return;
+            }
+            running_ = false;
+            if (fd_ >= 0)
+            {
+                shutdownSocket(fd_);
+            }
+        }
+        acked_changed_.notify_all();
+
+        storage_.getChangeFeed().setCommitHook(nullptr);
+        if (shipper_.joinable())
+        {
+            shipper_.join();
+        }
+    }
+
+    bool ReplicationPrimary::waitForAck(uint64_t lsn, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        acked_changed_.wait_for(lock, timeout,
+                                [this, lsn]
+                                {
+                                    return acked_lsn_ >= lsn || fenced_ || !running_;
+                                });
+        return acked_lsn_ >= lsn;
+    }
+
+    ReplicationStatus ReplicationPrimary::getStatus() const
+    {
+        ReplicationStatus status;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            status.connected = connected_;
+            status.fenced = fenced_;
+            status.shipped_lsn = shipped_lsn_;
+            status.acked_lsn = acked_lsn_;
+            status.batches_shipped = batches_shipped_;
+        }
+
+        ChangeFeed &feed = storage_.getChangeFeed();
+        status.latest_lsn = feed.getLatestLsn();
+        if (status.latest_lsn > status.acked_lsn)
+        {
+            status.lag_records = status.latest_lsn - status.acked_lsn;
+            auto oldest = feed.read(status.acked_lsn, 1);
+            if (!oldest.empty())
+            {
+                status.lag = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    getCurrentTimestamp() - oldest.front().committed_at);
+            }
+        }
+        return status;
+    }
+
+    void ReplicationPrimary::shipLoop()
+    {
+        ChangeFeed &feed = storage_.getChangeFeed();
+        std::string buffer;
+        int fd = -1;
+
+        auto disconnect = [this, &fd]
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (fd >= 0)
+            {
+                closeSocket(fd);
+            }
+            fd = -1;
+            fd_ = -1;
+            connected_ = false;
+        };
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!running_ || fenced_)
+                {
+                    break;
+                }
+            }
+
+            if (fd < 0)
+            {
+                fd = connectTcp(address_, port_, CLUSTER_REQUEST_TIMEOUT_MS);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    fd_ = fd;
+                    if (!running_ && fd >= 0)
+                    {
+                        shutdownSocket(fd);
+                    }
+                }
+                buffer.clear();
+                if (fd < 0 || !handshake(fd, buffer))
+                {
+                    disconnect();
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    acked_changed_.wait_for(lock, std::chrono::milliseconds(REPLICATION_RETRY_INTERVAL_MS),
+                                            [this]
+                                            {
+                                                return !running_ || fenced_;
+                                            });
+                    continue;
+                }
+            }
+
+            uint64_t from;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                from = acked_lsn_;
+            }
+
+            // Everything committed since the last acknowledgement goes in one batch
+            auto records = feed.read(from, REPLICATION_BATCH_SIZE);
+            if (records.empty())
+            {
+                feed.waitForChanges(from, std::chrono::milliseconds(REPLICATION_RETRY_INTERVAL_MS));
+                continue;
+            }
+
+            std::string batch = "BATCH";
+            for (const auto &record : records)
+            {
+                batch += '\n';
+                batch += ChangeFeed::encode(record);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                shipped_lsn_ = records.back().lsn;
+            }
+
+            std::string response;
+            if (!writeFrame(fd, batch) || !readFrame(fd, buffer, response, REPLICATION_MAX_FRAME_SIZE))
+            {
+                disconnect();
+                continue;
+            }
+            if (response == "ERR promoted")
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::cerr << "Standby " << address_ << ":" << port_ << " was promoted; replication stopped."
+                          << std::endl;
+                fenced_ = true;
+                acked_changed_.notify_all();
+                break;
+            }
+            if (response.compare(0, 4, "ACK ") != 0)
+            {
+                std::cerr << "Standby rejected a replication batch: " << response << std::endl;
+                disconnect();
+                continue;
+            }
+
+            // Counted before the ack is published, so a woken waiter sees it
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++batches_shipped_;
+            }
+            setAcked(std::strtoull(response.c_str() + 4, nullptr, 10));
+        }
+
+        disconnect();
+    }
+
+    bool ReplicationPrimary::handshake(int fd, std::string &buffer)
+    {
+        std::string response;
+        if (!writeFrame(fd, "HELLO") || !readFrame(fd, buffer, response, REPLICATION_MAX_FRAME_SIZE))
+        {
+            return false;
+        }
+        if (response == "ERR promoted")
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fenced_ = true;
+            acked_changed_.notify_all();
+            return false;
+        }
+        if (response.compare(0, 3, "OK ") != 0)
+        {
+            return false;
+        }
+
+        // The standby's applied LSN wins, even when it went backwards
+        setAcked(std::strtoull(response.c_str() + 3, nullptr, 10));
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = true;
+        shipped_lsn_ = acked_lsn_;
+        return true;
+    }
+
+    void ReplicationPrimary::onCommit(uint64_t lsn)
+    {
+        if (mode_ != ReplicationCommitMode::Sync)
+        {
+            return;
+        }
+        if (!waitForAck(lsn, std::chrono::milliseconds(REPLICATION_SYNC_TIMEOUT_MS)))
+        {
+            std::cerr << "Standby did not acknowledge change " << lsn << " in time." << std::endl;
+        }
+    }
+
+    void ReplicationPrimary::setAcked(uint64_t lsn)
+    {
+        // Commit the offset before publishing the ack, so a waiter never sees
+        // an acknowledged LSN that a restart would ship again
+        storage_.getChangeFeed().commitOffset(REPLICATION_CONSUMER, lsn);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            acked_lsn_ = lsn;
+        }
+        acked_changed_.notify_all();
+    }
+
+    ReplicationStandby::ReplicationStandby(std::string db_path, std::string address, uint16_t port)
+        : db_path_(std::move(db_path)), address_(std::move(address)), port_(port),
+          storage_(std::make_unique<DataStorage>(db_path_))
+    {
+    }
+
+    ReplicationStandby::~ReplicationStandby()
+    {
+        stop();
+    }
+
+    bool ReplicationStandby::start()
+    {
+        if (listen_fd_ >= 0)
+        {
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!loadState() || promoted_)
+            {
+                std::cerr << "Standby at " << db_path_ << " has been promoted and cannot replicate." << std::endl;
+                return false;
+            }
+            if (!storage_->initialize())
+            {
+                return false;
+            }
+        }
+
+        int fd = listenTcp(address_, port_);
+        if (fd < 0)
+        {
+            std::cerr << "Standby failed to listen on " << address_ << ":" << port_ << std::endl;
+            return false;
+        }
+        listen_fd_ = fd;
+        accept_thread_ = std::thread(&ReplicationStandby::acceptLoop, this, fd);
+        return true;
+    }
+
+    void ReplicationStandby::stop()
+    {
+        int fd = listen_fd_.exchange(-1);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        shutdownSocket(fd);
+        int connection = connection_fd_.load();
+        if (connection >= 0)
+        {
+            shutdownSocket(connection);
+        }
+        if (accept_thread_.joinable())
+        {
+            accept_thread_.join();
+        }
+        closeSocket(fd);
+    }
+
+    bool ReplicationStandby::promote()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (promoted_)
+        {
+            return true;
+        }
+        if (!loadState())
+        {
+            return false;
+        }
+
+        // Batches are applied under the same lock, so none is half-applied here
+        promoted_ = true;
+        if (storage_)
+        {
+            storage_->flush();
+        }
+        if (!saveState())
+        {
+            promoted_ = false;
+            return false;
+        }
+        storage_.reset();
+        return true;
+    }
+
+    bool ReplicationStandby::isPromoted() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return promoted_;
+    }
+
+    uint64_t ReplicationStandby::getAppliedLsn() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return applied_lsn_;
+    }
+
+    Timestamp ReplicationStandby::getLastAppliedAt() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_applied_at_;
+    }
+
+    std::string ReplicationStandby::handleRequest(const std::string &request)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (promoted_)
+        {
+            return "ERR promoted";
+        }
+        if (request == "HELLO")
+        {
+            return "OK " + std::to_string(applied_lsn_);
+        }
+        if (request.compare(0, 5, "BATCH") != 0)
+        {
+            return "ERR unknown command";
+        }
+
+        // Records at or below the applied LSN are replays; stop at a gap
+        uint64_t applied = applied_lsn_;
+        size_t start = request.find('\n');
+        while (start != std::string::npos)
+        {
+            size_t end = request.find('\n', start + 1);
+            auto record = ChangeFeed::decode(request.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1));
+            start = end;
+            if (!record)
+            {
+                std::cerr << "Standby received a malformed change record." << std::endl;
+                break;
+            }
+            if (record->lsn <= applied)
+            {
+                continue;
+            }
+            if (record->lsn != applied + 1 || !apply(*record))
+            {
+                break;
+            }
+            applied = record->lsn;
+        }
+
+        if (applied != applied_lsn_)
+        {
+            // Durable before acknowledged
+            storage_->flush();
+            uint64_t previous = applied_lsn_;
+            applied_lsn_ = applied;
+            if (!saveState())
+            {
+                applied_lsn_ = previous;
+                return "ERR state not saved";
+            }
+            last_applied_at_ = getCurrentTimestamp();
+        }
+        return "ACK " + std::to_string(applied_lsn_);
+    }
+
+    void ReplicationStandby::acceptLoop(int listen_fd)
+    {
+        for (;;)
+        {
+            int fd = acceptTcp(listen_fd);
+            if (fd < 0)
+            {
+                break;
+            }
+
+            // stop() clears listen_fd_ before it looks at connection_fd_
+            connection_fd_ = fd;
+            if (listen_fd_ < 0)
+            {
+                connection_fd_ = -1;
+                closeSocket(fd);
+                break;
+            }
+
+            std::string buffer;
+            std::string request;
+            while (readFrame(fd, buffer, request, REPLICATION_MAX_FRAME_SIZE))
+            {
+                if (!writeFrame(fd, handleRequest(request)))
+                {
+                    break;
+                }
+            }
+            connection_fd_ = -1;
+            closeSocket(fd);
+        }
+    }
+
+    bool ReplicationStandby::apply(const ChangeRecord &record)
+    {
+        switch (record.type)
+        {
+        case ChangeType::EquipmentSaved:
+        {
+            Equipment equipment(record.equipment_id, record.equipment_type, record.name);
+            equipment.setStatus(record.status);
+            equipment.setUtilization(record.utilization);
+            if (record.position)
+            {
+                equipment.setLastPosition(*record.position);
+            }
+            return storage_->saveEquipment(equipment);
+        }
+        case ChangeType::EquipmentDeleted:
+            // Already gone is as good as deleted
+            storage_->deleteEquipment(record.equipment_id);
+            return true;
+        case ChangeType::PositionSaved:
+            return !record.position || storage_->savePosition(record.equipment_id, *record.position);
+        }
+        return false;
+    }
+
+    bool ReplicationStandby::loadState()
+    {
+        std::ifstream in(statePath());
+        if (!in.is_open())
+        {
+            return true; // Never replicated yet
+        }
+
+        std::string key;
+        uint64_t value = 0;
+        while (in >> key >> value)
+        {
+            if (key == "applied")
+            {
+                applied_lsn_ = value;
+            }
+            else if (key == "promoted")
+            {
+                promoted_ = value != 0;
+            }
+        }
+        return true;
+    }
+
+    bool ReplicationStandby::saveState()
+    {
+        try
+        {
+            std::filesystem::create_directories(db_path_ + "/replication");
+            std::string temporary = statePath() + ".tmp";
+            {
+                std::ofstream out(temporary, std::ios::trunc);
+                out << "applied " << applied_lsn_ << "\npromoted " << (promoted_ ? 1 : 0) << "\n";
+                out.flush();
+                if (!out)
+                {
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporary, statePath());
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Standby failed to save replication state: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+} // namespace equipment_tracker
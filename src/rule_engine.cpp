@@ -0,0 +1,527 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include "equipment_tracker/rule_engine.h"
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr int MINUTES_PER_DAY = 24 * 60;
+
+        std::string toLower(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c)
+                           {
+                               return static_cast<char>(std::tolower(c));
+                           });
+            return text;
+        }
+
+        std::string trim(const std::string &text)
+        {
+            size_t begin = text.find_first_not_of(" \t\r\n");
+            if (begin == std::string::npos)
+            {
+                return "";
+            }
+            size_t end = text.find_last_not_of(" \t\r\n");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        std::optional<EquipmentType> parseType(const std::string &name)
+        {
+            static const std::pair<const char *, EquipmentType> TYPES[] = {
+                {"forklift", EquipmentType::Forklift},
+                {"crane", EquipmentType::Crane},
+                {"bulldozer", EquipmentType::Bulldozer},
+                {"excavator", EquipmentType::Excavator},
+                {"truck", EquipmentType::Truck},
+                {"other", EquipmentType::Other}};
+
+            std::string lower = toLower(name);
+            for (const auto &[text, type] : TYPES)
+            {
+                if (lower == text)
+                {
+                    return type;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // "HH:MM" as minutes after midnight; "24:00" is accepted as a window end
+        std::optional<int> parseTimeOfDay(const std::string &text)
+        {
+            int hours = 0;
+            int minutes = 0;
+            char separator = 0;
+            std::istringstream in(text);
+            if (!(in >> hours >> separator >> minutes) || separator != ':' || in.peek() != EOF)
+            {
+                return std::nullopt;
+            }
+            if (hours < 0 || minutes < 0 || minutes > 59 || hours * 60 + minutes > MINUTES_PER_DAY)
+            {
+                return std::nullopt;
+            }
+            return (hours * 60 + minutes) % MINUTES_PER_DAY;
+        }
+
+        bool inWindow(int minute, int start, int end)
+        {
+            return start < end ? minute >= start && minute < end
+                               : minute >= start || minute < end;
+        }
+    } // namespace
+
+    std::optional<RuleDefinition> parseRule(const std::string &text)
+    {
+        RuleDefinition rule;
+
+        auto fail = [&](const std::string &reason) -> std::optional<RuleDefinition>
+        {
+            std::cerr << "Invalid rule \"" << text << "\": " << reason << std::endl;
+            return std::nullopt;
+        };
+
+        size_t colon = text.find(':');
+        if (colon == std::string::npos || trim(text.substr(0, colon)).empty())
+        {
+            return fail("expected \"<name>: <conditions>\"");
+        }
+        rule.name = trim(text.substr(0, colon));
+
+        std::vector<std::string> tokens;
+        std::istringstream in(text.substr(colon + 1));
+        for (std::string token; in >> token;)
+        {
+            tokens.push_back(token);
+        }
+        if (tokens.empty())
+        {
+            return fail("no conditions");
+        }
+
+        size_t i = 0;
+        auto next = [&]() -> std::string
+        {
+            return i < tokens.size() ? tokens[i++] : std::string();
+        };
+
+        while (i < tokens.size())
+        {
+            if (i > 0 && toLower(next()) != "and")
+            {
+                return fail("expected \"and\" before \"" + tokens[i - 1] + "\"");
+            }
+
+            std::string keyword = toLower(next());
+            if (keyword == "type")
+            {
+                if (toLower(next()) != "is")
+                {
+                    return fail("expected \"type is <type>\"");
+                }
+                std::string name = next();
+                auto type = parseType(name);
+                if (!type || rule.type)
+                {
+                    return fail(rule.type ? "more than one type" : "unknown equipment type \"" + name + "\"");
+                }
+                rule.type = type;
+            }
+            else if (keyword == "in")
+            {
+                std::string name = toLower(next()) == "zone" ? next() : std::string();
+                if (name.empty() || rule.zone)
+                {
+                    return fail(rule.zone ? "more than one zone" : "expected \"in zone <name>\"");
+                }
+                rule.zone = name;
+            }
+            else if (keyword == "speed")
+            {
+                if (next() != ">")
+                {
+                    return fail("expected \"speed > <value>\"");
+                }
+                std::string value = next();
+                char *unit_begin = nullptr;
+                double speed = std::strtod(value.c_str(), &unit_begin);
+                if (unit_begin == value.c_str() || speed < 0.0)
+                {
+                    return fail("invalid speed \"" + value + "\"");
+                }
+
+                // The unit may follow the number directly or as the next token
+                std::string unit = toLower(unit_begin);
+                if (unit.empty() && i < tokens.size() && toLower(tokens[i]) != "and")
+                {
+                    unit = toLower(next());
+                }
+                if (unit.empty() || unit == "km/h" || unit == "kph")
+                {
+                    speed /= 3.6;
+                }
+                else if (unit != "m/s")
+                {
+                    return fail("unknown speed unit \"" + unit + "\"");
+                }
+                rule.min_speed_mps = std::max(rule.min_speed_mps, speed);
+            }
+            else if (keyword == "moving")
+            {
+                rule.min_speed_mps = std::max(rule.min_speed_mps, MOVEMENT_SPEED_THRESHOLD);
+            }
+            else if (keyword == "between")
+            {
+                auto start = parseTimeOfDay(next());
+                bool joined = toLower(next()) == "and";
+                auto end = parseTimeOfDay(next());
+                if (!start || !joined || !end || *start == *end || rule.window)
+                {
+                    return fail(rule.window ? "more than one time window"
+                                            : "expected \"between HH:MM and HH:MM\" with distinct times");
+                }
+                rule.window = RuleTimeWindow{*start, *end};
+            }
+            else
+            {
+                return fail("unknown condition \"" + keyword + "\"");
+            }
+        }
+
+        return rule;
+    }
+
+    std::shared_ptr<const RulePlan> RulePlan::compile(
+        const std::vector<RuleZone> &zones,
+        const std::vector<RuleDefinition> &rules,
+        std::chrono::minutes utc_offset)
+    {
+        auto plan = std::make_shared<RulePlan>();
+        plan->utc_offset_seconds_ = std::chrono::duration_cast<std::chrono::seconds>(utc_offset).count();
+
+        std::unordered_map<std::string, uint32_t> zone_ids;
+        for (const auto &zone : zones)
+        {
+            if (zone.vertices.size() < 3)
+            {
+                std::cerr << "Zone " << zone.name << " needs at least three vertices." << std::endl;
+                return nullptr;
+            }
+            uint32_t id = static_cast<uint32_t>(plan->zones_.size());
+            if (!zone_ids.emplace(zone.name, id).second)
+            {
+                std::cerr << "Zone " << zone.name << " is defined more than once." << std::endl;
+                return nullptr;
+            }
+
+            Zone compiled{zone.vertices, 90.0, -90.0, 180.0, -180.0};
+            for (const auto &[latitude, longitude] : zone.vertices)
+            {
+                compiled.min_latitude = std::min(compiled.min_latitude, latitude);
+                compiled.max_latitude = std::max(compiled.max_latitude, latitude);
+                compiled.min_longitude = std::min(compiled.min_longitude, longitude);
+                compiled.max_longitude = std::max(compiled.max_longitude, longitude);
+            }
+
+            // Register the zone with every grid cell its bounding box touches
+            auto first_row = static_cast<int64_t>(std::floor(compiled.min_latitude / RULE_ZONE_CELL_DEGREES));
+            auto last_row = static_cast<int64_t>(std::floor(compiled.max_latitude / RULE_ZONE_CELL_DEGREES));
+            auto first_column = static_cast<int64_t>(std::floor(compiled.min_longitude / RULE_ZONE_CELL_DEGREES));
+            auto last_column = static_cast<int64_t>(std::floor(compiled.max_longitude / RULE_ZONE_CELL_DEGREES));
+            auto cells = static_cast<uint64_t>(last_row - first_row + 1) * static_cast<uint64_t>(last_column - first_column + 1);
+            if (cells > RULE_ZONE_MAX_CELLS)
+            {
+                plan->large_zones_.push_back(id);
+            }
+            else
+            {
+                for (int64_t row = first_row; row <= last_row; ++row)
+                {
+                    for (int64_t column = first_column; column <= last_column; ++column)
+                    {
+                        plan->zone_cells_[cellKey(row, column)].push_back(id);
+                    }
+                }
+            }
+            plan->zones_.push_back(std::move(compiled));
+        }
+
+        plan->group_index_.assign((plan->zones_.size() + 1) * TYPE_GROUPS, -1);
+        for (const auto &rule : rules)
+        {
+            size_t zone_slot = 0;
+            if (rule.zone)
+            {
+                auto it = zone_ids.find(*rule.zone);
+                if (it == zone_ids.end())
+                {
+                    std::cerr << "Rule " << rule.name << " refers to unknown zone " << *rule.zone << "." << std::endl;
+                    return nullptr;
+                }
+                zone_slot = it->second + 1;
+            }
+
+            if (rule.window &&
+                (rule.window->start_minute < 0 || rule.window->start_minute >= MINUTES_PER_DAY ||
+                 rule.window->end_minute < 0 || rule.window->end_minute >= MINUTES_PER_DAY ||
+                 rule.window->start_minute == rule.window->end_minute))
+            {
+                std::cerr << "Rule " << rule.name << " has an invalid time window." << std::endl;
+                return nullptr;
+            }
+
+            size_t type_slot = rule.type ? static_cast<size_t>(*rule.type) : TYPE_GROUPS - 1;
+            int32_t &group = plan->group_index_[zone_slot * TYPE_GROUPS + type_slot];
+            if (group < 0)
+            {
+                group = static_cast<int32_t>(plan->groups_.size());
+                plan->groups_.emplace_back();
+            }
+
+            auto index = static_cast<uint32_t>(plan->names_.size());
+            plan->names_.push_back(rule.name);
+            Group &target = plan->groups_[group];
+            if (!rule.window)
+            {
+                target.always.push_back(CompiledRule{rule.min_speed_mps, 0, 0, index});
+                continue;
+            }
+
+            // A window is one circular interval, so it overlaps an hour when the
+            // hour starts inside it or it starts inside the hour
+            CompiledRule compiled{rule.min_speed_mps, rule.window->start_minute, rule.window->end_minute, index};
+            for (int hour = 0; hour < 24; ++hour)
+            {
+                if (inWindow(hour * 60, compiled.start_minute, compiled.end_minute) ||
+                    compiled.start_minute / 60 == hour)
+                {
+                    target.hourly[hour].push_back(compiled);
+                }
+            }
+        }
+
+        auto by_speed = [](const CompiledRule &a, const CompiledRule &b)
+        {
+            return a.min_speed_mps < b.min_speed_mps;
+        };
+        for (auto &group : plan->groups_)
+        {
+            std::stable_sort(group.always.begin(), group.always.end(), by_speed);
+            for (auto &hour : group.hourly)
+            {
+                std::stable_sort(hour.begin(), hour.end(), by_speed);
+            }
+        }
+
+        return plan;
+    }
+
+    void RulePlan::match(EquipmentType type, const Position &position, double speed_mps,
+                         std::vector<uint32_t> &matched) const
+    {
+        if (groups_.empty())
+        {
+            return;
+        }
+
+        int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                              position.getTimestamp().time_since_epoch())
+                              .count() +
+                          utc_offset_seconds_;
+        int64_t minutes = seconds >= 0 ? seconds / 60 : (seconds - 59) / 60;
+        int minute = static_cast<int>((minutes % MINUTES_PER_DAY + MINUTES_PER_DAY) % MINUTES_PER_DAY);
+        int hour = minute / 60;
+        size_t type_slot = static_cast<size_t>(type);
+        size_t first = matched.size();
+
+        matchZone(0, type_slot, speed_mps, hour, minute, matched);
+
+        double latitude = position.getLatitude();
+        double longitude = position.getLongitude();
+        auto cell = zone_cells_.find(cellKey(static_cast<int64_t>(std::floor(latitude / RULE_ZONE_CELL_DEGREES)),
+                                             static_cast<int64_t>(std::floor(longitude / RULE_ZONE_CELL_DEGREES))));
+        if (cell != zone_cells_.end())
+        {
+            for (uint32_t zone : cell->second)
+            {
+                if (contains(zones_[zone], latitude, longitude))
+                {
+                    matchZone(zone + 1, type_slot, speed_mps, hour, minute, matched);
+                }
+            }
+        }
+        for (uint32_t zone : large_zones_)
+        {
+            if (contains(zones_[zone], latitude, longitude))
+            {
+                matchZone(zone + 1, type_slot, speed_mps, hour, minute, matched);
+            }
+        }
+
+        std::sort(matched.begin() + first, matched.end());
+    }
+
+    void RulePlan::matchZone(size_t zone_slot, size_t type, double speed_mps, int hour, int minute,
+                             std::vector<uint32_t> &matched) const
+    {
+        for (size_t type_slot : {type, TYPE_GROUPS - 1})
+        {
+            int32_t group = group_index_[zone_slot * TYPE_GROUPS + type_slot];
+            if (group < 0)
+            {
+                continue;
+            }
+
+            for (const auto &rule : groups_[group].always)
+            {
+                if (!(speed_mps > rule.min_speed_mps))
+                {
+                    break;
+                }
+                matched.push_back(rule.rule);
+            }
+            for (const auto &rule : groups_[group].hourly[hour])
+            {
+                if (!(speed_mps > rule.min_speed_mps))
+                {
+                    break;
+                }
+                if (inWindow(minute, rule.start_minute, rule.end_minute))
+                {
+                    matched.push_back(rule.rule);
+                }
+            }
+        }
+    }
+
+    uint64_t RulePlan::cellKey(int64_t row, int64_t column)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) |
+               static_cast<uint32_t>(column);
+    }
+
+    bool RulePlan::contains(const Zone &zone, double latitude, double longitude)
+    {
+        if (latitude < zone.min_latitude || latitude > zone.max_latitude ||
+            longitude < zone.min_longitude || longitude > zone.max_longitude)
+        {
+            return false;
+        }
+
+        // Even-odd ray casting; zones are small enough to treat degrees as planar
+        bool inside = false;
+        const auto &vertices = zone.vertices;
+        for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+        {
+            const auto &[lat_i, lon_i] = vertices[i];
+            const auto &[lat_j, lon_j] = vertices[j];
+            if ((lat_i > latitude) != (lat_j > latitude) &&
+                longitude < (lon_j - lon_i) * (latitude - lat_i) / (lat_j - lat_i) + lon_i)
+            {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    RuleEngine::RuleEngine()
+        : plan_(std::make_shared<RulePlan>())
+    {
+    }
+
+    void RuleEngine::setPlan(std::shared_ptr<const RulePlan> plan)
+    {
+        plan_ = plan ? std::move(plan) : std::make_shared<RulePlan>();
+        for (auto &[id, state] : machines_)
+        {
+            state.active.clear();
+        }
+    }
+
+    std::vector<RuleAlert> RuleEngine::evaluate(const EquipmentId &id, EquipmentType type, const Position &position)
+    {
+        std::vector<RuleAlert> alerts;
+
+        auto [it, inserted] = machines_.try_emplace(id);
+        MachineState &state = it->second;
+        if (!inserted)
+        {
+            if (position.getTimestamp() <= state.last.getTimestamp())
+            {
+                return alerts;
+            }
+            double seconds = std::chrono::duration<double>(position.getTimestamp() - state.last.getTimestamp()).count();
+            state.speed_mps = state.last.distanceTo(position) / seconds;
+        }
+        state.last = position;
+
+        matched_.clear();
+        plan_->match(type, position, state.speed_mps, matched_);
+        if (matched_ == state.active)
+        {
+            return alerts;
+        }
+
+        std::vector<uint32_t> changed;
+        std::set_difference(state.active.begin(), state.active.end(), matched_.begin(), matched_.end(),
+                            std::back_inserter(changed));
+        for (uint32_t rule : changed)
+        {
+            alerts.push_back(RuleAlert{plan_->ruleName(rule), id, RuleAlertType::Cleared, state.speed_mps, position});
+        }
+        changed.clear();
+        std::set_difference(matched_.begin(), matched_.end(), state.active.begin(), state.active.end(),
+                            std::back_inserter(changed));
+        for (uint32_t rule : changed)
+        {
+            alerts.push_back(RuleAlert{plan_->ruleName(rule), id, RuleAlertType::Raised, state.speed_mps, position});
+        }
+
+        state.active.assign(matched_.begin(), matched_.end());
+        return alerts;
+    }
+
+    std::vector<RuleAlert> RuleEngine::remove(const EquipmentId &id)
+    {
+        std::vector<RuleAlert> alerts;
+
+        auto it = machines_.find(id);
+        if (it == machines_.end())
+        {
+            return alerts;
+        }
+
+        const MachineState &state = it->second;
+        for (uint32_t rule : state.active)
+        {
+            alerts.push_back(RuleAlert{plan_->ruleName(rule), id, RuleAlertType::Cleared, state.speed_mps, state.last});
+        }
+        machines_.erase(it);
+        return alerts;
+    }
+
+    std::vector<std::pair<EquipmentId, std::string>> RuleEngine::getActiveAlerts() const
+    {
+        std::vector<std::pair<EquipmentId, std::string>> result;
+        for (const auto &[id, state] : machines_)
+        {
+            for (uint32_t rule : state.active)
+            {
+                result.emplace_back(id, plan_->ruleName(rule));
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,728 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "equipment_tracker/storage_io.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define EQUIPMENT_TRACKER_HAS_IO_URING 1
+#endif
+
+namespace equipment_tracker
+{
+
+    IoBuffer::IoBuffer(size_t size, size_t alignment)
+        : storage_(new char[size + alignment]),
+          size_(size)
+    {
+        void *ptr = storage_.get();
+        size_t space = size + alignment;
+        data_ = static_cast<char *>(std::align(alignment, size, ptr, space));
+    }
+
+    IoBuffer IoBuffer::copyOf(const void *data, size_t size, size_t alignment)
+    {
+        IoBuffer buffer(size, alignment);
+        std::memcpy(buffer.data(), data, size);
+        return buffer;
+    }
+
+    namespace
+    {
+        struct Operation
+        {
+            enum class Kind
+            {
+                Write,
+                Read,
+                Sync
+            };
+
+            Kind kind;
+            int fd;
+            uint64_t offset;
+            IoBuffer buffer;
+            IoCompletion done;
+            size_t transferred{0}; // Bytes moved by earlier partial transfers
+        };
+
+#ifdef _WIN32
+        // The CRT has no positional I/O; workers serialize seek+transfer pairs
+        std::mutex positional_io_mutex;
+#endif
+
+        // Run one operation with blocking calls; returns bytes (or 0) or -errno
+        int64_t performBlocking(Operation &op, uint64_t &syscalls)
+        {
+            if (op.kind == Operation::Kind::Sync)
+            {
+                ++syscalls;
+#ifdef _WIN32
+                return _commit(op.fd) == 0 ? 0 : -errno;
+#elif defined(__APPLE__)
+                return fsync(op.fd) == 0 ? 0 : -errno;
+#else
+                return fdatasync(op.fd) == 0 ? 0 : -errno;
+#endif
+            }
+
+            size_t done = op.transferred;
+            while (done < op.buffer.size())
+            {
+                char *data = op.buffer.data() + done;
+                size_t remaining = op.buffer.size() - done;
+                int64_t offset = static_cast<int64_t>(op.offset + done);
+
+                ++syscalls;
+#ifdef _WIN32
+                int64_t n;
+                {
+                    std::lock_guard<std::mutex> lock(positional_io_mutex);
+                    _lseeki64(op.fd, offset, SEEK_SET);
+                    n = op.kind == Operation::Kind::Write
+                            ? _write(op.fd, data, static_cast<unsigned>(remaining))
+                            : _read(op.fd, data, static_cast<unsigned>(remaining));
+                }
+#else
+                int64_t n = op.kind == Operation::Kind::Write
+                                ? ::pwrite(op.fd, data, remaining, offset)
+                                : ::pread(op.fd, data, remaining, offset);
+#endif
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return -errno;
+                }
+                if (n == 0)
+                {
+                    break; // End of file on a read
+                }
+                done += static_cast<size_t>(n);
+            }
+
+            return static_cast<int64_t>(done);
+        }
+
+        /**
+         * Shared batching, completion accounting and wait() for both backends.
+         * Derived classes decide how a staged operation reaches the kernel.
+         */
+        class QueuedIoBackend : public StorageIoBackend
+        {
+        public:
+            void submitWrite(int fd, IoBuffer buffer, uint64_t offset, IoCompletion done) override
+            {
+                enqueue(new Operation{Operation::Kind::Write, fd, offset, std::move(buffer), std::move(done)});
+            }
+
+            void submitRead(int fd, IoBuffer buffer, uint64_t offset, IoCompletion done) override
+            {
+                enqueue(new Operation{Operation::Kind::Read, fd, offset, std::move(buffer), std::move(done)});
+            }
+
+            void submitSync(int fd, IoCompletion done) override
+            {
+                enqueue(new Operation{Operation::Kind::Sync, fd, 0, IoBuffer(), std::move(done)});
+            }
+
+            void submit() override
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                submitStagedLocked(lock);
+            }
+
+            void wait() override
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                submitStagedLocked(lock);
+                idle_.wait(lock, [this]
+                           { return outstanding_ == 0; });
+            }
+
+            IoStats getStats() const override
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                IoStats stats = stats_;
+                stats.syscalls += completion_syscalls_.load(std::memory_order_relaxed);
+                return stats;
+            }
+
+        protected:
+            mutable std::mutex mutex_;
+            IoStats stats_;
+            std::atomic<uint64_t> completion_syscalls_{0};
+
+            // Place one operation where the next flushStaged() will pick it up
+            virtual void stage(Operation *op, std::unique_lock<std::mutex> &lock) = 0;
+
+            // Hand every staged operation over; called with mutex_ held
+            virtual void flushStaged(std::unique_lock<std::mutex> &lock) = 0;
+
+            // Called by derived classes once the kernel or a worker is done
+            void complete(Operation *op, int64_t result)
+            {
+                if (op->done)
+                {
+                    IoResult io_result{result, std::move(op->buffer)};
+                    op->done(io_result);
+                }
+                else if (result < 0)
+                {
+                    std::cerr << "Storage I/O error: " << std::strerror(static_cast<int>(-result)) << std::endl;
+                }
+                delete op;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.operations;
+                if (--outstanding_ == 0)
+                {
+                    idle_.notify_all();
+                }
+            }
+
+        private:
+            std::condition_variable idle_;
+            size_t outstanding_{0};
+            size_t staged_{0};
+            std::chrono::steady_clock::time_point oldest_staged_;
+
+            void enqueue(Operation *op)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                ++outstanding_;
+                stage(op, lock);
+
+                auto now = std::chrono::steady_clock::now();
+                if (staged_++ == 0)
+                {
+                    oldest_staged_ = now;
+                }
+
+                if (staged_ >= IO_SUBMIT_BATCH_SIZE ||
+                    now - oldest_staged_ >= std::chrono::microseconds(IO_SUBMIT_MAX_DELAY_US))
+                {
+                    submitStagedLocked(lock);
+                }
+            }
+
+            void submitStagedLocked(std::unique_lock<std::mutex> &lock)
+            {
+                if (staged_ == 0)
+                {
+                    return;
+                }
+                staged_ = 0;
+                ++stats_.batches;
+                flushStaged(lock);
+            }
+        };
+
+        /**
+         * Portable fallback: staged batches are released to a small pool of
+         * workers that issue blocking pread/pwrite/fdatasync calls.
+         */
+        class ThreadPoolIoBackend : public QueuedIoBackend
+        {
+        public:
+            explicit ThreadPoolIoBackend(size_t worker_threads)
+            {
+#ifdef _WIN32
+                worker_threads = 1; // Seek+transfer pairs are serialized anyway
+#endif
+                for (size_t i = 0; i < std::max<size_t>(1, worker_threads); ++i)
+                {
+                    workers_.emplace_back(&ThreadPoolIoBackend::runWorker, this);
+                }
+            }
+
+            ~ThreadPoolIoBackend() override
+            {
+                wait();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                work_available_.notify_all();
+                for (auto &worker : workers_)
+                {
+                    worker.join();
+                }
+            }
+
+            const char *name() const override { return "thread-pool"; }
+
+        protected:
+            void stage(Operation *op, std::unique_lock<std::mutex> &) override
+            {
+                staged_ops_.push_back(op);
+            }
+
+            void flushStaged(std::unique_lock<std::mutex> &) override
+            {
+                work_.insert(work_.end(), staged_ops_.begin(), staged_ops_.end());
+                staged_ops_.clear();
+                work_available_.notify_all();
+            }
+
+        private:
+            std::vector<Operation *> staged_ops_;
+            std::deque<Operation *> work_;
+            std::condition_variable work_available_;
+            std::vector<std::thread> workers_;
+            bool stopping_{false};
+
+            void runWorker()
+            {
+                while (true)
+                {
+                    Operation *op;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        work_available_.wait(lock, [this]
+                                             { return stopping_ || !work_.empty(); });
+                        if (work_.empty())
+                        {
+                            return;
+                        }
+                        op = work_.front();
+                        work_.pop_front();
+                    }
+
+                    uint64_t syscalls = 0;
+                    int64_t result = performBlocking(*op, syscalls);
+                    completion_syscalls_.fetch_add(syscalls, std::memory_order_relaxed);
+                    complete(op, result);
+                }
+            }
+        };
+
+#ifdef EQUIPMENT_TRACKER_HAS_IO_URING
+
+        int ioUringSetup(unsigned entries, io_uring_params *params)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int ioUringRegister(int fd, unsigned opcode, void *arg, unsigned nr_args)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        /**
+         * io_uring backend driven by raw syscalls (no liburing dependency).
+         * Submitters fill SQEs under the backend mutex and enter the kernel
+         * once per batch; a dedicated thread blocks for completions.
+         */
+        class IoUringBackend : public QueuedIoBackend
+        {
+        public:
+            IoUringBackend() = default;
+
+            ~IoUringBackend() override
+            {
+                if (ring_fd_ < 0)
+                {
+                    return;
+                }
+
+                if (reaper_.joinable())
+                {
+                    wait();
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        // user_data of nullptr tells the completion thread to exit
+                        stage(nullptr, lock);
+                        flushStaged(lock);
+                    }
+                    reaper_.join();
+                }
+
+                if (sqes_)
+                {
+                    munmap(sqes_, sqes_size_);
+                }
+                if (cq_ring_ && cq_ring_ != sq_ring_)
+                {
+                    munmap(cq_ring_, cq_ring_size_);
+                }
+                if (sq_ring_)
+                {
+                    munmap(sq_ring_, sq_ring_size_);
+                }
+                close(ring_fd_);
+            }
+
+            // Set up the rings; false when the kernel refuses or lacks the opcodes we use
+            bool initialize(unsigned entries)
+            {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+
+                ring_fd_ = ioUringSetup(entries, &params);
+                if (ring_fd_ < 0)
+                {
+                    return false;
+                }
+
+                if (!supportsOpcodes())
+                {
+                    return false;
+                }
+
+                sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_mmap)
+                {
+                    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+                }
+
+                sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+                if (sq_ring_ == MAP_FAILED)
+                {
+                    sq_ring_ = nullptr;
+                    return false;
+                }
+
+                cq_ring_ = single_mmap ? sq_ring_
+                                       : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+                if (cq_ring_ == MAP_FAILED)
+                {
+                    cq_ring_ = nullptr;
+                    return false;
+                }
+
+                sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+                void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED)
+                {
+                    return false;
+                }
+                sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+                char *sq = static_cast<char *>(sq_ring_);
+                sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+                sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+                sq_entries_ = params.sq_entries;
+
+                // Slot i of the indirection array always points at SQE i
+                unsigned *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+                for (unsigned i = 0; i < params.sq_entries; ++i)
+                {
+                    array[i] = i;
+                }
+
+                char *cq = static_cast<char *>(cq_ring_);
+                cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+                cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+                cq_entries_ = params.cq_entries;
+
+                local_tail_ = *sq_tail_;
+                reaper_ = std::thread(&IoUringBackend::runReaper, this);
+                return true;
+            }
+
+            const char *name() const override { return "io_uring"; }
+
+        protected:
+            void stage(Operation *op, std::unique_lock<std::mutex> &lock) override
+            {
+                // Never have more requests in flight than the completion ring holds
+                while (true)
+                {
+                    ring_space_.wait(lock, [this]
+                                     { return in_flight_ + unsubmitted_ < cq_entries_; });
+                    if (unsubmitted_ < sq_entries_)
+                    {
+                        break;
+                    }
+                    flushStaged(lock);
+                }
+                fillSqe(op);
+            }
+
+            void flushStaged(std::unique_lock<std::mutex> &lock) override
+            {
+                while (unsubmitted_ > 0)
+                {
+                    int submitted = ioUringEnter(ring_fd_, unsubmitted_, 0, 0);
+                    ++stats_.syscalls;
+
+                    if (submitted < 0)
+                    {
+                        if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                        {
+                            continue;
+                        }
+                        std::cerr << "io_uring submit failed, completing the batch synchronously: "
+                                  << std::strerror(errno) << std::endl;
+                        completeUnsubmitted(lock);
+                        return;
+                    }
+
+                    in_flight_ += static_cast<unsigned>(submitted);
+                    unsubmitted_ -= static_cast<unsigned>(submitted);
+                }
+            }
+
+        private:
+            int ring_fd_{-1};
+            void *sq_ring_{nullptr};
+            void *cq_ring_{nullptr};
+            size_t sq_ring_size_{0};
+            size_t cq_ring_size_{0};
+            io_uring_sqe *sqes_{nullptr};
+            size_t sqes_size_{0};
+
+            unsigned *sq_tail_{nullptr};
+            unsigned sq_mask_{0};
+            unsigned sq_entries_{0};
+            unsigned *cq_head_{nullptr};
+            unsigned *cq_tail_{nullptr};
+            unsigned cq_mask_{0};
+            unsigned cq_entries_{0};
+            io_uring_cqe *cqes_{nullptr};
+
+            // Guarded by mutex_
+            unsigned local_tail_{0};
+            unsigned unsubmitted_{0};
+            unsigned in_flight_{0};
+            std::condition_variable ring_space_;
+
+            std::thread reaper_;
+
+            // Queue one operation, or the reaper's stop marker, in the next free
+            // SQE; called with mutex_ held and space reserved in both rings
+            void fillSqe(Operation *op)
+            {
+                io_uring_sqe &sqe = sqes_[local_tail_ & sq_mask_];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.user_data = reinterpret_cast<uint64_t>(op);
+
+                if (!op)
+                {
+                    sqe.opcode = IORING_OP_NOP;
+                }
+                else if (op->kind == Operation::Kind::Sync)
+                {
+                    sqe.opcode = IORING_OP_FSYNC;
+                    sqe.fd = op->fd;
+                    sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+                }
+                else
+                {
+                    // A retried partial transfer continues where the kernel stopped
+                    sqe.opcode = op->kind == Operation::Kind::Write ? IORING_OP_WRITE : IORING_OP_READ;
+                    sqe.fd = op->fd;
+                    sqe.addr = reinterpret_cast<uint64_t>(op->buffer.data() + op->transferred);
+                    sqe.len = static_cast<uint32_t>(op->buffer.size() - op->transferred);
+                    sqe.off = op->offset + op->transferred;
+                }
+
+                ++local_tail_;
+                ++unsubmitted_;
+                __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+            }
+
+            // The kernel refused the staged SQEs outright, so none of them was
+            // consumed: take them back off the ring and run their operations with
+            // blocking calls, so every completion still fires and wait() returns
+            void completeUnsubmitted(std::unique_lock<std::mutex> &lock)
+            {
+                std::vector<Operation *> ops;
+                for (unsigned i = unsubmitted_; i > 0; --i)
+                {
+                    ops.push_back(reinterpret_cast<Operation *>(sqes_[(local_tail_ - i) & sq_mask_].user_data));
+                }
+                local_tail_ -= unsubmitted_;
+                unsubmitted_ = 0;
+                __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+                ring_space_.notify_all();
+
+                lock.unlock();
+                for (Operation *op : ops)
+                {
+                    if (!op)
+                    {
+                        continue; // Stop marker; there is no operation to run
+                    }
+                    uint64_t syscalls = 0;
+                    int64_t result = performBlocking(*op, syscalls);
+                    completion_syscalls_.fetch_add(syscalls, std::memory_order_relaxed);
+                    complete(op, result);
+                }
+                lock.lock();
+            }
+
+            // True when a read or write should go back to the kernel for the
+            // rest of its buffer; result becomes the total for a finished one
+            static bool continueTransfer(Operation &op, int64_t &result)
+            {
+                if (op.kind == Operation::Kind::Sync)
+                {
+                    return false;
+                }
+                if (result == -EINTR || result == -EAGAIN)
+                {
+                    return true;
+                }
+                if (result < 0)
+                {
+                    return false;
+                }
+
+                // Zero bytes means end of file on a read; report what arrived
+                bool progressed = result > 0;
+                op.transferred += static_cast<size_t>(result);
+                result = static_cast<int64_t>(op.transferred);
+                return progressed && op.transferred < op.buffer.size();
+            }
+
+            bool supportsOpcodes()
+            {
+                constexpr unsigned PROBE_OPS = 64;
+                std::vector<char> storage(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op));
+                auto *probe = reinterpret_cast<io_uring_probe *>(storage.data());
+
+                if (ioUringRegister(ring_fd_, IORING_REGISTER_PROBE, probe, PROBE_OPS) < 0)
+                {
+                    return false;
+                }
+
+                for (unsigned opcode : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_NOP})
+                {
+                    if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void runReaper()
+            {
+                while (true)
+                {
+                    unsigned head = __atomic_load_n(cq_head_, __ATOMIC_RELAXED);
+                    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+                    if (head == tail)
+                    {
+                        completion_syscalls_.fetch_add(1, std::memory_order_relaxed);
+                        if (ioUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                        {
+                            std::cerr << "io_uring wait failed: " << std::strerror(errno) << std::endl;
+                            return;
+                        }
+                        continue;
+                    }
+
+                    bool stop = false;
+                    unsigned reaped = 0;
+                    std::vector<Operation *> retries;
+                    for (; head != tail; ++head, ++reaped)
+                    {
+                        const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+                        auto *op = reinterpret_cast<Operation *>(cqe.user_data);
+                        int64_t result = cqe.res;
+
+                        // Release the slot before running the completion
+                        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+
+                        if (!op)
+                        {
+                            stop = true;
+                            continue;
+                        }
+                        if (continueTransfer(*op, result))
+                        {
+                            retries.push_back(op);
+                            continue;
+                        }
+                        complete(op, result);
+                    }
+
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        in_flight_ -= reaped - static_cast<unsigned>(retries.size());
+
+                        // Retries keep the ring space they already held
+                        for (Operation *op : retries)
+                        {
+                            while (unsubmitted_ == sq_entries_)
+                            {
+                                flushStaged(lock);
+                            }
+                            --in_flight_;
+                            fillSqe(op);
+                        }
+                        if (!retries.empty())
+                        {
+                            flushStaged(lock);
+                        }
+                    }
+                    ring_space_.notify_all();
+
+                    if (stop)
+                    {
+                        return;
+                    }
+                }
+            }
+        };
+
+#endif // EQUIPMENT_TRACKER_HAS_IO_URING
+
+    } // namespace
+
+    std::unique_ptr<StorageIoBackend> createStorageIoBackend(IoBackendType type, size_t worker_threads)
+    {
+#ifdef EQUIPMENT_TRACKER_HAS_IO_URING
+        if (type != IoBackendType::ThreadPool)
+        {
+            auto backend = std::make_unique<IoUringBackend>();
+            if (backend->initialize(IO_URING_QUEUE_DEPTH))
+            {
+                return backend;
+            }
+        }
+#endif
+
+        if (type == IoBackendType::IoUring)
+        {
+            return nullptr;
+        }
+
+        return std::make_unique<ThreadPoolIoBackend>(worker_threads);
+    }
+
+} // namespace equipment_tracker
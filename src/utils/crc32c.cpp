@@ -0,0 +1,189 @@
+#include "equipment_tracker/utils/crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EQUIPMENT_TRACKER_CRC32C_SSE42 1
+#include <cpuid.h>
+#include <nmmintrin.h>
+#elif defined(_M_X64) && defined(_MSC_VER)
+#define EQUIPMENT_TRACKER_CRC32C_SSE42 1
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define EQUIPMENT_TRACKER_CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+namespace equipment_tracker
+{
+
+    namespace
+    {
+        constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78; // Reflected Castagnoli
+
+        // Slicing-by-8: eight bytes per step through eight 256-entry tables
+        struct Crc32cTables
+        {
+            uint32_t table[8][256];
+
+            Crc32cTables()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1)));
+                    }
+                    table[0][i] = crc;
+                }
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    for (int slice = 1; slice < 8; ++slice)
+                    {
+                        uint32_t previous = table[slice - 1][i];
+                        table[slice][i] = (previous >> 8) ^ table[0][previous & 0xFF];
+                    }
+                }
+            }
+        };
+
+        const Crc32cTables &tables()
+        {
+            static const Crc32cTables instance;
+            return instance;
+        }
+
+        // The raw functions work on the inverted register; callers invert around them
+        uint32_t updateSoftware(uint32_t crc, const unsigned char *p, size_t size)
+        {
+            const auto &t = tables().table;
+
+            while (size >= 8)
+            {
+                uint32_t low;
+                uint32_t high;
+                std::memcpy(&low, p, 4);
+                std::memcpy(&high, p + 4, 4);
+                low ^= crc;
+                crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^
+                      t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                      t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^
+                      t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+                p += 8;
+                size -= 8;
+            }
+
+            while (size-- > 0)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+            }
+            return crc;
+        }
+
+#if defined(EQUIPMENT_TRACKER_CRC32C_SSE42)
+#if !defined(_MSC_VER)
+        __attribute__((target("sse4.2")))
+#endif
+        uint32_t updateHardware(uint32_t crc, const unsigned char *p, size_t size)
+        {
+            uint64_t crc64 = crc;
+            while (size >= 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, p, 8);
+                crc64 = _mm_crc32_u64(crc64, word);
+                p += 8;
+                size -= 8;
+            }
+
+            crc = static_cast<uint32_t>(crc64);
+            while (size-- > 0)
+            {
+                crc = _mm_crc32_u8(crc, *p++);
+            }
+            return crc;
+        }
+
+        bool detectHardware()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[2] & (1 << 20)) != 0;
+#else
+            unsigned int eax, ebx, ecx, edx;
+            return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2) != 0;
+#endif
+        }
+
+        constexpr const char *HARDWARE_NAME = "sse4.2";
+#elif defined(EQUIPMENT_TRACKER_CRC32C_ARMV8)
+        uint32_t updateHardware(uint32_t crc, const unsigned char *p, size_t size)
+        {
+            while (size >= 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, p, 8);
+                crc = __crc32cd(crc, word);
+                p += 8;
+                size -= 8;
+            }
+
+            while (size-- > 0)
+            {
+                crc = __crc32cb(crc, *p++);
+            }
+            return crc;
+        }
+
+        // Compiled for a CPU that has the extension
+        bool detectHardware() { return true; }
+
+        constexpr const char *HARDWARE_NAME = "armv8";
+#else
+        uint32_t updateHardware(uint32_t crc, const unsigned char *p, size_t size)
+        {
+            return updateSoftware(crc, p, size);
+        }
+
+        bool detectHardware() { return false; }
+
+        constexpr const char *HARDWARE_NAME = "table";
+#endif
+
+        using UpdateFunction = uint32_t (*)(uint32_t, const unsigned char *, size_t);
+
+        UpdateFunction selectUpdate()
+        {
+            static const UpdateFunction update = detectHardware() ? updateHardware : updateSoftware;
+            return update;
+        }
+    } // namespace
+
+    uint32_t crc32c(const void *data, size_t size)
+    {
+        return crc32cExtend(0, data, size);
+    }
+
+    uint32_t crc32cExtend(uint32_t crc, const void *data, size_t size)
+    {
+        return ~selectUpdate()(~crc, static_cast<const unsigned char *>(data), size);
+    }
+
+    uint32_t crc32cExtendSoftware(uint32_t crc, const void *data, size_t size)
+    {
+        return ~updateSoftware(~crc, static_cast<const unsigned char *>(data), size);
+    }
+
+    bool crc32cIsHardwareAccelerated()
+    {
+        return selectUpdate() != updateSoftware;
+    }
+
+    const char *crc32cImplementation()
+    {
+        return crc32cIsHardwareAccelerated() ? HARDWARE_NAME : "table";
+    }
+
+} // namespace equipment_tracker
@@ -0,0 +1,189 @@
+#include "equipment_tracker/utils/socket_io.h"
+#include <cerrno>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace equipment_tracker
+{
+
+#ifndef _WIN32
+    namespace
+    {
+        void setNoDelay(int fd)
+        {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        bool sendAll(int fd, const std::string &data)
+        {
+            size_t sent = 0;
+            while (sent < data.size())
+            {
+                ssize_t result = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (result < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (result <= 0)
+                {
+                    return false;
+                }
+                sent += static_cast<size_t>(result);
+            }
+            return true;
+        }
+    } // namespace
+
+    int listenTcp(const std::string &address, uint16_t &port)
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+        {
+            return -1;
+        }
+
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+
+        socklen_t length = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &length);
+        port = ntohs(addr.sin_port);
+        return fd;
+    }
+
+    int connectTcp(const std::string &address, uint16_t port, int timeout_ms)
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+        {
+            return -1;
+        }
+
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+
+        timeval timeout{};
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_usec = (timeout_ms % 1000) * 1000;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        setNoDelay(fd);
+        return fd;
+    }
+
+    int acceptTcp(int listen_fd)
+    {
+        for (;;)
+        {
+            int fd = ::accept(listen_fd, nullptr, nullptr);
+            if (fd >= 0)
+            {
+                setNoDelay(fd);
+                return fd;
+            }
+            if (errno != EINTR)
+            {
+                return -1;
+            }
+        }
+    }
+
+    void shutdownSocket(int fd)
+    {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+
+    void closeSocket(int fd)
+    {
+        ::close(fd);
+    }
+
+    bool writeFrame(int fd, const std::string &body)
+    {
+        return sendAll(fd, std::to_string(body.size()) + "\n" + body);
+    }
+
+    bool readFrame(int fd, std::string &buffer, std::string &body, size_t max_size)
+    {
+        char chunk[16384];
+        for (;;)
+        {
+            size_t newline = buffer.find('\n');
+            if (newline != std::string::npos)
+            {
+                if (newline == 0 || newline > 10 ||
+                    buffer.find_first_not_of("0123456789") < newline)
+                {
+                    return false;
+                }
+                size_t length = std::strtoull(buffer.c_str(), nullptr, 10);
+                if (length > max_size)
+                {
+                    return false;
+                }
+                if (buffer.size() >= newline + 1 + length)
+                {
+                    body = buffer.substr(newline + 1, length);
+                    buffer.erase(0, newline + 1 + length);
+                    return true;
+                }
+            }
+            else if (buffer.size() > 10)
+            {
+                return false;
+            }
+
+            ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(received));
+        }
+    }
+#else
+    int listenTcp(const std::string &, uint16_t &) { return -1; }
+    int connectTcp(const std::string &, uint16_t, int) { return -1; }
+    int acceptTcp(int) { return -1; }
+    void shutdownSocket(int) {}
+    void closeSocket(int) {}
+    bool writeFrame(int, const std::string &) { return false; }
+    bool readFrame(int, std::string &, std::string &, size_t) { return false; }
+#endif
+
+} // namespace equipment_tracker
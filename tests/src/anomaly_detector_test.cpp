@@ -0,0 +1,162 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "equipment_tracker/anomaly_detector.h"
+
+namespace equipment_tracker {
+
+namespace {
+
+// Monday 00:00 UTC
+const Timestamp MONDAY = std::chrono::system_clock::from_time_t(1699833600);
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * A loader that drives laps of a 330 m circle at about 3 m/s from 08:00 to
+ * 17:00 on weekdays, reporting every 10 s, and stands still otherwise,
+ * reporting every 10 minutes
+ */
+class Routine {
+public:
+    explicit Routine(AnomalyDetector& detector) : detector_(detector) {}
+
+    std::vector<AnomalyEvent> runDays(int days) {
+        std::vector<AnomalyEvent> events;
+        for (int day = 0; day < days; ++day, ++day_) {
+            Timestamp midnight = MONDAY + std::chrono::hours(24 * day_);
+            bool weekday = day_ % 7 < 5;
+            for (int second = 0; second < 24 * 3600;) {
+                bool working = weekday && second >= 8 * 3600 && second < 17 * 3600;
+                if (working) {
+                    double speed = 3.0 + 0.5 * std::sin(step_ * 0.1);
+                    angle_ += speed * 10.0 / RADIUS_METERS;
+                    ++step_;
+                }
+                auto found = detector_.observe("LOADER", here(midnight + std::chrono::seconds(second)));
+                events.insert(events.end(), found.begin(), found.end());
+                second += working ? 10 : 600;
+            }
+        }
+        return events;
+    }
+
+    Position here(Timestamp at) const {
+        double radius_degrees = RADIUS_METERS / 111195.0;
+        return Position(37.0 + radius_degrees * std::sin(angle_),
+                        -122.0 + radius_degrees * std::cos(angle_) / std::cos(37.0 * PI / 180.0), 0.0, 2.0, at);
+    }
+
+    Timestamp dayStart() const { return MONDAY + std::chrono::hours(24 * day_); }
+
+private:
+    static constexpr double RADIUS_METERS = 330.0;
+    AnomalyDetector& detector_;
+    int day_{0};
+    long step_{0};
+    double angle_{0.0};
+};
+
+size_t countOf(const std::vector<AnomalyEvent>& events, AnomalyType type) {
+    size_t count = 0;
+    for (const auto& event : events) {
+        count += event.type == type;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(AnomalyDetectorTest, RoutineOperationIsLearnedAndQuiet) {
+    AnomalyDetector detector;
+    Routine routine(detector);
+    routine.runDays(14);
+
+    auto baseline = detector.getBaseline("LOADER");
+    ASSERT_TRUE(baseline.has_value());
+    EXPECT_NEAR(3.0, baseline->mean_speed_mps, 0.2);
+    EXPECT_LT(baseline->speed_deviation_mps, 1.0);
+    EXPECT_GT(baseline->moving_samples, 30000u);
+    EXPECT_GE(baseline->known_cells, 2u);
+    EXPECT_EQ(MONDAY, baseline->first_seen);
+
+    // A third week of the same work raises nothing
+    EXPECT_TRUE(routine.runDays(7).empty());
+}
+
+TEST(AnomalyDetectorTest, NightTheftIsFlaggedOncePerType) {
+    AnomalyDetector detector;
+    Routine routine(detector);
+    routine.runDays(13); // Through Saturday of the second week
+
+    // Sunday 02:00: driven north off the site at 8 m/s for 10 minutes
+    Timestamp start = routine.dayStart() + std::chrono::hours(2);
+    Position parked = routine.here(start);
+    std::vector<AnomalyEvent> events = detector.observe("LOADER", parked);
+    for (int i = 1; i <= 60; ++i) {
+        Position fix(parked.getLatitude() + i * 80.0 / 111195.0, parked.getLongitude(), 0.0, 2.0,
+                     start + std::chrono::seconds(10 * i));
+        auto found = detector.observe("LOADER", fix);
+        events.insert(events.end(), found.begin(), found.end());
+    }
+
+    EXPECT_EQ(1u, countOf(events, AnomalyType::OffHoursMovement));
+    EXPECT_EQ(1u, countOf(events, AnomalyType::LeftOperatingArea));
+    EXPECT_EQ(1u, countOf(events, AnomalyType::UnusualSpeed));
+    EXPECT_EQ(0u, countOf(events, AnomalyType::Teleport));
+    for (const auto& event : events) {
+        EXPECT_EQ("LOADER", event.equipment_id);
+        EXPECT_NEAR(8.0, event.speed_mps, 0.1);
+    }
+
+    // Speed and hour are judged on the first fix, the area once it is left behind
+    EXPECT_EQ(start + std::chrono::seconds(10), events.front().position.getTimestamp());
+    EXPECT_EQ(AnomalyType::LeftOperatingArea, events.back().type);
+    EXPECT_GT(events.back().position.getTimestamp(), start + std::chrono::minutes(1));
+}
+
+TEST(AnomalyDetectorTest, TeleportsAreFlaggedWithoutWarmup) {
+    AnomalyDetector detector;
+    Timestamp start = MONDAY + std::chrono::hours(9);
+    EXPECT_TRUE(detector.observe("T-1", Position(37.0, -122.0, 0.0, 2.0, start)).empty());
+
+    // 50 km in 10 s, and straight back
+    auto events = detector.observe("T-1", Position(37.45, -122.0, 0.0, 2.0, start + std::chrono::seconds(10)));
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(AnomalyType::Teleport, events[0].type);
+    EXPECT_NEAR(50000.0, events[0].distance_meters, 100.0);
+    EXPECT_TRUE(detector.observe("T-1", Position(37.0, -122.0, 0.0, 2.0, start + std::chrono::seconds(20))).empty());
+
+    // Short GPS jumps and stale fixes are ignored
+    EXPECT_TRUE(detector.observe("T-1", Position(37.0005, -122.0, 0.0, 2.0, start + std::chrono::milliseconds(20100))).empty());
+    EXPECT_TRUE(detector.observe("T-1", Position(38.0, -122.0, 0.0, 2.0, start)).empty());
+
+    // Neither jump taught it anything about speed
+    EXPECT_EQ(0u, detector.getBaseline("T-1")->moving_samples);
+}
+
+TEST(AnomalyDetectorTest, BaselinesStayBoundedPerMachine) {
+    AnomalyDetector detector;
+    Timestamp start = MONDAY + std::chrono::hours(9);
+
+    // A truck touring a 50 x 50 km region visits thousands of cells
+    for (int i = 0; i < 20000; ++i) {
+        double latitude = 37.0 + (i % 100) * 0.005;
+        double longitude = -122.0 + (i / 100) * 0.0025;
+        detector.observe("TOURING", Position(latitude, longitude, 0.0, 2.0, start + std::chrono::seconds(60 * i)));
+    }
+    auto baseline = detector.getBaseline("TOURING");
+    ASSERT_TRUE(baseline.has_value());
+    EXPECT_EQ(20000u, baseline->samples);
+    EXPECT_LE(baseline->known_cells, ANOMALY_AREA_CELLS);
+
+    EXPECT_EQ(1u, detector.size());
+    detector.remove("TOURING");
+    EXPECT_EQ(0u, detector.size());
+    EXPECT_FALSE(detector.getBaseline("TOURING").has_value());
+}
+
+} // namespace equipment_tracker
+// </test_code>
@@ -0,0 +1,207 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "equipment_tracker/arrow_export.h"
+
+namespace equipment_tracker {
+
+namespace {
+
+template <typename T>
+T readValue(const char* at) {
+    T value;
+    std::memcpy(&value, at, sizeof(T));
+    return value;
+}
+
+// Just enough Flatbuffers to follow the Arrow metadata
+struct FlatTable {
+    const char* table;
+
+    static FlatTable root(const char* buffer) {
+        return {buffer + readValue<uint32_t>(buffer)};
+    }
+
+    const char* field(int id) const {
+        const char* vtable = table - readValue<int32_t>(table);
+        if (4 + 2 * id >= readValue<uint16_t>(vtable)) {
+            return nullptr;
+        }
+        uint16_t offset = readValue<uint16_t>(vtable + 4 + 2 * id);
+        return offset ? table + offset : nullptr;
+    }
+
+    template <typename T>
+    T scalar(int id) const {
+        const char* at = field(id);
+        return at ? readValue<T>(at) : T();
+    }
+
+    const char* indirect(int id) const {
+        const char* at = field(id);
+        return at + readValue<uint32_t>(at);
+    }
+};
+
+struct IpcMessage {
+    uint8_t header_type;
+    int64_t rows;
+    const char* body;
+    std::vector<std::pair<int64_t, int64_t>> buffers; // offset, length
+};
+
+// Encapsulated messages from `at` up to the end-of-stream marker
+std::vector<IpcMessage> readMessages(const std::string& bytes, size_t at) {
+    std::vector<IpcMessage> messages;
+    while (at + 8 <= bytes.size() && readValue<uint32_t>(&bytes[at]) == 0xFFFFFFFF) {
+        int32_t length = readValue<int32_t>(&bytes[at + 4]);
+        if (length == 0) {
+            break;
+        }
+        FlatTable message = FlatTable::root(&bytes[at + 8]);
+        IpcMessage parsed{message.scalar<uint8_t>(1), 0, &bytes[at + 8 + length], {}};
+        if (parsed.header_type == 3) {
+            FlatTable batch{message.indirect(2)};
+            parsed.rows = batch.scalar<int64_t>(0);
+            const char* buffers = batch.indirect(2);
+            for (uint32_t i = 0; i < readValue<uint32_t>(buffers); ++i) {
+                parsed.buffers.emplace_back(readValue<int64_t>(buffers + 4 + 16 * i),
+                                            readValue<int64_t>(buffers + 12 + 16 * i));
+            }
+        }
+        messages.push_back(parsed);
+        at += 8 + length + message.scalar<int64_t>(3);
+    }
+    return messages;
+}
+
+} // namespace
+
+class ArrowExportTest : public ::testing::Test {
+protected:
+    std::string test_db_path;
+    std::unique_ptr<DataStorage> storage;
+    int64_t base_ns = 1700000000123456789LL;
+
+    void SetUp() override {
+        test_db_path = "arrow_export_test_" + std::to_string(::getpid()) + "_" +
+                       std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+        storage = std::make_unique<DataStorage>(test_db_path);
+        ASSERT_TRUE(storage->initialize());
+    }
+
+    void TearDown() override {
+        storage.reset();
+        std::filesystem::remove_all(test_db_path);
+    }
+
+    void record(const EquipmentId& id, int count) {
+        storage->saveEquipment(Equipment(id, EquipmentType::Truck, "Truck"));
+        for (int i = 0; i < count; ++i) {
+            storage->savePosition(id, Position(37.0 + i * 0.001, -122.0, 10.0 + i, 2.5,
+                                               Timestamp(std::chrono::nanoseconds(base_ns + i * 1000000000LL))));
+        }
+    }
+
+    std::string exportAs(ArrowIpcFormat format, size_t threads, size_t batch_rows,
+                         const std::vector<EquipmentId>& ids) {
+        std::ostringstream out;
+        ArrowExporter exporter(*storage, threads, batch_rows);
+        EXPECT_TRUE(exporter.exportHistory(ids, format, out));
+        EXPECT_EQ(out.str().size(), exporter.getStats().bytes);
+        return out.str();
+    }
+};
+
+TEST_F(ArrowExportTest, WritesAFileWithOneBatchSeriesPerMachine) {
+    record("T-1", 40);
+    record("T-2", 5);
+
+    std::ostringstream out;
+    ArrowExporter exporter(*storage, 2, 16);
+    ASSERT_TRUE(exporter.exportHistory({"T-1", "missing", "T-2"}, ArrowIpcFormat::File, out));
+    EXPECT_EQ(2u, exporter.getStats().equipment);
+    EXPECT_EQ(45u, exporter.getStats().rows);
+    EXPECT_EQ(4u, exporter.getStats().batches);
+
+    std::string bytes = out.str();
+    ASSERT_GT(bytes.size(), 20u);
+    EXPECT_EQ(0, std::memcmp(bytes.data(), "ARROW1\0\0", 8));
+    EXPECT_EQ("ARROW1", bytes.substr(bytes.size() - 6));
+    int32_t footer_length = readValue<int32_t>(&bytes[bytes.size() - 10]);
+    EXPECT_LT(static_cast<size_t>(footer_length), bytes.size());
+
+    auto messages = readMessages(bytes, 8);
+    ASSERT_EQ(5u, messages.size());
+    EXPECT_EQ(1, messages[0].header_type);
+    std::vector<int64_t> rows;
+    for (size_t i = 1; i < messages.size(); ++i) {
+        EXPECT_EQ(3, messages[i].header_type);
+        EXPECT_EQ(13u, messages[i].buffers.size());
+        rows.push_back(messages[i].rows);
+    }
+    EXPECT_EQ((std::vector<int64_t>{16, 16, 8, 5}), rows);
+
+    // The footer lists the same batches
+    FlatTable footer = FlatTable::root(&bytes[bytes.size() - 10 - footer_length]);
+    EXPECT_EQ(4u, readValue<uint32_t>(footer.indirect(3)));
+}
+
+TEST_F(ArrowExportTest, ColumnsKeepNanosecondTimestamps) {
+    record("Excavator 7", 3);
+
+    std::string bytes = exportAs(ArrowIpcFormat::Stream, 1, ARROW_BATCH_ROWS, {"Excavator 7"});
+    auto messages = readMessages(bytes, 0);
+    ASSERT_EQ(2u, messages.size());
+    const IpcMessage& batch = messages[1];
+    ASSERT_EQ(3, batch.rows);
+
+    // equipment_id: validity, offsets, data
+    EXPECT_EQ(0, batch.buffers[0].second);
+    EXPECT_EQ(11, readValue<int32_t>(batch.body + batch.buffers[1].first + 4));
+    EXPECT_EQ("Excavator 7Excavator 7Excavator 7",
+              std::string(batch.body + batch.buffers[2].first, batch.buffers[2].second));
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(base_ns + i * 1000000000LL, readValue<int64_t>(batch.body + batch.buffers[4].first + 8 * i));
+        EXPECT_DOUBLE_EQ(37.0 + i * 0.001, readValue<double>(batch.body + batch.buffers[6].first + 8 * i));
+        EXPECT_DOUBLE_EQ(-122.0, readValue<double>(batch.body + batch.buffers[8].first + 8 * i));
+        EXPECT_DOUBLE_EQ(10.0 + i, readValue<double>(batch.body + batch.buffers[10].first + 8 * i));
+        EXPECT_DOUBLE_EQ(2.5, readValue<double>(batch.body + batch.buffers[12].first + 8 * i));
+    }
+    for (const auto& buffer : batch.buffers) {
+        EXPECT_EQ(0, buffer.first % 8);
+    }
+}
+
+TEST_F(ArrowExportTest, OutputDoesNotDependOnThreadCount) {
+    std::vector<EquipmentId> ids;
+    for (int m = 0; m < 12; ++m) {
+        ids.push_back("T-" + std::to_string(m));
+        record(ids.back(), 10 + m * 7);
+    }
+
+    std::string serial = exportAs(ArrowIpcFormat::File, 1, 32, ids);
+    EXPECT_EQ(serial, exportAs(ArrowIpcFormat::File, 4, 32, ids));
+
+    // The stream format is the file format without magic and footer
+    std::string stream = exportAs(ArrowIpcFormat::Stream, 3, 32, ids);
+    EXPECT_EQ(stream, serial.substr(8, stream.size()));
+}
+
+TEST_F(ArrowExportTest, EmptyExportIsAValidFile) {
+    std::string bytes = exportAs(ArrowIpcFormat::File, 0, ARROW_BATCH_ROWS, {});
+    auto messages = readMessages(bytes, 8);
+    ASSERT_EQ(1u, messages.size());
+    EXPECT_EQ(1, messages[0].header_type);
+    EXPECT_EQ("ARROW1", bytes.substr(bytes.size() - 6));
+}
+
+} // namespace equipment_tracker
+// </test_code>
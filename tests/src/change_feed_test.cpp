@@ -0,0 +1,255 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/change_feed.h"
+
+namespace equipment_tracker {
+
+class ChangeFeedTest : public ::testing::Test {
+protected:
+    std::string directory;
+
+    void SetUp() override {
+        directory = "test_cdc_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(ChangeFeedTest, AssignsIncreasingLsns) {
+    ChangeFeed feed(directory);
+    ASSERT_TRUE(feed.open());
+
+    Equipment equipment("FL-1", EquipmentType::Forklift, "Forklift\tOne");
+    EXPECT_EQ(1u, feed.appendEquipmentSaved(equipment));
+    EXPECT_EQ(2u, feed.appendPositionSaved("FL-1", Position(37.7749, -122.4194, 5.0, 1.5)));
+    EXPECT_EQ(3u, feed.appendEquipmentDeleted("FL-1"));
+    EXPECT_EQ(3u, feed.getLatestLsn());
+
+    auto records = feed.read(0);
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ(ChangeType::EquipmentSaved, records[0].type);
+    EXPECT_EQ("Forklift\tOne", records[0].name);
+    EXPECT_EQ(EquipmentType::Forklift, records[0].equipment_type);
+    EXPECT_FALSE(records[0].position.has_value());
+
+    EXPECT_EQ(ChangeType::PositionSaved, records[1].type);
+    ASSERT_TRUE(records[1].position.has_value());
+    EXPECT_NEAR(37.7749, records[1].position->getLatitude(), 1e-9);
+    EXPECT_NEAR(1.5, records[1].position->getAccuracy(), 1e-9);
+
+    EXPECT_EQ(ChangeType::EquipmentDeleted, records[2].type);
+    EXPECT_EQ("FL-1", records[2].equipment_id);
+}
+
+TEST_F(ChangeFeedTest, CarriesUtilizationCounters) {
+    ChangeFeed feed(directory);
+    ASSERT_TRUE(feed.open());
+
+    Equipment equipment("EX-1", EquipmentType::Excavator, "Excavator");
+    UtilizationCounters counters;
+    counters.moving_seconds = 3600.25;
+    counters.idle_seconds = 1800.5;
+    counters.distance_meters = 12345.678;
+    equipment.setUtilization(counters);
+    feed.appendEquipmentSaved(equipment);
+
+    auto records = feed.read(0);
+    ASSERT_EQ(1u, records.size());
+    EXPECT_DOUBLE_EQ(3600.25, records[0].utilization.moving_seconds);
+    EXPECT_DOUBLE_EQ(1800.5, records[0].utilization.idle_seconds);
+    EXPECT_DOUBLE_EQ(12345.678, records[0].utilization.distance_meters);
+
+    // Lines from before the counters were added still decode
+    auto old = ChangeFeed::decode("7\tD\tEX-1\t0\t\t7\t4\t0\t0\t0\t0\t0\t0");
+    ASSERT_TRUE(old.has_value());
+    EXPECT_EQ(7u, old->lsn);
+    EXPECT_EQ(0.0, old->utilization.operatingSeconds());
+}
+
+TEST_F(ChangeFeedTest, ReadsInBatches) {
+    ChangeFeed feed(directory);
+    ASSERT_TRUE(feed.open());
+    for (int i = 0; i < 10; ++i) {
+        feed.appendEquipmentDeleted("EQ-" + std::to_string(i));
+    }
+
+    auto first = feed.read(0, 4);
+    ASSERT_EQ(4u, first.size());
+    EXPECT_EQ(1u, first.front().lsn);
+    EXPECT_EQ(4u, first.back().lsn);
+
+    auto rest = feed.read(first.back().lsn, 100);
+    ASSERT_EQ(6u, rest.size());
+    EXPECT_EQ(5u, rest.front().lsn);
+    EXPECT_EQ("EQ-9", rest.back().equipment_id);
+
+    EXPECT_TRUE(feed.read(10).empty());
+}
+
+TEST_F(ChangeFeedTest, ConsumerOffsetsPersist) {
+    {
+        ChangeFeed feed(directory);
+        ASSERT_TRUE(feed.open());
+        for (int i = 0; i < 5; ++i) {
+            feed.appendEquipmentDeleted("EQ-" + std::to_string(i));
+        }
+
+        EXPECT_EQ(0u, feed.getOffset("billing"));
+        auto batch = feed.readNext("billing", 3);
+        ASSERT_EQ(3u, batch.size());
+        EXPECT_TRUE(feed.commitOffset("billing", batch.back().lsn));
+    }
+
+    ChangeFeed reopened(directory);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(3u, reopened.getOffset("billing"));
+
+    auto remaining = reopened.readNext("billing");
+    ASSERT_EQ(2u, remaining.size());
+    EXPECT_EQ(4u, remaining.front().lsn);
+    EXPECT_EQ(0u, reopened.getOffset("bi"));
+}
+
+TEST_F(ChangeFeedTest, ReopenDiscardsTornTailAndContinuesSequence) {
+    {
+        ChangeFeed feed(directory);
+        ASSERT_TRUE(feed.open());
+        feed.appendEquipmentDeleted("EQ-1");
+        feed.appendEquipmentDeleted("EQ-2");
+    }
+
+    // Simulate a crash part-way through an append
+    {
+        std::ofstream log(directory + "/changes.log", std::ios::app | std::ios::binary);
+        log << "3\tD\tEQ-3\t12";
+    }
+
+    ChangeFeed feed(directory);
+    ASSERT_TRUE(feed.open());
+    EXPECT_EQ(2u, feed.getLatestLsn());
+    EXPECT_EQ(3u, feed.appendEquipmentDeleted("EQ-3"));
+
+    auto records = feed.read(0);
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ("EQ-3", records[2].equipment_id);
+}
+
+TEST_F(ChangeFeedTest, BatchesGetConsecutiveLsns) {
+    ChangeFeed feed(directory);
+    ASSERT_TRUE(feed.open());
+
+    std::vector<Equipment> batch;
+    for (int i = 0; i < 3; ++i) {
+        batch.emplace_back("EQ-" + std::to_string(i), EquipmentType::Crane, "Crane");
+    }
+    EXPECT_EQ(1u, feed.appendEquipmentSaved(batch[0]));
+    EXPECT_EQ(4u, feed.appendEquipmentSavedBatch(batch));
+    EXPECT_EQ(6u, feed.appendEquipmentDeletedBatch({"EQ-0", "EQ-1"}));
+    EXPECT_EQ(0u, feed.appendEquipmentDeletedBatch({}));
+
+    auto records = feed.read(0);
+    ASSERT_EQ(6u, records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(i + 1, records[i].lsn);
+    }
+    EXPECT_EQ("EQ-2", records[3].equipment_id);
+    EXPECT_EQ(ChangeType::EquipmentDeleted, records[5].type);
+    EXPECT_EQ("EQ-1", records[5].equipment_id);
+}
+
+TEST_F(ChangeFeedTest, ClosedFeedIgnoresAppends) {
+    ChangeFeed feed(directory);
+
+    EXPECT_EQ(0u, feed.appendEquipmentDeleted("EQ-1"));
+    EXPECT_TRUE(feed.read(0).empty());
+}
+
+TEST_F(ChangeFeedTest, RotatesSegmentsAndReadsAcrossThem) {
+    {
+        ChangeFeed feed(directory, 2048);
+        ASSERT_TRUE(feed.open());
+        ASSERT_TRUE(feed.commitOffset("archive", 0)); // Keeps every segment
+        for (int i = 0; i < 600; ++i) {
+            ASSERT_EQ(static_cast<uint64_t>(i + 1), feed.appendEquipmentDeleted("EQ-" + std::to_string(i)));
+        }
+        EXPECT_GT(feed.getSegmentCount(), 10u);
+        EXPECT_EQ(1u, feed.getOldestLsn());
+
+        auto all = feed.read(0, 1000);
+        ASSERT_EQ(600u, all.size());
+        for (size_t i = 0; i < all.size(); ++i) {
+            EXPECT_EQ(i + 1, all[i].lsn);
+        }
+
+        auto middle = feed.read(300, 5);
+        ASSERT_EQ(5u, middle.size());
+        EXPECT_EQ(301u, middle.front().lsn);
+        EXPECT_EQ("EQ-304", middle.back().equipment_id);
+    }
+
+    // A lost index is rebuilt from its segment
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".idx") {
+            std::filesystem::remove(entry.path());
+            break;
+        }
+    }
+
+    ChangeFeed reopened(directory, 2048);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(600u, reopened.getLatestLsn());
+    EXPECT_EQ(601u, reopened.appendEquipmentDeleted("EQ-600"));
+    auto all = reopened.read(0, 1000);
+    ASSERT_EQ(601u, all.size());
+    EXPECT_EQ("EQ-0", all.front().equipment_id);
+    EXPECT_EQ("EQ-600", all.back().equipment_id);
+}
+
+TEST_F(ChangeFeedTest, DropsSegmentsEveryConsumerHasPassed) {
+    ChangeFeed feed(directory, 2048);
+    ASSERT_TRUE(feed.open());
+    ASSERT_TRUE(feed.commitOffset("billing", 0));
+    ASSERT_TRUE(feed.commitOffset("audit", 0));
+    for (int i = 0; i < 300; ++i) {
+        feed.appendEquipmentDeleted("EQ-" + std::to_string(i));
+    }
+    size_t retained = feed.getSegmentCount();
+
+    // One consumer still needs everything
+    ASSERT_TRUE(feed.commitOffset("billing", 250));
+    feed.appendEquipmentDeletedBatch(std::vector<EquipmentId>(100, "EQ-X"));
+    EXPECT_EQ(1u, feed.getOldestLsn());
+    EXPECT_GT(feed.getSegmentCount(), retained);
+
+    ASSERT_TRUE(feed.commitOffset("audit", 120));
+    for (int i = 0; i < 60; ++i) {
+        feed.appendEquipmentDeleted("EQ-Y");
+    }
+    uint64_t oldest = feed.getOldestLsn();
+    EXPECT_GT(oldest, 1u);
+    EXPECT_LE(oldest, 121u);
+
+    // Nothing a consumer still needs was dropped, and reads resume at the oldest record
+    auto next = feed.readNext("audit", 1);
+    ASSERT_EQ(1u, next.size());
+    EXPECT_EQ(121u, next[0].lsn);
+    auto from_start = feed.read(0, 1);
+    ASSERT_EQ(1u, from_start.size());
+    EXPECT_EQ(oldest, from_start[0].lsn);
+
+    // Retention carries over a restart
+    feed.close();
+    ChangeFeed reopened(directory, 2048);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(oldest, reopened.getOldestLsn());
+    EXPECT_EQ(460u, reopened.getLatestLsn());
+}
+
+} // namespace equipment_tracker
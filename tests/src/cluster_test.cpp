@@ -0,0 +1,371 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "equipment_tracker/cluster.h"
+#include "equipment_tracker/equipment_tracker_service.h"
+
+namespace equipment_tracker {
+
+// Nodes run in this process, each with its own service and storage, and are
+// reached over loopback like remote ones
+class ClusterTest : public ::testing::Test {
+protected:
+    std::string base_path;
+    std::vector<std::unique_ptr<EquipmentTrackerService>> services;
+    std::vector<std::unique_ptr<ClusterNode>> nodes;
+    ClusterRouter router;
+
+    void SetUp() override {
+        base_path = "cluster_test_" + std::to_string(::getpid()) + "_" +
+                    std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+
+    void TearDown() override {
+        nodes.clear();
+        services.clear();
+        std::filesystem::remove_all(base_path);
+    }
+
+    // Start a node and return its index (also its name, "node-<index>")
+    size_t startNode() {
+        size_t index = services.size();
+        services.push_back(std::make_unique<EquipmentTrackerService>(
+            base_path + "/node-" + std::to_string(index)));
+        nodes.push_back(std::make_unique<ClusterNode>(*services.back()));
+        EXPECT_TRUE(nodes.back()->start());
+        return index;
+    }
+
+    std::optional<size_t> join(size_t index) {
+        return router.addNode(name(index), CLUSTER_DEFAULT_ADDRESS, nodes[index]->getPort());
+    }
+
+    static std::string name(size_t index) {
+        return "node-" + std::to_string(index);
+    }
+
+    static std::string id(size_t i) {
+        return "EQ-" + std::to_string(i);
+    }
+
+    static Position fix(size_t i, int step) {
+        return Position(37.0 + i * 0.001, -122.0 + step * 0.0001, 10.0, 2.0,
+                        Timestamp(std::chrono::seconds(1700000000 + step)));
+    }
+
+    // Each node must hold exactly the machines the router assigns to it
+    void expectPartitioned(size_t machines) {
+        std::map<std::string, size_t> expected;
+        for (size_t i = 0; i < machines; ++i) {
+            ++expected[*router.ownerOf(id(i))];
+        }
+        for (const auto& node : router.getNodes()) {
+            size_t index = std::stoul(node.substr(5));
+            auto held = services[index]->getAllEquipment();
+            EXPECT_EQ(expected[node], held.size()) << node;
+            for (const auto& equipment : held) {
+                EXPECT_EQ(node, *router.ownerOf(equipment.getId())) << equipment.getId();
+            }
+        }
+    }
+};
+
+TEST_F(ClusterTest, CodecRoundTripsEquipmentAndPositions) {
+    Equipment equipment("Crane 7%\tA", EquipmentType::Crane, "North\nyard crane");
+    equipment.setLastPosition(Position(37.123456789012345, -122.98765432109876, 12.5, 0.3,
+                                       Timestamp(std::chrono::nanoseconds(1700000000123456789LL))));
+    equipment.setStatus(EquipmentStatus::Maintenance);
+
+    std::string line = encodeClusterEquipment(equipment);
+    EXPECT_EQ(std::string::npos, line.find('\n'));
+    auto decoded = decodeClusterEquipment(line);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(equipment.getId(), decoded->getId());
+    EXPECT_EQ(equipment.getName(), decoded->getName());
+    EXPECT_EQ(EquipmentType::Crane, decoded->getType());
+    EXPECT_EQ(EquipmentStatus::Maintenance, decoded->getStatus());
+    ASSERT_TRUE(decoded->getLastPosition().has_value());
+    EXPECT_EQ(equipment.getLastPosition()->getLatitude(), decoded->getLastPosition()->getLatitude());
+    EXPECT_EQ(equipment.getLastPosition()->getLongitude(), decoded->getLastPosition()->getLongitude());
+    EXPECT_EQ(equipment.getLastPosition()->getTimestamp(), decoded->getLastPosition()->getTimestamp());
+
+    UtilizationCounters counters;
+    counters.moving_seconds = 3600.25;
+    counters.idle_seconds = 120.5;
+    counters.distance_meters = 12345.678;
+    equipment.setUtilization(counters);
+    decoded = decodeClusterEquipment(encodeClusterEquipment(equipment));
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(3600.25, decoded->getUtilization().moving_seconds);
+    EXPECT_EQ(120.5, decoded->getUtilization().idle_seconds);
+    EXPECT_EQ(12345.678, decoded->getUtilization().distance_meters);
+    EXPECT_FALSE(decodeClusterEquipment(line + "\t1 2").has_value());
+
+    auto bare = decodeClusterEquipment(encodeClusterEquipment(Equipment("T-1", EquipmentType::Truck, "")));
+    ASSERT_TRUE(bare.has_value());
+    EXPECT_FALSE(bare->getLastPosition().has_value());
+
+    EXPECT_FALSE(decodeClusterEquipment("").has_value());
+    EXPECT_FALSE(decodeClusterEquipment("T-1\t9\t0\tname\t-").has_value());
+    EXPECT_FALSE(decodeClusterEquipment("T-1\t1\t0\tname\t1 2 x").has_value());
+    EXPECT_FALSE(decodeClusterPosition("1 2 3 4").has_value());
+}
+
+TEST_F(ClusterTest, NodeAnswersRequestsDirectly) {
+    size_t index = startNode();
+    ClusterNode& node = *nodes[index];
+
+    EXPECT_EQ("OK", node.handleRequest("PING"));
+    EXPECT_EQ("OK", node.handleRequest("ADD\n" + encodeClusterEquipment(Equipment("F-1", EquipmentType::Forklift, "Lift"))));
+    EXPECT_EQ(0u, node.handleRequest("ADD\n" + encodeClusterEquipment(Equipment("F-1", EquipmentType::Forklift, "Lift"))).find("ERR"));
+    EXPECT_EQ("OK\nF-1", node.handleRequest("IDS"));
+    EXPECT_EQ("NONE", node.handleRequest("GET F-2"));
+    EXPECT_EQ(0u, node.handleRequest("BOGUS").find("ERR"));
+    EXPECT_EQ(0u, node.handleRequest("ADD\nnot a record").find("ERR"));
+    EXPECT_EQ("OK", node.handleRequest("REMOVE F-1"));
+    EXPECT_EQ("NONE", node.handleRequest("REMOVE F-1"));
+}
+
+TEST_F(ClusterTest, RoutesEachMachineToItsOwner) {
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(0u, join(startNode()).value_or(99));
+    }
+
+    constexpr size_t MACHINES = 30;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        ASSERT_TRUE(router.addEquipment(Equipment(id(i), EquipmentType::Truck, "Truck " + std::to_string(i))));
+        ASSERT_TRUE(router.updateEquipmentPosition(id(i), fix(i, 1)));
+    }
+    expectPartitioned(MACHINES);
+
+    auto equipment = router.getEquipment(id(7));
+    ASSERT_TRUE(equipment.has_value());
+    EXPECT_EQ("Truck 7", equipment->getName());
+    EXPECT_EQ(EquipmentStatus::Active, equipment->getStatus());
+    ASSERT_TRUE(equipment->getLastPosition().has_value());
+    EXPECT_DOUBLE_EQ(37.007, equipment->getLastPosition()->getLatitude());
+
+    EXPECT_FALSE(router.addEquipment(Equipment(id(7), EquipmentType::Truck, "Duplicate")));
+    EXPECT_FALSE(router.updateEquipmentPosition("missing", fix(0, 2)));
+    EXPECT_FALSE(router.getEquipment("missing").has_value());
+    EXPECT_TRUE(router.removeEquipment(id(7)));
+    EXPECT_FALSE(router.getEquipment(id(7)).has_value());
+    EXPECT_FALSE(router.removeEquipment(id(7)));
+}
+
+TEST_F(ClusterTest, FleetQueriesGatherFromEveryNode) {
+    for (int i = 0; i < 3; ++i) {
+        join(startNode());
+    }
+
+    constexpr size_t MACHINES = 40;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        Equipment equipment(id(i), EquipmentType::Excavator, "Excavator");
+        equipment.setLastPosition(fix(i, 0));
+        equipment.setStatus(i % 4 == 0 ? EquipmentStatus::Maintenance : EquipmentStatus::Active);
+        ASSERT_TRUE(router.addEquipment(equipment));
+    }
+
+    auto all = router.getAllEquipment();
+    ASSERT_EQ(MACHINES, all.size());
+    for (size_t i = 1; i < all.size(); ++i) {
+        EXPECT_LT(all[i - 1].getId(), all[i].getId());
+    }
+
+    auto maintenance = router.findEquipmentByStatus(EquipmentStatus::Maintenance);
+    EXPECT_EQ(MACHINES / 4, maintenance.size());
+    for (const auto& equipment : maintenance) {
+        EXPECT_EQ(EquipmentStatus::Maintenance, equipment.getStatus());
+    }
+
+    // Machines 10..19 sit at latitudes 37.010..37.019
+    auto area = router.findEquipmentInArea(37.0095, -123.0, 37.0195, -121.0);
+    ASSERT_EQ(10u, area.size());
+    for (const auto& equipment : area) {
+        double latitude = equipment.getLastPosition()->getLatitude();
+        EXPECT_GE(latitude, 37.0095);
+        EXPECT_LE(latitude, 37.0195);
+    }
+}
+
+TEST_F(ClusterTest, MembershipChangesMoveOnlyReassignedMachines) {
+    for (int i = 0; i < 3; ++i) {
+        join(startNode());
+    }
+
+    constexpr size_t MACHINES = 120;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        ASSERT_TRUE(router.addEquipment(Equipment(id(i), EquipmentType::Bulldozer, "Dozer")));
+        for (int step = 1; step <= 2; ++step) {
+            ASSERT_TRUE(router.updateEquipmentPosition(id(i), fix(i, step)));
+        }
+    }
+
+    // A joining node takes over roughly a quarter, with their history
+    size_t joined = startNode();
+    auto moved = join(joined);
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_GT(*moved, 0u);
+    EXPECT_LT(*moved, MACHINES / 2);
+    EXPECT_EQ(*moved, services[joined]->getAllEquipment().size());
+    expectPartitioned(MACHINES);
+    ASSERT_EQ(MACHINES, router.getAllEquipment().size());
+
+    auto taken = services[joined]->getAllEquipment().front();
+    EXPECT_EQ(2u, services[joined]->getPositionHistory(taken.getId()).size());
+    EXPECT_EQ(EquipmentStatus::Active, taken.getStatus());
+    ASSERT_TRUE(router.updateEquipmentPosition(taken.getId(), fix(0, 3)));
+    EXPECT_EQ(3u, services[joined]->getPositionHistory(taken.getId()).size());
+
+    // A leaving node hands all of its machines to the others
+    size_t leaving_count = services[1]->getAllEquipment().size();
+    moved = router.removeNode(name(1));
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(leaving_count, *moved);
+    EXPECT_TRUE(services[1]->getAllEquipment().empty());
+    expectPartitioned(MACHINES);
+    EXPECT_EQ(MACHINES, router.getAllEquipment().size());
+}
+
+TEST_F(ClusterTest, MovedMachinesKeepTheirWholeHistory) {
+    join(startNode());
+    join(startNode());
+
+    // More stored fixes than any node keeps in memory: older ones written to
+    // the owner's storage directly, the latest routed so counters advance
+    constexpr size_t MACHINES = 12;
+    constexpr int FIXES = static_cast<int>(DEFAULT_MAX_HISTORY_SIZE) * 3;
+    constexpr int ROUTED = 5;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        ASSERT_TRUE(router.addEquipment(Equipment(id(i), EquipmentType::Truck, "Truck")));
+        size_t owner = std::stoul(router.ownerOf(id(i))->substr(5));
+        for (int step = 1; step <= FIXES - ROUTED; ++step) {
+            ASSERT_TRUE(services[owner]->getDataStorage().savePosition(id(i), fix(i, step)));
+        }
+        for (int step = FIXES - ROUTED + 1; step <= FIXES; ++step) {
+            ASSERT_TRUE(router.updateEquipmentPosition(id(i), fix(i, step)));
+        }
+    }
+    std::map<EquipmentId, UtilizationCounters> before;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        before[id(i)] = router.getEquipment(id(i))->getUtilization();
+        EXPECT_GT(before[id(i)].distance_meters, 0.0);
+    }
+
+    size_t joined = startNode();
+    auto moved = join(joined);
+    ASSERT_TRUE(moved.has_value());
+    ASSERT_GT(*moved, 0u);
+
+    Timestamp end = Timestamp(std::chrono::seconds(1700000000 + FIXES));
+    for (const auto& equipment : services[joined]->getAllEquipment()) {
+        const auto& id = equipment.getId();
+        auto& storage = services[joined]->getDataStorage();
+        EXPECT_EQ(static_cast<size_t>(FIXES), storage.getPositionHistory(id, Timestamp(), end).size()) << id;
+        EXPECT_EQ(DEFAULT_MAX_HISTORY_SIZE, services[joined]->getPositionHistory(id).size()) << id;
+        EXPECT_DOUBLE_EQ(before[id].distance_meters, equipment.getUtilization().distance_meters) << id;
+        EXPECT_DOUBLE_EQ(before[id].moving_seconds, equipment.getUtilization().moving_seconds) << id;
+
+        // Rollups are rebuilt from the copied fixes
+        auto hourly = storage.getAggregatedHistory(id, Timestamp(), end, std::chrono::hours(1));
+        ASSERT_FALSE(hourly.empty()) << id;
+        size_t samples = 0;
+        for (const auto& bucket : hourly) {
+            samples += bucket.samples;
+        }
+        EXPECT_EQ(static_cast<size_t>(FIXES), samples) << id;
+    }
+    expectPartitioned(MACHINES);
+}
+
+TEST_F(ClusterTest, RefusesInvalidMembershipChanges) {
+    size_t first = startNode();
+    ASSERT_TRUE(join(first).has_value());
+    EXPECT_FALSE(join(first).has_value());
+    EXPECT_FALSE(router.removeNode("unknown").has_value());
+    EXPECT_FALSE(router.removeNode(name(first)).has_value());
+
+    size_t stopped = startNode();
+    uint16_t port = nodes[stopped]->getPort();
+    nodes[stopped]->stop();
+    EXPECT_FALSE(router.addNode(name(stopped), CLUSTER_DEFAULT_ADDRESS, port).has_value());
+    EXPECT_EQ(std::vector<std::string>{name(first)}, router.getNodes());
+}
+
+TEST_F(ClusterTest, RoutesAcrossNodeProcesses) {
+    constexpr int PROCESSES = 3;
+    std::vector<pid_t> children;
+    std::vector<int> stop_pipes;
+
+    for (int i = 0; i < PROCESSES; ++i) {
+        int port_pipe[2];
+        int stop_pipe[2];
+        ASSERT_EQ(0, ::pipe(port_pipe));
+        ASSERT_EQ(0, ::pipe(stop_pipe));
+
+        pid_t pid = ::fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            // Child: serve until the parent closes the stop pipe
+            ::close(port_pipe[0]);
+            ::close(stop_pipe[1]);
+            for (int inherited : stop_pipes) {
+                ::close(inherited);
+            }
+            EquipmentTrackerService service(base_path + "/process-" + std::to_string(i));
+            ClusterNode node(service);
+            uint16_t port = node.start() ? node.getPort() : 0;
+            bool reported = ::write(port_pipe[1], &port, sizeof(port)) == sizeof(port);
+            char byte;
+            while (reported && ::read(stop_pipe[0], &byte, 1) > 0) {
+            }
+            node.stop();
+            ::_exit(0);
+        }
+
+        ::close(port_pipe[1]);
+        ::close(stop_pipe[0]);
+        uint16_t port = 0;
+        ASSERT_EQ(static_cast<ssize_t>(sizeof(port)), ::read(port_pipe[0], &port, sizeof(port)));
+        ::close(port_pipe[0]);
+        children.push_back(pid);
+        stop_pipes.push_back(stop_pipe[1]);
+        ASSERT_NE(0, port);
+        ASSERT_TRUE(router.addNode("process-" + std::to_string(i), CLUSTER_DEFAULT_ADDRESS, port).has_value());
+    }
+
+    constexpr size_t MACHINES = 30;
+    for (size_t i = 0; i < MACHINES; ++i) {
+        Equipment equipment(id(i), EquipmentType::Truck, "Truck");
+        equipment.setLastPosition(fix(i, 0));
+        EXPECT_TRUE(router.addEquipment(equipment));
+    }
+    EXPECT_EQ(MACHINES, router.getAllEquipment().size());
+    EXPECT_EQ(MACHINES, router.findEquipmentInArea(36.0, -123.0, 38.0, -121.0).size());
+    EXPECT_TRUE(router.updateEquipmentPosition(id(3), fix(3, 1)));
+    ASSERT_TRUE(router.getEquipment(id(3)).has_value());
+    EXPECT_EQ(fix(3, 1).getTimestamp(), router.getEquipment(id(3))->getLastPosition()->getTimestamp());
+
+    // Draining one process keeps every machine reachable
+    auto moved = router.removeNode("process-0");
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(MACHINES, router.getAllEquipment().size());
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        ::close(stop_pipes[i]);
+        int status = 0;
+        EXPECT_EQ(children[i], ::waitpid(children[i], &status, 0));
+        EXPECT_TRUE(WIFEXITED(status));
+    }
+}
+
+} // namespace equipment_tracker
+// </test_code>
@@ -7,6 +7,7 @@
 #include <ctime>
 #include <chrono>
 #include <thread>
+#include <vector>
 #include "equipment_tracker/data_storage.h"
 #include "equipment_tracker/equipment.h"
 #include "equipment_tracker/position.h"
@@ -129,6 +130,32 @@ TEST_F(DataStorageTest, UpdateEquipment) {
     }
 }
 
+TEST_F(DataStorageTest, RecordLoadsSkipTheHistory) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+
+    Equipment equipment = createTestEquipment();
+    ASSERT_TRUE(storage.saveEquipment(equipment));
+    auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(storage.savePosition(equipment.getId(),
+                                         Position(37.0 + i * 0.001, -122.0, 0.0, 2.0, now - std::chrono::minutes(5 - i))));
+    }
+
+    auto record = storage.loadEquipmentRecord(equipment.getId());
+    ASSERT_TRUE(record.has_value());
+    verifyEquipment(equipment, *record);
+    EXPECT_TRUE(record->getPositionHistory().empty());
+
+    auto records = storage.getAllEquipmentRecords();
+    ASSERT_EQ(1u, records.size());
+    EXPECT_TRUE(records[0].getPositionHistory().empty());
+
+    auto full = storage.loadEquipment(equipment.getId());
+    ASSERT_TRUE(full.has_value());
+    EXPECT_EQ(5u, full->getPositionHistory().size());
+}
+
 // Test deleting equipment
 TEST_F(DataStorageTest, DeleteEquipment) {
     DataStorage storage(test_db_path);
@@ -492,5 +519,558 @@ TEST_F(DataStorageTest, PositionHistoryTimeRangeFiltering) {
     EXPECT_EQ(1, mid_history.size());
 }
 
+// Test bracketing lookup through the position time index
+TEST_F(DataStorageTest, GetBracketingPositions) {
+    DataStorage storage(test_db_path);
+    EXPECT_TRUE(storage.initialize());
+
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+    EXPECT_TRUE(storage.savePosition("bracket1", Position(10.0, 20.0, 0.0, 2.0, base)));
+    EXPECT_TRUE(storage.savePosition("bracket1", Position(11.0, 21.0, 0.0, 2.0, base + std::chrono::seconds(60))));
+    EXPECT_TRUE(storage.savePosition("bracket1", Position(12.0, 22.0, 0.0, 2.0, base + std::chrono::seconds(120))));
+
+    // Between two fixes
+    auto between = storage.getBracketingPositions("bracket1", base + std::chrono::seconds(90));
+    ASSERT_EQ(2u, between.size());
+    EXPECT_DOUBLE_EQ(11.0, between[0].getLatitude());
+    EXPECT_DOUBLE_EQ(12.0, between[1].getLatitude());
+
+    // Exact match
+    auto exact = storage.getBracketingPositions("bracket1", base + std::chrono::seconds(60));
+    ASSERT_EQ(1u, exact.size());
+    EXPECT_DOUBLE_EQ(11.0, exact[0].getLatitude());
+
+    // After the last fix only the preceding fix is known
+    auto after = storage.getBracketingPositions("bracket1", base + std::chrono::seconds(500));
+    ASSERT_EQ(1u, after.size());
+    EXPECT_DOUBLE_EQ(12.0, after[0].getLatitude());
+
+    // Before the first fix only the following fix is known
+    auto before = storage.getBracketingPositions("bracket1", base - std::chrono::seconds(30));
+    ASSERT_EQ(1u, before.size());
+    EXPECT_DOUBLE_EQ(10.0, before[0].getLatitude());
+
+    // Unknown equipment
+    EXPECT_TRUE(storage.getBracketingPositions("missing", base).empty());
+}
+
+// Test that every committed mutation reaches the change feed in order
+TEST_F(DataStorageTest, MutationsAppearInChangeFeed) {
+    DataStorage storage(test_db_path);
+    EXPECT_TRUE(storage.initialize());
+
+    Equipment equipment = createTestEquipment("cdc1");
+    EXPECT_TRUE(storage.saveEquipment(equipment));
+    EXPECT_TRUE(storage.savePosition("cdc1", Position(37.0, -122.0)));
+    EXPECT_TRUE(storage.deleteEquipment("cdc1"));
+
+    auto &feed = storage.getChangeFeed();
+    EXPECT_EQ(3u, feed.getLatestLsn());
+    EXPECT_TRUE(std::filesystem::exists(feed.getLogPath()));
+
+    auto records = feed.read(0);
+    ASSERT_EQ(3u, records.size());
+    EXPECT_EQ(ChangeType::EquipmentSaved, records[0].type);
+    EXPECT_EQ("Test Forklift", records[0].name);
+    EXPECT_EQ(EquipmentStatus::Active, records[0].status);
+    EXPECT_EQ(ChangeType::PositionSaved, records[1].type);
+    EXPECT_EQ(ChangeType::EquipmentDeleted, records[2].type);
+    for (const auto &record : records) {
+        EXPECT_EQ("cdc1", record.equipment_id);
+    }
+}
+
+// Test that queued position writes survive a restart on either I/O backend
+TEST_F(DataStorageTest, PositionLogPersistsAcrossInstances) {
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+
+    for (IoBackendType backend : {IoBackendType::ThreadPool, IoBackendType::Auto}) {
+        std::string id = backend == IoBackendType::ThreadPool ? "pool" : "auto";
+        {
+            DataStorage storage(test_db_path, backend);
+            EXPECT_TRUE(storage.initialize());
+            for (int i = 0; i < 200; ++i) {
+                EXPECT_TRUE(storage.savePosition(id, Position(10.0 + i * 0.001, 20.0, 0.0, 2.0,
+                                                               base + std::chrono::seconds(i))));
+            }
+            EXPECT_TRUE(storage.flush());
+            EXPECT_GE(storage.getIoStats().operations, 200u);
+        }
+
+        DataStorage reopened(test_db_path, backend);
+        EXPECT_TRUE(reopened.initialize());
+        auto history = reopened.getPositionHistory(id, base, base + std::chrono::seconds(199));
+        ASSERT_EQ(200u, history.size());
+        EXPECT_NEAR(10.0, history.front().getLatitude(), 1e-9);
+        EXPECT_NEAR(10.199, history.back().getLatitude(), 1e-9);
+    }
+}
+
+TEST_F(DataStorageTest, CorruptEquipmentRecordIsSkipped) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("intact")));
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("torn")));
+
+    // Simulate a torn write: the file lost its tail
+    std::string path = test_db_path + "/equipment/torn.txt";
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 12);
+
+    EXPECT_FALSE(storage.loadEquipment("torn").has_value());
+    ASSERT_TRUE(storage.loadEquipment("intact").has_value());
+
+    auto all = storage.getAllEquipment();
+    ASSERT_EQ(1u, all.size());
+    EXPECT_EQ("intact", all[0].getId());
+}
+
+TEST_F(DataStorageTest, LoadsEquipmentWrittenWithoutChecksum) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    std::filesystem::create_directories(test_db_path + "/equipment");
+    {
+        std::ofstream file(test_db_path + "/equipment/legacy.txt");
+        file << "id=legacy\nname=Old Crane\ntype=1\nstatus=0\n";
+    }
+
+    auto equipment = storage.loadEquipment("legacy");
+    ASSERT_TRUE(equipment.has_value());
+    EXPECT_EQ("Old Crane", equipment->getName());
+}
+
+TEST_F(DataStorageTest, DeleteLeavesTombstoneForBackgroundReclamation) {
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("old")));
+    for (int i = 0; i < 100; ++i) {
+        storage.savePosition("old", Position(1.0, 2.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+    }
+
+    ASSERT_TRUE(storage.deleteEquipment("old"));
+
+    // Logically gone at once, whatever the reclaimer has got to
+    EXPECT_FALSE(std::filesystem::exists(test_db_path + "/equipment/old.txt"));
+    EXPECT_FALSE(std::filesystem::exists(test_db_path + "/positions/old"));
+    EXPECT_FALSE(storage.loadEquipment("old").has_value());
+    EXPECT_TRUE(storage.getPositionHistory("old", base, base + std::chrono::seconds(100)).empty());
+
+    storage.waitForReclamation();
+    EXPECT_EQ(0u, storage.getPendingReclamationCount());
+    EXPECT_TRUE(std::filesystem::is_empty(test_db_path + "/tombstones"));
+}
+
+TEST_F(DataStorageTest, ReAddAfterDeleteStartsFreshHistory) {
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+
+    for (int round = 0; round < 3; ++round) {
+        ASSERT_TRUE(storage.saveEquipment(createTestEquipment("reused")));
+        for (int i = 0; i <= round; ++i) {
+            storage.savePosition("reused", Position(round, 0.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+        }
+
+        auto history = storage.getPositionHistory("reused", base, base + std::chrono::seconds(10));
+        ASSERT_EQ(static_cast<size_t>(round + 1), history.size());
+        EXPECT_DOUBLE_EQ(static_cast<double>(round), history.back().getLatitude());
+
+        ASSERT_TRUE(storage.deleteEquipment("reused"));
+    }
+
+    storage.waitForReclamation();
+    EXPECT_TRUE(std::filesystem::is_empty(test_db_path + "/tombstones"));
+}
+
+TEST_F(DataStorageTest, TombstonesFromEarlierRunAreReclaimed) {
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+    }
+
+    // As if the process stopped before the reclaimer got to it
+    std::string leftover = test_db_path + "/tombstones/crashed.1.1/positions";
+    std::filesystem::create_directories(leftover);
+    std::ofstream(leftover + "/segment-00000001.log") << "history";
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    storage.waitForReclamation();
+    EXPECT_TRUE(std::filesystem::is_empty(test_db_path + "/tombstones"));
+}
+
+TEST_F(DataStorageTest, BatchSaveWritesOnePackAndReloads) {
+    std::vector<Equipment> batch;
+    for (int i = 0; i < 50; ++i) {
+        batch.push_back(createTestEquipment("bulk" + std::to_string(i)));
+    }
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        ASSERT_TRUE(storage.saveEquipmentBatch(batch));
+
+        EXPECT_FALSE(std::filesystem::exists(test_db_path + "/equipment/bulk0.txt"));
+        size_t packs = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(test_db_path + "/equipment/packs")) {
+            (void)entry;
+            ++packs;
+        }
+        EXPECT_EQ(1u, packs);
+        EXPECT_EQ(50u, storage.getChangeFeed().getLatestLsn());
+    }
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    EXPECT_EQ(50u, storage.getAllEquipment().size());
+
+    auto loaded = storage.loadEquipment("bulk17");
+    ASSERT_TRUE(loaded.has_value());
+    verifyEquipment(batch[17], *loaded);
+}
+
+TEST_F(DataStorageTest, SingleSaveShadowsPackedRecordUntilNextBatch) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+
+    Equipment equipment = createTestEquipment("mixed");
+    ASSERT_TRUE(storage.saveEquipmentBatch({equipment}));
+
+    equipment.setName("Renamed Once");
+    ASSERT_TRUE(storage.saveEquipment(equipment));
+    EXPECT_EQ("Renamed Once", storage.loadEquipment("mixed")->getName());
+    EXPECT_EQ(1u, storage.getAllEquipment().size());
+
+    equipment.setName("Renamed Twice");
+    ASSERT_TRUE(storage.saveEquipmentBatch({equipment}));
+    EXPECT_FALSE(std::filesystem::exists(test_db_path + "/equipment/mixed.txt"));
+
+    DataStorage reopened(test_db_path);
+    ASSERT_TRUE(reopened.initialize());
+    EXPECT_EQ("Renamed Twice", reopened.loadEquipment("mixed")->getName());
+}
+
+TEST_F(DataStorageTest, UpdatesAreHeldAndWrittenInBatches) {
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        Equipment equipment = createTestEquipment("busy");
+        ASSERT_TRUE(storage.saveEquipment(equipment));
+        uint64_t saved_lsn = storage.getChangeFeed().getLatestLsn();
+
+        // Per-fix refreshes touch neither the disk nor the feed...
+        for (int i = 0; i < 20; ++i) {
+            equipment.setLastPosition(Position(10.0 + i, 20.0, 0.0, 1.0));
+            ASSERT_TRUE(storage.updateEquipment(equipment));
+        }
+        EXPECT_TRUE(std::filesystem::is_empty(test_db_path + "/equipment/packs"));
+        EXPECT_EQ(saved_lsn, storage.getChangeFeed().getLatestLsn());
+
+        // ...but loads already see them
+        auto loaded = storage.loadEquipment("busy");
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_NEAR(29.0, loaded->getLastPosition()->getLatitude(), 1e-9);
+        EXPECT_EQ(1u, storage.getAllEquipment().size());
+
+        // One pack and one feed record for the whole run
+        ASSERT_TRUE(storage.flush());
+        EXPECT_FALSE(std::filesystem::is_empty(test_db_path + "/equipment/packs"));
+        EXPECT_EQ(saved_lsn + 1, storage.getChangeFeed().getLatestLsn());
+    }
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    auto loaded = storage.loadEquipment("busy");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_NEAR(29.0, loaded->getLastPosition()->getLatitude(), 1e-9);
+
+    // Deleting drops a pending update with the record
+    ASSERT_TRUE(storage.updateEquipment(*loaded));
+    ASSERT_TRUE(storage.deleteEquipment("busy"));
+    ASSERT_TRUE(storage.flush());
+    EXPECT_FALSE(storage.loadEquipment("busy").has_value());
+}
+
+TEST_F(DataStorageTest, DeletedPackedRecordsStayDeleted) {
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        ASSERT_TRUE(storage.saveEquipmentBatch({createTestEquipment("p1"), createTestEquipment("p2"),
+                                                createTestEquipment("p3")}));
+        ASSERT_TRUE(storage.saveEquipment(createTestEquipment("single")));
+
+        ASSERT_TRUE(storage.deleteEquipment("p1"));
+        ASSERT_TRUE(storage.deleteEquipmentBatch({"p2", "single"}));
+        EXPECT_FALSE(storage.loadEquipment("p2").has_value());
+        EXPECT_FALSE(storage.loadEquipment("single").has_value());
+    }
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    auto all = storage.getAllEquipment();
+    ASSERT_EQ(1u, all.size());
+    EXPECT_EQ("p3", all[0].getId());
+}
+
+TEST_F(DataStorageTest, TruncatedPackKeepsCompleteEntries) {
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        ASSERT_TRUE(storage.saveEquipmentBatch({createTestEquipment("kept")}));
+        ASSERT_TRUE(storage.saveEquipmentBatch({createTestEquipment("torn1"), createTestEquipment("torn2")}));
+    }
+
+    // Cut the second pack inside its last entry, as a crash mid-write would
+    std::filesystem::path pack = test_db_path + "/equipment/packs/pack-0000000000000002.pack";
+    std::filesystem::resize_file(pack, std::filesystem::file_size(pack) - 5);
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    EXPECT_TRUE(storage.loadEquipment("kept").has_value());
+    EXPECT_TRUE(storage.loadEquipment("torn1").has_value());
+    EXPECT_FALSE(storage.loadEquipment("torn2").has_value());
+}
+
+TEST_F(DataStorageTest, SupersededPacksAreCompacted) {
+    auto countPacks = [this] {
+        size_t packs = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(test_db_path + "/equipment/packs")) {
+            (void)entry;
+            ++packs;
+        }
+        return packs;
+    };
+
+    std::vector<Equipment> fleet;
+    for (int i = 0; i < 1000; ++i) {
+        fleet.push_back(createTestEquipment("fleet" + std::to_string(i)));
+    }
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+
+        // Rewriting the whole fleet supersedes the previous pack each time
+        size_t most = 0;
+        for (int round = 0; round < 20; ++round) {
+            fleet[0].setName("Round " + std::to_string(round));
+            ASSERT_TRUE(storage.saveEquipmentBatch(fleet));
+            most = std::max(most, countPacks());
+        }
+        EXPECT_GT(most, 2u);
+        EXPECT_LT(countPacks(), most);
+
+        // Deletion markers are dropped by compaction too
+        std::vector<EquipmentId> removed;
+        for (int i = 500; i < 1000; ++i) {
+            removed.push_back(fleet[i].getId());
+        }
+        ASSERT_TRUE(storage.deleteEquipmentBatch(removed));
+        fleet.erase(fleet.begin() + 500, fleet.end());
+        for (int round = 0; round < 20; ++round) {
+            ASSERT_TRUE(storage.saveEquipmentBatch(fleet));
+        }
+        EXPECT_LT(countPacks(), 10u);
+        EXPECT_EQ(500u, storage.getAllEquipment().size());
+    }
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    EXPECT_EQ(500u, storage.getAllEquipment().size());
+    EXPECT_EQ("Round 19", storage.loadEquipment("fleet0")->getName());
+    EXPECT_FALSE(storage.loadEquipment("fleet700").has_value());
+}
+
+TEST_F(DataStorageTest, RecentPositionsReadOnlyTheNewestFixes) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    DataStorage storage(test_db_path, IoBackendType::ThreadPool, options);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("recent")));
+
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+    for (int i = 0; i < 45; ++i) {
+        storage.savePosition("recent", Position(i, 0.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+    }
+
+    auto recent = storage.getRecentPositions("recent", 12);
+    ASSERT_EQ(12u, recent.size());
+    EXPECT_DOUBLE_EQ(33.0, recent.front().getLatitude());
+    EXPECT_DOUBLE_EQ(44.0, recent.back().getLatitude());
+
+    EXPECT_EQ(45u, storage.getRecentPositions("recent", 100).size());
+    EXPECT_TRUE(storage.getRecentPositions("unknown", 10).empty());
+}
+
+TEST_F(DataStorageTest, HistoryQueriesSpanHotWarmAndColdTiers) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    DataStorage storage(test_db_path, IoBackendType::ThreadPool, options);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("tiered")));
+
+    // Forty days every six hours, then the last hour every minute
+    auto now = std::chrono::system_clock::from_time_t(std::chrono::system_clock::to_time_t(getCurrentTimestamp()));
+    for (int i = 0; i < 160; ++i) {
+        storage.savePosition("tiered", Position(i, 0.0, 0.0, 2.0,
+                                                now - std::chrono::hours(24 * 40) + std::chrono::hours(6 * i)));
+    }
+    for (int j = 0; j < 60; ++j) {
+        storage.savePosition("tiered", Position(1000 + j, 0.0, 0.0, 2.0,
+                                                now - std::chrono::seconds(3570 - 60 * j)));
+    }
+    storage.maintainHistoryTiers(now);
+
+    auto stats = storage.getHistoryTierStats();
+    EXPECT_GT(stats.logs.cold_segments, 0u);
+    EXPECT_GT(stats.logs.warm_segments, 0u);
+    EXPECT_EQ(0u, stats.hot_equipment);
+
+    // Last half hour: loads the hot tier, which then follows new fixes
+    auto recent = storage.getPositionHistory("tiered", now - std::chrono::minutes(30), now);
+    ASSERT_EQ(30u, recent.size());
+    EXPECT_DOUBLE_EQ(1030.0, recent.front().getLatitude());
+    stats = storage.getHistoryTierStats();
+    EXPECT_EQ(1u, stats.hot_equipment);
+    EXPECT_EQ(60u, stats.hot_fixes);
+
+    storage.savePosition("tiered", Position(2000, 0.0, 0.0, 2.0, now));
+    recent = storage.getPositionHistory("tiered", now - std::chrono::minutes(30), now);
+    ASSERT_EQ(31u, recent.size());
+    EXPECT_DOUBLE_EQ(2000.0, recent.back().getLatitude());
+
+    // Five weeks ago is only in compressed archives
+    auto cold = storage.getPositionHistory("tiered", now - std::chrono::hours(24 * 35), now - std::chrono::hours(24 * 33));
+    ASSERT_EQ(9u, cold.size());
+    EXPECT_DOUBLE_EQ(20.0, cold.front().getLatitude());
+    EXPECT_DOUBLE_EQ(28.0, cold.back().getLatitude());
+
+    auto warm = storage.getPositionHistory("tiered", now - std::chrono::hours(24 * 10), now - std::chrono::hours(24 * 9));
+    EXPECT_EQ(5u, warm.size());
+
+    EXPECT_EQ(221u, storage.getPositionHistory("tiered").size());
+
+    ASSERT_TRUE(storage.deleteEquipment("tiered"));
+    EXPECT_EQ(0u, storage.getHistoryTierStats().hot_equipment);
+    EXPECT_TRUE(storage.getPositionHistory("tiered", now - std::chrono::minutes(30), now).empty());
+}
+
+TEST_F(DataStorageTest, RotationArchivesAgedSegmentsInTheBackground) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    DataStorage storage(test_db_path, IoBackendType::ThreadPool, options);
+    ASSERT_TRUE(storage.initialize());
+
+    // Forty days every six hours; no maintenance call
+    auto now = std::chrono::system_clock::from_time_t(std::chrono::system_clock::to_time_t(getCurrentTimestamp()));
+    for (int i = 0; i < 160; ++i) {
+        ASSERT_TRUE(storage.savePosition("rotating", Position(i, 0.0, 0.0, 2.0,
+                                                              now - std::chrono::hours(24 * 40) + std::chrono::hours(6 * i))));
+    }
+    storage.waitForArchiving();
+
+    auto stats = storage.getHistoryTierStats();
+    EXPECT_GT(stats.logs.cold_segments, 0u);
+    EXPECT_GT(stats.logs.warm_segments, 0u);
+
+    auto history = storage.getPositionHistory("rotating", now - std::chrono::hours(24 * 41), now);
+    ASSERT_EQ(160u, history.size());
+    EXPECT_DOUBLE_EQ(0.0, history.front().getLatitude());
+    EXPECT_DOUBLE_EQ(159.0, history.back().getLatitude());
+}
+
+TEST_F(DataStorageTest, ScanPositionHistoryStreamsOneSegmentAtATime) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    DataStorage storage(test_db_path, IoBackendType::ThreadPool, options);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("scanned")));
+
+    auto base = std::chrono::system_clock::from_time_t(1700000000);
+    for (int i = 0; i < 45; ++i) {
+        storage.savePosition("scanned", Position(i, 0.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+    }
+
+    // No chunk is larger than a segment
+    std::vector<size_t> chunk_sizes;
+    double expected = 5.0;
+    EXPECT_TRUE(storage.scanPositionHistory("scanned", base + std::chrono::seconds(5), base + std::chrono::seconds(30),
+        [&](const std::vector<Position>& chunk) {
+            chunk_sizes.push_back(chunk.size());
+            for (const auto& position : chunk) {
+                EXPECT_DOUBLE_EQ(expected++, position.getLatitude());
+            }
+            return true;
+        }));
+    EXPECT_EQ(31.0, expected);
+    EXPECT_GE(chunk_sizes.size(), 3u);
+    for (size_t size : chunk_sizes) {
+        EXPECT_LE(size, 10u);
+    }
+
+    // Stopping early
+    size_t chunks = 0;
+    storage.scanPositionHistory("scanned", Timestamp(), getCurrentTimestamp(),
+        [&](const std::vector<Position>&) {
+            return ++chunks < 2;
+        });
+    EXPECT_EQ(2u, chunks);
+
+    EXPECT_FALSE(storage.scanPositionHistory("unknown", Timestamp(), getCurrentTimestamp(),
+        [](const std::vector<Position>&) { return true; }));
+}
+
+TEST_F(DataStorageTest, AggregatedHistoryFollowsTheEquipmentLifecycle) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("rolled")));
+
+    auto base = std::chrono::system_clock::from_time_t(1700002800);
+    for (int i = 0; i < 180; ++i) {
+        storage.savePosition("rolled", Position(37.0, -122.0 + i * 1e-4, 0.0, 2.0, base + std::chrono::seconds(i * 20)));
+    }
+
+    auto hourly = storage.getAggregatedHistory("rolled", base, base + std::chrono::hours(1), std::chrono::hours(1));
+    ASSERT_EQ(1u, hourly.size());
+    EXPECT_EQ(180u, hourly[0].samples);
+    EXPECT_NEAR(179 * Position(37.0, -122.0).distanceTo(Position(37.0, -122.0001)), hourly[0].distance_meters, 1e-3);
+
+    // A reused ID starts with empty rollups
+    ASSERT_TRUE(storage.deleteEquipment("rolled"));
+    EXPECT_TRUE(storage.getAggregatedHistory("rolled", base, base + std::chrono::hours(1),
+                                             std::chrono::hours(1)).empty());
+    ASSERT_TRUE(storage.saveEquipment(createTestEquipment("rolled")));
+    storage.savePosition("rolled", Position(37.0, -122.0, 0.0, 2.0, base + std::chrono::minutes(5)));
+    hourly = storage.getAggregatedHistory("rolled", base, base + std::chrono::hours(1), std::chrono::hours(1));
+    ASSERT_EQ(1u, hourly.size());
+    EXPECT_EQ(1u, hourly[0].samples);
+}
+
+TEST_F(DataStorageTest, UtilizationCountersPersistWithTheRecord) {
+    Equipment equipment = createTestEquipment("counted");
+    UtilizationCounters counters;
+    counters.moving_seconds = 3600.25;
+    counters.idle_seconds = 7200.5;
+    counters.distance_meters = 12345.678;
+    equipment.setUtilization(counters);
+
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        ASSERT_TRUE(storage.saveEquipment(equipment));
+        ASSERT_TRUE(storage.saveEquipmentBatch({createTestEquipment("idle")}));
+    }
+
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    auto loaded = storage.loadEquipment("counted");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_DOUBLE_EQ(3600.25, loaded->getUtilization().moving_seconds);
+    EXPECT_DOUBLE_EQ(7200.5, loaded->getUtilization().idle_seconds);
+    EXPECT_NEAR(12345.678, loaded->getUtilization().distance_meters, 1e-9);
+
+    auto idle = storage.loadEquipment("idle");
+    ASSERT_TRUE(idle.has_value());
+    EXPECT_EQ(0.0, idle->getUtilization().operatingSeconds());
+}
+
 } // namespace equipment_tracker
 // </test_code>
\ No newline at end of file
@@ -259,4 +259,36 @@ namespace equipment_tracker
         EXPECT_THAT(unknown.toString(), ::testing::HasSubstr("status=Unknown"));
     }
 
+    TEST_F(EquipmentTest, UtilizationAccumulatesPerInterval)
+    {
+        Equipment equipment("123", EquipmentType::Truck, "Truck");
+        auto base = std::chrono::system_clock::from_time_t(1700000000);
+
+        // 10 s parked with jitter, 10 s at about 5.6 m/s, then a gap and a stale fix
+        equipment.updateUtilization(Position(37.0, -122.0, 0.0, 2.0, base));
+        equipment.updateUtilization(Position(37.00001, -122.0, 0.0, 2.0, base + std::chrono::seconds(10)));
+        equipment.updateUtilization(Position(37.00051, -122.0, 0.0, 2.0, base + std::chrono::seconds(20)));
+        equipment.updateUtilization(Position(37.00051, -122.0, 0.0, 2.0, base + std::chrono::seconds(5)));
+        equipment.updateUtilization(Position(37.1, -122.0, 0.0, 2.0, base + std::chrono::hours(2)));
+
+        UtilizationCounters counters = equipment.getUtilization();
+        EXPECT_DOUBLE_EQ(10.0, counters.idle_seconds);
+        EXPECT_DOUBLE_EQ(10.0, counters.moving_seconds);
+        EXPECT_DOUBLE_EQ(20.0, counters.operatingSeconds());
+        EXPECT_NEAR(55.6, counters.distance_meters, 0.1);
+
+        // Counters travel with copies, and the next interval starts from the newest fix
+        Equipment copy = equipment;
+        copy.updateUtilization(Position(37.1, -122.0, 0.0, 2.0, base + std::chrono::hours(2) + std::chrono::seconds(30)));
+        EXPECT_DOUBLE_EQ(40.0, copy.getUtilization().idle_seconds);
+        EXPECT_DOUBLE_EQ(10.0, equipment.getUtilization().idle_seconds);
+
+        // A reloaded record continues from its last position
+        Equipment reloaded("123", EquipmentType::Truck, "Truck");
+        reloaded.setUtilization(counters);
+        reloaded.setLastPosition(Position(37.0, -122.0, 0.0, 2.0, base));
+        reloaded.updateUtilization(Position(37.0, -122.0, 0.0, 2.0, base + std::chrono::seconds(60)));
+        EXPECT_DOUBLE_EQ(70.0, reloaded.getUtilization().idle_seconds);
+    }
+
 } // namespace equipment_tracker
\ No newline at end of file
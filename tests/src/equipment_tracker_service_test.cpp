@@ -1,6 +1,12 @@
 // <test_code>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <thread>
 #include "equipment_tracker/equipment_tracker_service.h"
 
@@ -8,7 +14,8 @@
 class TestableEquipmentTrackerService : public equipment_tracker::EquipmentTrackerService
 {
 public:
-    TestableEquipmentTrackerService() : equipment_tracker::EquipmentTrackerService() {}
+    explicit TestableEquipmentTrackerService(const std::string &db_path)
+        : equipment_tracker::EquipmentTrackerService(db_path) {}
 
     // Expose internal state for testing if needed
     bool isInternalRunning() const { return isRunning(); }
@@ -18,11 +25,19 @@ public:
 class EquipmentTrackerServiceTest : public ::testing::Test
 {
 protected:
+    std::string db_path;
     std::unique_ptr<TestableEquipmentTrackerService> service;
 
     void SetUp() override
     {
-        service = std::make_unique<TestableEquipmentTrackerService>();
+        // A fresh storage directory per test, outside the default path
+        static std::atomic<int> counter{0};
+        db_path = (std::filesystem::temp_directory_path() /
+                   ("service_test_" +
+                    std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + "_" +
+                    std::to_string(counter++)))
+                      .string();
+        service = std::make_unique<TestableEquipmentTrackerService>(db_path);
     }
 
     void TearDown() override
@@ -31,6 +46,8 @@ protected:
         {
             service->stop();
         }
+        service.reset();
+        std::filesystem::remove_all(db_path);
     }
 
     // Helper method to create a test equipment
@@ -303,6 +320,465 @@ TEST_F(EquipmentTrackerServiceTest, ServiceStateConsistency)
     EXPECT_TRUE(service->isRunning());
 }
 
+// Test interpolated batch lookup at an instant
+TEST_F(EquipmentTrackerServiceTest, GetPositionsAtInterpolatesHistory)
+{
+    auto base = std::chrono::system_clock::now() - std::chrono::minutes(5);
+
+    auto equipment1 = createTestEquipment("TEST-001");
+    equipment1.recordPosition(equipment_tracker::Position(10.0, 20.0, 0.0, 2.0, base));
+    equipment1.recordPosition(equipment_tracker::Position(10.0, 20.2, 0.0, 2.0, base + std::chrono::seconds(20)));
+
+    auto equipment2 = createTestEquipment("TEST-002");
+    equipment2.recordPosition(equipment_tracker::Position(-5.0, 30.0, 0.0, 2.0, base));
+    equipment2.recordPosition(equipment_tracker::Position(-5.2, 30.0, 0.0, 2.0, base + std::chrono::seconds(10)));
+
+    service->addEquipment(equipment1);
+    service->addEquipment(equipment2);
+
+    auto positions = service->getPositionsAt(
+        {"TEST-001", "NONEXISTENT-001", "TEST-002"},
+        base + std::chrono::seconds(5),
+        equipment_tracker::InterpolationMethod::Linear);
+
+    ASSERT_EQ(positions.size(), 3);
+    ASSERT_TRUE(positions[0].has_value());
+    EXPECT_NEAR(positions[0]->getLongitude(), 20.05, 1e-9);
+    EXPECT_FALSE(positions[1].has_value());
+    ASSERT_TRUE(positions[2].has_value());
+    EXPECT_NEAR(positions[2]->getLatitude(), -5.1, 1e-9);
+}
+
+// Test proximity alerts raised from position updates
+TEST_F(EquipmentTrackerServiceTest, UpdateEquipmentPositionRaisesProximityEvents)
+{
+    std::vector<equipment_tracker::ProximityEvent> events;
+    service->registerProximityCallback([&events](const equipment_tracker::ProximityEvent &event)
+                                       { events.push_back(event); });
+
+    service->addEquipment(createTestEquipment("TEST-001"));
+    service->addEquipment(createTestEquipment("TEST-002"));
+
+    EXPECT_TRUE(service->updateEquipmentPosition("TEST-001", equipment_tracker::Position(37.7749, -122.4194)));
+    EXPECT_TRUE(service->updateEquipmentPosition("TEST-002", equipment_tracker::Position(37.77492, -122.4194)));
+    EXPECT_FALSE(service->updateEquipmentPosition("NONEXISTENT-001", equipment_tracker::Position(37.7749, -122.4194)));
+
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, equipment_tracker::ProximityEventType::Entered);
+    EXPECT_EQ(service->getProximityPairs().size(), 1);
+
+    // Removing one machine closes the pair
+    service->removeEquipment("TEST-002");
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[1].type, equipment_tracker::ProximityEventType::Exited);
+    EXPECT_TRUE(service->getProximityPairs().empty());
+}
+
+// Test that fixes are projected onto the registered site at ingest
+TEST_F(EquipmentTrackerServiceTest, UpdateEquipmentPositionProjectsToSite)
+{
+    uint32_t site = service->addSite("yard", 37.7749, -122.4194, 2000.0);
+    service->addEquipment(createTestEquipment("TEST-001"));
+
+    EXPECT_FALSE(service->getLocalPosition("TEST-001").has_value());
+    service->updateEquipmentPosition("TEST-001", equipment_tracker::Position(37.7758, -122.4194));
+
+    auto local = service->getLocalPosition("TEST-001");
+    ASSERT_TRUE(local.has_value());
+    EXPECT_EQ(local->site, site);
+    EXPECT_NEAR(local->point.north, 100.0, 1.0);
+    EXPECT_NEAR(local->point.east, 0.0, 0.01);
+}
+
+// Test that a held fleet snapshot is unaffected by later writes
+TEST_F(EquipmentTrackerServiceTest, FleetSnapshotIsStableAcrossUpdates)
+{
+    service->addEquipment(createTestEquipment("TEST-001"));
+
+    auto before = service->getFleetSnapshot();
+    ASSERT_EQ(before->size(), 1);
+
+    service->addEquipment(createTestEquipment("TEST-002"));
+    service->updateEquipmentPosition("TEST-001", equipment_tracker::Position(37.7749, -122.4194));
+
+    EXPECT_EQ(before->size(), 1);
+    EXPECT_FALSE(before->find("TEST-001")->getLastPosition().has_value());
+    EXPECT_EQ(before->find("TEST-002"), nullptr);
+
+    auto after = service->getFleetSnapshot();
+    EXPECT_GT(after->getVersion(), before->getVersion());
+    EXPECT_EQ(after->size(), 2);
+    EXPECT_TRUE(after->find("TEST-001")->getLastPosition().has_value());
+    EXPECT_TRUE(service->getEquipment("TEST-001")->getLastPosition().has_value());
+}
+
+// Test that accepted fixes fan out to every position event subscriber
+TEST_F(EquipmentTrackerServiceTest, UpdateEquipmentPositionPublishesEvents)
+{
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    auto &bus = service->getPositionEventBus();
+    bus.subscribe("first", [&](const equipment_tracker::PositionEvent &event)
+                  { first.push_back(event.equipment_id); },
+                  equipment_tracker::DeliveryMode::Synchronous);
+    auto id = bus.subscribe("second", [&](const equipment_tracker::PositionEvent &event)
+                            { second.push_back(event.equipment_id); });
+
+    service->addEquipment(createTestEquipment("TEST-001"));
+    service->updateEquipmentPosition("TEST-001", equipment_tracker::Position(37.7749, -122.4194));
+    service->updateEquipmentPosition("NONEXISTENT-001", equipment_tracker::Position(37.7749, -122.4194));
+    bus.flush();
+
+    ASSERT_EQ(first.size(), 1);
+    EXPECT_EQ(first[0], "TEST-001");
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(bus.getStats(id)->delivered, 1);
+}
+
+// Test that the server uplink sheds fixes later than analytics subscribers
+TEST_F(EquipmentTrackerServiceTest, UplinkHasItsOwnQueueCapacity)
+{
+    size_t uplink_capacity = 0;
+    size_t anomaly_capacity = 0;
+    for (const auto &stats : service->getPositionEventBus().getAllStats())
+    {
+        if (stats.name == "uplink")
+        {
+            uplink_capacity = stats.queue_capacity;
+        }
+        else if (stats.name == "anomaly")
+        {
+            anomaly_capacity = stats.queue_capacity;
+        }
+    }
+
+    EXPECT_EQ(equipment_tracker::UPLINK_EVENT_QUEUE_CAPACITY, uplink_capacity);
+    EXPECT_EQ(equipment_tracker::DEFAULT_EVENT_QUEUE_CAPACITY, anomaly_capacity);
+}
+
+TEST_F(EquipmentTrackerServiceTest, RemovedIdCanBeReAddedBeforeReclamation)
+{
+    auto &storage = service->getDataStorage();
+    auto base = std::chrono::system_clock::from_time_t(1600000000);
+
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("READD-001")));
+    for (int i = 0; i < 50; ++i)
+    {
+        service->updateEquipmentPosition("READD-001", equipment_tracker::Position(
+                                                          37.0, -122.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+    }
+
+    ASSERT_TRUE(service->removeEquipment("READD-001"));
+    EXPECT_FALSE(service->getEquipment("READD-001").has_value());
+
+    // Reuse the ID while the old history may still be waiting for deletion
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("READD-001")));
+    service->updateEquipmentPosition("READD-001", equipment_tracker::Position(
+                                                      38.0, -121.0, 0.0, 2.0, base + std::chrono::seconds(100)));
+
+    storage.waitForReclamation();
+    EXPECT_EQ(0u, storage.getPendingReclamationCount());
+
+    auto history = storage.getPositionHistory("READD-001", base, base + std::chrono::seconds(200));
+    ASSERT_EQ(1u, history.size());
+    EXPECT_DOUBLE_EQ(38.0, history[0].getLatitude());
+
+    service->removeEquipment("READD-001");
+}
+
+TEST_F(EquipmentTrackerServiceTest, BatchOperationsReportPerItemResults)
+{
+    std::vector<equipment_tracker::Equipment> batch;
+    for (int i = 0; i < 5; ++i)
+    {
+        batch.push_back(createTestEquipment("BULK-00" + std::to_string(i)));
+    }
+    batch.push_back(createTestEquipment("BULK-001")); // Repeated in the batch
+    batch.push_back(createTestEquipment("")); // No ID
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("BULK-EXISTING")));
+    batch.push_back(createTestEquipment("BULK-EXISTING")); // Already registered
+
+    auto version = service->getFleetSnapshot()->getVersion();
+    auto added = service->addEquipmentBatch(batch);
+    EXPECT_EQ((std::vector<bool>{true, true, true, true, true, false, false, false}), added);
+    EXPECT_EQ(version + 1, service->getFleetSnapshot()->getVersion());
+    EXPECT_TRUE(service->getEquipment("BULK-004").has_value());
+
+    auto renamed = createTestEquipment("BULK-002");
+    renamed.setName("Renamed");
+    renamed.setStatus(equipment_tracker::EquipmentStatus::Maintenance);
+    equipment_tracker::Equipment retyped("BULK-003", equipment_tracker::EquipmentType::Crane, "Crane");
+    auto updated = service->updateEquipmentBatch({renamed, retyped, createTestEquipment("BULK-MISSING")});
+    EXPECT_EQ((std::vector<bool>{true, false, false}), updated);
+    EXPECT_EQ("Renamed", service->getEquipment("BULK-002")->getName());
+    EXPECT_EQ("Renamed", service->getDataStorage().loadEquipment("BULK-002")->getName());
+
+    auto removed = service->removeEquipmentBatch({"BULK-000", "BULK-001", "BULK-MISSING"});
+    EXPECT_EQ((std::vector<bool>{true, true, false}), removed);
+    EXPECT_FALSE(service->getEquipment("BULK-000").has_value());
+    EXPECT_FALSE(service->getDataStorage().loadEquipment("BULK-001").has_value());
+
+    service->removeEquipmentBatch({"BULK-002", "BULK-003", "BULK-004", "BULK-EXISTING"});
+}
+
+TEST_F(EquipmentTrackerServiceTest, FailedBatchSaveLeavesNothingApplied)
+{
+    // A regular file where the storage directory should be makes every save fail
+    { std::ofstream blocker(db_path); }
+    auto blocked = std::make_unique<TestableEquipmentTrackerService>(db_path + "/db");
+
+    auto version = blocked->getFleetSnapshot()->getVersion();
+    auto added = blocked->addEquipmentBatch({createTestEquipment("FAIL-001"), createTestEquipment("FAIL-002")});
+    EXPECT_EQ((std::vector<bool>{false, false}), added);
+    EXPECT_FALSE(blocked->getEquipment("FAIL-001").has_value());
+    EXPECT_EQ(version, blocked->getFleetSnapshot()->getVersion());
+    EXPECT_FALSE(blocked->addEquipment(createTestEquipment("FAIL-003")));
+    EXPECT_FALSE(blocked->getEquipment("FAIL-003").has_value());
+
+    // Once storage is reachable the same batch goes through
+    std::filesystem::remove(db_path);
+    added = blocked->addEquipmentBatch({createTestEquipment("FAIL-001"), createTestEquipment("FAIL-002")});
+    EXPECT_EQ((std::vector<bool>{true, true}), added);
+    EXPECT_TRUE(blocked->getDataStorage().loadEquipment("FAIL-002").has_value());
+    blocked.reset();
+}
+
+TEST_F(EquipmentTrackerServiceTest, EvictedHistoryIsRefetchedFromStorage)
+{
+    auto base = std::chrono::system_clock::from_time_t(1650000000);
+    std::vector<equipment_tracker::EquipmentId> ids = {"CACHE-001", "CACHE-002", "CACHE-003"};
+    for (const auto &id : ids)
+    {
+        ASSERT_TRUE(service->addEquipment(createTestEquipment(id)));
+        for (int i = 0; i < 5; ++i)
+        {
+            service->updateEquipmentPosition(id, equipment_tracker::Position(
+                                                     37.0 + i, -122.0, 0.0, 2.0, base + std::chrono::seconds(i)));
+        }
+    }
+
+    // Fleet records no longer carry history; reads go through the cache
+    EXPECT_TRUE(service->getFleetSnapshot()->find("CACHE-001")->getPositionHistory().empty());
+    auto history = service->getPositionHistory("CACHE-001");
+    ASSERT_EQ(5u, history.size());
+    EXPECT_DOUBLE_EQ(41.0, history.back().getLatitude());
+
+    service->setHistoryMemoryBudget(0);
+    auto stats = service->getHistoryCacheStats();
+    EXPECT_EQ(0u, stats.resident_entries);
+    EXPECT_EQ(0u, stats.resident_bytes);
+
+    service->setHistoryMemoryBudget(equipment_tracker::DEFAULT_HISTORY_MEMORY_BUDGET);
+    auto equipment = service->getEquipment("CACHE-002");
+    ASSERT_TRUE(equipment.has_value());
+    ASSERT_EQ(5u, equipment->getPositionHistory().size());
+    EXPECT_TRUE(equipment->isMoving());
+
+    auto refetched = service->getHistoryCacheStats();
+    EXPECT_EQ(stats.misses + 1, refetched.misses);
+    EXPECT_EQ(1u, refetched.resident_entries);
+
+    for (const auto &id : ids)
+    {
+        service->removeEquipment(id);
+    }
+}
+
+TEST_F(EquipmentTrackerServiceTest, FleetStateIsPublishedToSharedMemory)
+{
+    std::string name = "/et_service_fleet_" + std::to_string(
+                                                  std::chrono::steady_clock::now().time_since_epoch().count());
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("SHM-001")));
+    ASSERT_TRUE(service->startFleetStatePublishing(name, 64));
+
+    equipment_tracker::FleetStateReader reader;
+    ASSERT_TRUE(reader.open(name));
+    ASSERT_TRUE(reader.find("SHM-001").has_value());
+    EXPECT_FALSE(reader.find("SHM-001")->getPosition().has_value());
+
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("SHM-002")));
+    service->updateEquipmentPosition("SHM-002", equipment_tracker::Position(40.0, -105.0, 1600.0, 3.0));
+    auto record = reader.find("SHM-002");
+    ASSERT_TRUE(record.has_value());
+    ASSERT_TRUE(record->getPosition().has_value());
+    EXPECT_DOUBLE_EQ(40.0, record->getPosition()->getLatitude());
+    EXPECT_EQ(static_cast<uint8_t>(equipment_tracker::EquipmentStatus::Active), record->status);
+
+    service->removeEquipment("SHM-001");
+    EXPECT_FALSE(reader.find("SHM-001").has_value());
+
+    service->stopFleetStatePublishing();
+    equipment_tracker::FleetStateReader late;
+    EXPECT_FALSE(late.open(name));
+
+    service->removeEquipment("SHM-002");
+}
+
+TEST_F(EquipmentTrackerServiceTest, FleetTilesFollowPositionUpdates)
+{
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("TILE-001")));
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("TILE-002")));
+    service->updateEquipmentPosition("TILE-001", equipment_tracker::Position(37.7749, -122.4194, 0.0, 2.0));
+    service->updateEquipmentPosition("TILE-002", equipment_tracker::Position(37.7750, -122.4195, 0.0, 2.0));
+
+    auto world = service->getFleetTile(0, 0, 0);
+    ASSERT_NE(nullptr, world);
+    EXPECT_GE(world->count, 2u);
+
+    auto [x, y] = equipment_tracker::FleetTileIndex::tileFor(37.7749, -122.4194, 16);
+    auto street = service->getFleetTile(16, x, y);
+    ASSERT_NE(nullptr, street);
+    ASSERT_EQ(2u, street->points.size());
+    EXPECT_EQ("TILE-001", street->points[0].id);
+    EXPECT_EQ(equipment_tracker::EquipmentStatus::Active, street->points[0].status);
+
+    // Moving one machine across the world updates both tiles
+    service->updateEquipmentPosition("TILE-002", equipment_tracker::Position(-33.8688, 151.2093, 0.0, 2.0));
+    EXPECT_EQ(1u, service->getFleetTile(16, x, y)->points.size());
+
+    service->removeEquipment("TILE-001");
+    EXPECT_TRUE(service->getFleetTile(16, x, y)->points.empty());
+    service->removeEquipment("TILE-002");
+}
+
+TEST_F(EquipmentTrackerServiceTest, RulesAlertOnPositionUpdates)
+{
+    auto rule = equipment_tracker::parseRule("yard-speeding: type is Forklift and in zone yard and speed > 10 km/h");
+    ASSERT_TRUE(rule.has_value());
+    equipment_tracker::RuleZone yard{"yard", {{37.0, -122.0}, {37.0, -121.99}, {37.01, -121.99}, {37.01, -122.0}}};
+    ASSERT_TRUE(service->setRules({yard}, {*rule}));
+    EXPECT_FALSE(service->setRules({}, {*rule}));
+
+    std::vector<equipment_tracker::RuleAlert> alerts;
+    service->registerRuleCallback([&](const equipment_tracker::RuleAlert &alert)
+                                  { alerts.push_back(alert); });
+
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("RULE-001")));
+    auto base = equipment_tracker::getCurrentTimestamp();
+    service->updateEquipmentPosition("RULE-001", equipment_tracker::Position(37.005, -121.995, 0.0, 2.0, base));
+    service->updateEquipmentPosition("RULE-001", equipment_tracker::Position(37.0051, -121.995, 0.0, 2.0,
+                                                                             base + std::chrono::seconds(2)));
+
+    ASSERT_EQ(1u, alerts.size());
+    EXPECT_EQ("yard-speeding", alerts[0].rule);
+    EXPECT_EQ(equipment_tracker::RuleAlertType::Raised, alerts[0].type);
+    ASSERT_EQ(1u, service->getActiveRuleAlerts().size());
+
+    service->removeEquipment("RULE-001");
+    ASSERT_EQ(2u, alerts.size());
+    EXPECT_EQ(equipment_tracker::RuleAlertType::Cleared, alerts[1].type);
+    EXPECT_TRUE(service->getActiveRuleAlerts().empty());
+}
+
+TEST_F(EquipmentTrackerServiceTest, UtilizationCountersFollowPositionUpdates)
+{
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("UTIL-001")));
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("UTIL-002")));
+    auto base = equipment_tracker::getCurrentTimestamp() - std::chrono::minutes(5);
+    for (int i = 0; i <= 6; ++i)
+    {
+        // Four moving intervals of 10 s, then two parked ones
+        double latitude = 37.0 + std::min(i, 4) * 5e-4;
+        service->updateEquipmentPosition("UTIL-001", equipment_tracker::Position(latitude, -122.0, 0.0, 2.0,
+                                                                                 base + std::chrono::seconds(10 * i)));
+    }
+
+    auto counters = service->getUtilization("UTIL-001");
+    ASSERT_TRUE(counters.has_value());
+    EXPECT_DOUBLE_EQ(40.0, counters->moving_seconds);
+    EXPECT_DOUBLE_EQ(20.0, counters->idle_seconds);
+    EXPECT_NEAR(4 * 55.6, counters->distance_meters, 1.0);
+    EXPECT_FALSE(service->getUtilization("UNKNOWN").has_value());
+
+    auto fleet = service->getFleetUtilization();
+    auto it = std::find_if(fleet.begin(), fleet.end(), [](const auto &entry)
+                           { return entry.first == "UTIL-002"; });
+    ASSERT_NE(fleet.end(), it);
+    EXPECT_EQ(0.0, it->second.operatingSeconds());
+
+    // Saved with the record, so a reload keeps them
+    auto stored = service->getDataStorage().loadEquipment("UTIL-001");
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_DOUBLE_EQ(40.0, stored->getUtilization().moving_seconds);
+
+    service->removeEquipment("UTIL-001");
+    service->removeEquipment("UTIL-002");
+}
+
+TEST_F(EquipmentTrackerServiceTest, AnomaliesReachTheCallback)
+{
+    std::mutex events_mutex;
+    std::vector<equipment_tracker::AnomalyEvent> events;
+    service->registerAnomalyCallback([&](const equipment_tracker::AnomalyEvent &event)
+                                     {
+                                         std::lock_guard<std::mutex> lock(events_mutex);
+                                         events.push_back(event); });
+
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("ANOM-001")));
+    auto base = equipment_tracker::getCurrentTimestamp() - std::chrono::seconds(20);
+    service->updateEquipmentPosition("ANOM-001", equipment_tracker::Position(37.0, -122.0, 0.0, 2.0, base));
+    service->updateEquipmentPosition("ANOM-001", equipment_tracker::Position(37.45, -122.0, 0.0, 2.0,
+                                                                             base + std::chrono::seconds(10)));
+
+    // Detection runs on an event-bus worker
+    size_t received = 0;
+    for (int i = 0; i < 200 && received == 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(events_mutex);
+        received = events.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+        ASSERT_EQ(1u, events.size());
+        EXPECT_EQ("ANOM-001", events[0].equipment_id);
+        EXPECT_EQ(equipment_tracker::AnomalyType::Teleport, events[0].type);
+    }
+    auto baseline = service->getAnomalyBaseline("ANOM-001");
+    ASSERT_TRUE(baseline.has_value());
+    EXPECT_EQ(2u, baseline->samples);
+
+    service->removeEquipment("ANOM-001");
+    EXPECT_FALSE(service->getAnomalyBaseline("ANOM-001").has_value());
+}
+
+TEST_F(EquipmentTrackerServiceTest, PositionsAreMatchedToTheRoadGraph)
+{
+    // A 1 km road running north
+    equipment_tracker::RoadGraph graph;
+    for (int i = 0; i <= 10; ++i)
+    {
+        graph.addNode(37.0 + i * 0.0009, -122.0);
+        if (i > 0)
+        {
+            graph.addEdge(i - 1, i);
+        }
+    }
+    EXPECT_FALSE(service->setRoadGraph(equipment_tracker::RoadGraph()));
+    ASSERT_TRUE(service->setRoadGraph(graph));
+
+    ASSERT_TRUE(service->addEquipment(createTestEquipment("ROAD-001")));
+    auto base = equipment_tracker::getCurrentTimestamp() - std::chrono::seconds(20);
+    service->updateEquipmentPosition("ROAD-001", equipment_tracker::Position(37.0002, -121.99995, 0.0, 2.0, base));
+    service->updateEquipmentPosition("ROAD-001", equipment_tracker::Position(37.0004, -122.00005, 0.0, 2.0,
+                                                                             base + std::chrono::seconds(5)));
+
+    // Matching runs on an event-bus worker
+    std::optional<equipment_tracker::MatchedPosition> matched;
+    for (int i = 0; i < 200 && !(matched && matched->route_meters > 0.0); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        matched = service->getMatchedPosition("ROAD-001");
+    }
+    ASSERT_TRUE(matched.has_value());
+    EXPECT_DOUBLE_EQ(-122.0, std::round(matched->longitude * 1e6) / 1e6);
+    EXPECT_NEAR(22.2, matched->route_meters, 0.5);
+    EXPECT_FALSE(service->getMatchedPosition("UNKNOWN").has_value());
+
+    service->removeEquipment("ROAD-001");
+    EXPECT_FALSE(service->getMatchedPosition("ROAD-001").has_value());
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,86 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "equipment_tracker/fleet_snapshot.h"
+
+namespace equipment_tracker {
+
+class FleetSnapshotTest : public ::testing::Test {
+protected:
+    FleetSnapshotPublisher publisher;
+
+    Equipment makeEquipment(const std::string &id) {
+        return Equipment(id, EquipmentType::Forklift, "Forklift " + id);
+    }
+};
+
+TEST_F(FleetSnapshotTest, StartsEmpty) {
+    auto snapshot = publisher.acquire();
+
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_TRUE(snapshot->empty());
+    EXPECT_EQ(0u, snapshot->getVersion());
+}
+
+TEST_F(FleetSnapshotTest, DerivedVersionsLeaveOriginalUntouched) {
+    auto v0 = publisher.acquire();
+    auto v1 = v0->withEquipment(makeEquipment("FL-1"));
+    auto v2 = v1->withEquipment(makeEquipment("FL-2"));
+    auto v3 = v2->withoutEquipment("FL-1");
+
+    EXPECT_EQ(0u, v0->size());
+    EXPECT_EQ(1u, v1->size());
+    EXPECT_EQ(2u, v2->size());
+    EXPECT_EQ(1u, v3->size());
+    EXPECT_EQ(3u, v3->getVersion());
+
+    EXPECT_EQ(nullptr, v3->find("FL-1"));
+    ASSERT_NE(nullptr, v2->find("FL-1"));
+    EXPECT_EQ("Forklift FL-1", v2->find("FL-1")->getName());
+}
+
+TEST_F(FleetSnapshotTest, UnchangedRecordsAreShared) {
+    auto v1 = publisher.acquire()->withEquipment(makeEquipment("FL-1"));
+    auto v2 = v1->withEquipment(makeEquipment("FL-2"));
+
+    EXPECT_EQ(v1->find("FL-1").get(), v2->find("FL-1").get());
+}
+
+TEST_F(FleetSnapshotTest, PublishMakesSnapshotVisible) {
+    auto next = publisher.acquire()->withEquipment(makeEquipment("FL-1"));
+    publisher.publish(next);
+
+    EXPECT_EQ(next, publisher.acquire());
+    EXPECT_EQ(1u, publisher.getVersion());
+}
+
+TEST_F(FleetSnapshotTest, ReadersSeeConsistentVersionsDuringWrites) {
+    std::atomic<bool> done{false};
+    std::atomic<bool> inconsistent{false};
+
+    // Each version N contains exactly N records
+    std::thread reader([&]() {
+        while (!done.load()) {
+            auto snapshot = publisher.acquire();
+            size_t count = 0;
+            snapshot->forEach([&](const Equipment &) { ++count; });
+            if (count != snapshot->getVersion() || count != snapshot->size()) {
+                inconsistent = true;
+            }
+        }
+    });
+
+    for (int i = 0; i < 500; ++i) {
+        publisher.publish(publisher.acquire()->withEquipment(makeEquipment("FL-" + std::to_string(i))));
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_FALSE(inconsistent.load());
+    EXPECT_EQ(500u, publisher.acquire()->size());
+}
+
+} // namespace equipment_tracker
@@ -0,0 +1,151 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "equipment_tracker/fleet_state_table.h"
+
+namespace equipment_tracker {
+
+class FleetStateTableTest : public ::testing::Test {
+protected:
+    std::string name;
+
+    void SetUp() override {
+        name = "/et_fleet_test_" + std::to_string(::getpid()) + "_" +
+               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    void TearDown() override {
+        ::shm_unlink(name.c_str());
+    }
+
+    static Equipment machine(const std::string& id, double latitude) {
+        Equipment equipment(id, EquipmentType::Crane, "Crane " + id);
+        equipment.setStatus(EquipmentStatus::Active);
+        equipment.setLastPosition(Position(latitude, -122.0, 5.0, 1.5,
+                                           Timestamp(std::chrono::seconds(1700000000))));
+        return equipment;
+    }
+};
+
+TEST_F(FleetStateTableTest, ReaderSeesPublishedState) {
+    FleetStateTable table(name, 16);
+    ASSERT_TRUE(table.create());
+    ASSERT_TRUE(table.publish(machine("CR-1", 37.5)));
+    ASSERT_TRUE(table.publish(Equipment("CR-2", EquipmentType::Truck, "No fix yet")));
+
+    FleetStateReader reader;
+    ASSERT_TRUE(reader.open(name));
+    auto record = reader.find("CR-1");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_STREQ("CR-1", record->id);
+    EXPECT_EQ(static_cast<uint8_t>(EquipmentType::Crane), record->type);
+    EXPECT_EQ(static_cast<uint8_t>(EquipmentStatus::Active), record->status);
+    auto position = record->getPosition();
+    ASSERT_TRUE(position.has_value());
+    EXPECT_DOUBLE_EQ(37.5, position->getLatitude());
+    EXPECT_EQ(Timestamp(std::chrono::seconds(1700000000)), position->getTimestamp());
+
+    ASSERT_TRUE(reader.find("CR-2").has_value());
+    EXPECT_FALSE(reader.find("CR-2")->getPosition().has_value());
+    EXPECT_FALSE(reader.find("CR-3").has_value());
+
+    // Updates are visible through the existing mapping
+    uint64_t generation = reader.getGeneration();
+    ASSERT_TRUE(table.publish(machine("CR-1", 38.0)));
+    EXPECT_GT(reader.getGeneration(), generation);
+    EXPECT_DOUBLE_EQ(38.0, reader.find("CR-1")->latitude);
+    EXPECT_EQ(2u, reader.find("CR-1")->updates);
+    EXPECT_EQ(2u, reader.readAll().size());
+}
+
+TEST_F(FleetStateTableTest, RemovedSlotsAreReused) {
+    FleetStateTable table(name, 2);
+    ASSERT_TRUE(table.create());
+    ASSERT_TRUE(table.publish(machine("A", 1.0)));
+    ASSERT_TRUE(table.publish(machine("B", 2.0)));
+    EXPECT_FALSE(table.publish(machine("C", 3.0))); // Full
+
+    FleetStateReader reader;
+    ASSERT_TRUE(reader.open(name));
+    ASSERT_TRUE(reader.find("A").has_value());
+
+    ASSERT_TRUE(table.remove("A"));
+    EXPECT_FALSE(reader.find("A").has_value());
+    ASSERT_TRUE(table.publish(machine("C", 3.0)));
+    EXPECT_EQ(2u, reader.getSlotCount());
+    ASSERT_TRUE(reader.find("C").has_value());
+    EXPECT_EQ(1u, reader.find("C")->updates);
+
+    table.clear();
+    EXPECT_TRUE(reader.readAll().empty());
+    EXPECT_EQ(0u, table.size());
+}
+
+TEST_F(FleetStateTableTest, RejectsUnknownLayout) {
+    FleetStateReader reader;
+    EXPECT_FALSE(reader.open(name)); // No region
+
+    // A region from a different layout version
+    {
+        FleetStateTable table(name, 4);
+        ASSERT_TRUE(table.create());
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        ASSERT_GE(fd, 0);
+        void* region = ::mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        ASSERT_NE(MAP_FAILED, region);
+        uint32_t version = FLEET_STATE_LAYOUT_VERSION + 1;
+        std::memcpy(static_cast<char*>(region) + 8, &version, sizeof(version));
+        ::munmap(region, 64);
+
+        EXPECT_FALSE(reader.open(name));
+        EXPECT_FALSE(reader.isOpen());
+    }
+
+    FleetStateTable table(name, 4);
+    ASSERT_TRUE(table.create()); // Replaces the region
+    EXPECT_TRUE(reader.open(name));
+}
+
+TEST_F(FleetStateTableTest, ConcurrentReadsAreNeverTorn) {
+    FleetStateTable table(name, 4);
+    ASSERT_TRUE(table.create());
+    Equipment initial("HOT", EquipmentType::Crane, "Crane");
+    initial.setLastPosition(Position(0.0, 0.0, 0.0, 0.0, Timestamp()));
+    ASSERT_TRUE(table.publish(initial));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; i <= 200000; ++i) {
+            Equipment equipment("HOT", EquipmentType::Crane, "Crane");
+            equipment.setLastPosition(Position(i, i, i, i, Timestamp(std::chrono::seconds(i))));
+            table.publish(equipment);
+        }
+        done = true;
+    });
+
+    FleetStateReader reader;
+    ASSERT_TRUE(reader.open(name));
+    size_t reads = 0;
+    while (!done) {
+        auto record = reader.find("HOT");
+        ASSERT_TRUE(record.has_value());
+        ASSERT_EQ(record->latitude, record->longitude);
+        ASSERT_EQ(record->latitude, record->altitude);
+        ASSERT_EQ(record->latitude, record->accuracy);
+        ++reads;
+    }
+    writer.join();
+    EXPECT_GT(reads, 0u);
+    EXPECT_DOUBLE_EQ(200000.0, reader.find("HOT")->latitude);
+}
+
+} // namespace equipment_tracker
+// </test_code>
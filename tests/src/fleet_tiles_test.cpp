@@ -0,0 +1,135 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <string>
+#include "equipment_tracker/fleet_tiles.h"
+
+namespace equipment_tracker {
+
+namespace {
+
+Equipment machineAt(const std::string& id, double latitude, double longitude,
+                    EquipmentType type = EquipmentType::Truck) {
+    Equipment equipment(id, type, "Machine " + id);
+    equipment.setLastPosition(Position(latitude, longitude, 0.0, 2.0));
+    return equipment;
+}
+
+} // namespace
+
+TEST(FleetTileIndexTest, TileForFollowsSlippyMapNumbering) {
+    EXPECT_EQ(std::make_pair(0u, 0u), FleetTileIndex::tileFor(0.0, 0.0, 0));
+    EXPECT_EQ(std::make_pair(1u, 1u), FleetTileIndex::tileFor(-10.0, 10.0, 1));
+    EXPECT_EQ(std::make_pair(0u, 0u), FleetTileIndex::tileFor(10.0, -10.0, 1));
+    // San Francisco at zoom 10
+    EXPECT_EQ(std::make_pair(163u, 395u), FleetTileIndex::tileFor(37.7749, -122.4194, 10));
+    // Poles and the antimeridian stay on the grid
+    EXPECT_EQ(std::make_pair(3u, 0u), FleetTileIndex::tileFor(90.0, 180.0, 2));
+    EXPECT_EQ(std::make_pair(0u, 3u), FleetTileIndex::tileFor(-90.0, -180.0, 2));
+}
+
+TEST(FleetTileIndexTest, LowZoomsReturnClusters) {
+    FleetTileIndex index;
+    index.update(machineAt("SF-1", 37.7749, -122.4194));
+    index.update(machineAt("SF-2", 37.7751, -122.4196));
+    index.update(machineAt("SYD-1", -33.8688, 151.2093));
+    index.update(Equipment("NO-FIX", EquipmentType::Crane, "No fix yet"));
+    EXPECT_EQ(3u, index.size());
+
+    auto world = index.getTile(0, 0, 0);
+    ASSERT_NE(nullptr, world);
+    EXPECT_EQ(3u, world->count);
+    EXPECT_TRUE(world->points.empty());
+    ASSERT_EQ(2u, world->clusters.size());
+
+    uint32_t total = 0;
+    for (const auto& cluster : world->clusters) {
+        total += cluster.count;
+        if (cluster.count == 2) {
+            EXPECT_NEAR(37.775, cluster.latitude, 1e-6);
+            EXPECT_NEAR(-122.4195, cluster.longitude, 1e-6);
+        }
+    }
+    EXPECT_EQ(3u, total);
+
+    auto [x, y] = FleetTileIndex::tileFor(37.7749, -122.4194, 5);
+    EXPECT_EQ(2u, index.getTile(5, x, y)->count);
+    EXPECT_EQ(0u, index.getTile(5, x + 1, y)->count);
+    EXPECT_EQ(nullptr, index.getTile(1, 2, 0));
+    EXPECT_EQ(nullptr, index.getTile(FLEET_TILE_MAX_ZOOM + 1, 0, 0));
+}
+
+TEST(FleetTileIndexTest, HighZoomsReturnMachines) {
+    FleetTileIndex index;
+    index.update(machineAt("B", 37.7749, -122.4194, EquipmentType::Excavator));
+    index.update(machineAt("A", 37.7749, -122.4193));
+    index.update(machineAt("FAR", 37.80, -122.40));
+
+    auto [x, y] = FleetTileIndex::tileFor(37.7749, -122.4194, FLEET_TILE_POINT_ZOOM);
+    auto tile = index.getTile(FLEET_TILE_POINT_ZOOM, x, y);
+    ASSERT_EQ(2u, tile->points.size());
+    EXPECT_TRUE(tile->clusters.empty());
+    EXPECT_EQ("A", tile->points[0].id);
+    EXPECT_EQ("B", tile->points[1].id);
+    EXPECT_EQ(EquipmentType::Excavator, tile->points[1].type);
+
+    // Deeper tiles only list the machines they contain
+    auto [deep_x, deep_y] = FleetTileIndex::tileFor(37.7749, -122.4194, FLEET_TILE_MAX_ZOOM);
+    auto deep = index.getTile(FLEET_TILE_MAX_ZOOM, deep_x, deep_y);
+    ASSERT_EQ(1u, deep->points.size());
+    EXPECT_EQ("B", deep->points[0].id);
+}
+
+TEST(FleetTileIndexTest, TilesAreCachedUntilTheirContentChanges) {
+    FleetTileIndex index;
+    index.update(machineAt("SF-1", 37.7749, -122.4194));
+    index.update(machineAt("SYD-1", -33.8688, 151.2093));
+
+    auto [x, y] = FleetTileIndex::tileFor(37.7749, -122.4194, 8);
+    auto [sx, sy] = FleetTileIndex::tileFor(-33.8688, 151.2093, 8);
+    auto first = index.getTile(8, x, y);
+    auto sydney = index.getTile(8, sx, sy);
+    EXPECT_EQ(first, index.getTile(8, x, y));
+
+    // A move elsewhere leaves the tile alone
+    index.update(machineAt("SYD-1", -33.8700, 151.2100));
+    EXPECT_EQ(first, index.getTile(8, x, y));
+    EXPECT_NE(sydney, index.getTile(8, sx, sy));
+
+    // A move within the tile rebuilds it
+    index.update(machineAt("SF-1", 37.7800, -122.4100));
+    auto moved = index.getTile(8, x, y);
+    EXPECT_NE(first, moved);
+    ASSERT_EQ(1u, moved->clusters.size());
+    EXPECT_DOUBLE_EQ(37.78, moved->clusters[0].latitude);
+
+    // Leaving the tile empties it
+    index.update(machineAt("SF-1", 40.7128, -74.0060));
+    EXPECT_EQ(0u, index.getTile(8, x, y)->count);
+    EXPECT_EQ(2u, index.getTile(0, 0, 0)->count);
+
+    index.remove("SF-1");
+    index.remove("SYD-1");
+    EXPECT_EQ(0u, index.size());
+    EXPECT_EQ(0u, index.getTile(0, 0, 0)->count);
+}
+
+TEST(FleetTileIndexTest, StatusChangesReachPointTiles) {
+    FleetTileIndex index;
+    Equipment equipment = machineAt("T-1", 37.7749, -122.4194);
+    index.update(equipment);
+
+    auto [x, y] = FleetTileIndex::tileFor(37.7749, -122.4194, 16);
+    EXPECT_EQ(EquipmentStatus::Inactive, index.getTile(16, x, y)->points[0].status);
+
+    equipment.setStatus(EquipmentStatus::Maintenance);
+    index.update(equipment);
+    EXPECT_EQ(EquipmentStatus::Maintenance, index.getTile(16, x, y)->points[0].status);
+
+    // Machines without a position leave the index
+    index.update(Equipment("T-1", EquipmentType::Truck, "Truck"));
+    EXPECT_EQ(0u, index.size());
+    EXPECT_TRUE(index.getTile(16, x, y)->points.empty());
+}
+
+} // namespace equipment_tracker
+// </test_code>
@@ -0,0 +1,99 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "equipment_tracker/hash_ring.h"
+
+namespace equipment_tracker {
+
+class ConsistentHashRingTest : public ::testing::Test {
+protected:
+    static constexpr size_t KEYS = 20000;
+
+    static std::map<std::string, std::string> owners(const ConsistentHashRing& ring) {
+        std::map<std::string, std::string> result;
+        for (size_t i = 0; i < KEYS; ++i) {
+            std::string key = "EQ-" + std::to_string(i);
+            result[key] = *ring.ownerOf(key);
+        }
+        return result;
+    }
+};
+
+TEST_F(ConsistentHashRingTest, EmptyRingHasNoOwner) {
+    ConsistentHashRing ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.ownerOf("EQ-1").has_value());
+
+    EXPECT_TRUE(ring.addNode("a"));
+    EXPECT_FALSE(ring.addNode("a"));
+    EXPECT_EQ("a", *ring.ownerOf("EQ-1"));
+    EXPECT_TRUE(ring.removeNode("a"));
+    EXPECT_FALSE(ring.removeNode("a"));
+    EXPECT_FALSE(ring.ownerOf("EQ-1").has_value());
+}
+
+TEST_F(ConsistentHashRingTest, KeysAreSpreadEvenly) {
+    ConsistentHashRing ring;
+    for (const char* node : {"a", "b", "c", "d"}) {
+        ring.addNode(node);
+    }
+
+    std::map<std::string, size_t> counts;
+    for (const auto& [key, owner] : owners(ring)) {
+        ++counts[owner];
+    }
+    ASSERT_EQ(4u, counts.size());
+    for (const auto& [node, count] : counts) {
+        EXPECT_GT(count, KEYS / 4 * 3 / 4) << node;
+        EXPECT_LT(count, KEYS / 4 * 5 / 4) << node;
+    }
+}
+
+TEST_F(ConsistentHashRingTest, OwnershipIsIndependentOfInsertionOrder) {
+    ConsistentHashRing forward;
+    ConsistentHashRing backward;
+    for (const char* node : {"a", "b", "c"}) {
+        forward.addNode(node);
+    }
+    for (const char* node : {"c", "b", "a"}) {
+        backward.addNode(node);
+    }
+    EXPECT_EQ(owners(forward), owners(backward));
+    EXPECT_EQ(ConsistentHashRing::hash("EQ-1"), ConsistentHashRing::hash(std::string("EQ-1")));
+}
+
+TEST_F(ConsistentHashRingTest, MembershipChangesMoveOnlyAffectedKeys) {
+    ConsistentHashRing ring;
+    for (const char* node : {"a", "b", "c"}) {
+        ring.addNode(node);
+    }
+    auto before = owners(ring);
+
+    // A joining node takes about a quarter of the keys, all from others
+    ring.addNode("d");
+    auto joined = owners(ring);
+    size_t moved = 0;
+    for (const auto& [key, owner] : joined) {
+        if (owner != before[key]) {
+            EXPECT_EQ("d", owner) << key;
+            ++moved;
+        }
+    }
+    EXPECT_GT(moved, KEYS / 4 * 3 / 4);
+    EXPECT_LT(moved, KEYS / 4 * 5 / 4);
+
+    // A leaving node hands over only its own keys
+    ring.removeNode("b");
+    for (const auto& [key, owner] : owners(ring)) {
+        if (joined[key] != "b") {
+            EXPECT_EQ(joined[key], owner) << key;
+        } else {
+            EXPECT_NE("b", owner) << key;
+        }
+    }
+}
+
+} // namespace equipment_tracker
+// </test_code>
@@ -0,0 +1,156 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "equipment_tracker/history_cache.h"
+
+namespace equipment_tracker {
+
+class HistoryCacheTest : public ::testing::Test {
+protected:
+    // Stands in for DataStorage: every fix ever recorded, per equipment
+    std::map<EquipmentId, std::vector<Position>> stored;
+    size_t loads = 0;
+
+    HistoryCache::Loader loader() {
+        return [this](const EquipmentId& id, size_t max_positions) {
+            ++loads;
+            auto& history = stored[id];
+            size_t first = history.size() > max_positions ? history.size() - max_positions : 0;
+            return std::vector<Position>(history.begin() + first, history.end());
+        };
+    }
+
+    static Position fix(int i) {
+        return Position(37.0 + i * 0.001, -122.0, 0.0, 2.0,
+                        Timestamp(std::chrono::seconds(1700000000 + i)));
+    }
+
+    void ingest(HistoryCache& cache, const EquipmentId& id, int i) {
+        stored[id].push_back(fix(i));
+        cache.record(id, fix(i));
+    }
+
+    // Resident size of one machine with a full history
+    size_t entryBytes(size_t max_positions) {
+        HistoryCache probe(loader(), SIZE_MAX, max_positions);
+        for (size_t i = 0; i < max_positions; ++i) {
+            stored["probe"].push_back(fix(static_cast<int>(i)));
+        }
+        probe.get("probe");
+        stored.erase("probe");
+        loads = 0;
+        return probe.getStats().resident_bytes;
+    }
+};
+
+TEST_F(HistoryCacheTest, MissLoadsThenHits) {
+    HistoryCache cache(loader(), SIZE_MAX, 10);
+    for (int i = 0; i < 15; ++i) {
+        stored["EQ-1"].push_back(fix(i));
+    }
+
+    auto history = cache.get("EQ-1");
+    ASSERT_EQ(10u, history.size());
+    EXPECT_EQ(fix(5).getTimestamp(), history.front().getTimestamp());
+
+    ingest(cache, "EQ-1", 15);
+    history = cache.get("EQ-1");
+    ASSERT_EQ(10u, history.size());
+    EXPECT_EQ(fix(15).getTimestamp(), history.back().getTimestamp());
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, loads);
+    EXPECT_EQ(1u, stats.resident_entries);
+}
+
+TEST_F(HistoryCacheTest, StaysWithinBudget) {
+    size_t bytes = entryBytes(20);
+    HistoryCache cache(loader(), bytes * 5, 20);
+
+    for (int machine = 0; machine < 50; ++machine) {
+        EquipmentId id = "EQ-" + std::to_string(machine);
+        for (int i = 0; i < 20; ++i) {
+            stored[id].push_back(fix(i));
+        }
+        cache.get(id);
+
+        auto stats = cache.getStats();
+        EXPECT_LE(stats.resident_bytes, stats.budget_bytes);
+    }
+
+    auto stats = cache.getStats();
+    EXPECT_LE(stats.resident_entries, 5u);
+    EXPECT_EQ(50u - stats.resident_entries, stats.evictions);
+}
+
+TEST_F(HistoryCacheTest, EvictsColdBeforeRecentlyUsed) {
+    size_t bytes = entryBytes(20);
+    HistoryCache cache(loader(), bytes * 3, 20);
+
+    auto load = [&](const EquipmentId& id) {
+        for (int i = 0; i < 20; ++i) {
+            stored[id].push_back(fix(i));
+        }
+        cache.get(id);
+    };
+    load("EQ-A");
+    load("EQ-B");
+    load("EQ-C");
+
+    // The first sweep clears every reference bit and takes the oldest
+    load("EQ-D");
+    EXPECT_FALSE(cache.isResident("EQ-A"));
+
+    // Used since that sweep, so EQ-B gets a second chance and EQ-C goes
+    ingest(cache, "EQ-B", 20);
+    load("EQ-E");
+    EXPECT_TRUE(cache.isResident("EQ-B"));
+    EXPECT_FALSE(cache.isResident("EQ-C"));
+    EXPECT_TRUE(cache.isResident("EQ-D"));
+    EXPECT_TRUE(cache.isResident("EQ-E"));
+}
+
+TEST_F(HistoryCacheTest, EvictedHistoryIsRefetchedWithNewFixes) {
+    HistoryCache cache(loader(), SIZE_MAX, 10);
+    for (int i = 0; i < 5; ++i) {
+        ingest(cache, "EQ-1", i);
+    }
+    cache.get("EQ-1");
+
+    cache.setBudget(0);
+    EXPECT_FALSE(cache.isResident("EQ-1"));
+
+    // Recorded while evicted: only storage has it
+    ingest(cache, "EQ-1", 5);
+
+    cache.setBudget(SIZE_MAX);
+    auto history = cache.get("EQ-1");
+    ASSERT_EQ(6u, history.size());
+    EXPECT_EQ(fix(5).getTimestamp(), history.back().getTimestamp());
+    EXPECT_EQ(2u, cache.getStats().misses);
+    EXPECT_GE(cache.getStats().evictions, 1u);
+}
+
+TEST_F(HistoryCacheTest, PutAndErase) {
+    HistoryCache cache(loader(), SIZE_MAX, 3);
+    cache.put("EQ-1", {fix(0), fix(1), fix(2), fix(3)});
+
+    auto history = cache.get("EQ-1");
+    ASSERT_EQ(3u, history.size());
+    EXPECT_EQ(fix(1).getTimestamp(), history.front().getTimestamp());
+    EXPECT_EQ(0u, loads);
+
+    cache.erase("EQ-1");
+    EXPECT_FALSE(cache.isResident("EQ-1"));
+    EXPECT_EQ(0u, cache.getStats().resident_bytes);
+    EXPECT_TRUE(cache.get("EQ-1").empty());
+}
+
+} // namespace equipment_tracker
+// </test_code>
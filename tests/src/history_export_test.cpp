@@ -0,0 +1,132 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "equipment_tracker/history_export.h"
+
+namespace equipment_tracker {
+
+class HistoryExportTest : public ::testing::Test {
+protected:
+    std::string test_db_path;
+    std::unique_ptr<DataStorage> storage;
+    Timestamp base = std::chrono::system_clock::from_time_t(1700000000);
+
+    void SetUp() override {
+        test_db_path = "history_export_test_" + std::to_string(::getpid()) + "_" +
+                       std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+        PositionLogOptions options;
+        options.segment_size = POSITION_RECORD_SIZE * 10;
+        storage = std::make_unique<DataStorage>(test_db_path, IoBackendType::ThreadPool, options);
+        ASSERT_TRUE(storage->initialize());
+    }
+
+    void TearDown() override {
+        storage.reset();
+        std::filesystem::remove_all(test_db_path);
+    }
+
+    void record(const EquipmentId& id, int count, double latitude = 37.5) {
+        storage->saveEquipment(Equipment(id, EquipmentType::Truck, "Truck"));
+        for (int i = 0; i < count; ++i) {
+            storage->savePosition(id, Position(latitude + i * 0.25, -122.125, 10.5, 2.0,
+                                               base + std::chrono::milliseconds(1500 * i)));
+        }
+    }
+
+    std::string exportAs(const std::vector<EquipmentId>& ids, HistoryExportFormat format) {
+        std::ostringstream out;
+        HistoryExporter exporter(*storage);
+        EXPECT_TRUE(exporter.exportHistory(ids, format, out));
+        EXPECT_EQ(out.str().size(), exporter.getStats().bytes);
+        return out.str();
+    }
+};
+
+TEST_F(HistoryExportTest, CsvHasOneRowPerFixWithNanosecondTimestamps) {
+    record("T-1", 2);
+    record("T,2", 1);
+
+    EXPECT_EQ("equipment_id,timestamp_ns,latitude,longitude,altitude,accuracy\n"
+              "T-1,1700000000000000000,37.5,-122.125,10.5,2\n"
+              "T-1,1700000001500000000,37.75,-122.125,10.5,2\n"
+              "\"T,2\",1700000000000000000,37.5,-122.125,10.5,2\n",
+              exportAs({"T-1", "T,2", "missing"}, HistoryExportFormat::Csv));
+}
+
+TEST_F(HistoryExportTest, NdjsonEscapesIds) {
+    record("T\"1", 1);
+
+    EXPECT_EQ("{\"equipment_id\":\"T\\\"1\",\"timestamp_ns\":1700000000000000000,\"latitude\":37.5,"
+              "\"longitude\":-122.125,\"altitude\":10.5,\"accuracy\":2}\n",
+              exportAs({"T\"1"}, HistoryExportFormat::Ndjson));
+}
+
+TEST_F(HistoryExportTest, GeoJsonFeatureCollections) {
+    record("T-1", 3);
+    record("T-2", 1, 38.0);
+
+    EXPECT_EQ("{\"type\":\"FeatureCollection\",\"features\":[\n"
+              "{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\",\"coordinates\":"
+              "[[-122.125,37.5,10.5],[-122.125,37.75,10.5],[-122.125,38,10.5]]},"
+              "\"properties\":{\"equipment_id\":\"T-1\",\"fixes\":3,"
+              "\"start_ns\":1700000000000000000,\"end_ns\":1700000003000000000}},\n"
+              "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":[-122.125,38,10.5]},"
+              "\"properties\":{\"equipment_id\":\"T-2\",\"fixes\":1,"
+              "\"start_ns\":1700000000000000000,\"end_ns\":1700000000000000000}}\n"
+              "]}\n",
+              exportAs({"T-1", "T-2"}, HistoryExportFormat::GeoJsonLineStrings));
+
+    EXPECT_EQ("{\"type\":\"FeatureCollection\",\"features\":[\n"
+              "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":[-122.125,38,10.5]},"
+              "\"properties\":{\"equipment_id\":\"T-2\",\"timestamp_ns\":1700000000000000000,\"accuracy\":2}}\n"
+              "]}\n",
+              exportAs({"T-2"}, HistoryExportFormat::GeoJsonPoints));
+
+    EXPECT_EQ("{\"type\":\"FeatureCollection\",\"features\":[\n]}\n",
+              exportAs({"missing"}, HistoryExportFormat::GeoJsonPoints));
+}
+
+TEST_F(HistoryExportTest, ExportsOnlyTheRequestedRangeAcrossSegments) {
+    record("T-1", 100);
+
+    std::ostringstream out;
+    HistoryExporter exporter(*storage);
+    ASSERT_TRUE(exporter.exportHistory({"T-1"}, HistoryExportFormat::Csv, out,
+                                       base + std::chrono::seconds(15), base + std::chrono::seconds(60)));
+    EXPECT_EQ(1u, exporter.getStats().equipment);
+    EXPECT_EQ(31u, exporter.getStats().fixes);
+
+    std::istringstream rows(out.str());
+    std::string row;
+    std::getline(rows, row);
+    std::getline(rows, row);
+    EXPECT_EQ("T-1,1700000015000000000,40,-122.125,10.5,2", row);
+}
+
+TEST_F(HistoryExportTest, BufferedSinkFlushesWhenFull) {
+    std::ostringstream out;
+    {
+        BufferedSink sink(out, 64);
+        for (int i = 0; i < 100; ++i) {
+            sink.appendInteger(i);
+            sink.append(' ');
+        }
+        sink.appendDouble(0.1);
+        sink.appendDouble(std::numeric_limits<double>::quiet_NaN());
+        sink.append(std::string(200, 'x'));
+        EXPECT_GT(out.str().size(), 0u);
+        EXPECT_EQ(290u + 3u + 4u + 200u, sink.getBytesWritten());
+    }
+    EXPECT_EQ(0u, out.str().find("0 1 2 3"));
+    EXPECT_NE(std::string::npos, out.str().find("99 0.1null"));
+    EXPECT_EQ(290u + 3u + 4u + 200u, out.str().size());
+}
+
+} // namespace equipment_tracker
+// </test_code>
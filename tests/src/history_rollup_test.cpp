@@ -0,0 +1,213 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "equipment_tracker/history_rollup.h"
+#include "equipment_tracker/data_storage.h"
+
+namespace equipment_tracker {
+
+class HistoryRollupTest : public ::testing::Test {
+protected:
+    std::string test_db_path;
+    Timestamp base = std::chrono::system_clock::from_time_t(1700002800); // On an hour boundary
+
+    void SetUp() override {
+        test_db_path = "history_rollup_test_" + std::to_string(::getpid()) + "_" +
+                       std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_db_path);
+    }
+
+    Position fixAt(int seconds) const {
+        return Position(37.0 + seconds * 1e-5, -122.0, 10.0 + (seconds % 7), 2.0,
+                        base + std::chrono::seconds(seconds));
+    }
+
+    // Aggregates computed straight from the fixes, for comparison
+    std::vector<PositionAggregate> fromRaw(const std::vector<Position>& fixes, std::chrono::seconds width) const {
+        std::vector<PositionAggregate> result;
+        int64_t width_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(width).count();
+        RollupBucket bucket;
+        const Position* previous = nullptr;
+        for (const auto& fix : fixes) {
+            int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                fix.getTimestamp().time_since_epoch()).count();
+            int64_t start = ns / width_ns * width_ns;
+            if (bucket.samples > 0 && start != bucket.start_ns) {
+                result.push_back(bucket.toAggregate(width_ns));
+                bucket = RollupBucket();
+            }
+            bucket.start_ns = start;
+            double seconds = previous ? std::chrono::duration<double>(
+                fix.getTimestamp() - previous->getTimestamp()).count() : 0.0;
+            bucket.add(fix, previous ? previous->distanceTo(fix) : 0.0, seconds);
+            previous = &fix;
+        }
+        if (bucket.samples > 0) {
+            result.push_back(bucket.toAggregate(width_ns));
+        }
+        return result;
+    }
+
+    static void expectSame(const std::vector<PositionAggregate>& expected,
+                           const std::vector<PositionAggregate>& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i].bucket_start, actual[i].bucket_start);
+            EXPECT_EQ(expected[i].samples, actual[i].samples);
+            EXPECT_EQ(expected[i].first.getTimestamp(), actual[i].first.getTimestamp());
+            EXPECT_EQ(expected[i].last.getTimestamp(), actual[i].last.getTimestamp());
+            EXPECT_DOUBLE_EQ(expected[i].min_latitude, actual[i].min_latitude);
+            EXPECT_DOUBLE_EQ(expected[i].max_latitude, actual[i].max_latitude);
+            EXPECT_DOUBLE_EQ(expected[i].max_altitude, actual[i].max_altitude);
+            EXPECT_NEAR(expected[i].avg_latitude, actual[i].avg_latitude, 1e-9);
+            EXPECT_NEAR(expected[i].distance_meters, actual[i].distance_meters, 1e-6);
+            EXPECT_NEAR(expected[i].max_speed_mps, actual[i].max_speed_mps, 1e-9);
+        }
+    }
+};
+
+TEST_F(HistoryRollupTest, AggregatesMatchTheRawFixes) {
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+
+    std::vector<Position> fixes;
+    for (int t = 0; t < 3 * 3600; t += 10) {
+        fixes.push_back(fixAt(t));
+        ASSERT_TRUE(storage.savePosition("T-1", fixes.back()));
+    }
+
+    Timestamp end = base + std::chrono::hours(3);
+    for (int minutes : {1, 15, 60, 120, 24 * 60}) {
+        std::chrono::seconds width(minutes * 60);
+        expectSame(fromRaw(fixes, width), storage.getAggregatedHistory("T-1", base, end, width));
+    }
+
+    auto hourly = storage.getAggregatedHistory("T-1", base, end, std::chrono::hours(1));
+    ASSERT_EQ(3u, hourly.size());
+    EXPECT_EQ(360u, hourly[0].samples);
+    EXPECT_EQ(base + std::chrono::hours(1), hourly[0].bucket_end);
+    EXPECT_EQ(base + std::chrono::seconds(3590), hourly[0].last.getTimestamp());
+    EXPECT_GT(hourly[1].distance_meters, 0.0);
+
+    // Ranges are widened to whole buckets
+    auto middle = storage.getAggregatedHistory("T-1", base + std::chrono::minutes(90),
+                                               base + std::chrono::minutes(91), std::chrono::hours(1));
+    ASSERT_EQ(1u, middle.size());
+    EXPECT_EQ(360u, middle[0].samples);
+
+    EXPECT_TRUE(storage.getAggregatedHistory("T-1", base, end, std::chrono::seconds(90)).empty());
+    EXPECT_TRUE(storage.getAggregatedHistory("unknown", base, end, std::chrono::hours(1)).empty());
+}
+
+TEST_F(HistoryRollupTest, ReopeningRebuildsOpenBuckets) {
+    std::vector<Position> fixes;
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        for (int t = 0; t < 5000; t += 7) {
+            fixes.push_back(fixAt(t));
+            storage.savePosition("T-1", fixes.back());
+        }
+    }
+
+    Timestamp end = base + std::chrono::hours(4);
+    {
+        DataStorage storage(test_db_path);
+        ASSERT_TRUE(storage.initialize());
+        expectSame(fromRaw(fixes, std::chrono::minutes(1)),
+                   storage.getAggregatedHistory("T-1", base, end, std::chrono::minutes(1)));
+
+        // Writing on after the restart continues the open buckets
+        for (int t = 5000; t < 9000; t += 7) {
+            fixes.push_back(fixAt(t));
+            storage.savePosition("T-1", fixes.back());
+        }
+        expectSame(fromRaw(fixes, std::chrono::minutes(15)),
+                   storage.getAggregatedHistory("T-1", base, end, std::chrono::minutes(15)));
+    }
+
+    // A rollup file with a torn record is cut back and rebuilt from the fixes
+    {
+        std::ofstream torn(std::filesystem::path(test_db_path) / "positions" / "T-1" / "rollup-60.bin",
+                           std::ios::binary | std::ios::app);
+        torn << "torn record";
+    }
+    DataStorage storage(test_db_path);
+    ASSERT_TRUE(storage.initialize());
+    expectSame(fromRaw(fixes, std::chrono::minutes(1)),
+               storage.getAggregatedHistory("T-1", base, end, std::chrono::minutes(1)));
+    expectSame(fromRaw(fixes, std::chrono::hours(1)),
+               storage.getAggregatedHistory("T-1", base, end, std::chrono::hours(1)));
+}
+
+TEST_F(HistoryRollupTest, LateFixesMergeIntoStoredBuckets) {
+    std::filesystem::create_directories(test_db_path);
+    HistoryRollup rollup(test_db_path);
+    EXPECT_FALSE(rollup.open().has_value());
+
+    for (int t : {0, 30, 240, 250, 400}) {
+        ASSERT_TRUE(rollup.add(fixAt(t)));
+    }
+    auto before = rollup.query(base, base + std::chrono::minutes(10), std::chrono::minutes(1));
+    ASSERT_EQ(3u, before.size());
+
+    // One into a closed bucket, one into an empty minute between stored ones
+    ASSERT_TRUE(rollup.add(fixAt(10)));
+    ASSERT_TRUE(rollup.add(fixAt(130)));
+
+    auto after = rollup.query(base, base + std::chrono::minutes(10), std::chrono::minutes(1));
+    ASSERT_EQ(4u, after.size());
+    EXPECT_EQ(3u, after[0].samples);
+    EXPECT_DOUBLE_EQ(before[0].distance_meters, after[0].distance_meters);
+    EXPECT_EQ(base + std::chrono::minutes(2), after[1].bucket_start);
+    EXPECT_EQ(1u, after[1].samples);
+    EXPECT_EQ(0.0, after[1].distance_meters);
+    EXPECT_EQ(base + std::chrono::minutes(4), after[2].bucket_start);
+
+    // The hourly level has stored nothing yet, so a reopen replays every fix
+    // in log order; stored minutes are not counted twice
+    HistoryRollup reopened(test_db_path);
+    EXPECT_FALSE(reopened.open().has_value());
+    for (int t : {0, 30, 240, 250, 400, 10, 130}) {
+        reopened.add(fixAt(t), true);
+    }
+    auto replayed = reopened.query(base, base + std::chrono::minutes(10), std::chrono::minutes(1));
+    ASSERT_EQ(after.size(), replayed.size());
+    for (size_t i = 0; i < after.size(); ++i) {
+        EXPECT_EQ(after[i].samples, replayed[i].samples);
+    }
+    auto hour = reopened.query(base, base, std::chrono::hours(1));
+    ASSERT_EQ(1u, hour.size());
+    EXPECT_EQ(7u, hour[0].samples);
+}
+
+TEST_F(HistoryRollupTest, RecordsRoundTripAndRejectCorruption) {
+    RollupBucket bucket;
+    bucket.start_ns = 1700000000000000000LL;
+    bucket.add(fixAt(0), 0.0, 0.0);
+    bucket.add(fixAt(20), 12.5, 2.5);
+
+    char record[ROLLUP_RECORD_SIZE];
+    bucket.encode(record);
+    RollupBucket decoded;
+    ASSERT_TRUE(RollupBucket::decode(record, decoded));
+    EXPECT_EQ(bucket.start_ns, decoded.start_ns);
+    EXPECT_EQ(2u, decoded.samples);
+    EXPECT_EQ(fixAt(20).getTimestamp(), decoded.last.getTimestamp());
+    EXPECT_DOUBLE_EQ(12.5, decoded.distance_meters);
+    EXPECT_DOUBLE_EQ(5.0, decoded.max_speed_mps);
+
+    record[100] ^= 1;
+    EXPECT_FALSE(RollupBucket::decode(record, decoded));
+}
+
+} // namespace equipment_tracker
+// </test_code>
@@ -0,0 +1,145 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "equipment_tracker/local_projection.h"
+
+namespace equipment_tracker {
+
+class LocalProjectionTest : public ::testing::Test {
+protected:
+    LocalProjection projection{37.7749, -122.4194};
+};
+
+TEST_F(LocalProjectionTest, OriginProjectsToZero) {
+    LocalPoint point = projection.project(37.7749, -122.4194);
+
+    EXPECT_FLOAT_EQ(0.0f, point.east);
+    EXPECT_FLOAT_EQ(0.0f, point.north);
+}
+
+TEST_F(LocalProjectionTest, DistancesMatchHaversineWithinSite) {
+    Position origin(37.7749, -122.4194);
+    std::vector<Position> targets = {
+        Position(37.7839, -122.4194),  // ~1 km north
+        Position(37.7749, -122.4080),  // ~1 km east
+        Position(37.7479, -122.3854),  // ~4 km south-east
+    };
+
+    LocalPoint origin_point = projection.project(origin);
+    for (const auto &target : targets) {
+        double expected = origin.distanceTo(target);
+        double actual = origin_point.distanceTo(projection.project(target));
+        // Haversine uses a spherical Earth; allow for the ellipsoid difference
+        EXPECT_NEAR(expected, actual, expected * 0.005);
+    }
+}
+
+TEST_F(LocalProjectionTest, UnprojectRoundTrips) {
+    LocalPoint point = projection.project(37.7900, -122.4000);
+
+    double lat = 0.0;
+    double lon = 0.0;
+    projection.unproject(point, lat, lon);
+
+    EXPECT_NEAR(37.7900, lat, 1e-6);
+    EXPECT_NEAR(-122.4000, lon, 1e-6);
+}
+
+TEST_F(LocalProjectionTest, BatchMatchesScalar) {
+    std::vector<double> lats;
+    std::vector<double> lons;
+    for (int i = 0; i < 37; ++i) {
+        lats.push_back(37.7749 + i * 0.0007);
+        lons.push_back(-122.4194 - i * 0.0011);
+    }
+
+    std::vector<float> east(lats.size());
+    std::vector<float> north(lats.size());
+    projection.projectBatch(lats.data(), lons.data(), lats.size(), east.data(), north.data());
+
+    for (size_t i = 0; i < lats.size(); ++i) {
+        LocalPoint expected = projection.project(lats[i], lons[i]);
+        EXPECT_FLOAT_EQ(expected.east, east[i]);
+        EXPECT_FLOAT_EQ(expected.north, north[i]);
+    }
+}
+
+TEST_F(LocalProjectionTest, HandlesAntimeridian) {
+    LocalProjection fiji(-17.0, 179.999);
+
+    LocalPoint west = fiji.project(-17.0, -179.999);
+    double lat_east[] = {-17.0};
+    double lon_east[] = {-179.999};
+    float east[1];
+    float north[1];
+    fiji.projectBatch(lat_east, lon_east, 1, east, north);
+
+    EXPECT_GT(west.east, 0.0f);
+    EXPECT_LT(west.east, 500.0f);
+    EXPECT_FLOAT_EQ(west.east, east[0]);
+}
+
+TEST(SiteProjectionRegistryTest, CreatesAndReusesSites) {
+    SiteProjectionRegistry registry(5000.0);
+
+    LocalFix first = registry.project(Position(37.7749, -122.4194));
+    LocalFix nearby = registry.project(Position(37.7800, -122.4100));
+    LocalFix far = registry.project(Position(34.0522, -118.2437));
+
+    EXPECT_EQ(2u, registry.size());
+    EXPECT_EQ(first.site, nearby.site);
+    EXPECT_NE(first.site, far.site);
+    EXPECT_TRUE(registry.getSite(far.site).tile);
+    EXPECT_LT(std::abs(far.point.east), 5000.0f);
+    EXPECT_LT(std::abs(far.point.north), 5000.0f);
+}
+
+TEST(SiteProjectionRegistryTest, AssignmentDoesNotDependOnFixOrder) {
+    std::vector<Position> fixes;
+    for (int i = 0; i < 40; ++i) {
+        fixes.emplace_back(37.70 + 0.005 * i, -122.50 + 0.004 * i);
+    }
+
+    SiteProjectionRegistry forward;
+    SiteProjectionRegistry backward;
+    std::vector<std::string> forward_sites;
+    std::vector<std::string> backward_sites(fixes.size());
+    for (const auto& fix : fixes) {
+        forward_sites.push_back(forward.getSite(forward.project(fix).site).name);
+    }
+    for (size_t i = fixes.size(); i-- > 0;) {
+        backward_sites[i] = backward.getSite(backward.project(fixes[i]).site).name;
+    }
+
+    EXPECT_EQ(forward_sites, backward_sites);
+    EXPECT_GT(forward.size(), 1u);
+}
+
+TEST(SiteProjectionRegistryTest, OverlappingSitesResolveToNearestOrigin) {
+    SiteProjectionRegistry registry;
+    uint32_t west = registry.addSite("west", 51.5, -0.14, 2000.0);
+    uint32_t east = registry.addSite("east", 51.5, -0.11, 2000.0);
+
+    EXPECT_EQ(west, registry.findSite(51.5, -0.13));
+    EXPECT_EQ(east, registry.findSite(51.5, -0.124));
+
+    // In the overlap both sites are reported, away from it only one
+    auto near = registry.sitesNear(51.5, -0.125, 100.0);
+    EXPECT_EQ(2u, near.size());
+    EXPECT_EQ(1u, registry.sitesNear(51.5, -0.15, 100.0).size());
+}
+
+TEST(SiteProjectionRegistryTest, UsesRegisteredSites) {
+    SiteProjectionRegistry registry;
+    uint32_t yard = registry.addSite("yard", 51.5, -0.12, 2000.0);
+
+    auto site = registry.findSite(51.505, -0.12);
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(yard, *site);
+    EXPECT_EQ("yard", registry.getSite(yard).name);
+    EXPECT_FALSE(registry.findSite(51.6, -0.12).has_value());
+}
+
+} // namespace equipment_tracker
@@ -0,0 +1,170 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "equipment_tracker/map_matcher.h"
+
+namespace equipment_tracker {
+
+namespace {
+
+const LocalProjection SITE(37.0, -122.0);
+const Timestamp START = std::chrono::system_clock::from_time_t(1700000000);
+
+// Node placed in metres east and north of the site origin
+uint32_t addNodeAt(RoadGraph& graph, float east, float north) {
+    double latitude = 0.0;
+    double longitude = 0.0;
+    SITE.unproject(LocalPoint{east, north}, latitude, longitude);
+    return graph.addNode(latitude, longitude);
+}
+
+// A straight east-west road of 100 m edges; returns its nodes
+std::vector<uint32_t> addRoad(RoadGraph& graph, float north, int edges) {
+    std::vector<uint32_t> nodes{addNodeAt(graph, 0.0f, north)};
+    for (int i = 1; i <= edges; ++i) {
+        nodes.push_back(addNodeAt(graph, 100.0f * i, north));
+        graph.addEdge(nodes[i - 1], nodes[i]);
+    }
+    return nodes;
+}
+
+Position fixAt(float east, float north, int seconds) {
+    double latitude = 0.0;
+    double longitude = 0.0;
+    SITE.unproject(LocalPoint{east, north}, latitude, longitude);
+    return Position(latitude, longitude, 0.0, 2.0, START + std::chrono::seconds(seconds));
+}
+
+} // namespace
+
+TEST(MapMatcherTest, ParsesRoadGraphText) {
+    std::istringstream text(
+        "# Haul road\n"
+        "node gate 37.0 -122.0\n"
+        "node pit 37.001 -122.0\n"
+        "\n"
+        "node dump 37.001 -122.001\n"
+        "edge gate pit\n"
+        "edge pit dump\n");
+    auto graph = RoadGraph::parse(text);
+    ASSERT_TRUE(graph.has_value());
+    EXPECT_EQ(3u, graph->getNodes().size());
+    ASSERT_EQ(2u, graph->getEdges().size());
+    EXPECT_EQ(1u, graph->getEdges()[1].from);
+    EXPECT_EQ(2u, graph->getEdges()[1].to);
+
+    for (const char* malformed : {"node a 37.0\n", "node a 37.0 -122.0\nnode a 37.1 -122.0\n",
+                                  "node a 37.0 -122.0\nedge a b\n", "node a 37.0 -122.0\nedge a a\n",
+                                  "node a 95.0 -122.0\n", "node a 37.0 -122.0 extra\n", "road a b\n"}) {
+        std::istringstream bad(malformed);
+        EXPECT_FALSE(RoadGraph::parse(bad).has_value()) << malformed;
+    }
+    EXPECT_FALSE(RoadGraph::load("no_such_road_graph.txt").has_value());
+}
+
+TEST(MapMatcherTest, EdgeIndexFindsNearbyEdges) {
+    RoadGraph graph;
+    addRoad(graph, 0.0f, 10);    // Edges 0-9
+    addRoad(graph, 200.0f, 10);  // Edges 10-19
+    MapMatcher matcher(graph);
+
+    double latitude = 0.0;
+    double longitude = 0.0;
+    SITE.unproject(LocalPoint{250.0f, 20.0f}, latitude, longitude);
+    EXPECT_EQ(std::vector<uint32_t>({2}), matcher.edgesNear(latitude, longitude, 30.0));
+
+    // On a node, both edges meeting there
+    SITE.unproject(LocalPoint{300.0f, 190.0f}, latitude, longitude);
+    EXPECT_EQ(std::vector<uint32_t>({12, 13}), matcher.edgesNear(latitude, longitude, 15.0));
+    EXPECT_EQ(std::vector<uint32_t>({2, 3, 11, 12, 13, 14}), matcher.edgesNear(latitude, longitude, 195.0));
+
+    // Between the roads and off the map
+    SITE.unproject(LocalPoint{500.0f, 100.0f}, latitude, longitude);
+    EXPECT_TRUE(matcher.edgesNear(latitude, longitude, 50.0).empty());
+    EXPECT_TRUE(matcher.edgesNear(38.0, -121.0, 50.0).empty());
+}
+
+TEST(MapMatcherTest, ZigzagFixesFollowTheRoad) {
+    RoadGraph graph;
+    addRoad(graph, 0.0f, 10);
+    MapMatcher matcher(graph);
+
+    // 800 m east, fixes every 10 m swinging 7 m either side of the road
+    double raw_meters = 0.0;
+    Position previous = fixAt(50.0f, 7.0f, 0);
+    std::optional<MatchedPosition> matched = matcher.match("HAUL-1", previous);
+    ASSERT_TRUE(matched.has_value());
+    EXPECT_EQ(0.0, matched->route_meters);
+    for (int i = 1; i <= 80; ++i) {
+        Position fix = fixAt(50.0f + 10.0f * i, i % 2 ? -7.0f : 7.0f, 2 * i);
+        raw_meters += previous.distanceTo(fix);
+        previous = fix;
+        matched = matcher.match("HAUL-1", fix);
+        ASSERT_TRUE(matched.has_value());
+        EXPECT_NEAR(7.0, matched->error_meters, 0.1);
+    }
+
+    EXPECT_GT(raw_meters, 1300.0);
+    EXPECT_NEAR(800.0, matched->total_route_meters, 2.0);
+    EXPECT_EQ(8u, matched->edge);
+    EXPECT_NEAR(50.0, matched->offset_meters, 0.5);
+    double latitude = 0.0;
+    double longitude = 0.0;
+    SITE.unproject(LocalPoint{850.0f, 0.0f}, latitude, longitude);
+    EXPECT_NEAR(latitude, matched->latitude, 1e-6);
+    EXPECT_NEAR(longitude, matched->longitude, 1e-6);
+    EXPECT_EQ(START + std::chrono::seconds(160), matched->timestamp);
+}
+
+TEST(MapMatcherTest, StaysOnTheConnectedRoad) {
+    // Two parallel roads 30 m apart, joined only at their west ends
+    RoadGraph graph;
+    auto south = addRoad(graph, 0.0f, 10);
+    auto north = addRoad(graph, 30.0f, 10);
+    graph.addEdge(south[0], north[0]);
+    MapMatcher matcher(graph);
+
+    for (int i = 0; i <= 40; ++i) {
+        // One fix strays closer to the north road
+        float offset = i == 20 ? 17.0f : (i % 2 ? -5.0f : 5.0f);
+        auto matched = matcher.match("HAUL-2", fixAt(100.0f + 20.0f * i, offset, 2 * i));
+        ASSERT_TRUE(matched.has_value());
+        EXPECT_LT(matched->edge, 10u) << "fix " << i;
+    }
+    EXPECT_NEAR(800.0, matcher.getMatch("HAUL-2")->total_route_meters, 2.0);
+}
+
+TEST(MapMatcherTest, RestartsAndIgnoresStaleFixes) {
+    RoadGraph graph;
+    addRoad(graph, 0.0f, 10);
+    MapMatcher matcher(graph);
+
+    ASSERT_TRUE(matcher.match("HAUL-3", fixAt(100.0f, 0.0f, 0)).has_value());
+    ASSERT_TRUE(matcher.match("HAUL-3", fixAt(120.0f, 0.0f, 2)).has_value());
+
+    // Parked jitter adds no distance
+    auto parked = matcher.match("HAUL-3", fixAt(122.0f, 3.0f, 4));
+    ASSERT_TRUE(parked.has_value());
+    EXPECT_EQ(0.0, parked->route_meters);
+    EXPECT_NEAR(20.0, parked->total_route_meters, 0.1);
+
+    // Off the road network, stale, then back after a long gap
+    EXPECT_FALSE(matcher.match("HAUL-3", fixAt(500.0f, 300.0f, 6)).has_value());
+    EXPECT_FALSE(matcher.match("HAUL-3", fixAt(140.0f, 0.0f, 5)).has_value());
+    auto resumed = matcher.match("HAUL-3", fixAt(600.0f, 0.0f, 600));
+    ASSERT_TRUE(resumed.has_value());
+    EXPECT_EQ(0.0, resumed->route_meters);
+    EXPECT_NEAR(20.0, resumed->total_route_meters, 0.1);
+
+    EXPECT_EQ(1u, matcher.size());
+    matcher.remove("HAUL-3");
+    EXPECT_FALSE(matcher.getMatch("HAUL-3").has_value());
+    EXPECT_EQ(0u, matcher.size());
+}
+
+} // namespace equipment_tracker
+// </test_code>
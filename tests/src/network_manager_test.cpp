@@ -265,6 +265,20 @@ TEST_F(NetworkManagerTest, MultiplePositionUpdatesAreProcessed) {
     EXPECT_THAT(output.str(), ::testing::HasSubstr("\"latitude\":40.7128"));
 }
 
+TEST_F(NetworkManagerTest, PositionPayloadCarriesChecksum) {
+    Position position(37.7749, -122.4194, 10.0, 5.0);
+    std::string payload = NetworkManager::formatPositionPayload("equipment1", position);
+
+    EXPECT_THAT(payload, ::testing::HasSubstr("\"crc32c\":\""));
+    EXPECT_TRUE(NetworkManager::verifyPayloadChecksum(payload));
+
+    std::string corrupted = payload;
+    corrupted[corrupted.find("37.7749") + 2] = '8';
+    EXPECT_FALSE(NetworkManager::verifyPayloadChecksum(corrupted));
+    EXPECT_FALSE(NetworkManager::verifyPayloadChecksum(payload.substr(0, payload.size() - 5)));
+    EXPECT_FALSE(NetworkManager::verifyPayloadChecksum("{\"id\":\"equipment1\"}"));
+}
+
 } // namespace equipment_tracker
 
 int main(int argc, char **argv) {
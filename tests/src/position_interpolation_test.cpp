@@ -0,0 +1,112 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+#include "equipment_tracker/position_interpolation.h"
+
+namespace equipment_tracker {
+
+class PositionInterpolationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        start_ = std::chrono::system_clock::now();
+    }
+
+    Position makeFix(double lat, double lon, double alt, int offset_seconds) {
+        return Position(lat, lon, alt, DEFAULT_POSITION_ACCURACY,
+                        start_ + std::chrono::seconds(offset_seconds));
+    }
+
+    Timestamp start_;
+};
+
+TEST_F(PositionInterpolationTest, LinearMidpoint) {
+    Position a = makeFix(10.0, 20.0, 100.0, 0);
+    Position b = makeFix(12.0, 24.0, 200.0, 10);
+
+    Position mid = interpolatePosition(a, b, start_ + std::chrono::seconds(5),
+                                       InterpolationMethod::Linear);
+
+    EXPECT_DOUBLE_EQ(11.0, mid.getLatitude());
+    EXPECT_DOUBLE_EQ(22.0, mid.getLongitude());
+    EXPECT_DOUBLE_EQ(150.0, mid.getAltitude());
+    EXPECT_EQ(start_ + std::chrono::seconds(5), mid.getTimestamp());
+}
+
+TEST_F(PositionInterpolationTest, GreatCircleMatchesLinearOverShortDistances) {
+    Position a = makeFix(37.7749, -122.4194, 0.0, 0);
+    Position b = makeFix(37.7760, -122.4180, 0.0, 4);
+    Timestamp at = start_ + std::chrono::seconds(1);
+
+    Position linear = interpolatePosition(a, b, at, InterpolationMethod::Linear);
+    Position great_circle = interpolatePosition(a, b, at, InterpolationMethod::GreatCircle);
+
+    EXPECT_LT(linear.distanceTo(great_circle), 0.01);
+}
+
+TEST_F(PositionInterpolationTest, GreatCircleStaysOnArc) {
+    // Along the equator the great circle is the equator itself
+    Position a = makeFix(0.0, 0.0, 0.0, 0);
+    Position b = makeFix(0.0, 90.0, 0.0, 90);
+
+    Position mid = interpolatePosition(a, b, start_ + std::chrono::seconds(45),
+                                       InterpolationMethod::GreatCircle);
+
+    EXPECT_NEAR(0.0, mid.getLatitude(), 1e-9);
+    EXPECT_NEAR(45.0, mid.getLongitude(), 1e-9);
+}
+
+TEST_F(PositionInterpolationTest, LinearCrossesAntimeridian) {
+    Position a = makeFix(0.0, 179.0, 0.0, 0);
+    Position b = makeFix(0.0, -179.0, 0.0, 2);
+
+    Position mid = interpolatePosition(a, b, start_ + std::chrono::seconds(1),
+                                       InterpolationMethod::Linear);
+
+    EXPECT_NEAR(180.0, std::abs(mid.getLongitude()), 1e-9);
+}
+
+TEST_F(PositionInterpolationTest, HistoryFindsBracketingFixes) {
+    std::vector<Position> history = {
+        makeFix(0.0, 0.0, 0.0, 0),
+        makeFix(1.0, 1.0, 0.0, 10),
+        makeFix(2.0, 2.0, 0.0, 20),
+        makeFix(3.0, 3.0, 0.0, 30),
+    };
+
+    auto result = interpolateHistory(history, start_ + std::chrono::seconds(25),
+                                     InterpolationMethod::Linear);
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_DOUBLE_EQ(2.5, result->getLatitude());
+    EXPECT_DOUBLE_EQ(2.5, result->getLongitude());
+}
+
+TEST_F(PositionInterpolationTest, HistoryExactHitReturnsFix) {
+    std::vector<Position> history = {
+        makeFix(0.0, 0.0, 0.0, 0),
+        makeFix(1.0, 1.0, 0.0, 10),
+    };
+
+    auto result = interpolateHistory(history, start_ + std::chrono::seconds(10),
+                                     InterpolationMethod::GreatCircle);
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_DOUBLE_EQ(1.0, result->getLatitude());
+    EXPECT_DOUBLE_EQ(1.0, result->getLongitude());
+}
+
+TEST_F(PositionInterpolationTest, HistoryOutsideRangeReturnsNullopt) {
+    std::vector<Position> history = {
+        makeFix(0.0, 0.0, 0.0, 0),
+        makeFix(1.0, 1.0, 0.0, 10),
+    };
+
+    EXPECT_FALSE(interpolateHistory(history, start_ - std::chrono::seconds(1),
+                                    InterpolationMethod::Linear).has_value());
+    EXPECT_FALSE(interpolateHistory(history, start_ + std::chrono::seconds(11),
+                                    InterpolationMethod::Linear).has_value());
+    EXPECT_FALSE(interpolateHistory({}, start_, InterpolationMethod::Linear).has_value());
+}
+
+} // namespace equipment_tracker
@@ -0,0 +1,480 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "equipment_tracker/position_log.h"
+
+namespace equipment_tracker {
+
+class PositionLogTest : public ::testing::Test {
+protected:
+    std::filesystem::path directory;
+    std::unique_ptr<StorageIoBackend> io;
+
+    void SetUp() override {
+        directory = "test_position_log_" +
+                    std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+        io = createStorageIoBackend(IoBackendType::ThreadPool);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    static Position fix(int i) {
+        return Position(37.0 + i * 0.001, -122.0, 10.0, 2.0,
+                        Timestamp(std::chrono::seconds(1700000000 + i)));
+    }
+
+    static void flush(PositionLog& log, StorageIoBackend& backend) {
+        backend.wait();
+        log.writeTail();
+        backend.wait();
+        auto ok = std::make_shared<std::atomic<bool>>(true);
+        log.submitSync(ok);
+        backend.wait();
+        log.releaseSealed();
+        EXPECT_TRUE(ok->load());
+    }
+
+    static size_t fileCount(const std::filesystem::path& dir) {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            (void)entry;
+            ++count;
+        }
+        return count;
+    }
+};
+
+TEST_F(PositionLogTest, OpenWithoutCreateFailsWhenEmpty) {
+    PositionLog log(directory, *io);
+    EXPECT_FALSE(log.open(false));
+    EXPECT_FALSE(std::filesystem::exists(directory));
+}
+
+TEST_F(PositionLogTest, RotatesSegmentsAtConfiguredSize) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 35; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+
+    // Header and footer leave room for 8 fixes per segment
+    EXPECT_EQ(log.getSegmentCount(), 5u);
+    EXPECT_EQ(fileCount(directory), 5u);
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), 35u);
+    for (int i = 0; i < 35; ++i) {
+        EXPECT_EQ(positions[i].getTimestamp(), fix(i).getTimestamp());
+    }
+}
+
+TEST_F(PositionLogTest, ReadRecentStopsAtEnoughSegments) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 35; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+
+    auto recent = log.readRecent(10);
+    ASSERT_EQ(10u, recent.size());
+    EXPECT_EQ(fix(25).getTimestamp(), recent.front().getTimestamp());
+    EXPECT_EQ(fix(34).getTimestamp(), recent.back().getTimestamp());
+
+    EXPECT_EQ(35u, log.readRecent(1000).size());
+    EXPECT_TRUE(log.readRecent(0).empty());
+}
+
+TEST_F(PositionLogTest, PreallocationDoesNotChangeVisibleSize) {
+    PositionLog log(directory, *io);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 3; ++i) {
+        log.append(fix(i));
+    }
+    flush(log, *io);
+
+    auto segment = std::filesystem::directory_iterator(directory)->path();
+    EXPECT_EQ(std::filesystem::file_size(segment), 4 * POSITION_RECORD_SIZE); // Header and 3 fixes
+}
+
+TEST_F(PositionLogTest, ReopenContinuesAfterLastRecord) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 6;
+    {
+        PositionLog log(directory, *io, options);
+        ASSERT_TRUE(log.open(true));
+        for (int i = 0; i < 6; ++i) {
+            log.append(fix(i));
+        }
+        flush(log, *io);
+    }
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(false));
+    EXPECT_EQ(log.getSegmentCount(), 2u);
+    for (int i = 6; i < 9; ++i) {
+        log.append(fix(i));
+    }
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), 9u);
+    EXPECT_EQ(positions.back().getTimestamp(), fix(8).getTimestamp());
+    EXPECT_EQ(log.getSegmentCount(), 3u);
+}
+
+TEST_F(PositionLogTest, TornAndZeroTailIsIgnored) {
+    {
+        PositionLog log(directory, *io);
+        ASSERT_TRUE(log.open(true));
+        log.append(fix(0));
+        log.append(fix(1));
+        flush(log, *io);
+    }
+    {
+        // A record whose checksum never made it, then zeros and a torn write
+        std::ofstream file(directory / "segment-00000001.log", std::ios::binary | std::ios::app);
+        char record[POSITION_RECORD_SIZE];
+        encodePositionRecord(fix(9), record);
+        record[POSITION_RECORD_SIZE - 1] ^= 0x5A;
+        file.write(record, sizeof(record));
+        std::string zeros(POSITION_RECORD_SIZE * 3, '\0');
+        file.write(zeros.data(), zeros.size());
+        file.write(record, 7);
+    }
+
+    PositionLog log(directory, *io);
+    ASSERT_TRUE(log.open(false));
+    log.append(fix(2));
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), 3u);
+    EXPECT_EQ(positions[2].getTimestamp(), fix(2).getTimestamp());
+    EXPECT_EQ(log.verify().corrupt_records, 0u);
+}
+
+TEST_F(PositionLogTest, CorruptRecordIsSkipped) {
+    {
+        PositionLog log(directory, *io);
+        ASSERT_TRUE(log.open(true));
+        for (int i = 0; i < 5; ++i) {
+            log.append(fix(i));
+        }
+        flush(log, *io);
+    }
+    {
+        // Flip a latitude byte of the third fix (after the header record)
+        std::fstream file(directory / "segment-00000001.log", std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(3 * POSITION_RECORD_SIZE + 10);
+        file.put('\x7F');
+    }
+
+    PositionLog log(directory, *io);
+    ASSERT_TRUE(log.open(false));
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), 4u);
+    EXPECT_EQ(positions[1].getTimestamp(), fix(1).getTimestamp());
+    EXPECT_EQ(positions[2].getTimestamp(), fix(3).getTimestamp());
+
+    auto check = log.verify();
+    EXPECT_EQ(check.records, 4u);
+    EXPECT_EQ(check.corrupt_records, 1u);
+}
+
+TEST_F(PositionLogTest, VerifyUsesSegmentFooters) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 12;
+    {
+        PositionLog log(directory, *io, options);
+        ASSERT_TRUE(log.open(true));
+        for (int i = 0; i < 25; ++i) {
+            log.append(fix(i));
+        }
+        flush(log, *io);
+
+        auto check = log.verify();
+        EXPECT_EQ(check.segments, 3u);
+        EXPECT_EQ(check.records, 25u);
+        EXPECT_EQ(check.corrupt_records, 0u);
+        EXPECT_EQ(check.corrupt_segments, 0u);
+    }
+    {
+        std::fstream file(directory / "segment-00000001.log", std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(2 * POSITION_RECORD_SIZE + 3);
+        file.put('\x01');
+    }
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(false));
+    auto check = log.verify();
+    EXPECT_EQ(check.corrupt_segments, 1u);
+    EXPECT_EQ(check.corrupt_records, 1u);
+    EXPECT_EQ(check.records, 24u);
+}
+
+TEST_F(PositionLogTest, ReadsLegacySingleFileLog) {
+    std::filesystem::create_directories(directory);
+    {
+        // The unchecked 40-byte layout: int64 ns timestamp, then four doubles
+        std::ofstream file(directory / POSITION_LOG_FILENAME, std::ios::binary);
+        Position position = fix(0);
+        int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            position.getTimestamp().time_since_epoch()).count();
+        double fields[4] = {position.getLatitude(), position.getLongitude(),
+                            position.getAltitude(), position.getAccuracy()};
+        file.write(reinterpret_cast<const char*>(&timestamp_ns), sizeof(timestamp_ns));
+        file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+
+    PositionLog log(directory, *io);
+    ASSERT_TRUE(log.open(false));
+    log.append(fix(1));
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), 2u);
+    EXPECT_EQ(positions[0].getTimestamp(), fix(0).getTimestamp());
+    EXPECT_DOUBLE_EQ(positions[0].getLatitude(), fix(0).getLatitude());
+
+    // The legacy file is left alone; new fixes go to a checksummed segment
+    EXPECT_EQ(log.getSegmentCount(), 2u);
+    EXPECT_EQ(std::filesystem::file_size(directory / POSITION_LOG_FILENAME), LEGACY_POSITION_RECORD_SIZE);
+}
+
+TEST_F(PositionLogTest, DirectIoRoundTripsAcrossBlocks) {
+    PositionLogOptions options;
+    options.direct_io = true;
+    options.segment_size = DIRECT_IO_ALIGNMENT * 2;
+
+    // Enough records to fill blocks, straddle block edges and rotate
+    const int count = static_cast<int>(options.segment_size / POSITION_RECORD_SIZE) + 50;
+    {
+        PositionLog log(directory, *io, options);
+        ASSERT_TRUE(log.open(true));
+        for (int i = 0; i < count; ++i) {
+            ASSERT_TRUE(log.append(fix(i)));
+        }
+
+        auto positions = log.readAll();
+        ASSERT_EQ(positions.size(), static_cast<size_t>(count));
+        flush(log, *io);
+    }
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(false));
+    log.append(fix(count));
+
+    auto positions = log.readAll();
+    ASSERT_EQ(positions.size(), static_cast<size_t>(count + 1));
+    for (int i = 0; i <= count; ++i) {
+        EXPECT_EQ(positions[i].getTimestamp(), fix(i).getTimestamp());
+    }
+}
+
+TEST_F(PositionLogTest, ArchiveCodecIsLossless) {
+    std::vector<Position> positions;
+    for (int i = 0; i < 200; ++i) {
+        // Irregular intervals, a clock step backwards and sub-second timestamps
+        auto time = Timestamp(std::chrono::seconds(1700000000 + i * 5 + (i % 7))) +
+                    std::chrono::milliseconds(i % 3 == 0 ? 250 : 0);
+        if (i == 100) {
+            time -= std::chrono::seconds(30);
+        }
+        positions.emplace_back(-33.5 + i * 1e-6, 151.25 - i * 3e-7, i % 10 * 0.5, 2.0 + i % 2, time);
+    }
+
+    std::string encoded = encodePositionArchive(positions);
+    EXPECT_LT(encoded.size(), positions.size() * POSITION_RECORD_SIZE / 2);
+
+    std::vector<Position> decoded;
+    ASSERT_TRUE(decodePositionArchive(encoded.data(), encoded.size(), decoded));
+    ASSERT_EQ(positions.size(), decoded.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(positions[i].getLatitude(), decoded[i].getLatitude());
+        EXPECT_EQ(positions[i].getLongitude(), decoded[i].getLongitude());
+        EXPECT_EQ(positions[i].getAltitude(), decoded[i].getAltitude());
+        EXPECT_EQ(positions[i].getAccuracy(), decoded[i].getAccuracy());
+        EXPECT_EQ(positions[i].getTimestamp(), decoded[i].getTimestamp());
+    }
+
+    decoded.clear();
+    EXPECT_FALSE(decodePositionArchive(encoded.data(), encoded.size() / 2, decoded));
+}
+
+TEST_F(PositionLogTest, RotationArchivesAgedSegments) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    options.archive_after_seconds = 10;
+    {
+        PositionLog log(directory, *io, options);
+        ASSERT_TRUE(log.open(true));
+        for (int i = 0; i < 35; ++i) {
+            ASSERT_TRUE(log.append(fix(i)));
+        }
+
+        // Appends only record the cutoff; the owner archives later
+        EXPECT_EQ(0u, log.getTiers().cold_segments);
+        auto cutoff = log.takeArchiveCutoff();
+        ASSERT_TRUE(cutoff.has_value());
+        EXPECT_FALSE(log.takeArchiveCutoff().has_value());
+
+        // Segments ending more than 10 s before the newest fix are compressed
+        EXPECT_EQ(2u, log.archiveBefore(*cutoff));
+        auto tiers = log.getTiers();
+        EXPECT_EQ(2u, tiers.cold_segments);
+        EXPECT_EQ(16u, tiers.cold_fixes);
+        EXPECT_EQ(3u, tiers.warm_segments);
+        EXPECT_TRUE(std::filesystem::exists(directory / "archive-00000001.arc"));
+        EXPECT_FALSE(std::filesystem::exists(directory / "segment-00000001.log"));
+        flush(log, *io);
+    }
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(false));
+    EXPECT_EQ(2u, log.getTiers().cold_segments);
+    EXPECT_EQ(0u, log.verify().corrupt_records);
+
+    auto positions = log.readAll();
+    ASSERT_EQ(35u, positions.size());
+    for (int i = 0; i < 35; ++i) {
+        EXPECT_EQ(fix(i).getTimestamp(), positions[i].getTimestamp());
+        EXPECT_EQ(fix(i).getLatitude(), positions[i].getLatitude());
+    }
+    EXPECT_EQ(5u, log.readRecent(5).size());
+}
+
+TEST_F(PositionLogTest, ArchiveJobsCommitAfterLaterAppends) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    options.archive_after_seconds = 0;
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+    auto jobs = log.planArchive(fix(16).getTimestamp());
+    ASSERT_EQ(2u, jobs.size());
+    EXPECT_TRUE(log.planArchive(fix(16).getTimestamp()).empty()); // Already planned
+
+    // Written while the log keeps taking fixes
+    for (auto& job : jobs) {
+        EXPECT_TRUE(PositionLog::writeArchive(job));
+    }
+    for (int i = 20; i < 35; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+    EXPECT_EQ(0u, log.getTiers().cold_segments);
+
+    EXPECT_EQ(2u, log.commitArchive(jobs));
+    EXPECT_EQ(2u, log.getTiers().cold_segments);
+    EXPECT_FALSE(std::filesystem::exists(directory / "archive-00000001.arc.tmp"));
+    EXPECT_FALSE(std::filesystem::exists(directory / "segment-00000001.log"));
+
+    auto positions = log.readAll();
+    ASSERT_EQ(35u, positions.size());
+    for (int i = 0; i < 35; ++i) {
+        EXPECT_EQ(fix(i).getTimestamp(), positions[i].getTimestamp());
+    }
+
+    // A job for a segment that is no longer planned is dropped
+    EXPECT_EQ(0u, log.commitArchive(jobs));
+    EXPECT_EQ(2u, log.getTiers().cold_segments);
+}
+
+TEST_F(PositionLogTest, ArchiveJobsOnlyCommitToThePlanningLog) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    options.archive_after_seconds = 0;
+
+    auto log = std::make_unique<PositionLog>(directory, *io, options);
+    ASSERT_TRUE(log->open(true));
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(log->append(fix(i)));
+    }
+    auto stale = log->planArchive(fix(16).getTimestamp());
+    ASSERT_EQ(2u, stale.size());
+    for (auto& job : stale) {
+        EXPECT_TRUE(PositionLog::writeArchive(job));
+    }
+    uint64_t generation = log->getGeneration();
+    log.reset();
+
+    // Reopened for the same directory and planning the same segments
+    log = std::make_unique<PositionLog>(directory, *io, options);
+    ASSERT_TRUE(log->open(false));
+    EXPECT_NE(generation, log->getGeneration());
+    auto jobs = log->planArchive(fix(16).getTimestamp());
+    ASSERT_EQ(2u, jobs.size());
+
+    EXPECT_EQ(0u, log->commitArchive(stale));
+    EXPECT_EQ(0u, log->getTiers().cold_segments);
+    for (auto& job : jobs) {
+        EXPECT_TRUE(PositionLog::writeArchive(job));
+    }
+    EXPECT_EQ(2u, log->commitArchive(jobs));
+    EXPECT_EQ(20u, log->readAll().size());
+}
+
+TEST_F(PositionLogTest, ReadRangeSpansTiers) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    options.archive_after_seconds = 0;
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 35; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+    EXPECT_EQ(0u, log.getTiers().cold_segments);
+    EXPECT_EQ(2u, log.archiveBefore(fix(16).getTimestamp()));
+
+    // Cold, warm (mapped) and active segments
+    auto positions = log.readRange(fix(5).getTimestamp(), fix(30).getTimestamp());
+    ASSERT_EQ(26u, positions.size());
+    for (int i = 0; i < 26; ++i) {
+        EXPECT_EQ(fix(i + 5).getTimestamp(), positions[i].getTimestamp());
+    }
+    EXPECT_GT(log.getTiers().mapped_bytes, 0u);
+
+    EXPECT_EQ(2u, log.readRange(fix(33).getTimestamp(), fix(40).getTimestamp()).size());
+    EXPECT_TRUE(log.readRange(fix(50).getTimestamp(), fix(60).getTimestamp()).empty());
+}
+
+TEST_F(PositionLogTest, SegmentRangesComeFromFootersAndArchives) {
+    PositionLogOptions options;
+    options.segment_size = POSITION_RECORD_SIZE * 10;
+    options.archive_after_seconds = 0;
+
+    PositionLog log(directory, *io, options);
+    ASSERT_TRUE(log.open(true));
+    for (int i = 0; i < 35; ++i) {
+        ASSERT_TRUE(log.append(fix(i)));
+    }
+    EXPECT_EQ(1u, log.archiveBefore(fix(8).getTimestamp()));
+
+    // Eight fixes per segment; the last three are in the active segment
+    std::vector<std::pair<Timestamp, Timestamp>> ranges;
+    ASSERT_TRUE(log.getSegmentRanges(ranges));
+    ASSERT_EQ(5u, ranges.size());
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(fix(8 * i).getTimestamp(), ranges[i].first);
+        EXPECT_EQ(fix(std::min(8 * i + 7, 34)).getTimestamp(), ranges[i].second);
+    }
+}
+
+} // namespace equipment_tracker
+// </test_code>
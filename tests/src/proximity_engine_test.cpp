@@ -0,0 +1,172 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include "equipment_tracker/proximity_engine.h"
+
+namespace equipment_tracker {
+
+// Roughly one metre of latitude in degrees
+constexpr double LAT_METER = 1.0 / 111195.0;
+
+class ProximityEngineTest : public ::testing::Test {
+protected:
+    Position at(double north_meters, double east_meters = 0.0) {
+        // Site origin in San Francisco; longitude scaled for the latitude
+        double lat = 37.7749 + north_meters * LAT_METER;
+        double lon = -122.4194 + east_meters * LAT_METER / std::cos(37.7749 * M_PI / 180.0);
+        return Position(lat, lon);
+    }
+
+    ProximityEngine engine{10.0};
+};
+
+TEST_F(ProximityEngineTest, EmitsEnteredWhenWithinThreshold) {
+    EXPECT_TRUE(engine.update("TRUCK-1", EquipmentType::Truck, at(0.0)).empty());
+
+    auto events = engine.update("FORK-1", EquipmentType::Forklift, at(5.0));
+
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(ProximityEventType::Entered, events[0].type);
+    EXPECT_EQ("FORK-1", events[0].first);
+    EXPECT_EQ("TRUCK-1", events[0].second);
+    EXPECT_NEAR(5.0, events[0].distance_meters, 0.1);
+}
+
+TEST_F(ProximityEngineTest, NoEventWhenFarApart) {
+    engine.update("TRUCK-1", EquipmentType::Truck, at(0.0));
+
+    auto events = engine.update("FORK-1", EquipmentType::Forklift, at(0.0, 50.0));
+
+    EXPECT_TRUE(events.empty());
+    EXPECT_TRUE(engine.getActivePairs().empty());
+}
+
+TEST_F(ProximityEngineTest, EventsAreIncremental) {
+    engine.update("TRUCK-1", EquipmentType::Truck, at(0.0));
+    ASSERT_EQ(1u, engine.update("FORK-1", EquipmentType::Forklift, at(5.0)).size());
+
+    // Still close: no repeated alert
+    EXPECT_TRUE(engine.update("FORK-1", EquipmentType::Forklift, at(6.0)).empty());
+
+    // Inside the hysteresis band: still no event
+    EXPECT_TRUE(engine.update("FORK-1", EquipmentType::Forklift, at(10.5)).empty());
+
+    // Moved away
+    auto events = engine.update("FORK-1", EquipmentType::Forklift, at(40.0));
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(ProximityEventType::Exited, events[0].type);
+    EXPECT_TRUE(engine.getActivePairs().empty());
+}
+
+TEST_F(ProximityEngineTest, DetectsPairsAcrossCellBoundaries) {
+    // Cells are 10m wide; place the machines on either side of a boundary
+    engine.update("A", EquipmentType::Other, at(9.5));
+    auto events = engine.update("B", EquipmentType::Other, at(10.5));
+
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(ProximityEventType::Entered, events[0].type);
+}
+
+TEST_F(ProximityEngineTest, UsesLargerThresholdOfPair) {
+    engine.setThreshold(EquipmentType::Truck, 30.0);
+
+    engine.update("TRUCK-1", EquipmentType::Truck, at(0.0));
+    auto truck_events = engine.update("FORK-1", EquipmentType::Forklift, at(25.0));
+    auto forklift_events = engine.update("FORK-2", EquipmentType::Forklift, at(0.0, 15.0));
+
+    // Truck/forklift pairs use 30m, forklift/forklift pairs keep 10m
+    EXPECT_EQ(2u, truck_events.size() + forklift_events.size());
+    EXPECT_DOUBLE_EQ(30.0, engine.getPairThreshold(EquipmentType::Truck, EquipmentType::Forklift));
+    EXPECT_DOUBLE_EQ(10.0, engine.getPairThreshold(EquipmentType::Forklift, EquipmentType::Forklift));
+
+    auto pairs = engine.getActivePairs();
+    EXPECT_EQ(2u, pairs.size());
+    EXPECT_EQ(pairs.end(), std::find(pairs.begin(), pairs.end(),
+                                     std::make_pair(EquipmentId("FORK-1"), EquipmentId("FORK-2"))));
+}
+
+TEST_F(ProximityEngineTest, RejectsInvalidThresholds) {
+    EXPECT_FALSE(engine.setThreshold(EquipmentType::Truck, 0.0));
+    EXPECT_FALSE(engine.setThreshold(EquipmentType::Truck, -5.0));
+    EXPECT_FALSE(engine.setThreshold(EquipmentType::Truck, std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_FALSE(engine.setThreshold(EquipmentType::Truck, std::numeric_limits<double>::infinity()));
+    EXPECT_DOUBLE_EQ(10.0, engine.getThreshold(EquipmentType::Truck));
+
+    // The grid still works after the rejected values
+    engine.update("A", EquipmentType::Truck, at(0.0));
+    EXPECT_EQ(1u, engine.update("B", EquipmentType::Truck, at(5.0)).size());
+
+    ProximityEngine fallback(-1.0);
+    EXPECT_DOUBLE_EQ(DEFAULT_PROXIMITY_THRESHOLD_METERS, fallback.getThreshold(EquipmentType::Crane));
+    ProximityEngine unbounded(std::numeric_limits<double>::infinity());
+    EXPECT_DOUBLE_EQ(DEFAULT_PROXIMITY_THRESHOLD_METERS, unbounded.getThreshold(EquipmentType::Crane));
+}
+
+TEST_F(ProximityEngineTest, RemoveEmitsExitAndReusesSlot) {
+    engine.update("A", EquipmentType::Other, at(0.0));
+    engine.update("B", EquipmentType::Other, at(3.0));
+
+    auto events = engine.remove("A");
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(ProximityEventType::Exited, events[0].type);
+    EXPECT_EQ(1u, engine.size());
+    EXPECT_TRUE(engine.remove("A").empty());
+
+    auto reentered = engine.update("C", EquipmentType::Other, at(2.0));
+    ASSERT_EQ(1u, reentered.size());
+    EXPECT_EQ("B", reentered[0].first);
+    EXPECT_EQ("C", reentered[0].second);
+}
+
+TEST(ProximityEngineSitesTest, DetectsPairsStraddlingATileBoundary) {
+    SiteProjectionRegistry sites;
+    ProximityEngine engine(sites, 10.0);
+
+    // Find the southern edge of the tile around a fix
+    LocalFix probe = sites.project(Position(37.7749, -122.4194));
+    double edge = sites.getSite(probe.site).south;
+    Position north_of(edge + 2.0 * LAT_METER, -122.4194);
+    Position south_of(edge - 2.0 * LAT_METER, -122.4194);
+
+    EXPECT_TRUE(engine.update("NORTH", EquipmentType::Other, north_of).empty());
+    auto entered = engine.update("SOUTH", EquipmentType::Other, south_of);
+    ASSERT_NE(sites.findSite(north_of.getLatitude(), north_of.getLongitude()),
+              sites.findSite(south_of.getLatitude(), south_of.getLongitude()));
+    ASSERT_EQ(1u, entered.size());
+    EXPECT_EQ(ProximityEventType::Entered, entered[0].type);
+    EXPECT_NEAR(4.0, entered[0].distance_meters, 0.5);
+
+    // Moving along the boundary keeps the pair; moving away ends it
+    EXPECT_TRUE(engine.update("NORTH", EquipmentType::Other,
+                              Position(edge + 5.0 * LAT_METER, -122.4194)).empty());
+    auto exited = engine.update("SOUTH", EquipmentType::Other, Position(edge - 30.0 * LAT_METER, -122.4194));
+    ASSERT_EQ(1u, exited.size());
+    EXPECT_EQ(ProximityEventType::Exited, exited[0].type);
+
+    // The machine already there is found from the other side too
+    auto again = engine.update("SOUTH", EquipmentType::Other, south_of);
+    ASSERT_EQ(1u, again.size());
+    EXPECT_EQ(ProximityEventType::Entered, again[0].type);
+}
+
+TEST(ProximityEngineSitesTest, DetectsPairsAcrossARegisteredSiteEdge) {
+    SiteProjectionRegistry sites;
+    uint32_t yard = sites.addSite("yard", 37.7749, -122.4194, 500.0);
+    ProximityEngine engine(sites, 10.0);
+
+    // One machine just inside the yard, one just outside on an auto-created tile
+    Position inside(37.7749 + 497.0 * LAT_METER, -122.4194);
+    Position outside(37.7749 + 503.0 * LAT_METER, -122.4194);
+    engine.update("INSIDE", EquipmentType::Other, inside);
+    auto events = engine.update("OUTSIDE", EquipmentType::Other, outside);
+
+    EXPECT_EQ(yard, sites.findSite(inside.getLatitude(), inside.getLongitude()));
+    EXPECT_NE(yard, sites.findSite(outside.getLatitude(), outside.getLongitude()));
+    ASSERT_EQ(1u, events.size());
+    EXPECT_NEAR(6.0, events[0].distance_meters, 0.5);
+}
+
+} // namespace equipment_tracker
@@ -0,0 +1,257 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "equipment_tracker/replication.h"
+#include "equipment_tracker/equipment_tracker_service.h"
+
+namespace equipment_tracker {
+
+class ReplicationTest : public ::testing::Test {
+protected:
+    std::string base_path;
+    std::string primary_path;
+    std::string standby_path;
+
+    void SetUp() override {
+        base_path = "replication_test_" + std::to_string(::getpid()) + "_" +
+                    std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+        primary_path = base_path + "/primary";
+        standby_path = base_path + "/standby";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(base_path);
+    }
+
+    static Equipment machine(const std::string& id) {
+        Equipment equipment(id, EquipmentType::Truck, "Truck " + id);
+        equipment.setStatus(EquipmentStatus::Active);
+        return equipment;
+    }
+
+    static Position fix(int step) {
+        return Position(37.0 + step * 0.001, -122.0, 5.0, 2.0,
+                        Timestamp(std::chrono::seconds(1700000000 + step)));
+    }
+};
+
+TEST_F(ReplicationTest, ShipsChangesAsynchronously) {
+    ReplicationStandby standby(standby_path);
+    ASSERT_TRUE(standby.start());
+
+    DataStorage primary(primary_path);
+    ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, standby.getPort());
+    ASSERT_TRUE(replication.start());
+
+    ASSERT_TRUE(primary.saveEquipment(machine("T-1")));
+    ASSERT_TRUE(primary.saveEquipment(machine("T-2")));
+    for (int step = 1; step <= 5; ++step) {
+        ASSERT_TRUE(primary.savePosition("T-1", fix(step)));
+    }
+    ASSERT_TRUE(primary.deleteEquipment("T-2"));
+
+    uint64_t latest = primary.getChangeFeed().getLatestLsn();
+    ASSERT_TRUE(replication.waitForAck(latest, std::chrono::seconds(5)));
+    EXPECT_EQ(latest, standby.getAppliedLsn());
+    EXPECT_EQ(latest, primary.getChangeFeed().getOffset(REPLICATION_CONSUMER));
+
+    auto status = replication.getStatus();
+    EXPECT_TRUE(status.connected);
+    EXPECT_EQ(latest, status.acked_lsn);
+    EXPECT_EQ(0u, status.lag_records);
+    EXPECT_EQ(std::chrono::nanoseconds(0), status.lag);
+    EXPECT_GE(status.batches_shipped, 1u);
+
+    replication.stop();
+    ASSERT_TRUE(standby.promote());
+    DataStorage copy(standby_path);
+    auto equipment = copy.loadEquipment("T-1");
+    ASSERT_TRUE(equipment.has_value());
+    EXPECT_EQ("Truck T-1", equipment->getName());
+    EXPECT_FALSE(copy.loadEquipment("T-2").has_value());
+    EXPECT_EQ(5u, copy.getPositionHistory("T-1", Timestamp(), fix(10).getTimestamp()).size());
+}
+
+TEST_F(ReplicationTest, SyncCommitWaitsForTheStandby) {
+    ReplicationStandby standby(standby_path);
+    ASSERT_TRUE(standby.start());
+
+    DataStorage primary(primary_path);
+    ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, standby.getPort(),
+                                   ReplicationCommitMode::Sync);
+    ASSERT_TRUE(replication.start());
+
+    // Each write returns only once the standby has applied it
+    ASSERT_TRUE(primary.saveEquipment(machine("T-1")));
+    EXPECT_EQ(primary.getChangeFeed().getLatestLsn(), standby.getAppliedLsn());
+    for (int step = 1; step <= 3; ++step) {
+        ASSERT_TRUE(primary.savePosition("T-1", fix(step)));
+        EXPECT_EQ(primary.getChangeFeed().getLatestLsn(), standby.getAppliedLsn());
+    }
+
+    replication.setCommitMode(ReplicationCommitMode::Async);
+    EXPECT_EQ(ReplicationCommitMode::Async, replication.getCommitMode());
+}
+
+TEST_F(ReplicationTest, ResumesAfterStandbyOutageAndReportsLag) {
+    ReplicationStandby standby(standby_path);
+    ASSERT_TRUE(standby.start());
+    uint16_t port = standby.getPort();
+
+    DataStorage primary(primary_path);
+    ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, port);
+    ASSERT_TRUE(replication.start());
+    ASSERT_TRUE(primary.saveEquipment(machine("T-1")));
+    ASSERT_TRUE(replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(5)));
+    uint64_t before_outage = standby.getAppliedLsn();
+
+    standby.stop();
+    for (int step = 1; step <= 10; ++step) {
+        ASSERT_TRUE(primary.savePosition("T-1", fix(step)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto status = replication.getStatus();
+    EXPECT_EQ(10u, status.lag_records);
+    EXPECT_GE(status.lag, std::chrono::milliseconds(20));
+    EXPECT_EQ(before_outage, standby.getAppliedLsn());
+
+    // The restarted standby reports its applied LSN and receives the rest
+    ReplicationStandby restarted(standby_path, CLUSTER_DEFAULT_ADDRESS, port);
+    ASSERT_TRUE(restarted.start());
+    uint64_t latest = primary.getChangeFeed().getLatestLsn();
+    ASSERT_TRUE(replication.waitForAck(latest, std::chrono::seconds(5)));
+    EXPECT_EQ(latest, restarted.getAppliedLsn());
+    EXPECT_EQ(0u, replication.getStatus().lag_records);
+}
+
+TEST_F(ReplicationTest, StandbyIgnoresReplaysAndStopsAtGaps) {
+    ReplicationStandby standby(standby_path);
+    EXPECT_EQ("OK 0", standby.handleRequest("HELLO"));
+
+    ChangeRecord first;
+    first.lsn = 1;
+    first.type = ChangeType::EquipmentSaved;
+    first.equipment_id = "T-1";
+    first.name = "Truck";
+    first.equipment_type = EquipmentType::Truck;
+    ChangeRecord third = first;
+    third.lsn = 3;
+
+    EXPECT_EQ("ACK 1", standby.handleRequest("BATCH\n" + ChangeFeed::encode(first)));
+    EXPECT_EQ("ACK 1", standby.handleRequest("BATCH\n" + ChangeFeed::encode(first)));
+    EXPECT_EQ("ACK 1", standby.handleRequest("BATCH\n" + ChangeFeed::encode(third)));
+    EXPECT_EQ(0u, standby.handleRequest("SOMETHING").find("ERR"));
+
+    ASSERT_TRUE(standby.promote());
+    EXPECT_TRUE(standby.isPromoted());
+    EXPECT_EQ("ERR promoted", standby.handleRequest("HELLO"));
+
+    // Promotion survives a restart
+    ReplicationStandby reopened(standby_path);
+    EXPECT_FALSE(reopened.start());
+}
+
+TEST_F(ReplicationTest, PromotionFencesThePrimaryAndServesTheData) {
+    ReplicationStandby standby(standby_path);
+    ASSERT_TRUE(standby.start());
+
+    DataStorage primary(primary_path);
+    ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, standby.getPort());
+    ASSERT_TRUE(replication.start());
+    Equipment truck = machine("T-1");
+    UtilizationCounters counters;
+    counters.moving_seconds = 5400.0;
+    counters.idle_seconds = 900.0;
+    counters.distance_meters = 31000.5;
+    truck.setUtilization(counters);
+    ASSERT_TRUE(primary.saveEquipment(truck));
+    ASSERT_TRUE(primary.savePosition("T-1", fix(1)));
+    ASSERT_TRUE(replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(5)));
+
+    ASSERT_TRUE(standby.promote());
+    ASSERT_TRUE(primary.saveEquipment(machine("T-2")));
+    EXPECT_FALSE(replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(5)));
+    EXPECT_TRUE(replication.getStatus().fenced);
+    standby.stop();
+
+    EquipmentTrackerService service(standby_path);
+    ASSERT_TRUE(service.getDataStorage().initialize());
+    auto equipment = service.getDataStorage().loadEquipment("T-1");
+    ASSERT_TRUE(equipment.has_value());
+    EXPECT_FALSE(service.getDataStorage().loadEquipment("T-2").has_value());
+    EXPECT_EQ(1u, service.getDataStorage().getRecentPositions("T-1", 10).size());
+
+    // Utilization counters come across with the record
+    service.start();
+    auto utilization = service.getUtilization("T-1");
+    service.stop();
+    ASSERT_TRUE(utilization.has_value());
+    EXPECT_DOUBLE_EQ(5400.0, utilization->moving_seconds);
+    EXPECT_DOUBLE_EQ(900.0, utilization->idle_seconds);
+    EXPECT_DOUBLE_EQ(31000.5, utilization->distance_meters);
+}
+
+TEST_F(ReplicationTest, ReplicatesToAStandbyProcess) {
+    int port_pipe[2];
+    int stop_pipe[2];
+    ASSERT_EQ(0, ::pipe(port_pipe));
+    ASSERT_EQ(0, ::pipe(stop_pipe));
+
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Child: serve as the standby until the parent closes the stop pipe
+        ::close(port_pipe[0]);
+        ::close(stop_pipe[1]);
+        ReplicationStandby standby(standby_path);
+        uint16_t port = standby.start() ? standby.getPort() : 0;
+        bool reported = ::write(port_pipe[1], &port, sizeof(port)) == sizeof(port);
+        char byte;
+        while (reported && ::read(stop_pipe[0], &byte, 1) > 0) {
+        }
+        standby.stop();
+        ::_exit(standby.promote() ? 0 : 1);
+    }
+
+    ::close(port_pipe[1]);
+    ::close(stop_pipe[0]);
+    uint16_t port = 0;
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(port)), ::read(port_pipe[0], &port, sizeof(port)));
+    ::close(port_pipe[0]);
+    ASSERT_NE(0, port);
+
+    {
+        DataStorage primary(primary_path);
+        ReplicationPrimary replication(primary, CLUSTER_DEFAULT_ADDRESS, port);
+        ASSERT_TRUE(replication.start());
+        std::vector<Equipment> fleet;
+        for (int i = 0; i < 20; ++i) {
+            fleet.push_back(machine("T-" + std::to_string(i)));
+        }
+        ASSERT_TRUE(primary.saveEquipmentBatch(fleet));
+        for (int step = 1; step <= 50; ++step) {
+            ASSERT_TRUE(primary.savePosition("T-3", fix(step)));
+        }
+        ASSERT_TRUE(replication.waitForAck(primary.getChangeFeed().getLatestLsn(), std::chrono::seconds(5)));
+    }
+
+    ::close(stop_pipe[1]);
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+
+    DataStorage copy(standby_path);
+    EXPECT_EQ(20u, copy.getAllEquipment().size());
+    EXPECT_EQ(50u, copy.getPositionHistory("T-3", Timestamp(), fix(100).getTimestamp()).size());
+}
+
+} // namespace equipment_tracker
+// </test_code>
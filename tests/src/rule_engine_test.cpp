@@ -0,0 +1,213 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "equipment_tracker/rule_engine.h"
+
+namespace equipment_tracker {
+
+namespace {
+
+// Midnight UTC
+const Timestamp MIDNIGHT = std::chrono::system_clock::from_time_t(1700006400);
+
+RuleZone squareZone(const std::string& name, double latitude, double longitude, double half_size) {
+    return RuleZone{name, {{latitude - half_size, longitude - half_size},
+                           {latitude - half_size, longitude + half_size},
+                           {latitude + half_size, longitude + half_size},
+                           {latitude + half_size, longitude - half_size}}};
+}
+
+RuleDefinition rule(const std::string& text) {
+    auto parsed = parseRule(text);
+    EXPECT_TRUE(parsed.has_value()) << text;
+    return parsed.value_or(RuleDefinition());
+}
+
+// Two fixes 2 s apart; a step of 1e-4 degrees of latitude is about 20 km/h
+std::vector<RuleAlert> drive(RuleEngine& engine, const std::string& id, EquipmentType type,
+                             double latitude, double longitude, double step, Timestamp at) {
+    auto alerts = engine.evaluate(id, type, Position(latitude, longitude, 0.0, 2.0, at));
+    auto more = engine.evaluate(id, type, Position(latitude + step, longitude, 0.0, 2.0,
+                                                   at + std::chrono::seconds(2)));
+    alerts.insert(alerts.end(), more.begin(), more.end());
+    return alerts;
+}
+
+} // namespace
+
+TEST(RuleEngineTest, ParseRuleReadsClauses) {
+    auto speeding = parseRule("zone-b-speeding: type is Truck and in zone B and speed > 15 km/h");
+    ASSERT_TRUE(speeding.has_value());
+    EXPECT_EQ("zone-b-speeding", speeding->name);
+    EXPECT_EQ(EquipmentType::Truck, speeding->type);
+    EXPECT_EQ("B", speeding->zone);
+    EXPECT_FALSE(speeding->window.has_value());
+    EXPECT_NEAR(15.0 / 3.6, speeding->min_speed_mps, 1e-12);
+
+    auto after_hours = parseRule("after-hours: moving and between 22:00 and 05:00");
+    ASSERT_TRUE(after_hours.has_value());
+    EXPECT_FALSE(after_hours->type.has_value());
+    EXPECT_FALSE(after_hours->zone.has_value());
+    ASSERT_TRUE(after_hours->window.has_value());
+    EXPECT_EQ(22 * 60, after_hours->window->start_minute);
+    EXPECT_EQ(5 * 60, after_hours->window->end_minute);
+    EXPECT_DOUBLE_EQ(MOVEMENT_SPEED_THRESHOLD, after_hours->min_speed_mps);
+
+    EXPECT_DOUBLE_EQ(4.0, parseRule("fast: speed > 4m/s")->min_speed_mps);
+    EXPECT_EQ(0, parseRule("late: between 18:00 and 24:00")->window->end_minute);
+    EXPECT_LT(parseRule("present: in zone yard")->min_speed_mps, 0.0);
+
+    EXPECT_FALSE(parseRule("type is Truck").has_value());
+    EXPECT_FALSE(parseRule("x: type is Rocket").has_value());
+    EXPECT_FALSE(parseRule("x: speed 15").has_value());
+    EXPECT_FALSE(parseRule("x: speed > 15 mph").has_value());
+    EXPECT_FALSE(parseRule("x: between 10:00 and 10:00").has_value());
+    EXPECT_FALSE(parseRule("x: moving or parked").has_value());
+    EXPECT_FALSE(parseRule("x: in zone A and in zone B").has_value());
+    EXPECT_FALSE(parseRule("x:").has_value());
+}
+
+TEST(RuleEngineTest, ZoneSpeedLimitRaisesOnceAndClears) {
+    RuleEngine engine;
+    engine.setPlan(RulePlan::compile({squareZone("B", 37.0, -122.0, 0.005)},
+                                     {rule("zone-b-speeding: type is Truck and in zone B and speed > 15 km/h")}));
+    Timestamp noon = MIDNIGHT + std::chrono::hours(12);
+
+    // Fast outside the zone, or fast inside it but not a truck
+    EXPECT_TRUE(drive(engine, "OUT", EquipmentType::Truck, 37.1, -122.0, 1e-4, noon).empty());
+    EXPECT_TRUE(drive(engine, "LIFT", EquipmentType::Forklift, 37.0, -122.0, 1e-4, noon).empty());
+
+    auto alerts = drive(engine, "T-1", EquipmentType::Truck, 37.0, -122.0, 1e-4, noon);
+    ASSERT_EQ(1u, alerts.size());
+    EXPECT_EQ("zone-b-speeding", alerts[0].rule);
+    EXPECT_EQ("T-1", alerts[0].equipment_id);
+    EXPECT_EQ(RuleAlertType::Raised, alerts[0].type);
+    EXPECT_NEAR(5.56, alerts[0].speed_mps, 0.01);
+
+    // Still speeding: no repeat
+    EXPECT_TRUE(engine.evaluate("T-1", EquipmentType::Truck,
+                                Position(37.0002, -122.0, 0.0, 2.0, noon + std::chrono::seconds(4))).empty());
+
+    // Stale fixes are ignored
+    EXPECT_TRUE(engine.evaluate("T-1", EquipmentType::Truck,
+                                Position(37.0002, -122.0, 0.0, 2.0, noon)).empty());
+
+    // Slowing down clears it
+    alerts = engine.evaluate("T-1", EquipmentType::Truck,
+                             Position(37.00021, -122.0, 0.0, 2.0, noon + std::chrono::seconds(6)));
+    ASSERT_EQ(1u, alerts.size());
+    EXPECT_EQ(RuleAlertType::Cleared, alerts[0].type);
+    EXPECT_TRUE(engine.getActiveAlerts().empty());
+}
+
+TEST(RuleEngineTest, TimeWindowsWrapMidnightInLocalTime) {
+    RuleEngine engine;
+    engine.setPlan(RulePlan::compile({}, {rule("after-hours: moving and between 22:00 and 05:00")},
+                                     std::chrono::minutes(120)));
+
+    // 19:59 UTC is 21:59 local, 20:00 UTC is 22:00 local
+    EXPECT_TRUE(drive(engine, "A", EquipmentType::Crane, 37.0, -122.0, 1e-4,
+                      MIDNIGHT + std::chrono::hours(19) + std::chrono::seconds(3596)).empty());
+    EXPECT_EQ(1u, drive(engine, "B", EquipmentType::Crane, 37.0, -122.0, 1e-4,
+                        MIDNIGHT + std::chrono::hours(20)).size());
+
+    // 02:30 UTC is 04:30 local; 03:00 UTC is 05:00 local and outside
+    EXPECT_EQ(1u, drive(engine, "C", EquipmentType::Crane, 37.0, -122.0, 1e-4,
+                        MIDNIGHT + std::chrono::minutes(150)).size());
+    EXPECT_TRUE(drive(engine, "D", EquipmentType::Crane, 37.0, -122.0, 1e-4,
+                      MIDNIGHT + std::chrono::hours(3)).empty());
+
+    // Parked machines do not match
+    EXPECT_TRUE(drive(engine, "E", EquipmentType::Crane, 37.0, -122.0, 0.0,
+                      MIDNIGHT + std::chrono::hours(21)).empty());
+
+    auto active = engine.getActiveAlerts();
+    ASSERT_EQ(2u, active.size());
+    EXPECT_EQ("B", active[0].first);
+    EXPECT_EQ("C", active[1].first);
+    EXPECT_EQ("after-hours", active[1].second);
+}
+
+TEST(RuleEngineTest, LargeRuleSetsMatchOnlyTheirZoneAndType) {
+    // A 40 x 40 grid of small zones, one rule per zone for trucks and one for
+    // cranes, plus a zone too large for the grid and a presence rule
+    std::vector<RuleZone> zones;
+    std::vector<RuleDefinition> rules;
+    for (int row = 0; row < 40; ++row) {
+        for (int column = 0; column < 40; ++column) {
+            std::string name = "Z" + std::to_string(row) + "-" + std::to_string(column);
+            zones.push_back(squareZone(name, 37.0 + row * 0.02, -122.0 + column * 0.02, 0.008));
+            rules.push_back(rule("truck-" + name + ": type is Truck and in zone " + name + " and speed > " +
+                                 std::to_string(10 + row % 5) + " km/h"));
+            rules.push_back(rule("crane-" + name + ": type is Crane and in zone " + name + " and moving"));
+        }
+    }
+    zones.push_back(squareZone("region", 37.4, -121.6, 2.0));
+    rules.push_back(rule("in-region: in zone region"));
+
+    auto plan = RulePlan::compile(zones, rules);
+    ASSERT_NE(nullptr, plan);
+    EXPECT_EQ(rules.size(), plan->size());
+
+    std::vector<uint32_t> matched;
+    Position in_zone(37.0 + 7 * 0.02, -122.0 + 3 * 0.02, 0.0, 2.0, MIDNIGHT);
+    plan->match(EquipmentType::Truck, in_zone, 5.0, matched);
+    ASSERT_EQ(2u, matched.size());
+    EXPECT_EQ("truck-Z7-3", plan->ruleName(matched[0]));
+    EXPECT_EQ("in-region", plan->ruleName(matched[1]));
+
+    // Below this zone's limit (12 km/h), between zones, and outside everything
+    matched.clear();
+    plan->match(EquipmentType::Truck, in_zone, 3.0, matched);
+    EXPECT_EQ(1u, matched.size());
+    matched.clear();
+    plan->match(EquipmentType::Crane, Position(37.01, -122.0, 0.0, 2.0, MIDNIGHT), 5.0, matched);
+    EXPECT_EQ(1u, matched.size());
+    matched.clear();
+    plan->match(EquipmentType::Crane, Position(30.0, -122.0, 0.0, 2.0, MIDNIGHT), 5.0, matched);
+    EXPECT_TRUE(matched.empty());
+}
+
+TEST(RuleEngineTest, CompileRejectsInvalidRuleSets) {
+    RuleDefinition in_b = rule("in-b: in zone B");
+    EXPECT_EQ(nullptr, RulePlan::compile({}, {in_b}));
+    EXPECT_EQ(nullptr, RulePlan::compile({RuleZone{"B", {{37.0, -122.0}, {37.1, -122.0}}}}, {in_b}));
+    EXPECT_EQ(nullptr, RulePlan::compile({squareZone("B", 37.0, -122.0, 0.01), squareZone("B", 38.0, -122.0, 0.01)},
+                                         {in_b}));
+
+    RuleDefinition bad_window{"bad", std::nullopt, std::nullopt, RuleTimeWindow{60, 60}};
+    EXPECT_EQ(nullptr, RulePlan::compile({}, {bad_window}));
+    bad_window.window = RuleTimeWindow{0, 1440};
+    EXPECT_EQ(nullptr, RulePlan::compile({}, {bad_window}));
+
+    EXPECT_NE(nullptr, RulePlan::compile({squareZone("B", 37.0, -122.0, 0.01)}, {in_b}));
+}
+
+TEST(RuleEngineTest, RemovingAMachineClearsItsAlerts) {
+    RuleEngine engine;
+    engine.setPlan(RulePlan::compile({squareZone("yard", 37.0, -122.0, 0.01)},
+                                     {rule("in-yard: in zone yard"), rule("anywhere-fast: speed > 3 m/s")}));
+
+    auto alerts = drive(engine, "T-1", EquipmentType::Truck, 37.0, -122.0, 1e-4, MIDNIGHT);
+    ASSERT_EQ(2u, alerts.size());
+    EXPECT_EQ("in-yard", alerts[0].rule);
+    EXPECT_EQ("anywhere-fast", alerts[1].rule);
+
+    alerts = engine.remove("T-1");
+    ASSERT_EQ(2u, alerts.size());
+    EXPECT_EQ(RuleAlertType::Cleared, alerts[0].type);
+    EXPECT_EQ(RuleAlertType::Cleared, alerts[1].type);
+    EXPECT_TRUE(engine.remove("T-1").empty());
+
+    // A new plan starts from a clean slate
+    drive(engine, "T-2", EquipmentType::Truck, 37.0, -122.0, 1e-4, MIDNIGHT);
+    engine.setPlan(nullptr);
+    EXPECT_TRUE(engine.getActiveAlerts().empty());
+    EXPECT_TRUE(engine.evaluate("T-2", EquipmentType::Truck,
+                                Position(37.001, -122.0, 0.0, 2.0, MIDNIGHT + std::chrono::seconds(10))).empty());
+}
+
+} // namespace equipment_tracker
+// </test_code>
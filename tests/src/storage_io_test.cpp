@@ -0,0 +1,159 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "equipment_tracker/storage_io.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace equipment_tracker {
+
+// Runs every case against each backend available on this machine
+class StorageIoTest : public ::testing::TestWithParam<IoBackendType> {
+protected:
+    std::string path;
+    std::unique_ptr<StorageIoBackend> backend;
+    int fd{-1};
+
+    void SetUp() override {
+        backend = createStorageIoBackend(GetParam());
+        if (!backend) {
+            GTEST_SKIP() << "backend unavailable";
+        }
+
+        path = "test_io_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+#ifdef _WIN32
+        fd = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, 0644);
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+#endif
+        ASSERT_GE(fd, 0);
+    }
+
+    void TearDown() override {
+        backend.reset();
+        if (fd >= 0) {
+#ifdef _WIN32
+            _close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+        std::filesystem::remove(path);
+    }
+};
+
+TEST_P(StorageIoTest, WritesLandAtTheirOffsets) {
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 100; ++i) {
+        char value = static_cast<char>('A' + i % 26);
+        backend->submitWrite(fd, IoBuffer::copyOf(&value, 1), i,
+                             [&](IoResult &result) {
+                                 EXPECT_EQ(1, result.result);
+                                 ++completed;
+                             });
+    }
+    backend->wait();
+
+    EXPECT_EQ(100, completed.load());
+    EXPECT_EQ(100u, std::filesystem::file_size(path));
+
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ('A', contents[0]);
+    EXPECT_EQ('Z', contents[25]);
+    EXPECT_EQ('A', contents[26]);
+}
+
+TEST_P(StorageIoTest, ReadReturnsWrittenData) {
+    const char message[] = "position-record";
+    backend->submitWrite(fd, IoBuffer::copyOf(message, sizeof(message)), 0);
+    backend->submitSync(fd);
+    backend->wait();
+
+    std::string read_back;
+    backend->submitRead(fd, IoBuffer(sizeof(message)), 0, [&](IoResult &result) {
+        ASSERT_EQ(static_cast<int64_t>(sizeof(message)), result.result);
+        read_back.assign(result.buffer.data());
+    });
+    backend->wait();
+
+    EXPECT_EQ("position-record", read_back);
+}
+
+TEST_P(StorageIoTest, ShortReadAtEndOfFile) {
+    backend->submitWrite(fd, IoBuffer::copyOf("abc", 3), 0);
+    backend->wait();
+
+    int64_t transferred = -1;
+    backend->submitRead(fd, IoBuffer(64), 0, [&](IoResult &result) { transferred = result.result; });
+    backend->wait();
+
+    EXPECT_EQ(3, transferred);
+}
+
+#ifndef _WIN32
+TEST_P(StorageIoTest, ShortTransfersAreResubmitted) {
+    if (GetParam() == IoBackendType::ThreadPool) {
+        GTEST_SKIP() << "pipes have no positional reads";
+    }
+
+    // A pipe hands back whatever has arrived, so the read completes in parts
+    int pipe_fds[2];
+    ASSERT_EQ(0, ::pipe(pipe_fds));
+    ASSERT_EQ(4, ::write(pipe_fds[1], "abcd", 4));
+
+    std::atomic<int64_t> transferred{-1};
+    std::string read_back;
+    backend->submitRead(pipe_fds[0], IoBuffer(8), 0, [&](IoResult &result) {
+        read_back.assign(result.buffer.data(), 8);
+        transferred = result.result;
+    });
+    backend->submit();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(-1, transferred.load());
+
+    ASSERT_EQ(4, ::write(pipe_fds[1], "efgh", 4));
+    backend->wait();
+    EXPECT_EQ(8, transferred.load());
+    EXPECT_EQ("abcdefgh", read_back);
+
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+}
+#endif
+
+TEST_P(StorageIoTest, OperationsAreBatched) {
+    for (size_t i = 0; i < IO_SUBMIT_BATCH_SIZE * 4; ++i) {
+        backend->submitWrite(fd, IoBuffer::copyOf("x", 1), i);
+    }
+    backend->wait();
+
+    IoStats stats = backend->getStats();
+    EXPECT_EQ(IO_SUBMIT_BATCH_SIZE * 4, stats.operations);
+    EXPECT_LE(stats.batches, 5u);
+}
+
+TEST(IoBufferTest, HonoursAlignment) {
+    IoBuffer buffer(100, 4096);
+
+    EXPECT_EQ(100u, buffer.size());
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buffer.data()) % 4096);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, StorageIoTest,
+                         ::testing::Values(IoBackendType::ThreadPool, IoBackendType::IoUring));
+
+} // namespace equipment_tracker
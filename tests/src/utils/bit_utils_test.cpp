@@ -0,0 +1,33 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "equipment_tracker/utils/bit_utils.h"
+
+namespace equipment_tracker {
+
+TEST(BitUtilsTest, CountTrailingZeros) {
+    EXPECT_EQ(0u, countTrailingZeros(1));
+    EXPECT_EQ(3u, countTrailingZeros(0x28));
+    EXPECT_EQ(31u, countTrailingZeros(uint64_t{1} << 31));
+    EXPECT_EQ(32u, countTrailingZeros(uint64_t{1} << 32));
+    EXPECT_EQ(63u, countTrailingZeros(uint64_t{1} << 63));
+    EXPECT_EQ(40u, countTrailingZeros(0xFFFFFF0000000000ull));
+}
+
+TEST(BitUtilsTest, CountOnes) {
+    EXPECT_EQ(0u, countOnes(0));
+    EXPECT_EQ(1u, countOnes(0x80000000u));
+    EXPECT_EQ(4u, countOnes(0xF0u));
+    EXPECT_EQ(16u, countOnes(0xAAAAAAAAu));
+    EXPECT_EQ(32u, countOnes(0xFFFFFFFFu));
+}
+
+TEST(BitUtilsTest, PrefetchIsOnlyAHint) {
+    int value = 7;
+    prefetchForRead(&value);
+    prefetchForRead(nullptr);
+    EXPECT_EQ(7, value);
+}
+
+} // namespace equipment_tracker
+// </test_code>
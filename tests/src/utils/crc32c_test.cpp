@@ -0,0 +1,76 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "equipment_tracker/utils/crc32c.h"
+
+namespace equipment_tracker {
+
+TEST(Crc32cTest, KnownVectors) {
+    // RFC 3720 (iSCSI) appendix B.4 check values
+    EXPECT_EQ(0xE3069283u, crc32c("123456789", 9));
+    EXPECT_EQ(0u, crc32c("", 0));
+
+    std::vector<unsigned char> zeros(32, 0x00);
+    EXPECT_EQ(0x8A9136AAu, crc32c(zeros.data(), zeros.size()));
+
+    std::vector<unsigned char> ones(32, 0xFF);
+    EXPECT_EQ(0x62A8AB43u, crc32c(ones.data(), ones.size()));
+
+    std::vector<unsigned char> ascending(32);
+    for (size_t i = 0; i < ascending.size(); ++i) {
+        ascending[i] = static_cast<unsigned char>(i);
+    }
+    EXPECT_EQ(0x46DD794Eu, crc32c(ascending.data(), ascending.size()));
+}
+
+TEST(Crc32cTest, ExtendMatchesSinglePass) {
+    std::string data = "The quick brown fox jumps over the lazy dog";
+    uint32_t whole = crc32c(data.data(), data.size());
+
+    for (size_t split = 0; split <= data.size(); ++split) {
+        uint32_t first = crc32c(data.data(), split);
+        EXPECT_EQ(whole, crc32cExtend(first, data.data() + split, data.size() - split));
+    }
+}
+
+TEST(Crc32cTest, HardwareMatchesTableAtEveryAlignment) {
+    std::mt19937 rng(42);
+    std::vector<unsigned char> buffer(4096 + 16);
+    for (auto& byte : buffer) {
+        byte = static_cast<unsigned char>(rng());
+    }
+
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t size : {0u, 1u, 7u, 8u, 9u, 63u, 64u, 1000u, 4096u}) {
+            EXPECT_EQ(crc32cExtendSoftware(0, buffer.data() + offset, size),
+                      crc32c(buffer.data() + offset, size))
+                << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+TEST(Crc32cTest, DetectsSingleBitFlips) {
+    std::vector<unsigned char> record(48, 0x5A);
+    uint32_t original = crc32c(record.data(), record.size());
+
+    for (size_t bit = 0; bit < record.size() * 8; ++bit) {
+        record[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+        EXPECT_NE(original, crc32c(record.data(), record.size()));
+        record[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+    }
+}
+
+TEST(Crc32cTest, ReportsImplementation) {
+    std::string name = crc32cImplementation();
+    if (crc32cIsHardwareAccelerated()) {
+        EXPECT_NE("table", name);
+    } else {
+        EXPECT_EQ("table", name);
+    }
+}
+
+} // namespace equipment_tracker
+// </test_code>
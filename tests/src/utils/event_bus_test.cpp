@@ -0,0 +1,110 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "equipment_tracker/utils/event_bus.h"
+
+namespace equipment_tracker {
+
+class EventBusTest : public ::testing::Test {
+protected:
+    EventBus<int> bus;
+};
+
+TEST_F(EventBusTest, DeliversToEverySubscriber) {
+    std::vector<int> sync_seen;
+    std::mutex queued_mutex;
+    std::vector<int> queued_seen;
+
+    bus.subscribe("sync", [&](const int &event) { sync_seen.push_back(event); },
+                  DeliveryMode::Synchronous);
+    bus.subscribe("queued", [&](const int &event) {
+        std::lock_guard<std::mutex> lock(queued_mutex);
+        queued_seen.push_back(event);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        bus.publish(i);
+    }
+    bus.flush();
+
+    EXPECT_EQ(10u, sync_seen.size());
+    std::lock_guard<std::mutex> lock(queued_mutex);
+    ASSERT_EQ(10u, queued_seen.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i, queued_seen[i]);
+    }
+}
+
+TEST_F(EventBusTest, SlowSubscriberDoesNotBlockPublisherOrOthers) {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> fast_count{0};
+
+    auto slow = bus.subscribe("slow", [gate](const int &) { gate.wait(); },
+                              DeliveryMode::Queued, 4);
+    auto fast = bus.subscribe("fast", [&](const int &) { ++fast_count; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        bus.publish(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+
+    // The fast subscriber keeps up while the slow one is stalled
+    for (int i = 0; i < 200 && fast_count.load() < 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(100, fast_count.load());
+
+    auto slow_stats = bus.getStats(slow);
+    ASSERT_TRUE(slow_stats.has_value());
+    EXPECT_EQ(100u, slow_stats->published);
+    EXPECT_GT(slow_stats->dropped, 0u);
+    EXPECT_LE(slow_stats->queue_depth, 4u);
+    EXPECT_EQ(0u, bus.getStats(fast)->dropped);
+
+    release.set_value();
+    bus.flush();
+
+    slow_stats = bus.getStats(slow);
+    EXPECT_EQ(100u, slow_stats->delivered + slow_stats->dropped);
+    EXPECT_GT(slow_stats->max_lag.count(), 0);
+}
+
+TEST_F(EventBusTest, UnsubscribeStopsDelivery) {
+    std::atomic<int> count{0};
+    auto id = bus.subscribe("counter", [&](const int &) { ++count; },
+                            DeliveryMode::Synchronous);
+
+    bus.publish(1);
+    EXPECT_TRUE(bus.unsubscribe(id));
+    EXPECT_FALSE(bus.unsubscribe(id));
+    bus.publish(2);
+
+    EXPECT_EQ(1, count.load());
+    EXPECT_EQ(0u, bus.subscriberCount());
+    EXPECT_FALSE(bus.getStats(id).has_value());
+}
+
+TEST_F(EventBusTest, ThrowingHandlerIsCountedAndIsolated) {
+    std::atomic<int> count{0};
+    auto failing = bus.subscribe("failing", [](const int &) { throw std::runtime_error("boom"); });
+    bus.subscribe("healthy", [&](const int &) { ++count; });
+
+    bus.publish(1);
+    bus.publish(2);
+    bus.flush();
+
+    EXPECT_EQ(2, count.load());
+    EXPECT_EQ(2u, bus.getStats(failing)->failed);
+    EXPECT_EQ(2u, bus.getAllStats().size());
+}
+
+} // namespace equipment_tracker
@@ -0,0 +1,144 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "equipment_tracker/utils/flat_hash_map.h"
+
+namespace equipment_tracker {
+
+class FlatHashMapTest : public ::testing::Test {
+protected:
+    FlatHashMap<int> map;
+};
+
+TEST_F(FlatHashMapTest, InsertAndFind) {
+    EXPECT_TRUE(map.try_emplace("FORKLIFT-001", 1).second);
+    EXPECT_TRUE(map.insert("CRANE-001", 2).second);
+
+    EXPECT_EQ(2u, map.size());
+    ASSERT_NE(map.end(), map.find("FORKLIFT-001"));
+    EXPECT_EQ(1, map.find("FORKLIFT-001")->second);
+    EXPECT_EQ(2, map.at("CRANE-001"));
+    EXPECT_EQ(map.end(), map.find("TRUCK-001"));
+    EXPECT_THROW(map.at("TRUCK-001"), std::out_of_range);
+}
+
+TEST_F(FlatHashMapTest, DuplicateInsertKeepsOriginal) {
+    map.try_emplace("A", 1);
+    auto [it, inserted] = map.try_emplace("A", 2);
+
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(1, it->second);
+    EXPECT_EQ(1u, map.size());
+}
+
+TEST_F(FlatHashMapTest, HeterogeneousLookup) {
+    map.try_emplace("EXCAVATOR-7", 7);
+
+    std::string buffer = "prefix:EXCAVATOR-7";
+    std::string_view view = std::string_view(buffer).substr(7);
+
+    EXPECT_TRUE(map.contains(view));
+    EXPECT_EQ(7, map.at(view));
+}
+
+TEST_F(FlatHashMapTest, EraseMovesLastEntryAndKeepsLookupsValid) {
+    for (int i = 0; i < 100; ++i) {
+        map.try_emplace("EQ-" + std::to_string(i), i);
+    }
+
+    EXPECT_EQ(1u, map.erase("EQ-10"));
+    EXPECT_EQ(0u, map.erase("EQ-10"));
+    EXPECT_EQ(99u, map.size());
+    EXPECT_FALSE(map.contains("EQ-10"));
+
+    for (int i = 0; i < 100; ++i) {
+        if (i == 10) {
+            continue;
+        }
+        ASSERT_TRUE(map.contains("EQ-" + std::to_string(i))) << i;
+        EXPECT_EQ(i, map.at("EQ-" + std::to_string(i)));
+    }
+}
+
+TEST_F(FlatHashMapTest, StructuredBindingIteration) {
+    map.try_emplace("A", 1);
+    map.try_emplace("B", 2);
+    map.try_emplace("C", 3);
+
+    int sum = 0;
+    std::string keys;
+    for (const auto &[key, value] : map) {
+        keys += key;
+        sum += value;
+    }
+
+    EXPECT_EQ("ABC", keys);
+    EXPECT_EQ(6, sum);
+}
+
+TEST_F(FlatHashMapTest, HandlesSurviveRehashAndOtherErasures) {
+    map.try_emplace("KEEP", 42);
+    auto handle = map.findHandle("KEEP");
+    ASSERT_TRUE(handle.has_value());
+
+    for (int i = 0; i < 1000; ++i) {
+        map.try_emplace("EQ-" + std::to_string(i), i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        map.erase("EQ-" + std::to_string(i));
+    }
+
+    auto *entry = map.get(*handle);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ("KEEP", entry->first);
+    EXPECT_EQ(42, entry->second);
+
+    map.erase("KEEP");
+    EXPECT_EQ(nullptr, map.get(*handle));
+
+    // Reusing the handle slot must not resurrect the stale handle
+    map.try_emplace("NEW", 1);
+    EXPECT_EQ(nullptr, map.get(*handle));
+}
+
+TEST_F(FlatHashMapTest, ClearInvalidatesHandles) {
+    map.try_emplace("A", 1);
+    auto handle = map.findHandle("A");
+    map.clear();
+
+    EXPECT_TRUE(map.empty());
+    map.try_emplace("A", 2);
+    EXPECT_EQ(nullptr, map.get(*handle));
+    EXPECT_EQ(2, map.at("A"));
+}
+
+TEST_F(FlatHashMapTest, MatchesUnorderedMapUnderRandomOperations) {
+    std::unordered_map<std::string, int> reference;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> key_dist(0, 499);
+    std::uniform_int_distribution<int> op_dist(0, 2);
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string key = "K" + std::to_string(key_dist(rng));
+        switch (op_dist(rng)) {
+        case 0:
+        case 1:
+            EXPECT_EQ(reference.emplace(key, i).second, map.try_emplace(key, i).second);
+            break;
+        default:
+            EXPECT_EQ(reference.erase(key), map.erase(key));
+            break;
+        }
+    }
+
+    ASSERT_EQ(reference.size(), map.size());
+    for (const auto &[key, value] : reference) {
+        ASSERT_TRUE(map.contains(key));
+        EXPECT_EQ(value, map.at(key));
+    }
+}
+
+} // namespace equipment_tracker
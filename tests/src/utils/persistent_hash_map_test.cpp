@@ -0,0 +1,85 @@
+// <test_code>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include "equipment_tracker/utils/persistent_hash_map.h"
+
+namespace equipment_tracker {
+
+class PersistentHashMapTest : public ::testing::Test {
+protected:
+    PersistentHashMap<int> empty;
+};
+
+TEST_F(PersistentHashMapTest, SetReturnsNewVersion) {
+    auto one = empty.set("FORKLIFT-001", 1);
+    auto two = one.set("CRANE-001", 2);
+
+    EXPECT_EQ(0u, empty.size());
+    EXPECT_EQ(1u, one.size());
+    EXPECT_EQ(2u, two.size());
+
+    EXPECT_EQ(nullptr, one.find("CRANE-001"));
+    ASSERT_NE(nullptr, two.find("CRANE-001"));
+    EXPECT_EQ(2, *two.find("CRANE-001"));
+    EXPECT_EQ(1, *two.find("FORKLIFT-001"));
+}
+
+TEST_F(PersistentHashMapTest, OverwriteKeepsOldVersion) {
+    auto v1 = empty.set("A", 1);
+    auto v2 = v1.set("A", 2);
+
+    EXPECT_EQ(1u, v2.size());
+    EXPECT_EQ(1, *v1.find("A"));
+    EXPECT_EQ(2, *v2.find("A"));
+}
+
+TEST_F(PersistentHashMapTest, EraseReturnsNewVersion) {
+    auto v1 = empty.set("A", 1).set("B", 2);
+    auto v2 = v1.erase("A");
+    auto v3 = v2.erase("MISSING");
+
+    EXPECT_EQ(2u, v1.size());
+    EXPECT_EQ(1u, v2.size());
+    EXPECT_EQ(1u, v3.size());
+    EXPECT_NE(nullptr, v1.find("A"));
+    EXPECT_EQ(nullptr, v2.find("A"));
+    EXPECT_EQ(2, *v3.find("B"));
+    EXPECT_TRUE(v2.erase("B").empty());
+}
+
+TEST_F(PersistentHashMapTest, MatchesReferenceUnderRandomOperations) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> key_dist(0, 2000);
+    std::uniform_int_distribution<int> op_dist(0, 3);
+
+    PersistentHashMap<int> map;
+    std::map<std::string, int> reference;
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string key = "EQ-" + std::to_string(key_dist(rng));
+        if (op_dist(rng) == 0) {
+            map = map.erase(key);
+            reference.erase(key);
+        } else {
+            map = map.set(key, i);
+            reference[key] = i;
+        }
+    }
+
+    ASSERT_EQ(reference.size(), map.size());
+    for (const auto &[key, value] : reference) {
+        ASSERT_NE(nullptr, map.find(key));
+        EXPECT_EQ(value, *map.find(key));
+    }
+
+    size_t visited = 0;
+    map.forEach([&](const EquipmentId &key, int value) {
+        EXPECT_EQ(reference.at(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(reference.size(), visited);
+}
+
+} // namespace equipment_tracker